@@ -1,36 +1,53 @@
 #pragma once
 
-#include "ILogHandler.h"
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "ILogger.h"
+
 class MockLogHandler : public ILogger {
 public:
-    void log(const std::string& message, LogLevel level = LogLevel::LOG_INFO) override {
-        messages.push_back({logLevelToString(level), message});
-    }
-    void debug(const std::string& message) override { log(message, LogLevel::LOG_DEBUG); }
-    void info(const std::string& message) override { log(message, LogLevel::LOG_INFO); }
-    void warn(const std::string& message) override { log(message, LogLevel::LOG_WARN); }
-    void error(const std::string& message) override { log(message, LogLevel::LOG_ERROR); }
-
-    void setLogLevel(LogLevel level) override { currentLogLevel = level; }
+    MockLogHandler() = default;
 
-    const std::vector<std::pair<std::string, std::string>>& getMessages() const { return messages; }
-    void clear() { messages.clear(); }
+    auto setLogLevel(LogLevel level) -> void override { currentLogLevel_ = level; }
+    auto addSink(const std::shared_ptr<LogSink>&) -> void override {}
+    auto setLogPath(const std::string&) -> void override {}
 
-protected:
-    std::string logLevelToString(LogLevel level) override {
+    auto toString(LogCategory) -> std::string override { return "TEST"; }
+    auto toString(LogLevel level) -> std::string override {
         switch (level) {
+            case LogLevel::LOG_TRACE: return "TRACE";
             case LogLevel::LOG_DEBUG: return "DEBUG";
             case LogLevel::LOG_INFO: return "INFO";
             case LogLevel::LOG_WARN: return "WARN";
             case LogLevel::LOG_ERROR: return "ERROR";
+            case LogLevel::LOG_FATAL: return "FATAL";
             default: return "UNKNOWN";
         }
     }
 
+    auto getMessages() const -> std::vector<std::pair<std::string, std::string>> {
+        std::lock_guard lock(mutex_);
+        return messages_;
+    }
+    void clear() {
+        std::lock_guard lock(mutex_);
+        messages_.clear();
+    }
+
+protected:
+    void logImpl(std::string_view message, LogLevel level) override {
+        if (level < currentLogLevel_) return;
+        std::lock_guard lock(mutex_);
+        messages_.emplace_back(toString(level), std::string(message));
+    }
+
 private:
-    std::vector<std::pair<std::string, std::string>> messages;
-    LogLevel currentLogLevel = LogLevel::LOG_INFO;
+    mutable std::mutex mutex_;
+    std::vector<std::pair<std::string, std::string>> messages_;
+    LogLevel currentLogLevel_ = LogLevel::LOG_INFO;
 };
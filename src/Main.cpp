@@ -15,9 +15,12 @@
 #include "PlatformInitializer.h"
 
 #include "ActionHandler.h"
+#include "CommandIndex.h"
 #include "ConfigManager.h"
 #include "ConfigMenu.h"
 #include "EventHandler.h"
+#include "Executor.h"
+#include "FocusTracker.h"
 #include "KeySender.h"
 #include "LimLookAndFeel.h"
 #include "LiveInterface.h"
@@ -25,6 +28,8 @@
 #include "PluginManager.h"
 #include "ResponseParser.h"
 #include "Theme.h"
+#include "UsageStore.h"
+#include "WaitScheduler.h"
 #include "WindowManager.h"
 
 class JuceApp : public juce::JUCEApplication {
@@ -87,11 +92,16 @@ public:
         r.configFiles();
         r.theme();
         r.eventHandler();
+        r.focusTracker();
+        r.waitScheduler();
         r.liveInterfaceAndStartObservers();
         r.responseParser();
         r.keySender();
         r.ipc();
         r.pluginManager();
+        r.usageStore();
+        r.commandIndex();
+        r.executor();
         r.actionHandler();
         r.windowManager();
 
@@ -105,8 +115,51 @@ public:
             juce::Thread::sleep(100);
         }
 
+        // the search box runs plugins, menu entries and actions from one index
+        auto commandIndex = container_.resolve<CommandIndex>();
+        auto pluginManager = container_.resolve<IPluginManager>();
+        commandIndex->setActions(container_.resolve<IActionHandler>()->commandNames());
+
+        // keep the search box built and filled so the hotkey only has to show it
+        auto windowManager = container_.resolve<WindowManager>();
+        windowManager->prewarmWindow("SearchBox");
+        std::weak_ptr<IPluginManager> weakPluginManager = pluginManager;
+        pluginManager->onCatalogChanged([windowManager, commandIndex, weakPluginManager]() {
+            if (auto pm = weakPluginManager.lock()) {
+                commandIndex->setPlugins(pm->getCatalog());
+            }
+            juce::MessageManager::callAsync([windowManager]() {
+                windowManager->prewarmWindow("SearchBox");
+            });
+        });
+
+        // edits to either config file apply without a relaunch. Listen
+        // before reading, so a reparse of a stale cache that finishes in
+        // between isn't missed
+        auto configManager = container_.resolve<ConfigManager>();
+        std::weak_ptr<ConfigManager> weakConfigManager = configManager;
+        configManager->onChanged([weakPluginManager, weakConfigManager](const ConfigChanges& changes) {
+            auto pm = weakPluginManager.lock();
+            auto config = weakConfigManager.lock();
+            if (pm && config && changes.pluginAliases) {
+                pm->setAliases(config->getPluginAliases());
+            }
+        });
+        pluginManager->setAliases(configManager->getPluginAliases());
+        configManager->watch();
+
+        auto configMenu = container_.resolve<ConfigMenu>();
+        std::weak_ptr<ConfigMenu> weakConfigMenu = configMenu;
+        configMenu->onChanged([commandIndex, weakConfigMenu]() {
+            if (auto menu = weakConfigMenu.lock()) {
+                commandIndex->setMenu(menu->getMenuData());
+            }
+        });
+        commandIndex->setMenu(configMenu->getMenuData());
+        configMenu->watch();
+
         logger->info("refreshing plugin cache");
-        container_.resolve<IPluginManager>()->refreshPlugins();
+        pluginManager->refreshPlugins();
 
         #ifndef _WIN32
         PlatformInitializer::init();
@@ -116,6 +169,22 @@ public:
     }
 
     void shutdown() override {
+        try {
+            // macros waiting on something would otherwise hold the
+            // executor up until they time out
+            container_.resolve<WaitScheduler>()->stop();
+        } catch (const std::exception& e) {
+            logger->error("Failed to stop macro waits: {}", std::string(e.what()));
+        }
+
+        try {
+            // finish queued actions while IPC is still up to take them
+            logger->info("stopping executor...");
+            container_.resolve<Executor>()->stop();
+        } catch (const std::exception& e) {
+            logger->error("Failed to stop executor: {}", std::string(e.what()));
+        }
+
         try {
             auto ipc = this->container_.resolve<IIPCCore>();
             if (ipc) {
@@ -129,6 +198,13 @@ public:
             logger->error("Unknown error occurred while resolving IIPCCore.");
         }
 
+        try {
+            // don't leave a coalesced save waiting for static destruction
+            container_.resolve<ConfigManager>()->flush();
+        } catch (const std::exception& e) {
+            logger->error("Failed to save config: {}", std::string(e.what()));
+        }
+
         logger->info("Goodbye.");
     }
 
@@ -145,8 +221,18 @@ public:
                 return;
             }
 
+            // followed when it switches; the bundled default until then
+            std::optional<LiveThemeSelection> selection;
+            auto preferences = PathFinder::livePreferences();
+            auto themes = PathFinder::liveThemes();
+            if (preferences && themes) {
+                selection = LiveThemeSelection{*preferences, *themes};
+            }
+
             app->container_.registerFactory<Theme>(
-                [themeFilePath](DependencyContainer&) { return std::make_shared<Theme>(*themeFilePath); }
+                [themeFilePath, selection](DependencyContainer&) {
+                    return std::make_shared<Theme>(*themeFilePath, selection);
+                }
                 , DependencyContainer::Lifetime::Singleton
             );
 
@@ -185,6 +271,8 @@ public:
                 [](DependencyContainer& c) -> std::shared_ptr<ILiveInterface> {
                     return std::make_shared<LiveInterface>(
                         [&c]() { return c.resolve<IEventHandler>(); }
+                        , [&c]() { return c.resolve<FocusTracker>(); }
+                        , [&c]() { return c.resolve<WaitScheduler>(); }
                     );
                 }
                 , DependencyContainer::Lifetime::Singleton
@@ -193,6 +281,20 @@ public:
             app->container_.resolve<ILiveInterface>();
         }
 
+        void focusTracker() {
+            app->container_.registerFactory<FocusTracker>(
+                [](DependencyContainer&) { return std::make_shared<FocusTracker>(); }
+                , DependencyContainer::Lifetime::Singleton
+            );
+        }
+
+        void waitScheduler() {
+            app->container_.registerFactory<WaitScheduler>(
+                [](DependencyContainer&) { return std::make_shared<WaitScheduler>(); }
+                , DependencyContainer::Lifetime::Singleton
+            );
+        }
+
         void responseParser() {
             app->container_.registerFactory<ResponseParser>(
                 [](DependencyContainer&) { return std::make_shared<ResponseParser>(); }
@@ -227,6 +329,22 @@ public:
             );
         }
 
+        void usageStore() {
+            auto usageFilePath = PathFinder::usage();
+
+            app->container_.registerFactory<UsageStore>(
+                [usageFilePath](DependencyContainer&) { return std::make_shared<UsageStore>(usageFilePath); }
+                , DependencyContainer::Lifetime::Singleton
+            );
+        }
+
+        void commandIndex() {
+            app->container_.registerFactory<CommandIndex>(
+                [](DependencyContainer&) { return std::make_shared<CommandIndex>(); }
+                , DependencyContainer::Lifetime::Singleton
+            );
+        }
+
         void eventHandler() {
             app->container_.registerFactory<IEventHandler>(
                 [](DependencyContainer& c) -> std::shared_ptr<IEventHandler> {
@@ -249,12 +367,23 @@ public:
                         , [&c]() { return c.resolve<IIPCCore>(); }
                         , [&c]() { return c.resolve<IEventHandler>(); }
                         , [&c]() { return c.resolve<ILiveInterface>(); }
+                        , [&c]() { return c.resolve<UsageStore>(); }
+                        , [&c]() { return c.resolve<FocusTracker>(); }
+                        , [&c]() { return c.resolve<Executor>(); }
+                        , [&c]() { return c.resolve<WaitScheduler>(); }
                     );
                 }
                 , DependencyContainer::Lifetime::Singleton
             );
         }
 
+        void executor() {
+            app->container_.registerFactory<Executor>(
+                [](DependencyContainer&) { return std::make_shared<Executor>(); }
+                , DependencyContainer::Lifetime::Singleton
+            );
+        }
+
         void windowManager() {
             app->container_.registerFactory<WindowManager>(
                 [](DependencyContainer& c) -> std::shared_ptr<WindowManager> {
@@ -266,6 +395,9 @@ public:
                         , [&c]() { return c.resolve<Theme>(); }
                         , [&c]() { return c.resolve<LimLookAndFeel>(); }
                         , [&c]() { return c.resolve<ConfigMenu>(); }
+                        , [&c]() { return c.resolve<UsageStore>(); }
+                        , [&c]() { return c.resolve<CommandIndex>(); }
+                        , [&c]() { return c.resolve<FocusTracker>(); }
                     );
                 }
                 , DependencyContainer::Lifetime::Singleton
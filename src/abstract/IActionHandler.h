@@ -1,8 +1,9 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
-class EKeyPress;
+class KeyChord;
 
 class IActionHandler {
 public:
@@ -14,11 +15,14 @@ public:
     auto operator=(IActionHandler &&) -> IActionHandler & = delete;
 
     virtual auto handleAction(std::string action) -> void = 0;
-    virtual auto handleKeyEvent(EKeyPress pressedKey) -> bool = 0;
+    virtual auto handleKeyEvent(KeyChord pressed) -> bool = 0;
     virtual auto handleDoubleRightClick() -> void = 0;
     virtual auto loadItem(int itemIndex) -> bool = 0;
     virtual auto loadItemByName(const std::string &itemName) -> bool = 0;
 
+    // actions that run without an argument, for the command palette
+    [[nodiscard]] virtual auto commandNames() const -> std::vector<std::string> = 0;
+
 protected:
     IActionHandler() = default;
 };
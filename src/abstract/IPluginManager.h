@@ -1,9 +1,15 @@
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Types.h"
 
+class PluginCatalog;
+
 class IPluginManager {
 public:
     virtual ~IPluginManager() = default;
@@ -14,8 +20,17 @@ public:
     auto operator=(IPluginManager&&) -> IPluginManager& = delete;
 
     [[nodiscard]] virtual auto getPlugins() const -> const std::vector<Plugin>& = 0;
+    [[nodiscard]] virtual auto getCatalog() const -> std::shared_ptr<const PluginCatalog> = 0;
     virtual auto refreshPlugins() -> void = 0;
 
+    // alias -> plugin name, resolved into every catalog built from now on
+    // (including one right away if plugins are already loaded)
+    virtual void setAliases(std::unordered_map<std::string, std::string> aliases) = 0;
+
+    // called on the thread that finished the refresh, after the new
+    // catalog is visible through getCatalog()
+    virtual void onCatalogChanged(std::function<void()> listener) = 0;
+
 protected:
     IPluginManager() = default;
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <functional>
 #include <vector>
@@ -18,6 +19,16 @@ public:
     virtual void close() = 0;
     [[nodiscard]] virtual auto getWindowHandle() const -> void* = 0;
 
+    // builds and lays out whatever it can ahead of the first open
+    virtual void prewarm() {}
+
+    // `requestedAt` is when the user asked for the window, for windows
+    // that track how long they take to appear
+    virtual void openRequestedAt(std::chrono::steady_clock::time_point requestedAt) {
+        (void)requestedAt;
+        open();
+    }
+
 protected:
     IWindow() = default;
 };
@@ -35,5 +46,7 @@ struct MenuItem {
     std::string label;
     std::string action;
     std::vector<MenuItem> children;
+
+    auto operator==(const MenuItem& other) const -> bool = default;
 };
 
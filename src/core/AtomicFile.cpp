@@ -0,0 +1,54 @@
+#include <cerrno>
+#include <cstdio>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "AtomicFile.h"
+
+auto writeFileAtomically(const std::filesystem::path& path
+                         , std::initializer_list<std::string_view> chunks) -> std::error_code {
+    std::error_code ec;
+
+    // a dotfiles setup links config.yaml in from elsewhere; renaming over
+    // the link would replace it with a plain file
+    auto target = path;
+    if (std::filesystem::is_symlink(path, ec)) {
+        target = std::filesystem::canonical(path, ec);
+        if (ec) {
+            return ec;
+        }
+    }
+
+    auto tmpPath = target;
+    tmpPath += ".tmp";
+
+    std::FILE* file = std::fopen(tmpPath.string().c_str(), "wb");
+    if (file == nullptr) {
+        return {errno, std::generic_category()};
+    }
+
+    bool ok = true;
+    for (std::string_view chunk : chunks) {
+        ok = ok && (chunk.empty() || std::fwrite(chunk.data(), chunk.size(), 1, file) == 1);
+    }
+    ok = ok && std::fflush(file) == 0;
+#ifndef _WIN32
+    ok = ok && ::fsync(fileno(file)) == 0;
+#endif
+    const int error = ok ? 0 : errno;
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok) {
+        std::filesystem::remove(tmpPath, ec);
+        return {error != 0 ? error : EIO, std::generic_category()};
+    }
+
+    std::filesystem::rename(tmpPath, target, ec);
+    if (ec) {
+        std::error_code ignored;
+        std::filesystem::remove(tmpPath, ignored);
+    }
+    return ec;
+}
@@ -0,0 +1,109 @@
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "LogGlobal.h"
+
+#include "AtomicFile.h"
+#include "CacheFile.h"
+
+namespace {
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t kind;
+        uint32_t reserved;
+        uint64_t sourceHash;
+        uint64_t payloadSize;
+    };
+
+    constexpr uint32_t FILE_MAGIC = 0x434d494c; // NOLINT "LIMC"
+    // bump when the header or any payload encoding changes
+    constexpr uint32_t FILE_VERSION = 3;
+
+    auto ingestFile(const unsigned char* data, size_t size, uint32_t kind
+                    , const std::function<bool(uint64_t, std::string_view)>& ingest) -> bool {
+        FileHeader header{};
+        if (size < sizeof(header)) {
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(header));
+
+        if (header.magic != FILE_MAGIC || header.version != FILE_VERSION || header.kind != kind
+            || header.payloadSize != size - sizeof(header))
+        {
+            return false;
+        }
+
+        const std::string_view payload(reinterpret_cast<const char*>(data + sizeof(header)), header.payloadSize); // NOLINT
+        return ingest(header.sourceHash, payload);
+    }
+}
+
+auto CacheFile::hash(std::string_view text) -> uint64_t {
+    // NOLINTBEGIN
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    // NOLINTEND
+    return hash;
+}
+
+auto CacheFile::read(const std::filesystem::path& path, Kind kind
+                     , const std::function<bool(uint64_t, std::string_view)>& ingest) -> bool {
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) {
+        return false;
+    }
+
+    bool hit = false;
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        logger->warn("unable to open cache {}: {}", path.string(), std::strerror(errno));
+        return false;
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+        const auto size = static_cast<size_t>(info.st_size);
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            hit = ingestFile(static_cast<const unsigned char*>(mapped), size, kind, ingest);
+            ::munmap(mapped, size);
+        } else {
+            logger->warn("unable to map cache {}: {}", path.string(), std::strerror(errno));
+        }
+    }
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary);
+    std::vector<unsigned char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    hit = ingestFile(buffer.data(), buffer.size(), kind, ingest);
+#endif
+    return hit;
+}
+
+auto CacheFile::write(const std::filesystem::path& path, Kind kind, uint64_t sourceHash, std::string_view payload) -> bool {
+    const FileHeader header{FILE_MAGIC, FILE_VERSION, kind, 0, sourceHash, payload.size()};
+    auto ec = writeFileAtomically(path, {
+        std::string_view(reinterpret_cast<const char*>(&header), sizeof(header)) // NOLINT
+        , payload
+    });
+    if (ec) {
+        logger->warn("unable to write cache {}: {}", path.string(), ec.message());
+        return false;
+    }
+    return true;
+}
@@ -1,20 +1,220 @@
+#include <algorithm>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <numeric>
+#include <sstream>
 
 #include "LogGlobal.h"
 #include "Types.h"
 
+#include "AtomicFile.h"
+#include "CacheFile.h"
 #include "ConfigManager.h"
+#include "KeyChord.h"
 #include "KeyMapper.h"
+#include "MacroProgram.h"
 
-ConfigManager::ConfigManager(std::filesystem::path configFile)
-    : configFile_(std::move(configFile))
-    , km_(new KeyMapper())
-    , initRetries_() {
+namespace {
+    // true if `next` differed and was moved in
+    template <typename T>
+    auto replaceIfChanged(T& current, T&& next) -> bool {
+        if (current == next) {
+            return false;
+        }
+        current = std::move(next);
+        return true;
+    }
+
+    // smallest encodings, to check counts against what's left
+    constexpr size_t MIN_PAIR_BYTES = 8;
+    constexpr size_t MIN_REMAP_BYTES = 8;
+    constexpr size_t MIN_STEP_BYTES = 4;
+
+    enum StepTag : uint8_t {
+        KeyStep = 0
+        , ActionStep = 1
+    };
+
+    void encodeMap(CacheWriter& out, const std::unordered_map<std::string, std::string>& map) {
+        out.u32(static_cast<uint32_t>(map.size()));
+        for (const auto& [key, value] : map) {
+            out.str(key);
+            out.str(value);
+        }
+    }
+
+    auto decodeMap(CacheReader& in) -> std::unordered_map<std::string, std::string> {
+        std::unordered_map<std::string, std::string> map;
+        for (uint32_t n = in.count(MIN_PAIR_BYTES); n > 0; --n) {
+            auto key = in.str();
+            map[std::move(key)] = in.str();
+        }
+        return map;
+    }
+
+    // keys are stored as their chord, so only what a chord can say back
+    // exactly is cacheable; everything processKeyPress makes qualifies
+    auto encodeChord(CacheWriter& out, const EKeyPress& key) -> bool {
+        const KeyChord chord = KeyChord::fromKeyPress(key);
+        if (!chord.valid() || !(chord.toKeyPress() == key)) {
+            return false;
+        }
+        out.u32(chord.index());
+        return true;
+    }
+
+    auto decodeChord(CacheReader& in) -> std::optional<EKeyPress> {
+        const uint32_t bits = in.u32();
+        const KeyChord chord(static_cast<uint8_t>(bits & ((1U << KeyChord::KEY_BITS) - 1))
+                             , static_cast<uint8_t>(bits >> KeyChord::KEY_BITS));
+        if (bits >= KeyChord::SPACE || !chord.valid()) {
+            return std::nullopt;
+        }
+        return chord.toKeyPress();
+    }
+
+    using RemapMap = std::unordered_map<EKeyPress, EMacro, EMacroHash>;
+
+    auto encodeMacro(CacheWriter& out, const EMacro& macro) -> bool {
+        out.u32(static_cast<uint32_t>(macro.steps.size()));
+        for (const auto& step : macro.steps) {
+            bool ok = std::visit([&](const auto& s) -> bool {
+                using T = std::decay_t<decltype(s)>;
+                if constexpr (std::is_same_v<T, EKeyPress>) {
+                    out.u8(KeyStep);
+                    return encodeChord(out, s);
+                } else {
+                    auto id = NamedActions::find(s.actionName);
+                    if (!id) {
+                        return false;
+                    }
+                    out.u8(ActionStep);
+                    out.u16(static_cast<uint16_t>(*id));
+                    out.u8(s.arguments ? 1 : 0);
+                    if (s.arguments) {
+                        out.str(*s.arguments);
+                    }
+                    return true;
+                }
+            }, step);
+            if (!ok) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    auto decodeMacro(CacheReader& in) -> std::optional<EMacro> {
+        EMacro macro;
+        for (uint32_t steps = in.count(MIN_STEP_BYTES); steps > 0; --steps) {
+            const uint8_t tag = in.u8();
+            if (tag == KeyStep) {
+                auto key = decodeChord(in);
+                if (!key) {
+                    return std::nullopt;
+                }
+                macro.addKeyPress(*key);
+            } else if (tag == ActionStep) {
+                const uint16_t id = in.u16();
+                if (id >= NamedActions::NAMES.size()) {
+                    return std::nullopt;
+                }
+                std::optional<std::string> argument;
+                if (in.u8() != 0) {
+                    argument = in.str();
+                }
+                macro.addAction(Action(std::string(NamedActions::name(static_cast<ActionId>(id))), argument));
+            } else {
+                return std::nullopt;
+            }
+        }
+        return macro;
+    }
+
+    auto encodeRemaps(CacheWriter& out, const RemapMap& remaps) -> bool {
+        out.u32(static_cast<uint32_t>(remaps.size()));
+        for (const auto& [from, macro] : remaps) {
+            if (!encodeChord(out, from) || !encodeMacro(out, macro)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    auto decodeRemaps(CacheReader& in, RemapMap& remaps) -> bool {
+        for (uint32_t n = in.count(MIN_REMAP_BYTES); n > 0; --n) {
+            auto from = decodeChord(in);
+            if (!from) {
+                return false;
+            }
+            auto macro = decodeMacro(in);
+            if (!macro) {
+                return false;
+            }
+            remaps[*from] = std::move(*macro);
+        }
+        return true;
+    }
+
+    // swaps in the remaps of one context that differ, compiling only those
+    void replaceRemaps(RemapMap& current, RemapTable::Programs& programs, RemapMap&& next, ConfigChanges& changes) {
+        for (auto it = current.begin(); it != current.end();) {
+            if (next.find(it->first) == next.end()) {
+                programs.erase(it->first);
+                it = current.erase(it);
+                ++changes.remapsRemoved;
+            } else {
+                ++it;
+            }
+        }
+        for (auto& [from, macro] : next) {
+            auto existing = current.find(from);
+            if (existing != current.end() && existing->second == macro) {
+                continue;
+            }
+            programs[from] = std::make_shared<const MacroProgram>(MacroProgram::compile(macro));
+            current[from] = std::move(macro);
+            ++changes.remapsChanged;
+        }
+    }
+}
+
+ConfigManager::ConfigManager(std::filesystem::path configFile, ConfigOptions options)
+    : km_(std::make_unique<KeyMapper>())
+    , configFile_(std::move(configFile))
+    , cacheFile_(configFile_.string() + ".cache")
+    , options_(options)
+    , initRetries_()
+    , remapTable_(std::make_shared<const RemapTable>())
+    , journal_(options_.undoDepth, options_.undoBytes) {
     loadConfig();
+
+    saveThread_ = std::thread([this]() { saveLoop(); });
+}
+
+ConfigManager::~ConfigManager() {
+    // stop the watcher before anything it calls into goes away
+    watcher_.reset();
+
+    if (refreshThread_.joinable()) {
+        refreshThread_.join();
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    saveCv_.notify_one();
+
+    if (saveThread_.joinable()) {
+        saveThread_.join();
+    }
+
+    flush();
 }
 
 auto ConfigManager::loadConfig() -> void {
@@ -27,104 +227,334 @@ auto ConfigManager::loadConfig() -> void {
             throw std::runtime_error("Config file is not a regular file: " + configFile_.string());
         }
 
-        YAML::Node config = YAML::LoadFile(configFile_.generic_string());
-        logger->info("Config file loaded successfully");
+        std::ifstream in(configFile_, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("unable to open " + configFile_.string());
+        }
+        const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        const uint64_t sourceHash = CacheFile::hash(text);
 
-        applyConfig(config);
+        std::optional<Sections> cached;
+        uint64_t cachedHash = 0;
+        CacheFile::read(cacheFile_, CacheFile::ConfigKind, [&](uint64_t hash, std::string_view payload) {
+            cached = decode(payload);
+            cachedHash = hash;
+            return cached.has_value();
+        });
+
+        if (cached && cachedHash == sourceHash) {
+            apply(std::move(*cached));
+            logger->info("Config loaded from cache");
+            return;
+        }
+
+        if (cached) {
+            // serve what the file compiled to last time until the edit is
+            // parsed, rather than holding startup up for it
+            apply(std::move(*cached));
+            logger->info("Config changed since it was cached, reparsing in the background");
+            if (refreshThread_.joinable()) {
+                refreshThread_.join();
+            }
+            refreshThread_ = std::thread([this]() { reload(); });
+            return;
+        }
+
+        auto sections = parse(YAML::Load(text));
+        logger->info("Config file loaded successfully");
+        {
+            std::lock_guard lock(writeMutex_);
+            writeCacheLocked(sourceHash, sections);
+        }
+        apply(std::move(sections));
 
     } catch (const std::exception &e) {
         logger->error("Error parsing config: {}", std::string(e.what()));
     }
 }
 
-auto ConfigManager::applyConfig(const YAML::Node& config) -> void {
+auto ConfigManager::watch(FileWatchOptions options) -> void {
+    if (watcher_) {
+        return;
+    }
+    watcher_ = std::make_unique<FileWatcher>(std::vector<std::filesystem::path>{configFile_}, [this]() { reload(); }, options);
+}
+
+auto ConfigManager::reload() -> bool {
+    ConfigChanges changes;
     try {
-        undoStack_.push_back(YAML::Clone(config));
+        std::ifstream in(configFile_, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("unable to open " + configFile_.string());
+        }
+        const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        {
+            // our own write coming back round; applying it could undo a
+            // setter call made since the snapshot was taken
+            std::lock_guard lock(writeMutex_);
+            if (text == written_) {
+                return true;
+            }
+        }
+        {
+            std::lock_guard lock(mutex_);
+            if (dirty_) {
+                logger->warn("config changed on disk with a save pending; keeping the changes made in the app");
+                return true;
+            }
+        }
 
-        if (config["init"]["retries"]) {
-            initRetries_ = config["init"]["retries"].as<int>();
+        // parsed and diffed before anything is touched, so a half-written
+        // or broken file can't leave the config half applied
+        auto sections = parse(YAML::Load(text));
+        {
+            std::lock_guard lock(writeMutex_);
+            writeCacheLocked(CacheFile::hash(text), sections);
         }
+        changes = apply(std::move(sections));
+    } catch (const std::exception& e) {
+        logger->error("config not reloaded, keeping the last good one: {}", e.what());
+        std::lock_guard lock(mutex_);
+        lastError_ = e.what();
+        return false;
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        lastError_.clear();
+    }
 
-        logger->info("remap before remap");
-        if (config["remap"] && config["remap"].IsMap()) {
-            for (const auto &item : config["remap"]) {
-                logger->debug("remap found remap");
-                logger->debug("remap fromStr: {}", item.first.as<std::string>());
-                logger->debug("remap toStr: {}", item.second.as<std::string>());
+    if (!changes.any()) {
+        logger->debug("config reloaded, nothing changed");
+        return true;
+    }
+    logger->info("config reloaded: {} remaps changed, {} removed", changes.remapsChanged, changes.remapsRemoved);
 
-                processRemap(item.first.as<std::string>(), item.second.as<std::string>());
-            }
+    std::vector<std::function<void(const ConfigChanges&)>> listeners;
+    {
+        std::lock_guard lock(listenersMutex_);
+        listeners = listeners_;
+    }
+    for (const auto& listener : listeners) {
+        listener(changes);
+    }
+    return true;
+}
+
+auto ConfigManager::lastError() const -> std::string {
+    std::lock_guard lock(mutex_);
+    return lastError_;
+}
+
+auto ConfigManager::onChanged(std::function<void(const ConfigChanges&)> listener) -> void {
+    std::lock_guard lock(listenersMutex_);
+    listeners_.push_back(std::move(listener));
+}
+
+auto ConfigManager::parse(const YAML::Node& config) -> Sections {
+    Sections parsed;
+    KeyMapper km;
+
+    if (config["init"] && config["init"]["retries"]) {
+        parsed.initRetries = config["init"]["retries"].as<int>();
+    }
+
+    // throws for a value that isn't a string; a bad key or step is
+    // logged and left out
+    auto parseRemap = [&](const std::string& fromStr, const YAML::Node& to, RemapMap& into) {
+        const auto toStr = to.as<std::string>();
+        logger->debug("remap from: {} to: {}", fromStr, toStr);
+        try {
+            into[km.processKeyPress(fromStr)] = parseMacro(km, toStr);
+        } catch (const std::runtime_error& e) {
+            logger->error("{}", e.what());
         }
+    };
 
-        if (config["rename-plugins"] && config["rename-plugins"].IsMap()) {
-            for (const auto &item : config["rename-plugins"]) {
-                auto originalName = item.first.as<std::string>();
-                auto newName = item.second.as<std::string>();
-                renamePlugins_[originalName] = newName;
+    if (config["remap"] && config["remap"].IsMap()) {
+        for (const auto &item : config["remap"]) {
+            const auto fromStr = item.first.as<std::string>();
+
+            // a map under a context's name overrides remaps there
+            auto context = KeyContexts::find(fromStr);
+            if (context && *context != KeyContext::Global && item.second.IsMap()) {
+                RemapMap layer;
+                for (const auto& entry : item.second) {
+                    parseRemap(entry.first.as<std::string>(), entry.second, layer);
+                }
+                if (!layer.empty()) {
+                    parsed.remapLayers[*context] = std::move(layer);
+                }
+                continue;
             }
-        } else {
-            //throw std::runtime_error("'rename-plugins' section is missing or not a sequence");
+
+            parseRemap(fromStr, item.second, parsed.remap);
         }
+    }
 
-        if (config["remove-plugins"] && config["remove-plugins"].IsSequence()) {
-            removePlugins_.clear();
-            for (const auto& plugin : config["remove-plugins"]) {
-                removePlugins_.push_back(plugin.as<std::string>());
+    if (config["app-shortcuts"] && config["app-shortcuts"].IsMap()) {
+        const auto& appShortcuts = config["app-shortcuts"];
+        if (appShortcuts["leader"]) {
+            const auto leader = appShortcuts["leader"].as<std::string>();
+            try {
+                parsed.leader = km.EKeyPressToString(km.processKeyPress(leader));
+            } catch (const std::runtime_error& e) {
+                logger->error("leader: {}", e.what());
             }
-        } else {
-            //throw std::runtime_error("'remove-plugins' section is missing or not a sequence");
         }
-
-        if (config["window"] && config["window"].IsMap()) {
-            for (const auto &item : config["window"]) {
-                auto windowName = item.first.as<std::string>();
-                auto setting = item.second.as<std::string>();
-                windowSettings_[windowName] = setting;
+        if (appShortcuts["sequence-timeout"]) {
+            parsed.sequenceTimeoutMs = appShortcuts["sequence-timeout"].as<int>();
+            if (parsed.sequenceTimeoutMs <= 0) {
+                logger->warn("sequence-timeout must be a number of milliseconds above 0, using {}", DEFAULT_SEQUENCE_TIMEOUT_MS);
+                parsed.sequenceTimeoutMs = DEFAULT_SEQUENCE_TIMEOUT_MS;
             }
-        } else {
-            //throw std::runtime_error("'window' section is missing or not a sequence of maps");
         }
+    }
 
-        if (config["shortcuts"] && config["shortcuts"].IsSequence()) {
-            shortcuts_.clear();
-            for (const auto& item : config["shortcuts"]) {
-                std::unordered_map<std::string, std::string> shortcutMap;
-                for (const auto& pair : item) {
-                    auto key = pair.first.as<std::string>();
-                    auto value = pair.second.as<std::string>();
-                    shortcutMap[key] = value;
+    // chords separated by spaces; written back canonical, so two spellings
+    // of one sequence are one entry
+    if (config["sequences"] && config["sequences"].IsMap()) {
+        for (const auto& item : config["sequences"]) {
+            const auto keysStr = item.first.as<std::string>();
+            const auto toStr = item.second.as<std::string>();
+            try {
+                std::istringstream tokens(keysStr);
+                std::string keys;
+                for (std::string token; tokens >> token;) {
+                    keys += keys.empty() ? "" : " ";
+                    keys += token == "leader" ? token : km.EKeyPressToString(km.processKeyPress(token));
                 }
-                shortcuts_.push_back(shortcutMap);
+                parsed.sequences[keys] = parseMacro(km, toStr);
+            } catch (const std::runtime_error& e) {
+                logger->error("sequence {}: {}", keysStr, e.what());
             }
-        } else {
-            //throw std::runtime_error("'shortcuts' section is missing or not a sequence of maps");
         }
+    }
 
-    } catch (const std::exception &e) {
-        std::cerr << "Error loading config: " << e.what() << std::endl;
+    if (config["rename-plugins"] && config["rename-plugins"].IsMap()) {
+        for (const auto &item : config["rename-plugins"]) {
+            parsed.renamePlugins[item.first.as<std::string>()] = item.second.as<std::string>();
+        }
+    }
+
+    if (config["plugin-aliases"] && config["plugin-aliases"].IsMap()) {
+        for (const auto &item : config["plugin-aliases"]) {
+            parsed.pluginAliases[item.first.as<std::string>()] = item.second.as<std::string>();
+        }
+    }
+
+    if (config["remove-plugins"] && config["remove-plugins"].IsSequence()) {
+        for (const auto& plugin : config["remove-plugins"]) {
+            parsed.removePlugins.push_back(plugin.as<std::string>());
+        }
+    }
+
+    if (config["window"] && config["window"].IsMap()) {
+        for (const auto &item : config["window"]) {
+            parsed.windowSettings[item.first.as<std::string>()] = item.second.as<std::string>();
+        }
+    }
+
+    if (config["shortcuts"] && config["shortcuts"].IsSequence()) {
+        for (const auto& item : config["shortcuts"]) {
+            std::unordered_map<std::string, std::string> shortcutMap;
+            for (const auto& pair : item) {
+                shortcutMap[pair.first.as<std::string>()] = pair.second.as<std::string>();
+            }
+            parsed.shortcuts.push_back(std::move(shortcutMap));
+        }
+    }
+
+    return parsed;
+}
+
+auto ConfigManager::apply(Sections parsed) -> ConfigChanges {
+    ConfigChanges changes;
+    std::lock_guard lock(mutex_);
+
+    changes.init = replaceIfChanged(initRetries_, std::move(parsed.initRetries));
+
+    replaceRemaps(remap_, programs_, std::move(parsed.remap), changes);
+
+    for (const auto& [context, layer] : remapLayers_) {
+        parsed.remapLayers.try_emplace(context);
+    }
+    for (auto& [context, layer] : parsed.remapLayers) {
+        replaceRemaps(remapLayers_[context], layerPrograms_[context], std::move(layer), changes);
+        if (remapLayers_[context].empty()) {
+            remapLayers_.erase(context);
+            layerPrograms_.erase(context);
+        }
+    }
+
+    const bool leader = replaceIfChanged(leader_, std::move(parsed.leader));
+    const bool timeout = replaceIfChanged(sequenceTimeoutMs_, std::move(parsed.sequenceTimeoutMs));
+    const bool sequences = replaceIfChanged(sequences_, std::move(parsed.sequences));
+    changes.sequences = leader || timeout || sequences;
+    if (changes.sequences) {
+        compileSequencesLocked();
+    }
+
+    if (changes.remapsChanged != 0 || changes.remapsRemoved != 0 || changes.sequences) {
+        publishRemaps();
     }
+
+    changes.renamePlugins = replaceIfChanged(renamePlugins_, std::move(parsed.renamePlugins));
+    changes.pluginAliases = replaceIfChanged(pluginAliases_, std::move(parsed.pluginAliases));
+    changes.removePlugins = replaceIfChanged(removePlugins_, std::move(parsed.removePlugins));
+    changes.window = replaceIfChanged(windowSettings_, std::move(parsed.windowSettings));
+    changes.shortcuts = replaceIfChanged(shortcuts_, std::move(parsed.shortcuts));
+
+    return changes;
 }
 
 auto ConfigManager::saveConfig() -> void {
-    undoStack_.push_back(YAML::Clone(config_));
+    {
+        std::lock_guard lock(mutex_);
+        dirty_ = true;
+    }
+    saveCv_.notify_one();
+}
 
-    config_["init"]["retries"] = initRetries_;
+auto ConfigManager::flush() -> void {
+    Sections snapshot;
+    {
+        std::lock_guard lock(mutex_);
+        if (!dirty_) {
+            return;
+        }
+        snapshot = snapshotLocked();
+        dirty_ = false;
+    }
+    write(emit(snapshot), snapshot);
+}
 
-    YAML::Node remapNode = YAML::Load("{}");
-    for (const auto& item : remap_) {
-        logger->debug("save remap");
+auto ConfigManager::snapshotLocked() const -> Sections {
+    return {initRetries_, remap_, renamePlugins_, pluginAliases_, removePlugins_, windowSettings_, shortcuts_, remapLayers_
+            , leader_, sequenceTimeoutMs_, sequences_};
+}
+
+auto ConfigManager::recordLocked(ConfigEdit edit) -> void {
+    const size_t bytes = editBytes(edit);
+    if (!journal_.record(std::move(edit), bytes)) {
+        logger->warn("change too large to undo ({} bytes)", bytes);
+    }
+}
+
+auto ConfigManager::emit(const Sections& sections) -> std::string {
+    KeyMapper km;
+    YAML::Node config;
 
-        std::string fromString = km_->EKeyPressToString(item.first);
-        logger->debug("save remap from: {}", fromString);
+    config["init"]["retries"] = sections.initRetries;
 
+    auto macroString = [&](const EMacro& macro) -> std::string {
         std::vector<std::string> stepStrings;
-        const EMacro& macro = item.second;
 
         for (const auto& item : macro.steps) {
             std::visit([&](auto&& arg) {
                 using T = std::decay_t<decltype(arg)>;
                 if constexpr (std::is_same_v<T, EKeyPress>) {
-                    stepStrings.push_back(km_->EKeyPressToString(arg));
+                    stepStrings.push_back(km.EKeyPressToString(arg));
                 } else if constexpr (std::is_same_v<T, Action>) {
                     if (arg.arguments) {
                         stepStrings.push_back(arg.actionName + "." + *arg.arguments);
@@ -136,129 +566,522 @@ auto ConfigManager::saveConfig() -> void {
         }
 
         std::string toString;
-        toString = std::accumulate(
-            std::next(stepStrings.begin()), stepStrings.end(), stepStrings[0],
-            [](std::string a, const std::string& b) {
-                return a + ", " + b;
-            }
-        );
+        if (!stepStrings.empty()) {
+            toString = std::accumulate(
+                std::next(stepStrings.begin()), stepStrings.end(), stepStrings[0],
+                [](std::string a, const std::string& b) {
+                    return a + ", " + b;
+                }
+            );
+        }
+        return toString;
+    };
+
+    YAML::Node remapNode = YAML::Load("{}");
+    for (const auto& item : sections.remap) {
+        remapNode[km.EKeyPressToString(item.first)] = macroString(item.second);
+    }
+    for (const auto& [context, layer] : sections.remapLayers) {
+        YAML::Node layerNode = YAML::Load("{}");
+        for (const auto& item : layer) {
+            layerNode[km.EKeyPressToString(item.first)] = macroString(item.second);
+        }
+        remapNode[std::string(KeyContexts::name(context))] = layerNode;
+    }
+    // a reload reads this back; leaving it out would drop every remap
+    config["remap"] = remapNode;
+
+    if (!sections.leader.empty()) {
+        config["app-shortcuts"]["leader"] = sections.leader;
+    }
+    if (sections.sequenceTimeoutMs != DEFAULT_SEQUENCE_TIMEOUT_MS) {
+        config["app-shortcuts"]["sequence-timeout"] = sections.sequenceTimeoutMs;
+    }
 
-        remapNode[fromString] = toString;
+    if (!sections.sequences.empty()) {
+        YAML::Node sequencesNode = YAML::Load("{}");
+        for (const auto& [keys, macro] : sections.sequences) {
+            sequencesNode[keys] = macroString(macro);
+        }
+        config["sequences"] = sequencesNode;
     }
 
     YAML::Node renamePluginsNode = YAML::Load("{}");
-    for (const auto &item : renamePlugins_) {
+    for (const auto &item : sections.renamePlugins) {
         renamePluginsNode[item.first] = item.second;
     }
-    config_["rename-plugins"] = renamePluginsNode;
+    config["rename-plugins"] = renamePluginsNode;
+
+    YAML::Node pluginAliasesNode = YAML::Load("{}");
+    for (const auto &item : sections.pluginAliases) {
+        pluginAliasesNode[item.first] = item.second;
+    }
+    config["plugin-aliases"] = pluginAliasesNode;
 
     YAML::Node removePluginsNode = YAML::Load("[]");
-    for (const auto &plugin : removePlugins_) {
+    for (const auto &plugin : sections.removePlugins) {
         removePluginsNode.push_back(plugin);
     }
-    config_["remove-plugins"] = removePluginsNode;
+    config["remove-plugins"] = removePluginsNode;
 
     YAML::Node windowNode = YAML::Load("{}");
-    for (const auto &item : windowSettings_) {
+    for (const auto &item : sections.windowSettings) {
         windowNode[item.first] = item.second;
     }
-    config_["window"] = windowNode;
+    config["window"] = windowNode;
 
     YAML::Node shortcutsNode = YAML::Load("[]");
-    for (const auto &shortcut : shortcuts_) {
+    for (const auto &shortcut : sections.shortcuts) {
         shortcutsNode.push_back(shortcut);
     }
-    config_["shortcuts"] = shortcutsNode;
+    config["shortcuts"] = shortcutsNode;
+
+    YAML::Emitter out;
+    out << config;
+    return std::string(out.c_str()) + "\n";
+}
+
+// atomically, so a crash mid-write leaves the previous config intact
+auto ConfigManager::write(const std::string& yaml, const Sections& sections) -> void {
+    std::lock_guard lock(writeMutex_);
+    if (yaml == written_) {
+        return;
+    }
+
+    // recorded first so the watcher, woken by the rename, sees it
+    written_ = yaml;
+    if (auto ec = writeFileAtomically(configFile_, {yaml})) {
+        logger->error("unable to write config {}: {}", configFile_.string(), ec.message());
+        written_.clear();
+        return;
+    }
+
+    logger->debug("wrote config {}", configFile_.string());
+
+    // what the file now says is what we just wrote it from
+    writeCacheLocked(CacheFile::hash(yaml), sections);
+}
+
+auto ConfigManager::writeCacheLocked(uint64_t sourceHash, const Sections& sections) -> void {
+    auto payload = encode(sections);
+    if (!payload) {
+        logger->warn("config has entries the cache can't hold; it'll be parsed at every launch");
+        std::error_code ec;
+        std::filesystem::remove(cacheFile_, ec);
+        return;
+    }
+    CacheFile::write(cacheFile_, CacheFile::ConfigKind, sourceHash, *payload);
+}
+
+auto ConfigManager::encode(const Sections& sections) -> std::optional<std::string> {
+    CacheWriter out;
+    out.i32(sections.initRetries);
+
+    if (!encodeRemaps(out, sections.remap)) {
+        return std::nullopt;
+    }
+
+    encodeMap(out, sections.renamePlugins);
+    encodeMap(out, sections.pluginAliases);
+
+    out.u32(static_cast<uint32_t>(sections.removePlugins.size()));
+    for (const auto& plugin : sections.removePlugins) {
+        out.str(plugin);
+    }
+
+    encodeMap(out, sections.windowSettings);
+
+    out.u32(static_cast<uint32_t>(sections.shortcuts.size()));
+    for (const auto& shortcut : sections.shortcuts) {
+        encodeMap(out, shortcut);
+    }
+
+    out.u32(static_cast<uint32_t>(sections.remapLayers.size()));
+    for (const auto& [context, layer] : sections.remapLayers) {
+        out.u8(static_cast<uint8_t>(context));
+        if (!encodeRemaps(out, layer)) {
+            return std::nullopt;
+        }
+    }
+
+    out.str(sections.leader);
+    out.i32(sections.sequenceTimeoutMs);
+    out.u32(static_cast<uint32_t>(sections.sequences.size()));
+    for (const auto& [keys, macro] : sections.sequences) {
+        out.str(keys);
+        if (!encodeMacro(out, macro)) {
+            return std::nullopt;
+        }
+    }
+
+    return out.bytes();
+}
+
+auto ConfigManager::decode(std::string_view payload) -> std::optional<Sections> {
+    CacheReader in(payload);
+    Sections sections;
+    sections.initRetries = in.i32();
+
+    if (!decodeRemaps(in, sections.remap)) {
+        return std::nullopt;
+    }
+
+    sections.renamePlugins = decodeMap(in);
+    sections.pluginAliases = decodeMap(in);
+
+    for (uint32_t n = in.count(sizeof(uint32_t)); n > 0; --n) {
+        sections.removePlugins.push_back(in.str());
+    }
+
+    sections.windowSettings = decodeMap(in);
+
+    for (uint32_t n = in.count(sizeof(uint32_t)); n > 0; --n) {
+        sections.shortcuts.push_back(decodeMap(in));
+    }
+
+    for (uint32_t n = in.count(1 + sizeof(uint32_t)); n > 0; --n) {
+        const uint8_t context = in.u8();
+        if (context == 0 || context >= KeyContexts::COUNT) {
+            return std::nullopt;
+        }
+        auto& layer = sections.remapLayers[static_cast<KeyContext>(context)];
+        if (!decodeRemaps(in, layer) || layer.empty()) {
+            return std::nullopt;
+        }
+    }
+
+    sections.leader = in.str();
+    sections.sequenceTimeoutMs = in.i32();
+    if (sections.sequenceTimeoutMs <= 0) {
+        return std::nullopt;
+    }
+    for (uint32_t n = in.count(2 * sizeof(uint32_t)); n > 0; --n) {
+        auto keys = in.str();
+        auto macro = decodeMacro(in);
+        if (!macro) {
+            return std::nullopt;
+        }
+        sections.sequences[std::move(keys)] = std::move(*macro);
+    }
+
+    if (!in.ok()) {
+        return std::nullopt;
+    }
+    return sections;
+}
 
-    std::ofstream fout(configFile_);
-    fout << config_;
+auto ConfigManager::saveLoop() -> void {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        saveCv_.wait(lock, [this]() { return stopping_ || dirty_; });
+        if (stopping_) {
+            return;
+        }
+
+        // let a burst of setter calls settle before touching the disk;
+        // the destructor does the final write if we're cut short
+        if (saveCv_.wait_for(lock, options_.saveDelay, [this]() { return stopping_; })) {
+            return;
+        }
+
+        auto snapshot = snapshotLocked();
+        dirty_ = false;
+
+        lock.unlock();
+        write(emit(snapshot), snapshot);
+        lock.lock();
+    }
 }
 
 auto ConfigManager::getInitRetries() const -> int {
+    std::lock_guard lock(mutex_);
     return initRetries_;
 }
 
 auto ConfigManager::setInitRetries(int retries) -> void {
-    initRetries_ = retries;
+    {
+        std::lock_guard lock(mutex_);
+        recordLocked(RetriesEdit{initRetries_, retries});
+        initRetries_ = retries;
+    }
     saveConfig();
 }
 
 auto ConfigManager::getRemap() const -> std::unordered_map<EKeyPress, EMacro, EMacroHash> {
     logger->debug("get remap caled");
+    std::lock_guard lock(mutex_);
     return remap_;
 }
 
+auto ConfigManager::getRemap(KeyContext context) const -> std::unordered_map<EKeyPress, EMacro, EMacroHash> {
+    std::lock_guard lock(mutex_);
+    if (context == KeyContext::Global) {
+        return remap_;
+    }
+    auto layer = remapLayers_.find(context);
+    return layer != remapLayers_.end() ? layer->second : RemapMap{};
+}
+
+auto ConfigManager::getRemapTable() const -> RemapTablePtr {
+    return std::atomic_load(&remapTable_);
+}
+
+auto ConfigManager::publishRemaps() -> void {
+    std::atomic_store(&remapTable_, RemapTablePtr(std::make_shared<const RemapTable>(programs_, layerPrograms_, sequenceTrie_)));
+}
+
+auto ConfigManager::compileSequencesLocked() -> void {
+    std::vector<SequenceTrie::Sequence> compiled;
+    compiled.reserve(sequences_.size());
+
+    for (const auto& [keys, macro] : sequences_) {
+        SequenceTrie::Sequence sequence;
+        std::istringstream tokens(keys);
+        for (std::string token; tokens >> token;) {
+            if (token == "leader") {
+                if (leader_.empty()) {
+                    logger->warn("sequence \"{}\" uses the leader, but app-shortcuts sets none", keys);
+                    sequence.chords.clear();
+                    break;
+                }
+                token = leader_;
+            }
+            sequence.chords.push_back(KeyMapper::parseChord(token).chord);
+        }
+        if (sequence.chords.empty()) {
+            continue;
+        }
+        sequence.program = std::make_shared<const MacroProgram>(MacroProgram::compile(macro));
+        compiled.push_back(std::move(sequence));
+    }
+
+    sequenceTrie_ = std::make_shared<const SequenceTrie>(std::move(compiled), std::chrono::milliseconds(sequenceTimeoutMs_));
+}
+
+auto ConfigManager::getLeader() const -> std::string {
+    std::lock_guard lock(mutex_);
+    return leader_;
+}
+
+auto ConfigManager::getSequences() const -> std::map<std::string, EMacro> {
+    std::lock_guard lock(mutex_);
+    return sequences_;
+}
+
 auto ConfigManager::setRemap(const std::string &fromStr, const std::string &toStr) -> void {
     logger->debug("setRemap: from: {} to: {}", fromStr, toStr);
-    processRemap(fromStr, toStr);
+    {
+        std::lock_guard lock(mutex_);
+        EKeyPress from = km_->processKeyPress(fromStr);
+        EMacro macro = parseMacro(*km_, toStr);
+
+        auto current = remap_.find(from);
+        recordLocked(RemapEdit{from, current != remap_.end() ? std::optional(current->second) : std::nullopt, macro});
+        putRemapLocked(from, macro);
+        publishRemaps();
+    }
     saveConfig();
 }
 
 auto ConfigManager::getRenamePlugins() const -> std::unordered_map<std::string, std::string> {
+    std::lock_guard lock(mutex_);
     return renamePlugins_;
 }
 
 auto ConfigManager::setRenamePlugin(const std::string &originalName, const std::string &newName) -> void {
-    renamePlugins_[originalName] = newName;
+    {
+        std::lock_guard lock(mutex_);
+        setStringLocked(&ConfigManager::renamePlugins_, originalName, newName);
+    }
+    saveConfig();
+}
+
+auto ConfigManager::getPluginAliases() const -> std::unordered_map<std::string, std::string> {
+    std::lock_guard lock(mutex_);
+    return pluginAliases_;
+}
+
+auto ConfigManager::setPluginAlias(const std::string &alias, const std::string &pluginName) -> void {
+    {
+        std::lock_guard lock(mutex_);
+        setStringLocked(&ConfigManager::pluginAliases_, alias, pluginName);
+    }
     saveConfig();
 }
 
 auto ConfigManager::getRemovePlugins() const -> std::vector<std::string> {
+    std::lock_guard lock(mutex_);
     return removePlugins_;
 }
 
 auto ConfigManager::setRemovePlugin(const std::string &pluginName) -> void {
-    removePlugins_.push_back(pluginName);
+    {
+        std::lock_guard lock(mutex_);
+        recordLocked(RemovePluginEdit{pluginName});
+        removePlugins_.push_back(pluginName);
+    }
     saveConfig();
 }
 
 auto ConfigManager::getWindowSettings() const -> std::unordered_map<std::string, std::string> {
+    std::lock_guard lock(mutex_);
     return windowSettings_;
 }
 
 auto ConfigManager::setWindowSetting(const std::string &windowName, const std::string &setting) -> void {
-    windowSettings_[windowName] = setting;
+    {
+        std::lock_guard lock(mutex_);
+        setStringLocked(&ConfigManager::windowSettings_, windowName, setting);
+    }
     saveConfig();
 }
 
 auto ConfigManager::getShortcuts() const -> std::vector<std::unordered_map<std::string, std::string>> {
+    std::lock_guard lock(mutex_);
     return shortcuts_;
 }
 
 auto ConfigManager::setShortcut(size_t index, const std::unordered_map<std::string, std::string>& shortcut) -> void {
-    if (index < shortcuts_.size()) {
-        shortcuts_[index] = shortcut;
-    } else {
-        throw std::out_of_range("Index is out of range");
+    {
+        std::lock_guard lock(mutex_);
+        if (index < shortcuts_.size()) {
+            recordLocked(ShortcutEdit{index, shortcuts_[index], shortcut});
+            shortcuts_[index] = shortcut;
+        } else {
+            throw std::out_of_range("Index is out of range");
+        }
     }
 
     saveConfig();
 }
 
 auto ConfigManager::undo() -> void {
-    if (canUndo()) {
-        // Remove the current state
-        undoStack_.pop_back();
+    {
+        std::lock_guard lock(mutex_);
+        const ConfigEdit* edit = journal_.undo();
+        if (edit == nullptr) {
+            logger->warn("Undo stack is empty, cannot undo.");
+            return;
+        }
+        replayLocked(*edit, true);
+    }
+    saveConfig();
+}
 
-        if (canUndo()) {
-            applyConfig(YAML::Clone(undoStack_.back()));
-            saveConfig();
-        } else {
-            logger->warn("No more states to undo.");
+auto ConfigManager::redo() -> void {
+    {
+        std::lock_guard lock(mutex_);
+        const ConfigEdit* edit = journal_.redo();
+        if (edit == nullptr) {
+            logger->warn("Nothing to redo.");
+            return;
         }
-    } else {
-        logger->warn("Undo stack is empty, cannot undo.");
+        replayLocked(*edit, false);
     }
+    saveConfig();
 }
 
 auto ConfigManager::canUndo() const -> bool {
-    return !undoStack_.empty();
+    std::lock_guard lock(mutex_);
+    return journal_.canUndo();
+}
+
+auto ConfigManager::canRedo() const -> bool {
+    std::lock_guard lock(mutex_);
+    return journal_.canRedo();
+}
+
+auto ConfigManager::setStringLocked(StringMap ConfigManager::* section, const std::string& key, const std::string& value) -> void {
+    StringMap& map = this->*section;
+    auto current = map.find(key);
+    recordLocked(StringEdit{section, key, current != map.end() ? std::optional(current->second) : std::nullopt, value});
+    map[key] = value;
+}
+
+auto ConfigManager::putRemapLocked(const EKeyPress& key, const std::optional<EMacro>& macro) -> void {
+    if (macro) {
+        programs_[key] = std::make_shared<const MacroProgram>(MacroProgram::compile(*macro));
+        remap_[key] = *macro;
+    } else {
+        programs_.erase(key);
+        remap_.erase(key);
+    }
+}
+
+auto ConfigManager::replayLocked(const ConfigEdit& edit, bool reverse) -> void {
+    std::visit([&](const auto& e) {
+        using T = std::decay_t<decltype(e)>;
+        if constexpr (std::is_same_v<T, RetriesEdit>) {
+            initRetries_ = reverse ? e.before : e.after;
+        } else if constexpr (std::is_same_v<T, RemapEdit>) {
+            putRemapLocked(e.key, reverse ? e.before : e.after);
+            publishRemaps();
+        } else if constexpr (std::is_same_v<T, StringEdit>) {
+            StringMap& map = this->*e.section;
+            const auto& value = reverse ? e.before : e.after;
+            if (value) {
+                map[e.key] = *value;
+            } else {
+                map.erase(e.key);
+            }
+        } else if constexpr (std::is_same_v<T, RemovePluginEdit>) {
+            if (!reverse) {
+                removePlugins_.push_back(e.plugin);
+            } else if (auto it = std::find(removePlugins_.rbegin(), removePlugins_.rend(), e.plugin); it != removePlugins_.rend()) {
+                removePlugins_.erase(std::next(it).base());
+            }
+        } else if constexpr (std::is_same_v<T, ShortcutEdit>) {
+            // a reload may have shortened the list since
+            if (e.index < shortcuts_.size()) {
+                shortcuts_[e.index] = reverse ? e.before : e.after;
+            }
+        }
+    }, edit);
 }
 
-auto ConfigManager::processRemap(const std::string &fromStr, const std::string &toStr) -> void {
-    logger->debug("process remap: from: {} to: {}", fromStr, toStr);
-    EKeyPress from = km_->processKeyPress(fromStr);
+auto ConfigManager::editBytes(const ConfigEdit& edit) -> size_t {
+    auto macroBytes = [](const std::optional<EMacro>& macro) -> size_t {
+        if (!macro) {
+            return 0;
+        }
+        size_t bytes = macro->steps.size() * sizeof(macro->steps[0]);
+        for (const auto& step : macro->steps) {
+            std::visit([&](const auto& s) {
+                using T = std::decay_t<decltype(s)>;
+                if constexpr (std::is_same_v<T, EKeyPress>) {
+                    bytes += s.key.size();
+                } else {
+                    bytes += s.actionName.size() + (s.arguments ? s.arguments->size() : 0);
+                }
+            }, step);
+        }
+        return bytes;
+    };
+    auto mapBytes = [](const StringMap& map) -> size_t {
+        size_t bytes = 0;
+        for (const auto& [key, value] : map) {
+            bytes += sizeof(StringMap::value_type) + key.size() + value.size();
+        }
+        return bytes;
+    };
+
+    return sizeof(ConfigEdit) + std::visit([&](const auto& e) -> size_t {
+        using T = std::decay_t<decltype(e)>;
+        if constexpr (std::is_same_v<T, RetriesEdit>) {
+            return 0;
+        } else if constexpr (std::is_same_v<T, RemapEdit>) {
+            return e.key.key.size() + macroBytes(e.before) + macroBytes(e.after);
+        } else if constexpr (std::is_same_v<T, StringEdit>) {
+            return e.key.size() + (e.before ? e.before->size() : 0) + (e.after ? e.after->size() : 0);
+        } else if constexpr (std::is_same_v<T, RemovePluginEdit>) {
+            return e.plugin.size();
+        } else {
+            return mapBytes(e.before) + mapBytes(e.after);
+        }
+    }, edit);
+}
 
+auto ConfigManager::parseMacro(KeyMapper& km, const std::string &toStr) -> EMacro {
     // stepsString is composed of any combination of
     // actions and/or keypresses. For example,
     // "cmd+a" or "load_item.Serum" or "a,load_item.Serum,shift+cmd+d,c"
@@ -281,7 +1104,7 @@ auto ConfigManager::processRemap(const std::string &fromStr, const std::string &
         if (step.length() == 1) {
             logger->debug("process remap: single character, processing as keypress: {}", step);
             try {
-                EKeyPress keyPress = km_->processKeyPress(step);
+                EKeyPress keyPress = km.processKeyPress(step);
                 macro.addKeyPress(keyPress);
             } catch (const std::runtime_error& e) {
                 logger->error("{}", e.what());
@@ -316,7 +1139,7 @@ auto ConfigManager::processRemap(const std::string &fromStr, const std::string &
             // TODO consider turning these into a keypress macro
             logger->debug("process remap: not in named actions. str: {}", step);
             try {
-                EKeyPress keyPress = km_->processKeyPress(step);
+                EKeyPress keyPress = km.processKeyPress(step);
                 macro.addKeyPress(keyPress);
             } catch (const std::runtime_error& e) {
                 logger->error("{}", e.what());
@@ -324,5 +1147,5 @@ auto ConfigManager::processRemap(const std::string &fromStr, const std::string &
         }
     }
 
-    remap_[from] = macro;
+    return macro;
 }
@@ -5,19 +5,65 @@
 #include <fstream>
 #include <iostream>
 #include <cstdlib>
+#include <iterator>
 #include "yaml-cpp/yaml.h"
 
 #include "LogGlobal.h"
 
+#include "CacheFile.h"
 #include "ConfigMenu.h"
 #include "IWindow.h"
 
+namespace {
+    // label, action and child count, all empty
+    constexpr size_t MIN_ITEM_BYTES = 12;
+    // deeper than any menu anyone would click through
+    constexpr int MAX_MENU_DEPTH = 64;
+
+    void encodeItems(CacheWriter& out, const std::vector<MenuItem>& items) {
+        out.u32(static_cast<uint32_t>(items.size()));
+        for (const auto& item : items) {
+            out.str(item.label);
+            out.str(item.action);
+            encodeItems(out, item.children);
+        }
+    }
+
+    auto decodeItems(CacheReader& in, int depth) -> std::optional<std::vector<MenuItem>> {
+        if (depth > MAX_MENU_DEPTH) {
+            return std::nullopt;
+        }
+        std::vector<MenuItem> items;
+        for (uint32_t n = in.count(MIN_ITEM_BYTES); n > 0; --n) {
+            MenuItem item;
+            item.label = in.str();
+            item.action = in.str();
+            auto children = decodeItems(in, depth + 1);
+            if (!children) {
+                return std::nullopt;
+            }
+            item.children = std::move(*children);
+            items.push_back(std::move(item));
+        }
+        return items;
+    }
+
+    auto readText(const std::filesystem::path& path) -> std::string {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("unable to open " + path.string());
+        }
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+}
+
 ConfigMenu::ConfigMenu(const std::filesystem::path& configFile)
     : configFile_(configFile)
 {
     configMenuFilePath_ =
         std::filesystem::path(std::string(getenv("HOME"))) / "Music" / "Ableton" / "User Remote Scripts"
         / "LiveImproved" / "config_menu.yaml";
+    cacheFilePath_ = configMenuFilePath_.string() + ".cache";
 
     LESConfigFilePath_ = std::filesystem::path(std::string(getenv("HOME"))) / ".les" / "menuconfig.ini";
 
@@ -35,6 +81,15 @@ ConfigMenu::ConfigMenu(const std::filesystem::path& configFile)
     logger->error("No menu config exists");
 }
 
+ConfigMenu::~ConfigMenu() {
+    // stop the watcher before anything it calls into goes away
+    watcher_.reset();
+
+    if (refreshThread_.joinable()) {
+        refreshThread_.join();
+    }
+}
+
 void ConfigMenu::outputItemToYAML(YAML::Emitter& out, const MenuItem& item) {
     out << YAML::BeginMap;
     out << YAML::Key << "label" << YAML::Value << item.label;
@@ -68,9 +123,57 @@ void ConfigMenu::saveToYAML(const std::vector<MenuItem>& menuData, const std::fi
 }
 
 auto ConfigMenu::getMenuData() -> std::vector<MenuItem> {
+    std::lock_guard lock(mutex_);
     return menuData_;
 }
 
+void ConfigMenu::watch(FileWatchOptions options) {
+    if (watcher_) {
+        return;
+    }
+    watcher_ = std::make_unique<FileWatcher>(std::vector<std::filesystem::path>{configMenuFilePath_}, [this]() { reload(); }, options);
+}
+
+auto ConfigMenu::reload() -> bool {
+    std::vector<MenuItem> menu;
+    try {
+        const std::string text = readText(configMenuFilePath_);
+        YAML::Node root = YAML::Load(text);
+        if (!root.IsSequence()) {
+            throw std::runtime_error("Menu config root is not a sequence");
+        }
+        menu = parseMenuItems(root);
+        writeCache(CacheFile::hash(text), menu);
+    } catch (const std::exception& e) {
+        logger->error("menu config not reloaded, keeping the last good one: {}", e.what());
+        return false;
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        if (menu == menuData_) {
+            return true;
+        }
+        menuData_ = std::move(menu);
+    }
+    logger->info("menu config reloaded");
+
+    std::vector<std::function<void()>> listeners;
+    {
+        std::lock_guard lock(listenersMutex_);
+        listeners = listeners_;
+    }
+    for (const auto& listener : listeners) {
+        listener();
+    }
+    return true;
+}
+
+void ConfigMenu::onChanged(std::function<void()> listener) {
+    std::lock_guard lock(listenersMutex_);
+    listeners_.push_back(std::move(listener));
+}
+
 void ConfigMenu::parseLESMenuConfig(const std::filesystem::path& filePath) {
     std::vector<MenuItem> menuData;
 
@@ -163,7 +266,10 @@ void ConfigMenu::parseLESMenuConfig(const std::filesystem::path& filePath) {
     }
 
     file.close();
-    menuData_ = menuData;
+    {
+        std::lock_guard lock(mutex_);
+        menuData_ = menuData;
+    }
 
     saveToYAML(menuData, configMenuFilePath_);
 }
@@ -199,17 +305,70 @@ void ConfigMenu::loadConfig() {
             return;
         }
 
-        YAML::Node root = YAML::LoadFile(configPath.string());
+        const std::string text = readText(configPath);
+        const uint64_t sourceHash = CacheFile::hash(text);
+
+        std::optional<std::vector<MenuItem>> cached;
+        uint64_t cachedHash = 0;
+        CacheFile::read(cacheFilePath_, CacheFile::MenuKind, [&](uint64_t hash, std::string_view payload) {
+            cached = decode(payload);
+            cachedHash = hash;
+            return cached.has_value();
+        });
+
+        if (cached) {
+            {
+                std::lock_guard lock(mutex_);
+                menuData_ = std::move(*cached);
+            }
+            if (cachedHash == sourceHash) {
+                logger->info("Loaded menu config from cache");
+                return;
+            }
+            // the old menu serves until the edit is parsed
+            logger->info("Menu config changed since it was cached, reparsing in the background");
+            if (refreshThread_.joinable()) {
+                refreshThread_.join();
+            }
+            refreshThread_ = std::thread([this]() { reload(); });
+            return;
+        }
+
+        YAML::Node root = YAML::Load(text);
         
         if (!root.IsSequence()) {
             logger->error("Menu config root is not a sequence");
             return;
         }
 
-        menuData_ = parseMenuItems(root);
-        logger->info("Loaded menu config with {} top-level items", std::to_string(menuData_.size()));
+        auto menu = parseMenuItems(root);
+        logger->info("Loaded menu config with {} top-level items", std::to_string(menu.size()));
+        writeCache(sourceHash, menu);
+
+        std::lock_guard lock(mutex_);
+        menuData_ = std::move(menu);
 
     } catch (const std::exception& e) {
         logger->error("Error loading config: {}", std::string(e.what()));
     }
 }
+
+auto ConfigMenu::encode(const std::vector<MenuItem>& menu) -> std::string {
+    CacheWriter out;
+    encodeItems(out, menu);
+    return out.bytes();
+}
+
+auto ConfigMenu::decode(std::string_view payload) -> std::optional<std::vector<MenuItem>> {
+    CacheReader in(payload);
+    auto menu = decodeItems(in, 0);
+    if (!menu || !in.ok()) {
+        return std::nullopt;
+    }
+    return menu;
+}
+
+void ConfigMenu::writeCache(uint64_t sourceHash, const std::vector<MenuItem>& menu) {
+    std::lock_guard lock(cacheMutex_);
+    CacheFile::write(cacheFilePath_, CacheFile::MenuKind, sourceHash, encode(menu));
+}
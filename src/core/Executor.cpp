@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <utility>
+
+#include "LogGlobal.h"
+
+#include "Executor.h"
+
+Executor::Queue::Queue(std::string_view name)
+    : name(name)
+    , serial(name != QUEUE_NAMES[static_cast<size_t>(ExecutorQueue::Pool)])
+    , waitTime(std::string(name) + " queue wait")
+    , runTime(std::string(name) + " queue run")
+{}
+
+Executor::Executor(ExecutorOptions options)
+    : options_(options)
+    , queues_{
+#define LIM_EXECUTOR_QUEUE_INIT(id, name) Queue(name),
+        LIM_EXECUTOR_QUEUES(LIM_EXECUTOR_QUEUE_INIT)
+#undef LIM_EXECUTOR_QUEUE_INIT
+    }
+{
+    for (Queue& q : queues_) {
+        const size_t workers = q.serial ? 1 : std::max<size_t>(options_.workers, 1);
+        for (size_t i = 0; i < workers; ++i) {
+            workers_.emplace_back([this, &q]() { workerLoop(q); });
+        }
+    }
+}
+
+Executor::~Executor() {
+    stop();
+}
+
+auto Executor::post(ExecutorQueue id, std::string name, Job job) -> bool {
+    {
+        std::lock_guard lock(mutex_);
+        Queue& q = queue(id);
+        if (stopping_) {
+            logger->warn("executor stopped, not running {}", name);
+            return false;
+        }
+        if (q.jobs.size() >= options_.maxQueued) {
+            ++q.stats.dropped;
+            logger->warn("{} queue full ({} waiting), dropping {}", q.name, q.jobs.size(), name);
+            return false;
+        }
+
+        q.jobs.push_back({std::move(name), std::move(job), std::chrono::steady_clock::now()});
+        ++q.stats.posted;
+        q.stats.depth = q.jobs.size() + q.running;
+        q.stats.maxDepth = std::max(q.stats.maxDepth, q.stats.depth);
+        q.ready.notify_one();
+    }
+    return true;
+}
+
+auto Executor::submit(ExecutorQueue id, std::string name, Job job) -> std::future<void> {
+    // shared, as Job has to be copyable
+    auto done = std::make_shared<std::promise<void>>();
+    auto future = done->get_future();
+    post(id, std::move(name), [done, job = std::move(job)]() {
+        try {
+            job();
+        } catch (...) {
+            done->set_exception(std::current_exception());
+            // still the worker's to log and count
+            throw;
+        }
+        done->set_value();
+    });
+    return future;
+}
+
+void Executor::drain() {
+    std::unique_lock lock(mutex_);
+    idle_.wait(lock, [this]() { return idleLocked(); });
+}
+
+void Executor::stop() {
+    {
+        std::lock_guard lock(mutex_);
+        if (stopping_ && workers_.empty()) {
+            return;
+        }
+        stopping_ = true;
+        for (Queue& q : queues_) {
+            q.ready.notify_all();
+        }
+    }
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+
+    std::lock_guard lock(mutex_);
+    for (const Queue& q : queues_) {
+        if (q.stats.posted == 0) {
+            continue;
+        }
+        logger->info("{} queue: {} run, {} failed, {} dropped, max depth {}"
+                     , q.name, q.stats.completed, q.stats.failed, q.stats.dropped, q.stats.maxDepth);
+        logger->info("{}", q.waitTime.summary());
+        logger->info("{}", q.runTime.summary());
+    }
+}
+
+auto Executor::stats(ExecutorQueue id) const -> ExecutorStats {
+    std::lock_guard lock(mutex_);
+    return queue(id).stats;
+}
+
+auto Executor::waitTime(ExecutorQueue id) const -> const LatencyHistogram& {
+    return queue(id).waitTime;
+}
+
+auto Executor::runTime(ExecutorQueue id) const -> const LatencyHistogram& {
+    return queue(id).runTime;
+}
+
+auto Executor::idleLocked() const -> bool {
+    for (const Queue& q : queues_) {
+        if (!q.jobs.empty() || q.running != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Executor::workerLoop(Queue& q) {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        q.ready.wait(lock, [&]() { return !q.jobs.empty() || stopping_; });
+        if (q.jobs.empty()) {
+            // stopping, and all of it has run
+            return;
+        }
+
+        Pending pending = std::move(q.jobs.front());
+        q.jobs.pop_front();
+        ++q.running;
+        lock.unlock();
+
+        const auto startedAt = std::chrono::steady_clock::now();
+        q.waitTime.record(startedAt - pending.postedAt);
+        bool failed = true;
+        try {
+            pending.job();
+            failed = false;
+        } catch (const std::exception& e) {
+            logger->error("{} failed on the {} queue: {}", pending.name, q.name, e.what());
+        } catch (...) {
+            logger->error("{} failed on the {} queue", pending.name, q.name);
+        }
+        q.runTime.recordSince(startedAt);
+
+        // let go of what the job captured before taking the lock
+        pending.job = nullptr;
+
+        lock.lock();
+        --q.running;
+        ++q.stats.completed;
+        q.stats.failed += failed ? 1 : 0;
+        q.stats.depth = q.jobs.size() + q.running;
+
+        if (idleLocked()) {
+            idle_.notify_all();
+        }
+    }
+}
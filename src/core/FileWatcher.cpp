@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <set>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#ifdef __APPLE__
+#include <sys/event.h>
+#elif defined(__linux__)
+#include <sys/inotify.h>
+#endif
+
+#include "LogGlobal.h"
+
+#include "FileWatcher.h"
+
+FileWatcher::FileWatcher(std::vector<std::filesystem::path> files, Callback onChange, FileWatchOptions options)
+    : files_(std::move(files))
+    , onChange_(std::move(onChange))
+    , options_(options)
+{
+#ifndef _WIN32
+    if (::pipe(wakePipe_) != 0) {
+        logger->warn("file watcher: unable to create wake pipe: {}", std::strerror(errno));
+        wakePipe_[0] = wakePipe_[1] = -1;
+    }
+#endif
+    openNotifications();
+
+    // taken before the thread starts so a change made right after
+    // construction isn't mistaken for the baseline
+    thread_ = std::thread([this, seen = stamps()]() mutable { run(std::move(seen)); });
+}
+
+FileWatcher::~FileWatcher() {
+    stopping_ = true;
+    wake();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    closeNotifications();
+#ifndef _WIN32
+    for (int& fd : wakePipe_) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+#endif
+}
+
+auto FileWatcher::changes() const -> uint64_t {
+    return changes_.load(std::memory_order_relaxed);
+}
+
+auto FileWatcher::stamps() const -> std::vector<Stamp> {
+    std::vector<Stamp> result(files_.size());
+    for (size_t i = 0; i < files_.size(); ++i) {
+        std::error_code ec;
+        auto status = std::filesystem::status(files_[i], ec);
+        if (ec || !std::filesystem::is_regular_file(status)) {
+            continue;
+        }
+        result[i].exists = true;
+        result[i].modified = std::filesystem::last_write_time(files_[i], ec);
+        result[i].size = std::filesystem::file_size(files_[i], ec);
+    }
+    return result;
+}
+
+void FileWatcher::run(std::vector<Stamp> seen) {
+    bool pending = false;
+    std::chrono::steady_clock::time_point due;
+
+    while (!stopping_) {
+        auto timeout = options_.pollInterval;
+        if (pending) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(due - std::chrono::steady_clock::now());
+            timeout = std::clamp(remaining, std::chrono::milliseconds(0), options_.pollInterval);
+        }
+
+        waitForEvent(timeout);
+        if (stopping_) {
+            break;
+        }
+
+        auto current = stamps();
+        if (current != seen) {
+            // still being written; push the deadline out
+            seen = std::move(current);
+            pending = true;
+            due = std::chrono::steady_clock::now() + options_.debounce;
+            continue;
+        }
+
+        if (pending && std::chrono::steady_clock::now() >= due) {
+            pending = false;
+            changes_.fetch_add(1, std::memory_order_relaxed);
+            try {
+                onChange_();
+            } catch (const std::exception& e) {
+                logger->error("file watcher callback threw: {}", e.what());
+            }
+        }
+    }
+}
+
+#ifdef __APPLE__
+
+void FileWatcher::openNotifications() {
+    if (queue_ < 0) {
+        queue_ = ::kqueue();
+        if (queue_ < 0) {
+            logger->warn("file watcher: kqueue unavailable, polling instead: {}", std::strerror(errno));
+            return;
+        }
+        if (wakePipe_[0] >= 0) {
+            struct kevent change{};
+            EV_SET(&change, wakePipe_[0], EVFILT_READ, EV_ADD, 0, 0, nullptr);
+            ::kevent(queue_, &change, 1, nullptr, 0, nullptr);
+        }
+    }
+
+    // the directories catch files being created or renamed into place,
+    // the files themselves catch writes in place
+    std::set<std::filesystem::path> paths;
+    for (const auto& file : files_) {
+        paths.insert(file.parent_path());
+        paths.insert(file);
+    }
+
+    for (const auto& path : paths) {
+        int fd = ::open(path.c_str(), O_EVTONLY);
+        if (fd < 0) {
+            continue;
+        }
+        struct kevent change{};
+        EV_SET(&change, fd, EVFILT_VNODE, EV_ADD | EV_CLEAR
+               , NOTE_WRITE | NOTE_EXTEND | NOTE_ATTRIB | NOTE_DELETE | NOTE_RENAME, 0, nullptr);
+        if (::kevent(queue_, &change, 1, nullptr, 0, nullptr) < 0) {
+            ::close(fd);
+            continue;
+        }
+        watchedFds_.push_back(fd);
+    }
+}
+
+void FileWatcher::closeNotifications() {
+    // closing a descriptor removes its events from the queue
+    for (int fd : watchedFds_) {
+        ::close(fd);
+    }
+    watchedFds_.clear();
+
+    if (queue_ >= 0 && stopping_) {
+        ::close(queue_);
+        queue_ = -1;
+    }
+}
+
+void FileWatcher::waitForEvent(std::chrono::milliseconds timeout) {
+    if (queue_ < 0) {
+        struct pollfd fds[1] = {{wakePipe_[0], POLLIN, 0}};
+        ::poll(fds, 1, static_cast<int>(timeout.count()));
+        return;
+    }
+
+    struct timespec wait{};
+    wait.tv_sec = static_cast<time_t>(timeout.count() / 1000); // NOLINT
+    wait.tv_nsec = static_cast<long>((timeout.count() % 1000) * 1000000); // NOLINT
+
+    struct kevent events[8]; // NOLINT
+    int count = ::kevent(queue_, nullptr, 0, events, 8, &wait); // NOLINT
+
+    bool vnodeChanged = false;
+    for (int i = 0; i < count; ++i) {
+        if (events[i].filter == EVFILT_VNODE) {
+            vnodeChanged = true;
+        }
+    }
+
+    // a file replaced by rename is a new inode; watch that one instead
+    if (vnodeChanged && !stopping_) {
+        closeNotifications();
+        openNotifications();
+    }
+}
+
+#elif defined(__linux__)
+
+void FileWatcher::openNotifications() {
+    inotify_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_ < 0) {
+        logger->warn("file watcher: inotify unavailable, polling instead: {}", std::strerror(errno));
+        return;
+    }
+
+    // watch directories rather than files so replacing a file by rename
+    // doesn't leave us watching the old inode
+    std::set<std::filesystem::path> dirs;
+    for (const auto& file : files_) {
+        dirs.insert(file.parent_path().empty() ? std::filesystem::path(".") : file.parent_path());
+    }
+    for (const auto& dir : dirs) {
+        if (::inotify_add_watch(inotify_, dir.c_str()
+                , IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM) < 0)
+        {
+            logger->debug("file watcher: unable to watch {}: {}", dir.string(), std::strerror(errno));
+        }
+    }
+}
+
+void FileWatcher::closeNotifications() {
+    if (inotify_ >= 0) {
+        ::close(inotify_);
+        inotify_ = -1;
+    }
+}
+
+void FileWatcher::waitForEvent(std::chrono::milliseconds timeout) {
+    struct pollfd fds[2] = {{inotify_, POLLIN, 0}, {wakePipe_[0], POLLIN, 0}};
+    ::poll(fds, 2, static_cast<int>(timeout.count()));
+
+    if ((fds[0].revents & POLLIN) != 0) {
+        // the events only tell us to look; stamps() decides what changed
+        char buffer[4096]; // NOLINT
+        while (::read(inotify_, buffer, sizeof(buffer)) > 0) {}
+    }
+}
+
+#else
+
+void FileWatcher::openNotifications() {}
+void FileWatcher::closeNotifications() {}
+
+#ifndef _WIN32
+void FileWatcher::waitForEvent(std::chrono::milliseconds timeout) {
+    struct pollfd fds[1] = {{wakePipe_[0], POLLIN, 0}};
+    ::poll(fds, 1, static_cast<int>(timeout.count()));
+}
+#else
+void FileWatcher::waitForEvent(std::chrono::milliseconds timeout) {
+    std::unique_lock lock(wakeMutex_);
+    wakeCv_.wait_for(lock, timeout, [this]() { return stopping_.load(); });
+}
+#endif
+
+#endif
+
+void FileWatcher::wake() {
+#ifndef _WIN32
+    if (wakePipe_[1] >= 0) {
+        const char byte = 1;
+        [[maybe_unused]] auto written = ::write(wakePipe_[1], &byte, 1);
+    }
+#else
+    {
+        std::lock_guard lock(wakeMutex_);
+    }
+    wakeCv_.notify_all();
+#endif
+}
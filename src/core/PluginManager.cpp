@@ -1,3 +1,4 @@
+#include <atomic>
 #include <functional>
 #include "PluginManager.h"
 #include "LogGlobal.h"
@@ -12,6 +13,7 @@ PluginManager::PluginManager(
     )
     : ipc_(std::move(ipc))
     , responseParser_(std::move(responseParser))
+    , catalog_(std::make_shared<const PluginCatalog>(std::vector<Plugin>{}))
 {}
 
 PluginManager::~PluginManager() = default;
@@ -20,6 +22,10 @@ auto PluginManager::getPlugins() const -> const std::vector<Plugin>& {
     return plugins_;
 }
 
+auto PluginManager::getCatalog() const -> PluginCatalogPtr {
+    return std::atomic_load(&catalog_);
+}
+
 void PluginManager::refreshPlugins() {
     auto ipc = ipc_();
     ipc->writeRequest("PLUGINS", [this](const std::string& response) {
@@ -27,6 +33,7 @@ void PluginManager::refreshPlugins() {
         try {
             if (!response.empty()) {
                 plugins_ = responseParser->parsePlugins(response);
+                publish(plugins_);
                 logger->info("Plugin cache refreshed");
             } else {
                 logger->error("Failed to receive a valid response. Do you have any VST3, AU, or VST plug-ins installed?");
@@ -36,3 +43,36 @@ void PluginManager::refreshPlugins() {
         }
     });
 }
+
+void PluginManager::setAliases(std::unordered_map<std::string, std::string> aliases) {
+    {
+        std::lock_guard lock(aliasesMutex_);
+        aliases_ = std::move(aliases);
+    }
+
+    auto current = getCatalog();
+    if (!current->empty()) {
+        publish(current->plugins());
+    }
+}
+
+void PluginManager::publish(std::vector<Plugin> plugins) {
+    {
+        std::lock_guard lock(aliasesMutex_);
+        std::atomic_store(&catalog_, PluginCatalogPtr(std::make_shared<const PluginCatalog>(std::move(plugins), ++catalogVersion_, aliases_)));
+    }
+
+    std::vector<std::function<void()>> listeners;
+    {
+        std::lock_guard lock(listenersMutex_);
+        listeners = catalogListeners_;
+    }
+    for (const auto& listener : listeners) {
+        listener();
+    }
+}
+
+void PluginManager::onCatalogChanged(std::function<void()> listener) {
+    std::lock_guard lock(listenersMutex_);
+    catalogListeners_.push_back(std::move(listener));
+}
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <bit>
+
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel(Tick now)
+    : now_(now)
+{
+    heads_.fill(NONE);
+}
+
+auto TimerWheel::schedule(Tick due, uint64_t token) -> Handle {
+    uint32_t index = 0;
+    if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    Node& node = nodes_[index];
+    node.due = std::max(due, now_ + 1);
+    node.token = token;
+    place(index);
+    ++size_;
+    return {index, node.generation};
+}
+
+auto TimerWheel::cancel(Handle handle) -> bool {
+    if (!handle.valid() || handle.index >= nodes_.size()) {
+        return false;
+    }
+    const Node& node = nodes_[handle.index];
+    if (node.generation != handle.generation || node.slot == NONE) {
+        return false;
+    }
+    unlink(handle.index);
+    release(handle.index);
+    return true;
+}
+
+auto TimerWheel::nextWake() const -> std::optional<Tick> {
+    if (size_ == 0) {
+        return std::nullopt;
+    }
+
+    // a level's slots before the one now_ is in are empty, and anything
+    // at a coarser level comes after the finer level's ring is through,
+    // so the first occupied slot from the finest level up is the answer
+    for (size_t level = 0; level < LEVELS; ++level) {
+        const size_t shift = SLOT_BITS * level;
+        const size_t current = (now_ >> shift) & (SLOTS - 1);
+        for (size_t slot = current + 1; slot < SLOTS; ++slot) {
+            if (heads_[level * SLOTS + slot] != NONE) {
+                const Tick ring = (now_ >> shift) & ~Tick{SLOTS - 1};
+                return (ring | slot) << shift;
+            }
+        }
+    }
+    // only timers past the horizon, which are looked at again when the
+    // top level comes round
+    return (now_ | (SPAN - 1)) + 1;
+}
+
+void TimerWheel::place(uint32_t index) {
+    Node& node = nodes_[index];
+
+    // the finest level whose slot tells `due` apart from now_: the two
+    // share every bit above that level's
+    const Tick differs = node.due ^ now_;
+    const size_t level = differs == 0 ? 0 : (std::bit_width(differs) - 1) / SLOT_BITS;
+
+    uint32_t slot = 0;
+    if (level < LEVELS) {
+        slot = static_cast<uint32_t>(level * SLOTS + ((node.due >> (SLOT_BITS * level)) & (SLOTS - 1)));
+    } else {
+        // past the horizon; the top level's first slot is next looked at
+        // when the clock wraps round to it
+        slot = static_cast<uint32_t>((LEVELS - 1) * SLOTS);
+    }
+
+    node.slot = slot;
+    node.prev = NONE;
+    node.next = heads_[slot];
+    if (node.next != NONE) {
+        nodes_[node.next].prev = index;
+    }
+    heads_[slot] = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.prev != NONE) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        heads_[node.slot] = node.next;
+    }
+    if (node.next != NONE) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.prev = NONE;
+    node.next = NONE;
+    node.slot = NONE;
+}
+
+void TimerWheel::release(uint32_t index) {
+    ++nodes_[index].generation;
+    free_.push_back(index);
+    --size_;
+}
+
+void TimerWheel::cascade() {
+    size_t top = 0;
+    while (top + 1 < LEVELS && (now_ & ((Tick{1} << (SLOT_BITS * (top + 1))) - 1)) == 0) {
+        ++top;
+    }
+
+    for (size_t level = top; level > 0; --level) {
+        const size_t slot = level * SLOTS + ((now_ >> (SLOT_BITS * level)) & (SLOTS - 1));
+        uint32_t index = heads_[slot];
+        heads_[slot] = NONE;
+        while (index != NONE) {
+            const uint32_t next = nodes_[index].next;
+            place(index);
+            index = next;
+        }
+    }
+}
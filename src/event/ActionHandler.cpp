@@ -2,10 +2,16 @@
 #ifndef _WIN32
 #import <ApplicationServices/ApplicationServices.h>
 #endif
+#include <chrono>
+#include <future>
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <thread>
 
+#include <JuceHeader.h>
+
 #include "LogGlobal.h"
 #include "Types.h"
 #include "Utils.h"
@@ -17,8 +23,15 @@
 #include "ActionHandler.h"
 #include "ConfigManager.h"
 #include "ContextMenu.h"
+#include "Executor.h"
+#include "FocusTracker.h"
+#include "KeyCodes.h"
 #include "KeySender.h"
+#include "MacroPipeline.h"
+#include "MacroProgram.h"
 #include "PluginManager.h"
+#include "UsageStore.h"
+#include "WaitScheduler.h"
 #include "WindowManager.h"
 
 ActionHandler::ActionHandler(
@@ -28,6 +41,10 @@ ActionHandler::ActionHandler(
               , std::function<std::shared_ptr<IIPCCore>()> ipc
               , std::function<std::shared_ptr<IEventHandler>()> eventHandler
               , std::function<std::shared_ptr<ILiveInterface>()> liveInterface
+              , std::function<std::shared_ptr<UsageStore>()> usageStore
+              , std::function<std::shared_ptr<FocusTracker>()> focusTracker
+              , std::function<std::shared_ptr<Executor>()> executor
+              , std::function<std::shared_ptr<WaitScheduler>()> waits
               )
     : ipc_(std::move(ipc))
     , windowManager_(std::move(windowManager))
@@ -35,11 +52,51 @@ ActionHandler::ActionHandler(
     , configManager_(std::move(configManager))
     , eventHandler_(std::move(eventHandler))
     , liveInterface_(std::move(liveInterface))
+    , usageStore_(std::move(usageStore))
+    , focusTracker_(std::move(focusTracker))
+    , executor_(std::move(executor))
+    , waits_(std::move(waits))
+    , macroLatency_("ordered macro")
 {
     initializeActionMap();
+
+    sequenceTimer_ = std::thread([this]() { sequenceTimerLoop(); });
+}
+
+ActionHandler::~ActionHandler() {
+    {
+        std::lock_guard lock(sequenceMutex_);
+        stopping_ = true;
+    }
+    sequenceWake_.notify_one();
+
+    if (sequenceTimer_.joinable()) {
+        sequenceTimer_.join();
+    }
+
+    if (macroLatency_.count() > 0) {
+        logger->info("{}", macroLatency_.summary());
+    }
+    for (size_t i = 0; i < PacingController::COUNT; ++i) {
+        const auto pace = static_cast<PaceClass>(i);
+        const auto stats = pacer_.stats(pace);
+        if (stats.sent > 0) {
+            logger->info("{} pacing: {}us apart, {} sent, {} dropped"
+                         , PacingController::name(pace)
+                         , std::chrono::duration_cast<std::chrono::microseconds>(pacer_.interval(pace)).count()
+                         , stats.sent, stats.dropped);
+        }
+    }
 }
 
-ActionHandler::~ActionHandler() = default;
+namespace {
+    // need an argument, or are the search box itself
+    const std::unordered_set<std::string> NOT_COMMANDS = {
+        "plugin"
+        , "searchbox"
+        , "write-request"
+    };
+}
 
 // Initialize the action map
 void ActionHandler::initializeActionMap() {
@@ -47,118 +104,405 @@ void ActionHandler::initializeActionMap() {
     // TODO: case insensitive
     // TODO: multiple args (plugin,Sylenth,Serum)
 
-    // NOTE actions must be added here and in Types.h
+    // NOTE actions must be added here and in Types.h, and in NOT_COMMANDS
+    // if they need an argument
     actionMap["closeFocusedPlugin"] = [this](const std::optional<std::string>& args) {
         auto liveInterface = liveInterface_();
-        std::thread([liveInterface]() {
+        return executor_()->submit(ExecutorQueue::Windows, "closeFocusedPlugin", [liveInterface]() {
             liveInterface->closeFocusedPlugin();
-        }).detach();
+        });
     };
 
     actionMap["closeAllPlugins"] = [this](const std::optional<std::string>& args) {
         auto liveInterface = liveInterface_();
-        std::thread([liveInterface]() {
+        return executor_()->submit(ExecutorQueue::Windows, "closeAllPlugins", [liveInterface]() {
             liveInterface->closeAllPlugins();
-        }).detach();
+        });
     };
 
     actionMap["openAllPlugins"] = [this](const std::optional<std::string>& args) {
         auto liveInterface = liveInterface_();
-        std::thread([liveInterface]() {
+        return executor_()->submit(ExecutorQueue::Windows, "openAllPlugins", [liveInterface]() {
             liveInterface->openAllPlugins();
-        }).detach();
+        });
     };
 
     actionMap["tilePluginWindows"] = [this](const std::optional<std::string>& args) {
         auto liveInterface = liveInterface_();
-        std::thread([liveInterface]() {
+        return executor_()->submit(ExecutorQueue::Windows, "tilePluginWindows", [liveInterface]() {
             liveInterface->tilePluginWindows();
-        }).detach();
+        });
     };
 
     actionMap["searchbox"] = [this](const std::optional<std::string>& args) {
+        // taken before anything else so the open latency includes resolving the manager
+        auto requestedAt = std::chrono::steady_clock::now();
         auto wm = windowManager_();
-        wm->openWindow("SearchBox");
+        return onMessageThread([wm, requestedAt]() {
+            wm->openWindow("SearchBox", requestedAt);
+        });
     };
 
+    // the IPC requests are done when Live answers them. If the request
+    // never goes out, the promise is dropped and the macro stops there
     actionMap["write-request"] = [this](const std::optional<std::string>& args) {
-        std::thread([this, args]() {
+        auto answered = std::make_shared<std::promise<void>>();
+        auto future = answered->get_future();
+        executor_()->post(ExecutorQueue::Ipc, "write-request", [this, args, answered]() {
             if (args) {
                 auto ipc = ipc_();
-                ipc->writeRequest(*args);
+                ipc->writeRequest(*args, trackIpc([answered](const std::string&) { answered->set_value(); }));
             } else {
                 throw std::runtime_error("write-request action requires an argument");
             }
-        }).detach();
+        });
+        return future;
     };
 
     actionMap["plugin"] = [this](const std::optional<std::string>& args) {
-        std::thread([this, args]() {
+        auto loaded = std::make_shared<std::promise<void>>();
+        auto future = loaded->get_future();
+        executor_()->post(ExecutorQueue::Ipc, "plugin", [this, args, loaded]() {
             if (args) {
-                this->loadItemByName(*args);
+                this->loadPlugin(*args, [loaded](const std::string&) { loaded->set_value(); });
             } else {
                 throw std::runtime_error("plugin action requires an argument");
             }
-        }).detach();
+        });
+        return future;
     };
+
+    for (size_t i = 0; i < actionTable_.size(); ++i) {
+        auto it = actionMap.find(std::string(NamedActions::NAMES[i]));
+        if (it != actionMap.end()) {
+            actionTable_[i] = it->second;
+        }
+    }
 }
 
-void ActionHandler::executeMacro(const EMacro& macro) {
-//    for (const auto& key : macro.keypresses) {
-//        log_.info("ActionHandler:: execMacro cmd: "   + std::to_string(key.cmd));
-//        log_.info("ActionHandler:: execMacro ctrl: "  + std::to_string(key.ctrl));
-//        log_.info("ActionHandler:: execMacro alt: "   + std::to_string(key.alt));
-//        log_.info("ActionHandler:: execMacro shift: " + std::to_string(key.shift));
-//        log_.info("ActionHandler:: execMacro sent: "  + key.key);
-//    }
-
-    for (const auto& step : macro.steps) {
-        // Use std::visit to handle the variant type (EKeyPress or Action)
-        std::visit([&](auto&& item) {
-            using T = std::decay_t<decltype(item)>;
-            if constexpr (std::is_same_v<T, EKeyPress>) {
-                logger->debug("macro sending keypress");
-                KeySender::getInstance().sendKeyPress(item);
-            } else if constexpr (std::is_same_v<T, Action>) {
-                logger->debug("macro sending action");
-                // If it's an Action, execute the action via the action map
-                auto it = actionMap.find(item.actionName);
-                if (it != actionMap.end()) {
-                    std::optional<std::string> optionalArgument = item.arguments;
-                    it->second(optionalArgument);
-                } else {
-                    logger->warn("Unknown action: {}", item.actionName);
-                }
+namespace {
+    // actions whose completion says something about how Live is keeping up
+    auto paceClass(ActionId id) -> std::optional<PaceClass> {
+        switch (id) {
+            case ActionId::load_item:
+            case ActionId::plugin:
+            case ActionId::write_request:
+                return PaceClass::Ipc;
+            case ActionId::closeFocusedPlugin:
+            case ActionId::closeAllPlugins:
+            case ActionId::openAllPlugins:
+            case ActionId::tilePluginWindows:
+                return PaceClass::Window;
+            default:
+                return std::nullopt;
+        }
+    }
+}
+
+struct ActionHandler::MacroRunner {
+    ActionHandler& handler;
+    KeySender& keys;
+    // null when run straight off, which doesn't wait for anything
+    PacingController* pacer = nullptr;
+    WaitScheduler* waits = nullptr;
+    // this run's waits
+    uint64_t group = 0;
+    // plugin windows opened before the last step went out
+    uint64_t windowsBefore = 0;
+
+    // when the keys not yet vouched for went out
+    std::optional<PacingController::TimePoint> keysSentAt;
+    PacingController::TimePoint actionSentAt;
+
+    void key(uint16_t keyCode, uint32_t modifiers, bool down) {
+        if (waits != nullptr && down) {
+            windowsBefore = waits->signals(WaitCondition::PluginWindow);
+        }
+        if (pacer != nullptr && down) {
+            const auto at = waitTurn(PaceClass::Key);
+            keysSentAt = keysSentAt.value_or(at);
+        }
+        keys.sendKey(keyCode, modifiers, down);
+    }
+
+    auto keysPosted() -> std::future<void> {
+        return keys.posted();
+    }
+
+    auto invoke(ActionId id, const std::optional<std::string>& argument) -> std::future<void> {
+        const auto& action = handler.actionTable_[static_cast<size_t>(id)];
+        if (!action) {
+            logger->warn("Unknown action: {}", NamedActions::name(id));
+            return {};
+        }
+        if (pacer != nullptr) {
+            if (auto pace = paceClass(id)) {
+                actionSentAt = waitTurn(*pace);
             }
-        }, step);
+        }
+        if (waits != nullptr) {
+            windowsBefore = waits->signals(WaitCondition::PluginWindow);
+        }
+        return action(argument);
+    }
+
+    // a window that opened since the step before went out counts, as it
+    // may well have been quicker than Live's answer to it
+    auto wait(WaitCondition condition, uint32_t ms) -> std::future<void> {
+        if (waits == nullptr) {
+            return {};
+        }
+        return handler.waitFor(condition, ms, group, windowsBefore);
+    }
+
+    // Posting keys only means they left us, so they're vouched for by
+    // the acknowledged step after them: if Live answered that in time it
+    // had caught up with them, and if it didn't they likely went missing
+    void settled(std::optional<ActionId> id, StepOutcome outcome) {
+        const auto pace = id ? paceClass(*id) : std::nullopt;
+        if (pacer == nullptr || !pace || outcome == StepOutcome::Failed) {
+            return;
+        }
+        if (outcome == StepOutcome::Done) {
+            pacer->accepted(*pace);
+            if (keysSentAt) {
+                pacer->accepted(PaceClass::Key);
+            }
+        } else {
+            pacer->dropped(*pace, actionSentAt);
+            if (keysSentAt) {
+                pacer->dropped(PaceClass::Key, *keysSentAt);
+            }
+        }
+        keysSentAt.reset();
+    }
+
+    auto waitTurn(PaceClass pace) -> PacingController::TimePoint {
+        const auto at = pacer->reserve(pace, PacingController::Clock::now());
+        std::this_thread::sleep_until(at);
+        return at;
+    }
+
+    void delay(uint32_t ms) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+};
+
+void ActionHandler::executeMacro(const MacroProgram& program) {
+    MacroRunner runner{*this, KeySender::getInstance()};
+    program.run(runner);
+}
+
+void ActionHandler::runMacro(const MacroProgram& program, std::shared_ptr<const void> owner) {
+    if (!program.waits()) {
+        executeMacro(program);
+        return;
+    }
+
+    // the newest macro has the run of Live; whatever older ones are
+    // still waiting for is no longer wanted
+    const uint64_t group = macroRuns_.fetch_add(1) + 1;
+    auto waits = waits_();
+    waits->preempt(group);
+
+    // don't hold up the event tap while it waits
+    executor_()->post(ExecutorQueue::Pool, "macro", [this, owner = std::move(owner), &program, waits, group]() {
+        MacroRunner runner{*this, KeySender::getInstance(), &pacer_, waits.get(), group};
+        const MacroRun run = MacroPipeline::run(program, runner);
+        macroLatency_.record(run.elapsed);
+
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(run.elapsed).count();
+        if (run.failed) {
+            logger->warn("macro stopped after {} of {} steps ({}us): {}", run.steps, program.code().size(), us, run.error);
+        } else {
+            logger->debug("macro: {} steps in {}us", run.steps, us);
+        }
+        if (run.timedOut > 0) {
+            logger->warn("macro: gave up waiting on {} step(s)", run.timedOut);
+        }
+    });
+}
+
+void ActionHandler::runSequenceStep(const KeySequencer::Step& step, const SequenceTriePtr& trie
+                                    , const RemapTablePtr& remaps, KeyContext context) {
+    for (const KeyChord chord : step.replay()) {
+        replayKey(chord, remaps, context);
+    }
+    if (step.program != nullptr) {
+        runMacro(*step.program, trie);
+    }
+}
+
+void ActionHandler::replayKey(KeyChord chord, const RemapTablePtr& remaps, KeyContext context) {
+    if (const MacroProgram* program = remaps->find(context, chord)) {
+        runMacro(*program, remaps);
+        return;
+    }
+    if (context == KeyContext::SearchBox) {
+        return;
+    }
+
+    // sent past the event tap, so it doesn't come back round to us
+    auto keyCode = KeyCodes::find(KeyChord::keyName(chord.key()));
+    if (!keyCode) {
+        logger->warn("can't replay \"{}\", it has no key code on this platform", KeyChord::keyName(chord.key()));
+        return;
+    }
+    auto& keys = KeySender::getInstance();
+    keys.sendKey(*keyCode, chord.modifierFlags(), true);
+    keys.sendKey(*keyCode, chord.modifierFlags(), false);
+}
+
+void ActionHandler::sequenceTimerLoop() {
+    std::unique_lock lock(sequenceMutex_);
+    while (!stopping_) {
+        const auto deadline = sequencer_.deadline();
+        if (!deadline) {
+            sequenceWake_.wait(lock);
+            continue;
+        }
+        // a key press in the meantime moves or clears the deadline and
+        // wakes us; expire() does nothing before it's due
+        sequenceWake_.wait_until(lock, *deadline);
+        const auto step = sequencer_.expire(KeySequencer::Clock::now());
+        if (step.empty()) {
+            continue;
+        }
+        const SequenceTriePtr trie = sequencer_.trie();
+
+        lock.unlock();
+        runSequenceStep(step, trie, configManager_()->getRemapTable(), focusTracker_()->context());
+        lock.lock();
     }
 }
 
 auto ActionHandler::closeWindows() -> bool {
     auto wm = windowManager_();
-    wm->closeWindow("ContextMenu");
-    wm->closeWindow("SearchBox");
+    onMessageThread([wm]() {
+        wm->closeWindow("ContextMenu");
+        wm->closeWindow("SearchBox");
+    });
 
     return false;
 }
 
+auto ActionHandler::onMessageThread(std::function<void()> work) -> std::future<void> {
+    auto* messageManager = juce::MessageManager::getInstanceWithoutCreating();
+    if (messageManager == nullptr || messageManager->isThisTheMessageThread()) {
+        work();
+        return {};
+    }
+
+    // if the message loop has gone, callAsync drops the lambda and the
+    // promise with it, which ends the macro waiting on it
+    auto done = std::make_shared<std::promise<void>>();
+    auto future = done->get_future();
+    juce::MessageManager::callAsync([done, work = std::move(work)]() {
+        try {
+            work();
+        } catch (...) {
+            done->set_exception(std::current_exception());
+            return;
+        }
+        done->set_value();
+    });
+    return future;
+}
+
 auto ActionHandler::loadItem(int itemIndex) -> bool {
     auto ipc = ipc_();
-    ipc->writeRequest("load_item," + std::to_string(itemIndex));
+    ipc->writeRequest("load_item," + std::to_string(itemIndex), trackIpc(nullptr));
+
+    // the pinned snapshot; the plugin list itself is replaced by refreshes
+    auto catalog = pluginManager_()->getCatalog();
+    if (const uint32_t index = catalog->findNumber(itemIndex); index != UINT32_MAX) {
+        usageStore_()->record(catalog->plugin(index).name);
+    }
 
     return false;
 }
 
 auto ActionHandler::loadItemByName(const std::string& itemName) -> bool {
-    auto ipc = ipc_();
-    auto pluginManager = pluginManager_();
-    for (const auto& plugin : pluginManager->getPlugins()) {
-        if (itemName == plugin.name) {
-          ipc->writeRequest("load_item," + std::to_string(plugin.number));
-          return true;
+    return loadPlugin(itemName, nullptr);
+}
+
+auto ActionHandler::loadPlugin(const std::string& itemName, IIPCCore::ResponseCallback onLoaded) -> bool {
+    auto catalog = pluginManager_()->getCatalog();
+    auto lookup = catalog->findPlugin(itemName);
+    if (!lookup.found()) {
+        logger->warn("not loading: {}", PluginCatalog::missReason(itemName, lookup));
+        return false;
+    }
+
+    const auto& plugin = catalog->plugin(lookup.index);
+    const std::string request = "load_item," + std::to_string(plugin.number);
+    ipc_()->writeRequest(request, trackIpc(std::move(onLoaded)));
+    usageStore_()->record(plugin.name);
+    return true;
+}
+
+auto ActionHandler::trackIpc(IIPCCore::ResponseCallback then) -> IIPCCore::ResponseCallback {
+    // the callback is dropped without being called if the request never
+    // gets an answer, which has to count as done too
+    class InFlight {
+    public:
+        explicit InFlight(ActionHandler& handler)
+            : handler_(handler)
+            , waits_(handler.waits_())
+        {
+            handler_.ipcInFlight_.fetch_add(1);
+        }
+
+        ~InFlight() { done(); }
+
+        InFlight(const InFlight&) = delete;
+        auto operator=(const InFlight&) -> InFlight& = delete;
+        InFlight(InFlight&&) = delete;
+        auto operator=(InFlight&&) -> InFlight& = delete;
+
+        void done() {
+            if (!done_.exchange(true) && handler_.ipcInFlight_.fetch_sub(1) == 1) {
+                waits_->signal(WaitCondition::Ipc);
+            }
+        }
+
+    private:
+        ActionHandler& handler_;
+        std::shared_ptr<WaitScheduler> waits_;
+        std::atomic<bool> done_{false};
+    };
+
+    auto inFlight = std::make_shared<InFlight>(*this);
+    return [inFlight, then = std::move(then)](const std::string& response) {
+        if (then) {
+            then(response);
+        }
+        inFlight->done();
+    };
+}
+
+auto ActionHandler::waitFor(WaitCondition condition, uint32_t ms, uint64_t group
+                            , std::optional<uint64_t> since) -> std::future<void> {
+    auto waits = waits_();
+    if (condition == WaitCondition::Ipc) {
+        // the count before the check, so a request answered in between
+        // has signalled past it
+        since = waits->signals(WaitCondition::Ipc);
+        if (ipcInFlight_.load() == 0) {
+            return {};
         }
     }
-    return false;
+    return waits->wait(condition, ms, group, since);
+}
+
+auto ActionHandler::commandNames() const -> std::vector<std::string> {
+    std::vector<std::string> names;
+    for (const auto& [name, handler] : actionMap) {
+        if (!NOT_COMMANDS.contains(name)) {
+            names.push_back(name);
+        }
+    }
+    return names;
 }
 
 auto ActionHandler::handleAction(std::string action) -> void {
@@ -172,7 +516,10 @@ auto ActionHandler::handleAction(std::string action) -> void {
         return;
     }
 
-    // Loop through each action
+    // compiled like a remap's steps, so a delay or wait is a step of the
+    // macro run on the executor rather than a block on the caller's
+    // thread, which for menu entries is the message thread
+    EMacro macro;
     for (auto& act : actions) {
         Utils::trim(act);
 
@@ -188,26 +535,23 @@ auto ActionHandler::handleAction(std::string action) -> void {
         std::string actionType = Utils::trim(actionParts[0]);
         logger->debug("Processing actionType: {}", actionType);
 
-        // Try to find the action handler in the map
-        auto actionHandler = actionMap.find(actionType);
-        if (actionHandler != actionMap.end()) {
-            // Check if there is an argument (second part after '.')
-            if (actionParts.size() > 1) {
-                std::string args = Utils::trim(actionParts[1]);
-                logger->debug("Action has argument: {}", args);
-
-                // Call the handler with the argument
-                actionHandler->second(args);
-            } else {
-                // No argument, pass std::nullopt
-                logger->debug("No argument provided for action: {}", actionType);
-                actionHandler->second(std::nullopt);
-            }
+        // Check if there is an argument (second part after '.')
+        if (actionParts.size() > 1) {
+            std::string args = Utils::trim(actionParts[1]);
+            logger->debug("Action has argument: {}", args);
+            macro.addAction(Action(actionType, args));
         } else {
-            // No handler found for this action type
-            logger->warn("No handler found for action type: {}", actionType);
+            logger->debug("No argument provided for action: {}", actionType);
+            macro.addAction(Action(actionType));
         }
     }
+
+    // unknown actions are logged and left out
+    auto program = std::make_shared<const MacroProgram>(MacroProgram::compile(macro));
+    if (program->code().empty()) {
+        return;
+    }
+    runMacro(*program, program);
 }
 
 // returns: bool: shouldPassEvent -- should the original event be passed
@@ -216,33 +560,49 @@ auto ActionHandler::handleAction(std::string action) -> void {
 
 // TODO cross-platform - send flags as another KeyPress object since CGEventFlags
 // doesn't exist on Windows
-auto ActionHandler::handleKeyEvent(EKeyPress pressedKey) -> bool {
+auto ActionHandler::handleKeyEvent(KeyChord pressed) -> bool {
     auto config = configManager_();
-    auto wm = windowManager_();
+    const KeyContext context = focusTracker_()->context();
 //    logger->info("action handler: Key event: " + type + ", Key code: " + std::to_string(keyCode) + ", Modifiers: {}", std::to_string(flags));
 
     // static cast probably not necessary
 
-    std::unordered_map<EKeyPress, EMacro, EMacroHash> remap = config->getRemap();
-
-    //logger->debug("searching map for pressed cmd: "   + std::to_string(pressedKey.cmd));
-    //logger->debug("searching map for pressed ctrl: "  + std::to_string(pressedKey.ctrl));
-    //logger->debug("searching map for pressed alt: "   + std::to_string(pressedKey.alt));
-    //logger->debug("searching map for pressed shift: {}", std::to_string(pressedKey.shift));
-    //logger->debug("searching map for pressed sent: "  + pressedKey.key);
+    auto remaps = config->getRemapTable();
+
+    // sequences first. Unmodified keys typed into a text field or the
+    // search box don't start one, as they aren't remapped there either
+    const bool typing = pressed.modifiers() == 0
+                        && (context == KeyContext::TextField || context == KeyContext::SearchBox);
+    KeySequencer::Step step;
+    SequenceTriePtr trie;
+    {
+        std::lock_guard lock(sequenceMutex_);
+        if (sequencer_.pending() || (!typing && !remaps->sequences()->empty())) {
+            step = sequencer_.press(remaps->sequences(), pressed, KeySequencer::Clock::now());
+            trie = sequencer_.trie();
+        }
+    }
+    if (!step.empty()) {
+        // the deadline moved
+        sequenceWake_.notify_one();
+        runSequenceStep(step, trie, remaps, context);
+        if (step.consumed) {
+            return false;
+        }
+    }
 
     // key remaps
-    auto it = remap.find(pressedKey);
-    if (it != remap.end()) {
-        executeMacro(it->second);
+    if (const MacroProgram* program = remaps->find(context, pressed)) {
+        // the table keeps the program alive
+        runMacro(*program, remaps);
         return false;
     } else {
-        logger->warn("Key not found in remap: {}", pressedKey.key);
+        logger->debug("Key not found in remap: {} ({})", KeyChord::keyName(pressed.key()), KeyContexts::name(context));
     }
 
     // when the menu is open, do not send keypresses to Live
     // or it activates your hotkeys
-    if (wm->isWindowOpen("SearchBox")) {
+    if (context == KeyContext::SearchBox) {
         logger->debug("is open, do not pass keys to Live");
         return false;
     }
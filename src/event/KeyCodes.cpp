@@ -0,0 +1,165 @@
+#include <array>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include "KeyCodes.h"
+
+namespace {
+    using KeyCode = std::pair<std::string_view, uint16_t>;
+
+#ifdef _WIN32
+    constexpr std::array KEY_CODES = {
+        // NOLINTBEGIN
+        KeyCode{"a", 'A'}, KeyCode{"b", 'B'}, KeyCode{"c", 'C'}, KeyCode{"d", 'D'}
+        , KeyCode{"e", 'E'}, KeyCode{"f", 'F'}, KeyCode{"g", 'G'}, KeyCode{"h", 'H'}
+        , KeyCode{"i", 'I'}, KeyCode{"j", 'J'}, KeyCode{"k", 'K'}, KeyCode{"l", 'L'}
+        , KeyCode{"m", 'M'}, KeyCode{"n", 'N'}, KeyCode{"o", 'O'}, KeyCode{"p", 'P'}
+        , KeyCode{"q", 'Q'}, KeyCode{"r", 'R'}, KeyCode{"s", 'S'}, KeyCode{"t", 'T'}
+        , KeyCode{"u", 'U'}, KeyCode{"v", 'V'}, KeyCode{"w", 'W'}, KeyCode{"x", 'X'}
+        , KeyCode{"y", 'Y'}, KeyCode{"z", 'Z'}
+        , KeyCode{"0", '0'}, KeyCode{"1", '1'}, KeyCode{"2", '2'}, KeyCode{"3", '3'}
+        , KeyCode{"4", '4'}, KeyCode{"5", '5'}, KeyCode{"6", '6'}, KeyCode{"7", '7'}
+        , KeyCode{"8", '8'}, KeyCode{"9", '9'}
+
+        , KeyCode{"tab", VK_TAB}
+        , KeyCode{"space", VK_SPACE}
+        , KeyCode{"escape", VK_ESCAPE}
+        , KeyCode{"enter", VK_RETURN}
+        , KeyCode{"backspace", VK_BACK}
+        , KeyCode{"delete", VK_BACK}
+        , KeyCode{"forwarddelete", VK_DELETE}
+
+        , KeyCode{"left", VK_LEFT}, KeyCode{"leftarrow", VK_LEFT}
+        , KeyCode{"right", VK_RIGHT}, KeyCode{"rightarrow", VK_RIGHT}
+        , KeyCode{"up", VK_UP}, KeyCode{"uparrow", VK_UP}
+        , KeyCode{"down", VK_DOWN}, KeyCode{"downarrow", VK_DOWN}
+        , KeyCode{"home", VK_HOME}
+        , KeyCode{"end", VK_END}
+        , KeyCode{"pageup", VK_PRIOR}
+        , KeyCode{"pagedown", VK_NEXT}
+
+        , KeyCode{"f1", VK_F1}, KeyCode{"f2", VK_F2}, KeyCode{"f3", VK_F3}, KeyCode{"f4", VK_F4}
+        , KeyCode{"f5", VK_F5}, KeyCode{"f6", VK_F6}, KeyCode{"f7", VK_F7}, KeyCode{"f8", VK_F8}
+        , KeyCode{"f9", VK_F9}, KeyCode{"f10", VK_F10}, KeyCode{"f11", VK_F11}, KeyCode{"f12", VK_F12}
+        // NOLINTEND
+    };
+#else
+    constexpr std::array KEY_CODES = {
+        // NOLINTBEGIN
+        KeyCode{"a", 0}
+        , KeyCode{"s", 1}
+        , KeyCode{"d", 2}
+        , KeyCode{"f", 3}
+        , KeyCode{"h", 4}
+        , KeyCode{"g", 5}
+        , KeyCode{"z", 6}
+        , KeyCode{"x", 7}
+        , KeyCode{"c", 8}
+        , KeyCode{"v", 9}
+        , KeyCode{"b", 11}
+        , KeyCode{"q", 12}
+        , KeyCode{"w", 13}
+        , KeyCode{"e", 14}
+        , KeyCode{"r", 15}
+        , KeyCode{"y", 16}
+        , KeyCode{"t", 17}
+        , KeyCode{"1", 18}
+        , KeyCode{"2", 19}
+        , KeyCode{"3", 20}
+        , KeyCode{"4", 21}
+        , KeyCode{"6", 22}
+        , KeyCode{"5", 23}
+        , KeyCode{"equal", 24}
+        , KeyCode{"9", 25}
+        , KeyCode{"7", 26}
+        , KeyCode{"minus", 27}
+        , KeyCode{"8", 28}
+        , KeyCode{"0", 29}
+        , KeyCode{"rightbracket", 30}
+        , KeyCode{"o", 31}
+        , KeyCode{"u", 32}
+        , KeyCode{"leftbracket", 33}
+        , KeyCode{"i", 34}
+        , KeyCode{"p", 35}
+        , KeyCode{"enter", 36}
+        , KeyCode{"l", 37}
+        , KeyCode{"j", 38}
+        , KeyCode{"quote", 39}
+        , KeyCode{"k", 40}
+        , KeyCode{"semicolon", 41}
+        , KeyCode{"backslash", 42}
+        , KeyCode{"comma", 43}
+        , KeyCode{"slash", 44}
+        , KeyCode{"n", 45}
+        , KeyCode{"m", 46}
+        , KeyCode{"period", 47}
+        , KeyCode{"tab", 48}
+        , KeyCode{"space", 49}
+        , KeyCode{"grave", 50}
+        , KeyCode{"delete", 51}
+        , KeyCode{"backspace", 51}
+        , KeyCode{"escape", 53}
+
+        , KeyCode{"rightcommand", 54}
+        , KeyCode{"command", 55}
+        , KeyCode{"shift", 56}
+        , KeyCode{"capslock", 57}
+        , KeyCode{"option", 58}
+        , KeyCode{"control", 59}
+        , KeyCode{"rightshift", 60}
+        , KeyCode{"rightoption", 61}
+        , KeyCode{"rightcontrol", 62}
+
+        , KeyCode{"f1", 122}
+        , KeyCode{"f2", 120}
+        , KeyCode{"f3", 99}
+        , KeyCode{"f4", 118}
+        , KeyCode{"f5", 96}
+        , KeyCode{"f6", 97}
+        , KeyCode{"f7", 98}
+        , KeyCode{"f8", 100}
+        , KeyCode{"f9", 101}
+        , KeyCode{"f10", 109}
+        , KeyCode{"f11", 103}
+        , KeyCode{"f12", 111}
+
+        , KeyCode{"uparrow", 126}
+        , KeyCode{"downarrow", 125}
+        , KeyCode{"leftarrow", 123}
+        , KeyCode{"rightarrow", 124}
+
+        , KeyCode{"home", 115}
+        , KeyCode{"end", 119}
+        , KeyCode{"pageup", 116}
+        , KeyCode{"pagedown", 121}
+        , KeyCode{"help", 114}
+        , KeyCode{"forwarddelete", 117}
+        // NOLINTEND
+    };
+#endif
+
+    auto lower(char c) -> char {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+}
+
+namespace KeyCodes {
+    auto find(std::string_view key) -> std::optional<uint16_t> {
+        for (const auto& [name, code] : KEY_CODES) {
+            if (name.size() != key.size()) {
+                continue;
+            }
+            bool same = true;
+            for (size_t i = 0; i < key.size() && same; ++i) {
+                same = lower(key[i]) == name[i];
+            }
+            if (same) {
+                return code;
+            }
+        }
+        return std::nullopt;
+    }
+}
@@ -0,0 +1,83 @@
+#include "KeySequencer.h"
+
+auto KeySequencer::press(const SequenceTriePtr& trie, KeyChord chord, TimePoint now) -> Step {
+    Step step;
+
+    if (pending()) {
+        if (trie != trie_) {
+            // the config changed mid-sequence; what was typed may mean
+            // something else now, so hand it back untouched
+            replayPending(step);
+            clear();
+        } else if (now >= deadline_) {
+            resolve(step);
+        }
+    }
+
+    if (pending()) {
+        const SequenceTrie::Node next = trie_->next(node_, chord);
+        if (next != SequenceTrie::NONE) {
+            advance(next, chord, now, step);
+            return step;
+        }
+        resolve(step);
+    }
+
+    // only swapped while idle, so a program from the old trie is never
+    // returned alongside the new one
+    if (trie != trie_) {
+        trie_ = trie;
+    }
+    if (!trie_) {
+        return step;
+    }
+
+    // the key after a sequence that didn't fit can start another; root
+    // children always lead on, so this never completes one
+    const SequenceTrie::Node next = trie_->next(SequenceTrie::ROOT, chord);
+    if (next != SequenceTrie::NONE) {
+        advance(next, chord, now, step);
+    }
+    return step;
+}
+
+auto KeySequencer::expire(TimePoint now) -> Step {
+    Step step;
+    if (pending() && now >= deadline_) {
+        resolve(step);
+    }
+    return step;
+}
+
+void KeySequencer::advance(SequenceTrie::Node next, KeyChord chord, TimePoint now, Step& step) {
+    step.consumed = true;
+    pending_[pendingCount_++] = chord;
+
+    if (!trie_->leadsOn(next)) {
+        step.program = trie_->program(next);
+        clear();
+        return;
+    }
+    node_ = next;
+    deadline_ = now + trie_->timeout();
+}
+
+void KeySequencer::resolve(Step& step) {
+    if (const MacroProgram* program = trie_->program(node_)) {
+        step.program = program;
+    } else {
+        replayPending(step);
+    }
+    clear();
+}
+
+void KeySequencer::replayPending(Step& step) {
+    for (uint8_t i = 0; i < pendingCount_; ++i) {
+        step.replayed[step.replayCount++] = pending_[i];
+    }
+}
+
+void KeySequencer::clear() {
+    node_ = SequenceTrie::ROOT;
+    pendingCount_ = 0;
+}
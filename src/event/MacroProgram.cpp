@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <charconv>
+
+#include "LogGlobal.h"
+
+#include "KeyCodes.h"
+#include "MacroProgram.h"
+
+namespace {
+    auto modifierFlags(const EKeyPress& kp) -> uint32_t {
+        uint32_t flags = Modifier::None;
+        if (kp.shift) flags |= Modifier::Shift;
+        if (kp.ctrl)  flags |= Modifier::Ctrl;
+        if (kp.alt)   flags |= Modifier::Alt;
+        if (kp.cmd)   flags |= Modifier::Cmd;
+        return flags;
+    }
+}
+
+MacroProgram::MacroProgram()
+    : arguments_(1)
+{}
+
+auto MacroProgram::compile(const EMacro& macro) -> MacroProgram {
+    MacroProgram program;
+    program.code_.reserve(macro.steps.size() * 2);
+
+    for (const auto& step : macro.steps) {
+        if (const auto* kp = std::get_if<EKeyPress>(&step)) {
+            auto keyCode = KeyCodes::find(kp->key);
+            if (!keyCode) {
+                logger->warn("macro: no key code for \"{}\" on this platform, skipping it", kp->key);
+                continue;
+            }
+            const uint32_t flags = modifierFlags(*kp);
+            program.code_.push_back({MacroOp::KeyDown, *keyCode, flags});
+            program.code_.push_back({MacroOp::KeyUp, *keyCode, flags});
+            continue;
+        }
+
+        const auto& action = std::get<Action>(step);
+        auto id = NamedActions::find(action.actionName);
+        if (!id) {
+            logger->warn("macro: unknown action {}, skipping it", action.actionName);
+            continue;
+        }
+
+        if (*id == ActionId::delay) {
+            uint32_t ms = 0;
+            const std::string& value = action.arguments.value_or("");
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), ms);
+            if (value.empty() || ec != std::errc() || end != value.data() + value.size()) {
+                logger->warn("macro: delay needs a number of milliseconds, got \"{}\"", value);
+                continue;
+            }
+            program.code_.push_back({MacroOp::Delay, 0, ms});
+            program.hasDelay_ = true;
+            continue;
+        }
+
+        if (*id == ActionId::wait) {
+            auto wait = WaitConditions::parse(action.arguments.value_or(""));
+            if (!wait) {
+                logger->warn("macro: can't wait for \"{}\"", action.arguments.value_or(""));
+                continue;
+            }
+            program.code_.push_back({MacroOp::Wait, static_cast<uint16_t>(wait->condition), wait->ms});
+            continue;
+        }
+
+        program.code_.push_back({MacroOp::Invoke, static_cast<uint16_t>(*id), program.intern(action.arguments)});
+    }
+
+    const bool invokes = std::any_of(program.code_.begin(), program.code_.end()
+                                     , [](const MacroInstr& instr) { return instr.op == MacroOp::Invoke; });
+    const bool waitsOn = std::any_of(program.code_.begin(), program.code_.end()
+                                     , [](const MacroInstr& instr) { return instr.op == MacroOp::Wait; });
+    const auto presses = std::count_if(program.code_.begin(), program.code_.end()
+                                       , [](const MacroInstr& instr) { return instr.op == MacroOp::KeyDown; });
+    program.waits_ = program.hasDelay_ || waitsOn || (invokes && program.code_.size() > 1) || presses > 1;
+
+    program.code_.shrink_to_fit();
+    return program;
+}
+
+auto MacroProgram::intern(const std::optional<std::string>& argument) -> uint32_t {
+    for (size_t i = 0; i < arguments_.size(); ++i) {
+        if (arguments_[i] == argument) {
+            return static_cast<uint32_t>(i);
+        }
+    }
+    arguments_.push_back(argument);
+    return static_cast<uint32_t>(arguments_.size() - 1);
+}
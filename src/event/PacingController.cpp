@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <cmath>
+
+#include "PacingController.h"
+
+PacingController::PacingController(const std::array<Limits, COUNT>& limits) {
+    for (size_t i = 0; i < COUNT; ++i) {
+        const Limits& l = limits[i];
+        State& s = states_[i];
+        // a shorter interval is a higher rate
+        s.minRate = toRate(l.max);
+        s.maxRate = toRate(l.min);
+        s.rate = std::clamp(toRate(l.initial), s.minRate, s.maxRate);
+        s.increase = l.increase;
+        s.decrease = l.decrease;
+    }
+}
+
+auto PacingController::toRate(std::chrono::nanoseconds interval) -> double {
+    const auto ns = std::max<std::chrono::nanoseconds::rep>(interval.count(), 1);
+    return 1e9 / static_cast<double>(ns); // NOLINT
+}
+
+auto PacingController::toInterval(double rate) -> std::chrono::nanoseconds {
+    return std::chrono::nanoseconds(std::llround(1e9 / rate)); // NOLINT
+}
+
+auto PacingController::reserve(PaceClass pace, TimePoint now) -> TimePoint {
+    std::lock_guard lock(mutex_);
+    State& s = state(pace);
+    const TimePoint at = std::max(now, s.nextSend);
+    s.nextSend = at + toInterval(s.rate);
+    ++s.stats.sent;
+    return at;
+}
+
+void PacingController::accepted(PaceClass pace) {
+    std::lock_guard lock(mutex_);
+    State& s = state(pace);
+    s.rate = std::min(s.rate + s.increase, s.maxRate);
+    ++s.stats.accepted;
+}
+
+void PacingController::dropped(PaceClass pace, TimePoint sentAt) {
+    std::lock_guard lock(mutex_);
+    State& s = state(pace);
+    ++s.stats.dropped;
+    if (sentAt < s.lastDecrease) {
+        // went out at the old rate; already paid for
+        return;
+    }
+    s.rate = std::max(s.rate * s.decrease, s.minRate);
+    ++s.stats.decreases;
+
+    // what's already reserved stays put; anything later is sent at the
+    // new rate, so its drops count again
+    s.lastDecrease = std::max(s.nextSend, sentAt + std::chrono::nanoseconds(1));
+}
+
+auto PacingController::interval(PaceClass pace) const -> std::chrono::nanoseconds {
+    std::lock_guard lock(mutex_);
+    return toInterval(state(pace).rate);
+}
+
+auto PacingController::stats(PaceClass pace) const -> Stats {
+    std::lock_guard lock(mutex_);
+    return state(pace).stats;
+}
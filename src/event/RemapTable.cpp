@@ -0,0 +1,60 @@
+#include "LogGlobal.h"
+
+#include "MacroProgram.h"
+#include "RemapTable.h"
+
+RemapTable::RemapTable()
+    : sequences_(std::make_shared<const SequenceTrie>())
+    , slots_(KeyChord::SPACE, nullptr)
+{}
+
+RemapTable::RemapTable(Programs programs, Layers layers, SequenceTriePtr sequences)
+    : programs_(std::move(programs))
+    , layers_(std::move(layers))
+    , sequences_(sequences ? std::move(sequences) : std::make_shared<const SequenceTrie>())
+    , slots_(KeyChord::SPACE, nullptr)
+{
+    fill(0, programs_, false);
+
+    bool unmodified = false;
+    for (const auto& [key, program] : programs_) {
+        unmodified = unmodified || !key.isModifierPressed();
+    }
+
+    for (size_t i = 0; i < KeyContexts::COUNT; ++i) {
+        const auto context = static_cast<KeyContext>(i);
+        const auto layer = layers_.find(context);
+        const bool overridden = layer != layers_.end() && !layer->second.empty();
+        const bool textField = context == KeyContext::TextField && unmodified;
+        if (context == KeyContext::Global || (!overridden && !textField)) {
+            continue;
+        }
+
+        const auto table = static_cast<uint32_t>(slots_.size());
+        slots_.resize(slots_.size() + KeyChord::SPACE, nullptr);
+        tables_[i] = table;
+
+        fill(table, programs_, context == KeyContext::TextField);
+        if (overridden) {
+            fill(table, layer->second, false);
+        }
+    }
+}
+
+void RemapTable::fill(uint32_t table, const Programs& programs, bool modifiedOnly) {
+    for (const auto& [key, program] : programs) {
+        const KeyChord chord = KeyChord::fromKeyPress(key);
+        if (!chord.valid()) {
+            // the global remaps are filled into every context's table;
+            // only say so the first time
+            if (table == 0 || &programs != &programs_) {
+                logger->warn("remap from \"{}\" can't be triggered, it isn't a key this build knows", key.key);
+            }
+            continue;
+        }
+        if (modifiedOnly && chord.modifiers() == 0) {
+            continue;
+        }
+        slots_[table + chord.index()] = program.get();
+    }
+}
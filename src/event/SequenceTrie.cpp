@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <bit>
+#include <unordered_map>
+
+#include "LogGlobal.h"
+
+#include "MacroProgram.h"
+#include "SequenceTrie.h"
+
+SequenceTrie::SequenceTrie()
+    : SequenceTrie({}, DEFAULT_TIMEOUT)
+{}
+
+SequenceTrie::SequenceTrie(std::vector<Sequence> sequences, std::chrono::milliseconds timeout)
+    : timeout_(timeout)
+    , nodes_(1)
+    , root_(KeyChord::SPACE, NONE)
+{
+    // edges by key while the trie grows, placed into edges_ at the end
+    std::unordered_map<uint64_t, Node> edges;
+    auto child = [&](Node node, KeyChord chord) -> Node {
+        Node* found = nullptr;
+        if (node == ROOT) {
+            found = &root_[chord.index()];
+        } else {
+            found = &edges.try_emplace(edgeKey(node, chord), NONE).first->second;
+        }
+        if (*found == NONE) {
+            *found = static_cast<Node>(nodes_.size());
+            ++nodes_[node].children;
+            nodes_.emplace_back();
+        }
+        return *found;
+    };
+
+    for (auto& sequence : sequences) {
+        if (sequence.chords.size() < 2 || sequence.chords.size() > MAX_LENGTH) {
+            logger->warn("sequence of {} keys left out, it takes 2 to {}", sequence.chords.size(), MAX_LENGTH);
+            continue;
+        }
+        bool valid = true;
+        for (const KeyChord chord : sequence.chords) {
+            valid = valid && chord.valid();
+        }
+        if (!valid) {
+            logger->warn("sequence left out, it has a key this build doesn't know");
+            continue;
+        }
+
+        Node node = ROOT;
+        for (const KeyChord chord : sequence.chords) {
+            node = child(node, chord);
+        }
+        if (nodes_[node].program != nullptr) {
+            logger->warn("sequence defined twice, the later one wins");
+        } else {
+            ++size_;
+        }
+        nodes_[node].program = sequence.program.get();
+        programs_.push_back(std::move(sequence.program));
+    }
+
+    // at most half full, so a probe ends at a free slot quickly
+    const size_t capacity = std::bit_ceil(std::max<size_t>(2, edges.size() * 2));
+    edges_.resize(capacity);
+    mask_ = capacity - 1;
+    for (const auto& [key, node] : edges) {
+        size_t i = slot(key);
+        while (edges_[i].key != 0) {
+            i = (i + 1) & mask_;
+        }
+        edges_[i] = {key, node};
+    }
+}
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <string_view>
+
+#include "LogGlobal.h"
+
+#include "WaitScheduler.h"
+
+WaitScheduler::WaitScheduler()
+    : start_(Clock::now())
+{
+    subscribers_.fill(NONE);
+    timer_ = std::thread([this]() { timerLoop(); });
+}
+
+WaitScheduler::~WaitScheduler() {
+    stop();
+}
+
+auto WaitScheduler::tick() const -> TimerWheel::Tick {
+    return static_cast<TimerWheel::Tick>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start_).count());
+}
+
+auto WaitScheduler::wait(WaitCondition condition, uint32_t ms, uint64_t group
+                         , std::optional<uint64_t> since) -> std::future<void> {
+    std::promise<void> promise;
+    auto future = promise.get_future();
+
+    std::lock_guard lock(mutex_);
+    if (stopping_ || group < floor_) {
+        ++stats_.cancelled;
+        promise.set_exception(std::make_exception_ptr(
+            StepCancelled("stopped waiting for " + std::string(WaitConditions::name(condition)))));
+        return future;
+    }
+
+    const auto c = static_cast<size_t>(condition);
+    const bool met = condition == WaitCondition::Time ? ms == 0 : since && signals_[c] > *since;
+    if (met) {
+        ++stats_.met;
+        promise.set_value();
+        return future;
+    }
+
+    // so the new timer is placed against the right tick
+    advanceLocked();
+
+    uint32_t index = 0;
+    if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(waiters_.size());
+        waiters_.emplace_back();
+    }
+
+    // tick() is rounded down, so a tick more makes sure it's never early
+    const TimerWheel::Tick due = tick() + ms + 1;
+    Waiter& waiter = waiters_[index];
+    waiter.promise = std::move(promise);
+    waiter.condition = condition;
+    waiter.group = group;
+    waiter.timer = wheel_.schedule(due, (uint64_t{index} << 32) | waiter.generation); // NOLINT
+    waiter.active = true;
+
+    if (condition != WaitCondition::Time) {
+        waiter.prev = NONE;
+        waiter.next = subscribers_[c];
+        if (waiter.next != NONE) {
+            waiters_[waiter.next].prev = index;
+        }
+        subscribers_[c] = index;
+    }
+
+    Group& owner = groups_[group];
+    ++owner.live;
+    owner.waiters.push_back({index, waiter.generation});
+    ++pending_;
+
+    if (!sleepingUntil_ || due < *sleepingUntil_) {
+        changed_.notify_one();
+    }
+    return future;
+}
+
+void WaitScheduler::signal(WaitCondition condition) {
+    std::lock_guard lock(mutex_);
+    const auto c = static_cast<size_t>(condition);
+    ++signals_[c];
+    while (subscribers_[c] != NONE) {
+        resolveLocked(subscribers_[c], Outcome::Met);
+    }
+}
+
+auto WaitScheduler::signals(WaitCondition condition) const -> uint64_t {
+    std::lock_guard lock(mutex_);
+    return signals_[static_cast<size_t>(condition)];
+}
+
+void WaitScheduler::preempt(uint64_t group) {
+    std::lock_guard lock(mutex_);
+    floor_ = std::max(floor_, group);
+    while (!groups_.empty() && groups_.begin()->first < floor_) {
+        cancelOldestLocked();
+    }
+}
+
+void WaitScheduler::cancelOldestLocked() {
+    // out of the map first, as resolving would erase it once empty
+    const Group waiters = std::move(groups_.begin()->second);
+    groups_.erase(groups_.begin());
+    for (const WaiterRef ref : waiters.waiters) {
+        const Waiter& waiter = waiters_[ref.index];
+        if (waiter.active && waiter.generation == ref.generation) {
+            resolveLocked(ref.index, Outcome::Cancelled);
+        }
+    }
+}
+
+void WaitScheduler::stop() {
+    {
+        std::lock_guard lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+        while (!groups_.empty()) {
+            cancelOldestLocked();
+        }
+    }
+    changed_.notify_one();
+
+    if (timer_.joinable()) {
+        timer_.join();
+    }
+
+    const Stats stats = this->stats();
+    if (stats.met + stats.timedOut + stats.cancelled > 0) {
+        logger->info("macro waits: {} met, {} timed out, {} cancelled", stats.met, stats.timedOut, stats.cancelled);
+    }
+}
+
+auto WaitScheduler::pending() const -> size_t {
+    std::lock_guard lock(mutex_);
+    return pending_;
+}
+
+auto WaitScheduler::stats() const -> Stats {
+    std::lock_guard lock(mutex_);
+    return stats_;
+}
+
+void WaitScheduler::timerLoop() {
+    std::unique_lock lock(mutex_);
+    while (!stopping_) {
+        advanceLocked();
+        sleepingUntil_ = wheel_.nextWake();
+        if (!sleepingUntil_) {
+            changed_.wait(lock);
+        } else {
+            changed_.wait_until(lock, start_ + std::chrono::milliseconds(*sleepingUntil_));
+        }
+    }
+    sleepingUntil_.reset();
+}
+
+void WaitScheduler::advanceLocked() {
+    wheel_.advance(tick(), [this](uint64_t token) {
+        const auto index = static_cast<uint32_t>(token >> 32); // NOLINT
+        const auto generation = static_cast<uint32_t>(token);
+        const Waiter& waiter = waiters_[index];
+        if (waiter.active && waiter.generation == generation) {
+            resolveLocked(index, waiter.condition == WaitCondition::Time ? Outcome::Met : Outcome::TimedOut);
+        }
+    });
+}
+
+void WaitScheduler::resolveLocked(uint32_t index, Outcome outcome) {
+    Waiter& waiter = waiters_[index];
+    const auto c = static_cast<size_t>(waiter.condition);
+
+    if (waiter.condition != WaitCondition::Time) {
+        if (waiter.prev != NONE) {
+            waiters_[waiter.prev].next = waiter.next;
+        } else {
+            subscribers_[c] = waiter.next;
+        }
+        if (waiter.next != NONE) {
+            waiters_[waiter.next].prev = waiter.prev;
+        }
+        waiter.prev = NONE;
+        waiter.next = NONE;
+    }
+    // already off the wheel if it's the timer firing
+    wheel_.cancel(waiter.timer);
+
+    // a cancelled group has already been taken out
+    auto group = groups_.find(waiter.group);
+    if (group != groups_.end() && --group->second.live == 0) {
+        groups_.erase(group);
+    }
+
+    std::promise<void> promise = std::move(waiter.promise);
+    waiter.active = false;
+    ++waiter.generation;
+    free_.push_back(index);
+    --pending_;
+
+    const std::string_view name = WaitConditions::name(waiter.condition);
+    switch (outcome) {
+        case Outcome::Met:
+            ++stats_.met;
+            promise.set_value();
+            break;
+        case Outcome::TimedOut:
+            ++stats_.timedOut;
+            promise.set_exception(std::make_exception_ptr(
+                StepTimedOut("timed out waiting for " + std::string(name))));
+            break;
+        case Outcome::Cancelled:
+            ++stats_.cancelled;
+            promise.set_exception(std::make_exception_ptr(
+                StepCancelled("stopped waiting for " + std::string(name))));
+            break;
+    }
+}
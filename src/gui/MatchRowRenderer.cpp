@@ -0,0 +1,107 @@
+#include "MatchRowRenderer.h"
+
+namespace {
+    // left inset, matching what drawText used to get
+    constexpr float TEXT_INSET = 2.0f;
+}
+
+void MatchRowRenderer::setRows(uint64_t catalogVersion, uint64_t generation) {
+    if (catalogVersion != catalogVersion_ || generation != generation_) {
+        catalogVersion_ = catalogVersion;
+        generation_ = generation;
+        layouts_.clear();
+    }
+}
+
+void MatchRowRenderer::paint(juce::Graphics& g
+                             , int row
+                             , const std::string& name
+                             , std::span<const MatchSpan> spans
+                             , juce::Rectangle<float> area
+                             , juce::Colour textColour
+                             , juce::Colour highlightColour)
+{
+    // a font or row height change invalidates every layout
+    if (g.getCurrentFont() != font_ || area.getHeight() != rowHeight_) {
+        font_ = g.getCurrentFont();
+        rowHeight_ = area.getHeight();
+        layouts_.clear();
+    }
+
+    const Layout& layout = layoutFor(row, name, spans, area.getHeight());
+
+    juce::Graphics::ScopedSaveState saveState(g);
+    g.reduceClipRegion(area.toNearestInt());
+
+    const auto transform = juce::AffineTransform::translation(area.getX() + TEXT_INSET, area.getY());
+
+    g.setColour(textColour);
+    layout.glyphs.draw(g, transform);
+
+    if (!layout.highlighted.empty()) {
+        // overdraw the matched glyphs; they're bold, so the tint covers the base
+        g.setColour(highlightColour);
+        for (const auto& range : layout.highlighted) {
+            for (int i = range.getStart(); i < range.getEnd(); ++i) {
+                layout.glyphs.getGlyph(i).draw(g, transform);
+            }
+        }
+    }
+}
+
+auto MatchRowRenderer::layoutFor(int row, const std::string& name, std::span<const MatchSpan> spans, float height) -> const Layout& {
+    auto it = layouts_.find(row);
+    if (it != layouts_.end()) {
+        ++hits_;
+        return it->second;
+    }
+
+    ++misses_;
+    if (layouts_.size() >= MAX_CACHED_ROWS) {
+        // rows are cheap to rebuild and long jumps rarely come back
+        layouts_.clear();
+    }
+
+    Layout& layout = layouts_[row];
+    build(layout, name, spans, height);
+    return layout;
+}
+
+void MatchRowRenderer::build(Layout& layout, const std::string& name, std::span<const MatchSpan> spans, float height) const {
+    const juce::Font bold = font_.boldened();
+    const float baseline = (height + font_.getAscent() - font_.getDescent()) * 0.5f; // NOLINT
+
+    float x = 0.0f;
+    size_t cursor = 0;
+
+    auto addSegment = [&](size_t begin, size_t end, bool highlighted) {
+        if (end <= begin) {
+            return;
+        }
+        const juce::Font& font = highlighted ? bold : font_;
+        const auto text = juce::String::fromUTF8(name.data() + begin, static_cast<int>(end - begin));
+
+        const int firstGlyph = layout.glyphs.getNumGlyphs();
+        layout.glyphs.addLineOfText(font, text, x, baseline);
+        if (highlighted) {
+            layout.highlighted.emplace_back(firstGlyph, layout.glyphs.getNumGlyphs());
+        }
+
+        const int glyphCount = layout.glyphs.getNumGlyphs();
+        if (glyphCount > 0) {
+            x = layout.glyphs.getGlyph(glyphCount - 1).getRight();
+        }
+    };
+
+    for (const auto& span : spans) {
+        const size_t begin = std::min<size_t>(span.offset, name.size());
+        const size_t end = std::min<size_t>(begin + span.length, name.size());
+        if (begin < cursor) {
+            continue;
+        }
+        addSegment(cursor, begin, false);
+        addSegment(begin, end, true);
+        cursor = end;
+    }
+    addSegment(cursor, name.size(), false);
+}
@@ -8,26 +8,35 @@
 
 #include "IEventHandler.h"
 #include "IActionHandler.h"
+#include "CommandIndex.h"
 #include "LimLookAndFeel.h"
-#include "PluginManager.h"
+#include "MatchRowRenderer.h"
+#include "PluginCatalog.h"
+#include "ResultList.h"
 #include "SearchBox.h"
+#include "SearchWorker.h"
 #include "Theme.h"
+#include "UsageStore.h"
 #include "WindowManager.h"
 
 class PluginListModel : public juce::ListBoxModel {
 public:
-    PluginListModel(std::shared_ptr<IPluginManager> pluginManager, std::shared_ptr<IActionHandler> actionHandler, std::shared_ptr<WindowManager> windowManager, std::shared_ptr<Theme> theme, int delayBeforeClose)
-        : pluginManager_(std::move(pluginManager))
+    PluginListModel(std::shared_ptr<CommandIndex> commandIndex, std::shared_ptr<IActionHandler> actionHandler, std::shared_ptr<WindowManager> windowManager, std::shared_ptr<Theme> theme, std::shared_ptr<UsageStore> usageStore, int delayBeforeClose)
+        : delayBeforeClose_(delayBeforeClose)
+        , commandIndex_(std::move(commandIndex))
         , actionHandler_(std::move(actionHandler))
         , windowManager_(std::move(windowManager))
         , theme_(std::move(theme))
-        , plugins_(pluginManager_->getPlugins())
-        , filteredPlugins_(plugins_)
-        , delayBeforeClose_(delayBeforeClose)
-    {}
+        , usageStore_(std::move(usageStore))
+        , catalog_(commandIndex_->snapshot())
+    {
+        loadColours();
+        rows_.reserve(*catalog_);
+        resetFilters();
+    }
 
     int getNumRows() override {
-        return static_cast<int>(filteredPlugins_.size());
+        return static_cast<int>(rows_.size());
     }
 
     void paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected) override {
@@ -36,82 +45,151 @@ public:
 //        // Extend the clipping region to include the scrollbar area
 //        g.reduceClipRegion(-18, 0, width + 18, height);
 
+        juce::Colour textColour = foregroundColour_;
         if (rowIsSelected) {
-            g.fillAll(theme_->getColorValue("SelectionBackground"));
-            g.setColour(theme_->getColorValue("SelectionForeground"));
+            g.fillAll(selectionBackgroundColour_);
+            textColour = selectionForegroundColour_;
         } else {
             g.fillAll(juce::Colours::transparentBlack);
-            g.setColour(theme_->getColorValue("ControlForeground"));
         }
-        if (rowNumber < filteredPlugins_.size()) {
-            auto& plugin = filteredPlugins_[rowNumber];
-            g.drawText(plugin.name, 2, 0, width - 4, height, juce::Justification::centredLeft, true);
+
+        if (const std::string* name = rows_.name(rowNumber)) {
+            const auto row = static_cast<uint32_t>(rowNumber);
+            juce::Rectangle<float> area(0.0f, 0.0f, static_cast<float>(width - 2), static_cast<float>(height));
+
+            // commands say where they come from, right aligned and dimmed
+            const uint32_t index = rows_.catalogIndex(row);
+            const bool isCommand = rows_.catalog()->kind(index) != EntryKind::Plugin;
+            const auto detailArea = isCommand ? area.removeFromRight(area.getWidth() * DETAIL_WIDTH) : juce::Rectangle<float>();
+
+            renderer_.paint(g, rowNumber, *name, rows_.spans(row), area, textColour, highlightColour_);
+
+            if (isCommand) {
+                // the renderer's layouts are keyed on the current font; leave it as found
+                juce::Graphics::ScopedSaveState saveState(g);
+                g.setColour(rowIsSelected ? textColour : detailColour_);
+                g.setFont(static_cast<float>(height) * DETAIL_FONT_SCALE);
+                g.drawText(rows_.catalog()->command(index).detail, detailArea, juce::Justification::centredRight, true);
+            }
         }
     }
 
     void listBoxItemClicked(int row, const juce::MouseEvent&) override {
-        if (row >= 0 && row < filteredPlugins_.size()) {
-            const Plugin* plugin = getPluginAtRow(row);
-            if (plugin) {
-                int pluginID = plugin->number;
-                juce::Timer::callAfterDelay(delayBeforeClose_, [this, pluginID]() {
-                    actionHandler_->loadItem(pluginID);
-                    windowManager_->closeWindow("SearchBox");
-                });
-            }
-        }
+        activateRow(row);
     }
 
-    const Plugin* getPluginAtRow(int row) const {
-        if (row >= 0 && row < filteredPlugins_.size()) {
-            return &filteredPlugins_[row];
+    // loads the plugin or runs the command on the row, then closes the box;
+    // resolved through whichever snapshot the rows were computed against
+    void activateRow(int row) {
+        const std::string* name = rows_.name(row);
+        if (!name) {
+            return;
         }
-        return nullptr;
+
+        if (const Plugin* plugin = rows_.plugin(row)) {
+            int pluginID = plugin->number;
+            juce::Timer::callAfterDelay(delayBeforeClose_, [this, pluginID]() {
+                actionHandler_->loadItem(pluginID);
+                windowManager_->closeWindow("SearchBox");
+            });
+            return;
+        }
+
+        // the box closes first so actions that move focus aren't undone by it
+        const auto& command = rows_.catalog()->command(rows_.catalogIndex(static_cast<uint32_t>(row)));
+        juce::Timer::callAfterDelay(delayBeforeClose_, [this, label = command.label, action = command.action]() {
+            windowManager_->closeWindow("SearchBox");
+            usageStore_->record(label);
+            actionHandler_->handleAction(action);
+        });
     }
 
-    void filterPlugins(const juce::String& searchText) {
-        filteredPlugins_.clear();
+    // the snapshot queries are run against; re-pinned whenever the box opens
+    // so a plugin refresh since the last open is picked up
+    auto catalog() const -> const PluginCatalogPtr& {
+        return catalog_;
+    }
 
-        // Filter based on searchText
-        for (const auto& plugin : plugins_) {
-            juce::String pluginName(plugin.name);
-            if (pluginName.containsIgnoreCase(searchText)) {
-                filteredPlugins_.push_back(plugin);
-            }
+    void pinCatalog(PluginCatalogPtr catalog) {
+        if (catalog && catalog != catalog_) {
+            catalog_ = std::move(catalog);
+            rows_.reserve(*catalog_);
+            resetFilters();
         }
     }
 
+    void setResults(const SearchResult& result) {
+        // the result may have been computed against an older snapshot,
+        // the rows keep that one alive until they're replaced
+        rows_.assign(result.catalog, result.matches, result.spans, result.spanOffsets);
+        renderer_.setRows(result.catalog->version(), result.generation);
+    }
+
     void resetFilters() {
-        filteredPlugins_ = plugins_;
+        // the unfiltered rows are the same for every generation; 0 is never a search's
+        rows_.showAll(catalog_);
+        renderer_.setRows(catalog_->version(), 0);
+    }
+
+    // once up front, and again whenever the theme is reloaded
+    void loadColours() {
+        auto palette = theme_->palette();
+        selectionBackgroundColour_ = palette->colour(ThemeColour::SelectionBackground);
+        selectionForegroundColour_ = palette->colour(ThemeColour::SelectionForeground);
+        foregroundColour_ = palette->colour(ThemeColour::ControlForeground);
+
+        detailColour_ = palette->colour(ThemeColour::RetroDisplayForegroundDisabled);
+
+        // older themes don't define a search colour
+        highlightColour_ = palette->colour(ThemeColour::SearchIndication);
+        if (highlightColour_.isTransparent()) {
+            highlightColour_ = palette->colour(ThemeColour::SelectionFrame);
+        }
     }
 
 public:
     int delayBeforeClose_;
 private:
-    std::shared_ptr<IPluginManager> pluginManager_;
+    // share of the row the detail of a command may take
+    static constexpr float DETAIL_WIDTH = 0.4f;
+    static constexpr float DETAIL_FONT_SCALE = 0.6f;
+
+    std::shared_ptr<CommandIndex> commandIndex_;
     std::shared_ptr<IActionHandler> actionHandler_;
     std::shared_ptr<WindowManager> windowManager_;
     std::shared_ptr<Theme> theme_;
-    const std::vector<Plugin>& plugins_;
-    std::vector<Plugin> filteredPlugins_;
-    const Plugin* selectedPlugin_ = nullptr;
+    std::shared_ptr<UsageStore> usageStore_;
+    PluginCatalogPtr catalog_;
+    ResultList rows_;
+    MatchRowRenderer renderer_;
+
+    juce::Colour selectionBackgroundColour_;
+    juce::Colour selectionForegroundColour_;
+    juce::Colour foregroundColour_;
+    juce::Colour detailColour_;
+    juce::Colour highlightColour_;
 };
 
 SearchBox::SearchBox(
-                     std::function<std::shared_ptr<IPluginManager>()> pluginManager
+                     std::function<std::shared_ptr<CommandIndex>()> commandIndex
                      , std::function<std::shared_ptr<IEventHandler>()> eventHandler
                      , std::function<std::shared_ptr<IActionHandler>()> actionHandler
                      , std::function<std::shared_ptr<WindowManager>()> windowManager
                      , std::function<std::shared_ptr<Theme>()> theme
                      , std::function<std::shared_ptr<LimLookAndFeel>()> limLookAndFeel
+                     , std::function<std::shared_ptr<UsageStore>()> usageStore
     )
     : TopLevelWindow("SearchBox", true)
-    , pluginManager_(std::move(pluginManager))
+    , commandIndex_(std::move(commandIndex))
     , eventHandler_(std::move(eventHandler))
     , actionHandler_(std::move(actionHandler))
     , windowManager_(std::move(windowManager))
     , theme_(std::move(theme))
     , limLookAndFeel_(std::move(limLookAndFeel))
+    , usageStore_(std::move(usageStore))
+    , searchLatency_("search input-to-result")
+    , firstPaintLatency_("search box hotkey-to-first-paint")
+    , focusLatency_("search box hotkey-to-focus")
     , selectedRow_()
     {
 
@@ -126,10 +204,21 @@ SearchBox::SearchBox(
 
     juce::LookAndFeel::setDefaultLookAndFeel(limLookAndFeel_().get());
 
-    pluginListModel_ = std::make_unique<PluginListModel>(pluginManager_(), actionHandler_(), windowManager_(), theme_(), DELAY_BEFORE_CLOSE);
+    pluginListModel_ = std::make_unique<PluginListModel>(commandIndex_(), actionHandler_(), windowManager_(), theme_(), usageStore_(), DELAY_BEFORE_CLOSE);
     listBox_.setModel(pluginListModel_.get());
     addAndMakeVisible(listBox_);
 
+    // results come back on the worker thread; hop to the message thread
+    // and drop them if the window is gone by then
+    juce::Component::SafePointer<SearchBox> safeThis(this);
+    searchWorker_ = std::make_unique<SearchWorker>([safeThis](std::shared_ptr<SearchResult> result) {
+        juce::MessageManager::callAsync([safeThis, result = std::move(result)]() {
+            if (safeThis != nullptr) {
+                safeThis->applySearchResult(*result);
+            }
+        });
+    });
+
     setUsingNativeTitleBar(false);
     setAlwaysOnTop(true);
 
@@ -137,7 +226,7 @@ SearchBox::SearchBox(
     searchField_.setJustification(juce::Justification::centredLeft);
     searchField_.setMultiLine(false);
     searchField_.setReturnKeyStartsNewLine(false);
-    searchField_.setTextToShowWhenEmpty("Search", theme_()->getColorValue("RetroDisplayForegroundDisabled"));
+    searchField_.setTextToShowWhenEmpty("Search", theme_()->colour(ThemeColour::RetroDisplayForegroundDisabled));
     searchField_.addListener(this);
     searchField_.addKeyListener(this);
     addAndMakeVisible(searchField_);
@@ -145,20 +234,39 @@ SearchBox::SearchBox(
     setWindowGeometry();
 }
 
-SearchBox::~SearchBox() {}
+SearchBox::~SearchBox() {
+    searchWorker_->stop();
+}
 
 void SearchBox::textEditorTextChanged(juce::TextEditor& editor) {
     if (&editor == &searchField_) {
         logger->debug("Search text changed: {}", editor.getText().toStdString());
-        juce::String searchText = searchField_.getText();
+        searchWorker_->submit(pluginListModel_->catalog(), searchField_.getText().toStdString(), rankingBoosts_);
+    }
+}
 
-        pluginListModel_->filterPlugins(searchText);
+void SearchBox::applySearchResult(const SearchResult& result) {
+    // results can arrive out of order; only ever move forward
+    if (result.generation <= displayedGeneration_) {
+        return;
+    }
+    displayedGeneration_ = result.generation;
 
-        listBox_.selectRow(0);
+    auto latency = std::chrono::steady_clock::now() - result.submittedAt;
+    searchLatency_.record(latency);
+    logger->debug("search generation {} \"{}\": {} matches in {}us"
+        , result.generation
+        , result.query
+        , result.matches.size()
+        , std::chrono::duration_cast<std::chrono::microseconds>(latency).count()
+    );
 
-        listBox_.updateContent();
-        listBox_.repaint();
-    }
+    pluginListModel_->setResults(result);
+
+    listBox_.selectRow(0);
+
+    listBox_.updateContent();
+    listBox_.repaint();
 }
 
 bool SearchBox::keyPressed(const juce::KeyPress& key, juce::Component*) {
@@ -176,15 +284,7 @@ bool SearchBox::keyPressed(const juce::KeyPress& key, juce::Component*) {
 
     if (key == juce::KeyPress::returnKey) {
         logger->info("enter key pressed");
-        int selectedRow = listBox_.getSelectedRow();
-        const Plugin* plugin = pluginListModel_->getPluginAtRow(selectedRow);
-        if (plugin) {
-            int pluginID = plugin->number;
-            juce::Timer::callAfterDelay(DELAY_BEFORE_CLOSE, [this, pluginID]() {
-                actionHandler_()->loadItem(pluginID);
-                windowManager_()->closeWindow("SearchBox");
-            });
-        }
+        pluginListModel_->activateRow(listBox_.getSelectedRow());
         return true;
     }
 
@@ -225,9 +325,32 @@ void SearchBox::setSelectedRow(int row) {
 }
 
 void SearchBox::resetFilters() {
+    // anything still in flight belongs to text that no longer exists
+    displayedGeneration_ = searchWorker_->latestGeneration();
+
     pluginListModel_->resetFilters();
     listBox_.updateContent();
     listBox_.repaint();
+
+    // alphabetical is shown immediately; the worker follows up with most used first
+    if (rankingBoosts_) {
+        searchWorker_->submit(pluginListModel_->catalog(), "", rankingBoosts_);
+    }
+}
+
+void SearchBox::refreshLiveBounds() {
+    liveBounds_ = eventHandler_()->getLiveBoundsRect();
+}
+
+auto SearchBox::refreshRanking() -> bool {
+    const auto before = pluginListModel_->catalog();
+    pluginListModel_->pinCatalog(commandIndex_()->snapshot());
+
+    // cached by the store until the catalog or the usage changes
+    auto boosts = usageStore_()->rankingBoosts(*pluginListModel_->catalog());
+    const bool changed = boosts != rankingBoosts_ || pluginListModel_->catalog() != before;
+    rankingBoosts_ = std::move(boosts);
+    return changed;
 }
 
 void SearchBox::setWindowGeometry() {
@@ -245,12 +368,15 @@ void SearchBox::setWindowGeometry() {
         int screenWidth = primaryDisplay->totalArea.getWidth();
         int screenHeight = primaryDisplay->totalArea.getHeight();
 
-        // Get Ableton Live's window bounds (assuming you have this method)
-        ERect liveBounds = eventHandler_()->getLiveBoundsRect();
+        // asking the window server is slow, so this is normally the
+        // bounds from the last time nobody was waiting
+        if (liveBounds_.width <= 0 || liveBounds_.height <= 0) {
+            refreshLiveBounds();
+        }
 
         // Center the widget inside Ableton Live's bounds
-        int xPos = liveBounds.x + (liveBounds.width - WIDGET_WIDTH) / 2;
-        int yPos = liveBounds.y + (liveBounds.height - WIDGET_HEIGHT) / 2;
+        int xPos = liveBounds_.x + (liveBounds_.width - WIDGET_WIDTH) / 2;
+        int yPos = liveBounds_.y + (liveBounds_.height - WIDGET_HEIGHT) / 2;
 
         // Ensure the window is within the screen boundaries
         xPos = std::max(0, std::min(xPos, screenWidth - WIDGET_WIDTH));
@@ -261,6 +387,17 @@ void SearchBox::setWindowGeometry() {
     }
 }
 
+// LimLookAndFeel sends this after the theme is reloaded
+void SearchBox::lookAndFeelChanged() {
+    juce::TopLevelWindow::lookAndFeelChanged();
+
+    if (pluginListModel_) {
+        pluginListModel_->loadColours();
+    }
+    searchField_.setTextToShowWhenEmpty("Search", theme_()->colour(ThemeColour::RetroDisplayForegroundDisabled));
+    repaint();
+}
+
 void SearchBox::resized() {
     const int listBoxOffset = 10;
 
@@ -278,7 +415,41 @@ void SearchBox::resized() {
 //    listBox_.setBounds(listBoxBounds);
 }
 
+// Everything open() would otherwise do on the hotkey's critical path:
+// the window already exists (TopLevelWindow puts it on the desktop), so
+// fill the list, measure Live, and paint once offscreen to load the
+// typeface and the row layouts.
+void SearchBox::prewarm() {
+    // an open box picks up a new catalog the next time it opens
+    if (isVisible()) {
+        return;
+    }
+
+    refreshRanking();
+    resetFilters();
+    listBox_.selectRow(0);
+
+    refreshLiveBounds();
+    setWindowGeometry();
+    resized();
+
+    auto start = std::chrono::steady_clock::now();
+    [[maybe_unused]] auto snapshot = createComponentSnapshot(getLocalBounds());
+    logger->debug("search box prewarmed, offscreen paint took {}us"
+        , std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
 void SearchBox::open() {
+    openRequestedAt(std::chrono::steady_clock::now());
+}
+
+void SearchBox::openRequestedAt(std::chrono::steady_clock::time_point requestedAt) {
+    openRequestedAt_ = requestedAt;
+    awaitingFirstPaint_ = true;
+    awaitingFocus_ = true;
+
+    // the catalog and ranking were pinned at prewarm or the last close;
+    // a load since then is picked up after the first paint
     setWindowGeometry();
 
     eventHandler_()->focusLim();
@@ -292,18 +463,45 @@ void SearchBox::open() {
 
     // hack for macOS
     // https://forum.juce.com/t/keyboard-focus-on-application-startup/9382/2
-    juce::Timer::callAfterDelay(DELAY_BEFORE_FOCUS, [this]() {
-        focus();
+    juce::Timer::callAfterDelay(FOCUS_RETRY_INTERVAL, [this]() {
+        focus(1);
     });
 }
 
-void SearchBox::focus() {
+void SearchBox::focus(int attempt) {
     // hack for macOS
     // https://forum.juce.com/t/keyboard-focus-on-application-startup/9382/2
-    if (!searchField_.hasKeyboardFocus(false)) {
-        searchField_.grabKeyboardFocus();
-        juce::Timer::callAfterDelay(DELAY_BEFORE_FOCUS, [this]() { focus(); });
+    if (!isVisible() || searchField_.hasKeyboardFocus(false)) {
+        return;
+    }
+    if (attempt > MAX_FOCUS_RETRIES) {
+        logger->warn("search box still has no keyboard focus after {} attempts", MAX_FOCUS_RETRIES);
+        return;
     }
+
+    searchField_.grabKeyboardFocus();
+    juce::Timer::callAfterDelay(FOCUS_RETRY_INTERVAL, [this, attempt]() { focus(attempt + 1); });
+}
+
+// focus counts once the window is key and the field has the keyboard;
+// either can happen last
+void SearchBox::recordFocusIfGained() {
+    if (awaitingFocus_ && isActiveWindow() && searchField_.hasKeyboardFocus(false)) {
+        awaitingFocus_ = false;
+        focusLatency_.recordSince(openRequestedAt_);
+        logger->debug("search box focused {}us after the hotkey"
+            , std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - openRequestedAt_).count());
+    }
+}
+
+void SearchBox::activeWindowStatusChanged() {
+    juce::TopLevelWindow::activeWindowStatusChanged();
+    recordFocusIfGained();
+}
+
+void SearchBox::focusOfChildComponentChanged(FocusChangeType cause) {
+    juce::TopLevelWindow::focusOfChildComponentChanged(cause);
+    recordFocusIfGained();
 }
 
 void SearchBox::mouseDown(const juce::MouseEvent& event) {
@@ -313,15 +511,27 @@ void SearchBox::mouseDown(const juce::MouseEvent& event) {
 }
 
 void SearchBox::close() {
+    for (const auto* histogram : {&searchLatency_, &firstPaintLatency_, &focusLatency_}) {
+        if (histogram->count() > 0) {
+            logger->info("{}", histogram->summary());
+        }
+    }
+    awaitingFirstPaint_ = false;
+    awaitingFocus_ = false;
+
     if (juce::MessageManager::getInstance()->isThisTheMessageThread()) {
         setVisible(false);
         searchField_.clear();
+        refreshRanking();
         resetFilters();
+        refreshLiveBounds();
     } else {
         juce::MessageManager::callAsync([this]() {
             setVisible(false);
             searchField_.clear();
+            refreshRanking();
             resetFilters();
+            refreshLiveBounds();
         });
     }
 }
@@ -346,26 +556,23 @@ void* SearchBox::getWindowHandle() const {
     return handle;
 }
 
-int SearchBox::getNumRows() {
-    return static_cast<int>(filteredOptions_.size());
-}
-
 #ifdef __clang__
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wold-style-cast"
 #endif
 void SearchBox::paint(juce::Graphics& g) {
     auto bounds = getLocalBounds().toFloat().reduced(0.5f); // NOLINT Reduce by 0.5 to avoid anti-aliasing artifacts
+    auto palette = theme_()->palette();
 
-    g.setColour(theme_()->getColorValue("SceneContrast"));
+    g.setColour(palette->colour(ThemeColour::SceneContrast));
     g.fillRoundedRectangle(bounds, 6.0f); // bounds, cornerSize
 
     // Draw the border
-    g.setColour(theme_()->getColorValue("SelectionFrame"));
+    g.setColour(palette->colour(ThemeColour::SelectionFrame));
     g.drawRoundedRectangle(bounds.reduced(8.0f), 6.0f, 2.0f); // bounds, cornerSize, borderThickness
                                                  //
     // Fill the background
-    g.setColour(theme_()->getColorValue("SurfaceBackground"));
+    g.setColour(palette->colour(ThemeColour::SurfaceBackground));
     g.fillRoundedRectangle(bounds.reduced(10.0f), 3.0f); // bounds, cornerSize
 
 //    g.setColour(theme_()->getColorValue("SceneContrast"));
@@ -374,11 +581,27 @@ void SearchBox::paint(juce::Graphics& g) {
     // Draw the text
     g.setFont(getHeight() * 0.7f);
 
+    if (awaitingFirstPaint_) {
+        awaitingFirstPaint_ = false;
+        firstPaintLatency_.recordSince(openRequestedAt_);
+        logger->debug("search box painted {}us after the hotkey"
+            , std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - openRequestedAt_).count());
+
+        // now that the user can see it, check whether Live moved since
+        // the bounds were cached and follow it if so, and pick up plugins
+        // loaded by hotkey while the box was closed
+        juce::Component::SafePointer<SearchBox> safeThis(this);
+        juce::MessageManager::callAsync([safeThis]() {
+            if (safeThis != nullptr && safeThis->isVisible()) {
+                safeThis->refreshLiveBounds();
+                safeThis->setWindowGeometry();
+                if (safeThis->searchField_.isEmpty() && safeThis->refreshRanking()) {
+                    safeThis->resetFilters();
+                }
+            }
+        });
+    }
 }
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif
-
-void SearchBox::paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected) {
-    return;
-}
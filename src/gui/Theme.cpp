@@ -1,59 +1,242 @@
-#include <iostream>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <memory>
 #include <string>
 #include <pugixml.hpp>
-#include <sstream>
 
 #include <JuceHeader.h>
 
+#include "FileWatcher.h"
 #include "LogGlobal.h"
 #include "Theme.h"
 
-// Helper function to convert hex color to RGB
-struct RGB {
-    int r, g, b;
-    RGB(int r, int g, int b) : r(r), g(g), b(b) {}
-};
+namespace {
+    constexpr std::array<std::string_view, ThemePalette::SIZE> COLOUR_NAMES = {
+#define LIM_THEME_NAME(name) #name,
+        LIM_THEME_COLOURS(LIM_THEME_NAME)
+#undef LIM_THEME_NAME
+    };
 
-RGB hexToRGB(const std::string& hex) {
-    if (hex[0] == '#') {
-        std::stringstream ss;
-        ss << std::hex << hex.substr(1);
-        unsigned int hexValue;
-        ss >> hexValue;
-        return RGB((hexValue >> 16) & 0xFF, (hexValue >> 8) & 0xFF, hexValue & 0xFF);
+    auto hexDigit(char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10; // NOLINT
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10; // NOLINT
+        return -1;
+    }
+
+    // Live writes "#rrggbb", or "#rrggbbaa" for translucent colours
+    auto parseColour(std::string_view value) -> std::optional<juce::Colour> {
+        if (value.empty() || value[0] != '#' || (value.size() != 7 && value.size() != 9)) { // NOLINT
+            return std::nullopt;
+        }
+
+        uint32_t rgba = 0;
+        for (char c : value.substr(1)) {
+            const int digit = hexDigit(c);
+            if (digit < 0) {
+                return std::nullopt;
+            }
+            rgba = (rgba << 4) | static_cast<uint32_t>(digit); // NOLINT
+        }
+        if (value.size() == 7) { // NOLINT
+            rgba = (rgba << 8) | 0xFF; // NOLINT
+        }
+
+        // NOLINTBEGIN
+        return juce::Colour(static_cast<uint8_t>(rgba >> 24)
+                            , static_cast<uint8_t>(rgba >> 16)
+                            , static_cast<uint8_t>(rgba >> 8)
+                            , static_cast<uint8_t>(rgba));
+        // NOLINTEND
+    }
+
+    // `text` as UTF-16LE, which is how Live writes strings it keeps in
+    // binary files. Theme names are ASCII
+    auto utf16(const std::string& text) -> std::string {
+        std::string wide;
+        wide.reserve(text.size() * 2);
+        for (char c : text) {
+            wide.push_back(c);
+            wide.push_back('\0');
+        }
+        return wide;
     }
-    return RGB(0, 0, 0); // Default black
 }
 
-Theme::Theme(const std::filesystem::path& filePath) {
-        pugi::xml_parse_result result = doc.load_file(filePath.generic_string().c_str());
-        if (!result) {
-            logger->error("Failed to load theme file: {}. Reason: {}", filePath.generic_string(), result.description());
+auto LiveThemeSelection::selected() const -> std::optional<std::filesystem::path> {
+    std::ifstream in(preferences, std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+    const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    std::error_code ec;
+    std::optional<std::filesystem::path> best;
+    size_t bestLength = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(themes, ec)) {
+        if (entry.path().extension() != ".ask") {
+            continue;
+        }
+        const std::string name = entry.path().stem().string();
+        if (name.size() <= bestLength) {
+            continue;
+        }
+        if (bytes.find(utf16(name)) != std::string::npos || bytes.find(name) != std::string::npos) {
+            best = entry.path();
+            bestLength = name.size();
         }
     }
+    return best;
+}
 
-auto Theme::getControlTextBack() -> juce::Colour {
-    return getColorValue("ControlTextBack");
+auto ThemePalette::load(const std::filesystem::path& filePath) -> std::shared_ptr<const ThemePalette> {
+    pugi::xml_document doc;
+    pugi::xml_parse_result result = doc.load_file(filePath.generic_string().c_str());
+    if (!result) {
+        logger->error("Failed to load theme file: {}. Reason: {}", filePath.generic_string(), result.description());
+        return nullptr;
+    }
+
+    pugi::xml_node root = doc.child("Ableton").child("Theme");
+    if (!root) {
+        logger->error("Theme file {} has no Ableton/Theme element", filePath.generic_string());
+        return nullptr;
+    }
+
+    auto palette = std::make_shared<ThemePalette>();
+    palette->colours_.fill(juce::Colours::transparentBlack);
+
+    size_t known = 0;
+    for (pugi::xml_node node : root.children()) {
+        auto colour = parseColour(node.attribute("Value").as_string());
+        if (!colour) {
+            continue;
+        }
+        if (auto id = find(node.name())) {
+            palette->colours_[static_cast<size_t>(*id)] = *colour;
+            ++known;
+        } else {
+            palette->others_.emplace(node.name(), *colour);
+        }
+    }
+
+    logger->debug("loaded theme {}: {} of {} known colours, {} others"
+                  , filePath.filename().string(), known, SIZE, palette->others_.size());
+    return palette;
 }
 
-auto Theme::getControlForeground() -> juce::Colour {
-    return getColorValue("ControlForeground");
+auto ThemePalette::name(ThemeColour id) -> std::string_view {
+    return COLOUR_NAMES[static_cast<size_t>(id)];
 }
 
-auto Theme::getColorValue(const std::string& tagName) -> juce::Colour {
-    pugi::xml_node node = doc.child("Ableton").child("Theme").child(tagName.c_str());
-    if (node) {
-        std::string colorValue = node.attribute("Value").as_string();
+auto ThemePalette::find(std::string_view key) -> std::optional<ThemeColour> {
+    for (size_t i = 0; i < SIZE; ++i) {
+        if (COLOUR_NAMES[i] == key) {
+            return static_cast<ThemeColour>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+auto ThemePalette::colour(std::string_view key) const -> juce::Colour {
+    if (auto id = find(key)) {
+        return colour(*id);
+    }
+    auto it = others_.find(std::string(key));
+    return it != others_.end() ? it->second : juce::Colours::transparentBlack;
+}
 
-        // Add FF (full opacity) after the # if the string starts with #
-        if (!colorValue.empty() && colorValue[0] == '#') {
-            colorValue = "#FF" + colorValue.substr(1);  // Insert FF for full opacity
+Theme::Theme(std::filesystem::path filePath, std::optional<LiveThemeSelection> selection)
+    : filePath_(std::move(filePath))
+    , selection_(std::move(selection))
+{
+    if (selection_) {
+        if (auto selected = selection_->selected()) {
+            filePath_ = std::move(*selected);
         }
+    }
+
+    palette_ = ThemePalette::load(filePath_);
+    if (!palette_) {
+        // an empty palette, so lookups never have to check
+        palette_ = std::make_shared<ThemePalette>();
+    }
+
+    fileWatcher_ = watchFile();
+    if (selection_) {
+        selectionWatcher_ = std::make_unique<FileWatcher>(
+            std::vector<std::filesystem::path>{selection_->preferences}, [this]() { followSelection(); });
+    }
+}
+
+Theme::~Theme() {
+    // stop the watchers before anything they call into goes away; the
+    // selection watcher first, since it replaces the other one
+    selectionWatcher_.reset();
+    fileWatcher_.reset();
+}
+
+auto Theme::watchFile() -> std::unique_ptr<FileWatcher> {
+    std::lock_guard lock(fileMutex_);
+    return std::make_unique<FileWatcher>(std::vector<std::filesystem::path>{filePath_}, [this]() { reload(); });
+}
+
+auto Theme::colour(ThemeColour id) const -> juce::Colour {
+    return palette()->colour(id);
+}
+
+auto Theme::getColorValue(const std::string& tagName) const -> juce::Colour {
+    return palette()->colour(tagName);
+}
 
-        // Convert the color string to a juce::Colour object
-        return juce::Colour::fromString(colorValue.c_str());
+auto Theme::getControlTextBack() const -> juce::Colour {
+    return colour(ThemeColour::ControlTextBack);
+}
+
+auto Theme::getControlForeground() const -> juce::Colour {
+    return colour(ThemeColour::ControlForeground);
+}
+
+auto Theme::palette() const -> std::shared_ptr<const ThemePalette> {
+    return std::atomic_load(&palette_);
+}
+
+void Theme::reload() {
+    std::filesystem::path filePath;
+    {
+        std::lock_guard lock(fileMutex_);
+        filePath = filePath_;
+    }
+
+    // parsed before the swap; painting keeps the old palette until then
+    auto palette = ThemePalette::load(filePath);
+    if (!palette) {
+        logger->warn("keeping the current theme, {} could not be loaded", filePath.generic_string());
+        return;
+    }
+
+    std::atomic_store(&palette_, std::shared_ptr<const ThemePalette>(std::move(palette)));
+    logger->info("theme reloaded from {}", filePath.generic_string());
+
+    // delivered asynchronously on the message thread
+    sendChangeMessage();
+}
+
+void Theme::followSelection() {
+    // Live rewrites Preferences.cfg for all sorts of reasons
+    auto selected = selection_->selected();
+    {
+        std::lock_guard lock(fileMutex_);
+        if (!selected || *selected == filePath_) {
+            return;
+        }
+        logger->info("Live switched theme to {}", selected->filename().string());
+        filePath_ = std::move(*selected);
     }
 
-    // Return a default color if the node or value is not found
-    return juce::Colours::transparentBlack;
+    // not under fileMutex_: the old watcher may be in reload(), waiting on it
+    fileWatcher_.reset();
+    fileWatcher_ = watchFile();
+    reload();
 }
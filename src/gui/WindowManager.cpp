@@ -8,6 +8,7 @@
 #include "IWindow.h"
 
 #include "ContextMenu.h"
+#include "FocusTracker.h"
 #include "SearchBox.h"
 #include "Theme.h"
 
@@ -19,6 +20,9 @@ WindowManager::WindowManager(
                              , std::function<std::shared_ptr<Theme>()> theme
                              , std::function<std::shared_ptr<LimLookAndFeel>()> limLookAndFeel
                              , std::function<std::shared_ptr<ConfigMenu>()> configMenu
+                             , std::function<std::shared_ptr<UsageStore>()> usageStore
+                             , std::function<std::shared_ptr<CommandIndex>()> commandIndex
+                             , std::function<std::shared_ptr<FocusTracker>()> focusTracker
                              )
     : pluginManager_(std::move(pluginManager))
     , eventHandler_(std::move(eventHandler))
@@ -27,6 +31,9 @@ WindowManager::WindowManager(
     , theme_(std::move(theme))
     , limLookAndFeel_(std::move(limLookAndFeel))
     , configMenu_(std::move(configMenu))
+    , usageStore_(std::move(usageStore))
+    , commandIndex_(std::move(commandIndex))
+    , focusTracker_(std::move(focusTracker))
 {}
 
 // Factory function to create window instances dynamically based on the name
@@ -35,7 +42,7 @@ auto WindowManager::createWindowInstance(const std::string& windowName) -> std::
         // TODO
         return std::make_unique<ContextMenu>(configMenu_, actionHandler_, windowManager_);
     } else if (windowName == "SearchBox") {
-        return std::make_unique<SearchBox>(pluginManager_, eventHandler_, actionHandler_, windowManager_, theme_, limLookAndFeel_);
+        return std::make_unique<SearchBox>(commandIndex_, eventHandler_, actionHandler_, windowManager_, theme_, limLookAndFeel_, usageStore_);
     }
     return nullptr;
 }
@@ -62,7 +69,17 @@ auto WindowManager::getWindowHandle(const std::string& windowName) const -> void
     }
 }
 
-void WindowManager::openWindow(const std::string& windowName) {
+void WindowManager::prewarmWindow(const std::string& windowName) {
+    registerWindow(windowName, []() {});
+
+    auto it = windows_.find(windowName);
+    if (it != windows_.end()) {
+        logger->debug("WM prewarming {}", windowName);
+        it->second.window->prewarm();
+    }
+}
+
+void WindowManager::openWindow(const std::string& windowName, std::chrono::steady_clock::time_point requestedAt) {
     logger->debug("WM open called");
 
     auto it = windows_.find(windowName);
@@ -83,9 +100,9 @@ void WindowManager::openWindow(const std::string& windowName) {
     if (!windowStates_[windowName]) {
         // TODO: making some assumptions by setting this to true before
         // calling `open()`, but the context menu is blocking so...
-        windowStates_[windowName] = true;
+        setWindowState(windowName, true);
         logger->debug("WM calling open");
-        it->second.window->open();
+        it->second.window->openRequestedAt(requestedAt);
     }
 }
 
@@ -96,7 +113,7 @@ void WindowManager::closeWindow(const std::string& windowName) {
     if (it != windows_.end() && windowStates_[windowName]) {
         it->second.window->close();
     }
-    windowStates_[windowName] = false;
+    setWindowState(windowName, false);
     logger->debug("updated window state to close");
     logger->debug("close - Current window state for {}: {}", windowName, std::to_string(windowStates_[windowName]));
     eventHandler_()->focusLive();
@@ -118,15 +135,22 @@ void WindowManager::toggleWindow(const std::string& windowName) {
 
     if (isOpen) {
         closeWindow(windowName);
-        windowStates_[windowName] = !isOpen;
+        setWindowState(windowName, !isOpen);
     } else {
         closeWindow(windowName);
-        windowStates_[windowName] = !isOpen;
+        setWindowState(windowName, !isOpen);
     }
 
     logger->debug("toggle - current window state for {}: {}", windowName, std::to_string(windowStates_[windowName]));
 }
 
+void WindowManager::setWindowState(const std::string& windowName, bool open) {
+    windowStates_[windowName] = open;
+    if (windowName == "SearchBox") {
+        focusTracker_()->setSearchBoxOpen(open);
+    }
+}
+
 auto WindowManager::isWindowOpen(const std::string& windowName) const -> bool {
     auto it = windowStates_.find(windowName);
     return (it != windowStates_.end() && it->second);
@@ -1,33 +1,132 @@
 #ifndef CONFIG_MANAGER_H
 #define CONFIG_MANAGER_H
 
+#include <chrono>
+#include <condition_variable>
 #include <cstdlib>
 #include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <variant>
 #include <vector>
 #include "yaml-cpp/yaml.h"
 
 #include "Types.h"
 
+#include "FileWatcher.h"
+#include "KeyContext.h"
+#include "RemapTable.h"
+#include "UndoJournal.h"
+
 class KeyMapper;
 
+struct ConfigOptions {
+    // a burst of setter calls is coalesced into one write
+    std::chrono::milliseconds saveDelay = std::chrono::milliseconds(250); // NOLINT
+
+    // undo history, by number of setter calls and by rough size
+    size_t undoDepth = 200; // NOLINT
+    size_t undoBytes = size_t(1) << 20; // NOLINT
+};
+
+// what a reload replaced
+struct ConfigChanges {
+    bool init = false;
+    bool renamePlugins = false;
+    bool pluginAliases = false;
+    bool removePlugins = false;
+    bool window = false;
+    bool shortcuts = false;
+    // the sequences, the leader or the sequence timeout
+    bool sequences = false;
+
+    // remaps that are new or map to different steps, and remaps taken out,
+    // in any context
+    size_t remapsChanged = 0;
+    size_t remapsRemoved = 0;
+
+    [[nodiscard]] auto any() const -> bool {
+        return init || renamePlugins || pluginAliases || removePlugins || window || shortcuts || sequences
+               || remapsChanged != 0 || remapsRemoved != 0;
+    }
+};
+
 class ConfigManager {
 public:
-    explicit ConfigManager(std::filesystem::path configFile);
+    explicit ConfigManager(std::filesystem::path configFile, ConfigOptions options = {});
+    ~ConfigManager();
+
+    ConfigManager(const ConfigManager&) = delete;
+    auto operator=(const ConfigManager&) -> ConfigManager& = delete;
+    ConfigManager(ConfigManager&&) = delete;
+    auto operator=(ConfigManager&&) -> ConfigManager& = delete;
 
+    // Loads what the file compiled to last time from a cache beside it
+    // when the file hasn't changed since, which skips YAML entirely. If
+    // the file has changed, the old cache is loaded anyway and the file is
+    // reparsed on a background thread, which then reports the difference
+    // to onChanged listeners like any other reload. Only with no usable
+    // cache does this parse before returning.
     void loadConfig();
+
+    // Marks the config as needing a write and returns. A background thread
+    // writes a snapshot once saveDelay has passed, to a temporary file
+    // that is synced and renamed over the config, so a crash mid-write
+    // leaves the previous file intact. The setters all call this.
     void saveConfig();
 
+    // writes synchronously if anything changed since the last write
+    void flush();
+
+    // Re-reads the file whenever it changes on disk, on the watcher's
+    // thread. Sections are compared with what is loaded and only the ones
+    // that differ are replaced; unchanged remaps keep their compiled
+    // programs. A file that doesn't parse leaves the last good config.
+    void watch(FileWatchOptions options = {});
+
+    // what watch() does on a change; false, with lastError() set, when the
+    // file couldn't be read or parsed
+    auto reload() -> bool;
+    [[nodiscard]] auto lastError() const -> std::string;
+
+    // after a reload that changed something, on the thread that reloaded
+    void onChanged(std::function<void(const ConfigChanges&)> listener);
+
     auto getInitRetries() const -> int;
     void setInitRetries(int retries);
 
     auto getRemap() const -> std::unordered_map<EKeyPress, EMacro, EMacroHash>;
     void setRemap(const std::string &from, const std::string &to);
 
+    // the overrides configured for `context`, without the global remaps
+    // they're laid over; Global is getRemap()
+    auto getRemap(KeyContext context) const -> std::unordered_map<EKeyPress, EMacro, EMacroHash>;
+
+    // the compiled remaps; any thread, never null. Hold on to the table
+    // for as long as a program found in it is in use
+    auto getRemapTable() const -> RemapTablePtr;
+
+    // the app-shortcuts leader, "" if none is set
+    auto getLeader() const -> std::string;
+
+    // multi-chord sequences by their chords, space separated, with
+    // "leader" standing for the leader: "leader p s" -> plugin.Serum
+    auto getSequences() const -> std::map<std::string, EMacro>;
+
     auto getRenamePlugins() const -> std::unordered_map<std::string, std::string>;
     void setRenamePlugin(const std::string &originalName, const std::string &newName);
 
+    // alias -> plugin name, for "plugin.X" steps and menu items
+    auto getPluginAliases() const -> std::unordered_map<std::string, std::string>;
+    void setPluginAlias(const std::string &alias, const std::string &pluginName);
+
     auto getRemovePlugins() const -> std::vector<std::string>;
     void setRemovePlugin(const std::string &pluginName);
 
@@ -37,28 +136,151 @@ public:
     auto getShortcuts() const -> std::vector<std::unordered_map<std::string, std::string>>;
     void setShortcut(size_t index, const std::unordered_map<std::string, std::string> &shortcut);
 
+    // step back and forth through setter calls; reloads aren't recorded
     void undo();
+    void redo();
     auto canUndo() const -> bool;
+    auto canRedo() const -> bool;
 
 private:
-    KeyMapper* km_;
+    using RemapMap = std::unordered_map<EKeyPress, EMacro, EMacroHash>;
+    // by context other than Global; no empty entries
+    using RemapLayers = std::map<KeyContext, RemapMap>;
+    using SequenceMap = std::map<std::string, EMacro>;
+
+    static constexpr int DEFAULT_SEQUENCE_TIMEOUT_MS = static_cast<int>(SequenceTrie::DEFAULT_TIMEOUT.count());
+
+    // the sections of a config file: what parse() reads and what the
+    // writer snapshots
+    struct Sections {
+        int initRetries = 0;
+        RemapMap remap;
+        std::unordered_map<std::string, std::string> renamePlugins;
+        std::unordered_map<std::string, std::string> pluginAliases;
+        std::vector<std::string> removePlugins;
+        std::unordered_map<std::string, std::string> windowSettings;
+        std::vector<std::unordered_map<std::string, std::string>> shortcuts;
+        RemapLayers remapLayers;
+        std::string leader;
+        int sequenceTimeoutMs = DEFAULT_SEQUENCE_TIMEOUT_MS;
+        SequenceMap sequences;
+    };
+
+    // throws on values of the wrong shape; remaps that don't parse are
+    // logged and left out, as they always were
+    static auto parse(const YAML::Node& config) -> Sections;
+    static auto parseMacro(KeyMapper& km, const std::string& steps) -> EMacro;
+
+    static auto emit(const Sections& sections) -> std::string;
+
+    // the cache payload; nullopt from encode for anything that doesn't
+    // round-trip, which then just isn't cached
+    static auto encode(const Sections& sections) -> std::optional<std::string>;
+    static auto decode(std::string_view payload) -> std::optional<Sections>;
+
+    // swaps in the sections that differ from the current ones
+    auto apply(Sections sections) -> ConfigChanges;
+
+    using StringMap = std::unordered_map<std::string, std::string>;
+
+    // What one setter call did, with what it replaced. Undo applies the
+    // `before` side, redo the `after` side; neither touches YAML.
+    struct RetriesEdit {
+        int before;
+        int after;
+    };
+    struct RemapEdit {
+        EKeyPress key;
+        std::optional<EMacro> before;
+        std::optional<EMacro> after;
+    };
+    // rename-plugins, plugin-aliases or window, picked by `section`
+    struct StringEdit {
+        StringMap ConfigManager::* section;
+        std::string key;
+        std::optional<std::string> before;
+        std::optional<std::string> after;
+    };
+    // setRemovePlugin appends
+    struct RemovePluginEdit {
+        std::string plugin;
+    };
+    struct ShortcutEdit {
+        size_t index;
+        StringMap before;
+        StringMap after;
+    };
+    using ConfigEdit = std::variant<RetriesEdit, RemapEdit, StringEdit, RemovePluginEdit, ShortcutEdit>;
 
-    void applyConfig(const YAML::Node& config);
+    [[nodiscard]] static auto editBytes(const ConfigEdit& edit) -> size_t;
 
-    void processRemap(const std::string &from, const std::string &to);
+    // with mutex_ held
+    [[nodiscard]] auto snapshotLocked() const -> Sections;
+    void setStringLocked(StringMap ConfigManager::* section, const std::string& key, const std::string& value);
+    void putRemapLocked(const EKeyPress& key, const std::optional<EMacro>& macro);
+    void recordLocked(ConfigEdit edit);
+    void replayLocked(const ConfigEdit& edit, bool reverse);
+
+    // the YAML and the sections it was emitted from, for the cache
+    void write(const std::string& yaml, const Sections& sections);
+    // with writeMutex_ held, so writers don't share the temporary file
+    void writeCacheLocked(uint64_t sourceHash, const Sections& sections);
+    void saveLoop();
+
+    std::unique_ptr<KeyMapper> km_;
+
+    // swaps a table of the current programs_, layerPrograms_ and
+    // sequenceTrie_ in for readers
+    void publishRemaps();
+    // with mutex_ held, after the sequences, leader or timeout change
+    void compileSequencesLocked();
 
     std::filesystem::path configFile_;
-    YAML::Node config_;
+    std::filesystem::path cacheFile_;
+    ConfigOptions options_;
 
     // Configuration options
     int initRetries_;
-    std::unordered_map<EKeyPress, EMacro, EMacroHash> remap_;
-    std::unordered_map<std::string, std::string> renamePlugins_;
+    RemapMap remap_;
+    RemapTable::Programs programs_;
+    RemapLayers remapLayers_;
+    RemapTable::Layers layerPrograms_;
+    std::string leader_;
+    int sequenceTimeoutMs_ = DEFAULT_SEQUENCE_TIMEOUT_MS;
+    SequenceMap sequences_;
+    SequenceTriePtr sequenceTrie_;
+
+    // written with std::atomic_store, read with std::atomic_load
+    RemapTablePtr remapTable_;
+    StringMap renamePlugins_;
+    StringMap pluginAliases_;
     std::vector<std::string> removePlugins_;
-    std::unordered_map<std::string, std::string> windowSettings_;
-    std::vector<std::unordered_map<std::string, std::string>> shortcuts_;
+    StringMap windowSettings_;
+    std::vector<StringMap> shortcuts_;
+
+    UndoJournal<ConfigEdit> journal_;
+
+    // guards everything above but remapTable_; the reload thread and
+    // the setters both write
+    mutable std::mutex mutex_;
+    std::condition_variable saveCv_;
+    std::string lastError_;
+    bool dirty_ = false;
+    bool stopping_ = false;
+
+    // serialises writes and remembers the last one, so the watcher can
+    // tell our own writes from edits
+    std::mutex writeMutex_;
+    std::string written_;
+
+    std::thread saveThread_;
+    // reparses a file that changed since its cache was written
+    std::thread refreshThread_;
+
+    std::mutex listenersMutex_;
+    std::vector<std::function<void(const ConfigChanges&)>> listeners_;
 
-    std::vector<YAML::Node> undoStack_;
+    std::unique_ptr<FileWatcher> watcher_;
 };
 
 #endif // CONFIG_MANAGER_H
@@ -1,14 +1,31 @@
 #pragma once
 
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 #include <yaml-cpp/yaml.h>
 
-class MenuItem;
+#include "FileWatcher.h"
+#include "IWindow.h"
 
 class ConfigMenu {
 public:
     explicit ConfigMenu(const std::filesystem::path& configFile);
+    ~ConfigMenu();
 
+    ConfigMenu(const ConfigMenu&) = delete;
+    auto operator=(const ConfigMenu&) -> ConfigMenu& = delete;
+    ConfigMenu(ConfigMenu&&) = delete;
+    auto operator=(ConfigMenu&&) -> ConfigMenu& = delete;
+
+    // from the cache beside the menu file when the file hasn't changed;
+    // otherwise as ConfigManager::loadConfig does
     void loadConfig();
     void saveConfig();
 
@@ -19,19 +36,42 @@ public:
 
     auto getMenuData() -> std::vector<MenuItem>;
 
+    // re-reads the menu file when it changes on disk; a file that doesn't
+    // parse keeps the menu that was loaded
+    void watch(FileWatchOptions options = {});
+    auto reload() -> bool;
+
+    // after a reload that changed the menu, on the thread that reloaded
+    void onChanged(std::function<void()> listener);
+
 private:
     std::vector<MenuItem> parseMenuItems(const YAML::Node& node);
     void saveToYAML(const std::vector<MenuItem>& menuData, const std::filesystem::path& filePath);
     void outputItemToYAML(YAML::Emitter& out, const MenuItem& item);
     void applyConfig(const YAML::Node& config);
 
+    static auto encode(const std::vector<MenuItem>& menu) -> std::string;
+    static auto decode(std::string_view payload) -> std::optional<std::vector<MenuItem>>;
+    void writeCache(uint64_t sourceHash, const std::vector<MenuItem>& menu);
+
+    mutable std::mutex mutex_;
     std::vector<MenuItem> menuData_;
     std::filesystem::path configFile_;
     std::filesystem::path configMenuFilePath_;
+    std::filesystem::path cacheFilePath_;
     std::filesystem::path LESConfigFilePath_;
 
     YAML::Node config_;
 
     std::vector<YAML::Node> undoStack_;
 
+    std::mutex listenersMutex_;
+    std::vector<std::function<void()>> listeners_;
+
+    // the refresh and the watcher can both write the cache
+    std::mutex cacheMutex_;
+    // reparses a menu file that changed since its cache was written
+    std::thread refreshThread_;
+
+    std::unique_ptr<FileWatcher> watcher_;
 };
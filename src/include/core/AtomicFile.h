@@ -0,0 +1,13 @@
+#pragma once
+
+#include <filesystem>
+#include <initializer_list>
+#include <string_view>
+#include <system_error>
+
+// Writes `chunks` back to back to a file beside `path`, syncs it and
+// renames it over `path`, so a crash mid-write leaves the previous file
+// intact and readers never see half of one. When `path` is a symlink its
+// target is replaced, not the link. The directory has to exist.
+auto writeFileAtomically(const std::filesystem::path& path
+                         , std::initializer_list<std::string_view> chunks) -> std::error_code;
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Binary files holding what a text file compiles to, stamped with a hash
+// of that text. Startup maps the cache in and skips parsing when the hash
+// still matches; anything else about the file (missing, truncated, older
+// format, other kind) reads as a miss and the text is parsed as usual.
+//
+// The payload is whatever the owner encodes with CacheWriter; it's only
+// ever read back by the same build, so it's in native byte order.
+namespace CacheFile {
+    // what a cache holds, so one can't be read back as another
+    enum Kind : uint32_t {
+        ConfigKind = 1
+        , MenuKind = 2
+    };
+
+    // FNV-1a over the source text
+    [[nodiscard]] auto hash(std::string_view text) -> uint64_t;
+
+    // maps `path` and hands `ingest` the payload when the header is ours
+    // and of `kind`; the view is only valid during the call. False on a
+    // miss, or when ingest returns false.
+    auto read(const std::filesystem::path& path, Kind kind
+              , const std::function<bool(uint64_t sourceHash, std::string_view payload)>& ingest) -> bool;
+
+    // beside the real file and renamed over it, so readers never see half
+    auto write(const std::filesystem::path& path, Kind kind, uint64_t sourceHash, std::string_view payload) -> bool;
+}
+
+class CacheWriter {
+public:
+    void u8(uint8_t value) { raw(&value, sizeof(value)); }
+    void u16(uint16_t value) { raw(&value, sizeof(value)); }
+    void u32(uint32_t value) { raw(&value, sizeof(value)); }
+    void i32(int32_t value) { raw(&value, sizeof(value)); }
+
+    void str(std::string_view value) {
+        u32(static_cast<uint32_t>(value.size()));
+        bytes_.append(value);
+    }
+
+    [[nodiscard]] auto bytes() const -> const std::string& { return bytes_; }
+
+private:
+    void raw(const void* data, size_t size) { bytes_.append(static_cast<const char*>(data), size); }
+
+    std::string bytes_;
+};
+
+// Reads what CacheWriter wrote. Running off the end, or a length that
+// doesn't fit, makes every later read return zero and ok() false, so a
+// decoder can read straight through and check once at the end.
+class CacheReader {
+public:
+    explicit CacheReader(std::string_view bytes) : bytes_(bytes) {}
+
+    auto u8() -> uint8_t { return scalar<uint8_t>(); }
+    auto u16() -> uint16_t { return scalar<uint16_t>(); }
+    auto u32() -> uint32_t { return scalar<uint32_t>(); }
+    auto i32() -> int32_t { return scalar<int32_t>(); }
+
+    auto str() -> std::string {
+        const uint32_t size = u32();
+        if (!ok_ || size > bytes_.size() - at_) {
+            ok_ = false;
+            return {};
+        }
+        std::string value(bytes_.substr(at_, size));
+        at_ += size;
+        return value;
+    }
+
+    // a count of items at least `minItemSize` bytes each; zero, and not
+    // ok(), if that many can't be left in the payload
+    auto count(size_t minItemSize) -> uint32_t {
+        const uint32_t n = u32();
+        if (!ok_ || static_cast<uint64_t>(n) * minItemSize > bytes_.size() - at_) {
+            ok_ = false;
+            return 0;
+        }
+        return n;
+    }
+
+    // everything read so far was there, and nothing is left over
+    [[nodiscard]] auto ok() const -> bool { return ok_ && at_ == bytes_.size(); }
+
+private:
+    template <typename T>
+    auto scalar() -> T {
+        T value{};
+        if (!ok_ || sizeof(T) > bytes_.size() - at_) {
+            ok_ = false;
+            return value;
+        }
+        std::memcpy(&value, bytes_.data() + at_, sizeof(T));
+        at_ += sizeof(T);
+        return value;
+    }
+
+    std::string_view bytes_;
+    size_t at_ = 0;
+    bool ok_ = true;
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "LatencyHistogram.h"
+
+// The queues work can be posted to. Pool runs its jobs on any of its
+// workers, side by side; the rest run theirs one at a time, in the order
+// posted, on a thread of their own, so operations on one resource never
+// overlap.
+#define LIM_EXECUTOR_QUEUES(X) \
+    X(Pool, "pool") \
+    X(Windows, "windows") \
+    X(Ipc, "ipc")
+
+enum class ExecutorQueue : uint8_t {
+#define LIM_EXECUTOR_QUEUE_ID(id, name) id,
+    LIM_EXECUTOR_QUEUES(LIM_EXECUTOR_QUEUE_ID)
+#undef LIM_EXECUTOR_QUEUE_ID
+};
+
+struct ExecutorOptions {
+    // the pool's; each serial queue has its own thread besides
+    size_t workers = 4;
+    // jobs waiting per queue; posting past it drops the job
+    size_t maxQueued = 64;
+};
+
+struct ExecutorStats {
+    uint64_t posted = 0;
+    uint64_t completed = 0;
+    // threw; counted in completed too
+    uint64_t failed = 0;
+    // the queue was full
+    uint64_t dropped = 0;
+
+    // waiting plus running, now and at most
+    size_t depth = 0;
+    size_t maxDepth = 0;
+};
+
+// A fixed set of worker threads in place of a thread per action, so a
+// held-down hotkey queues work instead of spawning threads. The serial
+// queues don't share the pool's workers, so a pool job can wait on work
+// it put on one (a macro waiting on its plugin load) however busy the
+// pool is. A job that throws is logged and counted; it doesn't take the
+// app down or stop the queue it was on.
+class Executor {
+public:
+    using Job = std::function<void()>;
+
+    static constexpr std::array QUEUE_NAMES = {
+#define LIM_EXECUTOR_QUEUE_NAME(id, name) std::string_view(name),
+        LIM_EXECUTOR_QUEUES(LIM_EXECUTOR_QUEUE_NAME)
+#undef LIM_EXECUTOR_QUEUE_NAME
+    };
+
+    explicit Executor(ExecutorOptions options = {});
+    // stop()s
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    auto operator=(const Executor&) -> Executor& = delete;
+    Executor(Executor&&) = delete;
+    auto operator=(Executor&&) -> Executor& = delete;
+
+    // `name` is what logs and failures call the job. False, and logged,
+    // if the queue is full or the executor has stopped
+    auto post(ExecutorQueue queue, std::string name, Job job) -> bool;
+
+    // post() with a future that's ready once the job has run. It throws
+    // what the job threw, or broken_promise if the job was dropped
+    auto submit(ExecutorQueue queue, std::string name, Job job) -> std::future<void>;
+
+    // blocks until every queue is empty and nothing is running
+    void drain();
+
+    // runs what's already queued, then joins the workers; later posts
+    // are refused. Logs each queue's stats
+    void stop();
+
+    [[nodiscard]] auto stats(ExecutorQueue queue) const -> ExecutorStats;
+
+    // from post to start, and from start to finish
+    [[nodiscard]] auto waitTime(ExecutorQueue queue) const -> const LatencyHistogram&;
+    [[nodiscard]] auto runTime(ExecutorQueue queue) const -> const LatencyHistogram&;
+
+private:
+    struct Pending {
+        std::string name;
+        Job job;
+        std::chrono::steady_clock::time_point postedAt;
+    };
+
+    struct Queue {
+        explicit Queue(std::string_view name);
+
+        std::string_view name;
+        bool serial;
+        std::deque<Pending> jobs;
+        // its workers wait on this
+        std::condition_variable ready;
+        size_t running = 0;
+        ExecutorStats stats;
+        LatencyHistogram waitTime;
+        LatencyHistogram runTime;
+    };
+
+    static constexpr size_t QUEUE_COUNT = QUEUE_NAMES.size();
+
+    // runs `q`'s jobs until stopped and it's empty
+    void workerLoop(Queue& q);
+
+    [[nodiscard]] auto idleLocked() const -> bool;
+
+    auto queue(ExecutorQueue id) -> Queue& { return queues_[static_cast<size_t>(id)]; }
+    [[nodiscard]] auto queue(ExecutorQueue id) const -> const Queue& { return queues_[static_cast<size_t>(id)]; }
+
+    ExecutorOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable idle_;
+    std::array<Queue, QUEUE_COUNT> queues_;
+    bool stopping_ = false;
+
+    std::vector<std::thread> workers_;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <condition_variable>
+#include <mutex>
+#endif
+
+struct FileWatchOptions {
+    // editors and Live itself save in several steps; wait for them to settle
+    std::chrono::milliseconds debounce = std::chrono::milliseconds(150); // NOLINT
+
+    // how often files are re-checked when no change notification arrives;
+    // the only mechanism where the platform has none we use
+    std::chrono::milliseconds pollInterval = std::chrono::milliseconds(1000); // NOLINT
+};
+
+// Calls back when any of a set of files changes on disk.
+//
+// Change notifications (kqueue on macOS, inotify on Linux) only wake the
+// watcher up; whether something changed is decided by comparing each
+// file's size and modification time against what was seen last. That way
+// atomic saves (write elsewhere, rename over) and files that don't exist
+// yet behave the same as in-place writes, and platforms without a
+// notification API fall back to polling with the same logic.
+//
+// The callback runs on the watcher's own thread, once per burst of changes.
+class FileWatcher {
+public:
+    using Callback = std::function<void()>;
+
+    FileWatcher(std::vector<std::filesystem::path> files, Callback onChange, FileWatchOptions options = {});
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    auto operator=(const FileWatcher&) -> FileWatcher& = delete;
+    FileWatcher(FileWatcher&&) = delete;
+    auto operator=(FileWatcher&&) -> FileWatcher& = delete;
+
+    // how many times the callback has been invoked
+    [[nodiscard]] auto changes() const -> uint64_t;
+
+private:
+    struct Stamp {
+        bool exists = false;
+        std::filesystem::file_time_type modified;
+        uintmax_t size = 0;
+
+        auto operator==(const Stamp&) const -> bool = default;
+    };
+
+    [[nodiscard]] auto stamps() const -> std::vector<Stamp>;
+
+    void run(std::vector<Stamp> seen);
+
+    void openNotifications();
+    void closeNotifications();
+
+    // blocks until a notification, the destructor, or the timeout
+    void waitForEvent(std::chrono::milliseconds timeout);
+    void wake();
+
+    std::vector<std::filesystem::path> files_;
+    Callback onChange_;
+    FileWatchOptions options_;
+
+    std::atomic<bool> stopping_ = false;
+    std::atomic<uint64_t> changes_ = 0;
+
+#ifdef __APPLE__
+    int queue_ = -1;
+    std::vector<int> watchedFds_;
+#elif defined(__linux__)
+    int inotify_ = -1;
+#endif
+
+#ifndef _WIN32
+    int wakePipe_[2] = {-1, -1};
+#else
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCv_;
+#endif
+
+    std::thread thread_;
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "fmt/format.h"
+
+// Lock-free log2-bucketed latency distribution. Recording is a couple
+// of relaxed atomic increments, so it is safe to call from hot paths
+// and from any thread. Bucket i holds samples in [2^(i-1), 2^i) us.
+class LatencyHistogram {
+public:
+    explicit LatencyHistogram(std::string name)
+        : name_(std::move(name))
+    {}
+
+    void record(std::chrono::nanoseconds elapsed) {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        auto value = static_cast<uint64_t>(us < 0 ? 0 : us);
+
+        size_t bucket = 0;
+        while (bucket + 1 < BUCKETS && (value >> bucket) != 0) {
+            ++bucket;
+        }
+
+        buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        totalUs_.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t seen = maxUs_.load(std::memory_order_relaxed);
+        while (value > seen && !maxUs_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+    }
+
+    void recordSince(std::chrono::steady_clock::time_point start) {
+        record(std::chrono::steady_clock::now() - start);
+    }
+
+    [[nodiscard]] auto count() const -> uint64_t {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    // upper bound of the bucket holding the given percentile (0..1), in us
+    [[nodiscard]] auto percentileUs(double p) const -> uint64_t {
+        const uint64_t total = count();
+        if (total == 0) {
+            return 0;
+        }
+
+        auto target = static_cast<uint64_t>(p * static_cast<double>(total));
+        if (target >= total) {
+            target = total - 1;
+        }
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen > target) {
+                return i == 0 ? 0 : (uint64_t{1} << i) - 1;
+            }
+        }
+        return maxUs_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto summary() const -> std::string {
+        const uint64_t total = count();
+        if (total == 0) {
+            return fmt::format("{}: no samples", name_);
+        }
+
+        return fmt::format("{}: n={} mean={}us p50<={}us p90<={}us p99<={}us max={}us"
+            , name_
+            , total
+            , totalUs_.load(std::memory_order_relaxed) / total
+            , percentileUs(0.50) // NOLINT
+            , percentileUs(0.90) // NOLINT
+            , percentileUs(0.99) // NOLINT
+            , maxUs_.load(std::memory_order_relaxed)
+        );
+    }
+
+    void reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        totalUs_.store(0, std::memory_order_relaxed);
+        maxUs_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t BUCKETS = 32;
+
+    std::string name_;
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> totalUs_{0};
+    std::atomic<uint64_t> maxUs_{0};
+};
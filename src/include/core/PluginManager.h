@@ -1,10 +1,12 @@
 #pragma once
 
 #include <functional>
+#include <mutex>
 #include <vector>
 #include <memory>
 
 #include "IPluginManager.h"
+#include "PluginCatalog.h"
 #include "Types.h"
 
 class IIPCCore;
@@ -26,10 +28,26 @@ public:
     auto operator=(PluginManager&&) -> PluginManager& = delete;
 
     [[nodiscard]] auto getPlugins() const -> const std::vector<Plugin>& override;
+    [[nodiscard]] auto getCatalog() const -> PluginCatalogPtr override;
     void refreshPlugins() override;
+    void setAliases(std::unordered_map<std::string, std::string> aliases) override;
+    void onCatalogChanged(std::function<void()> listener) override;
 
 private:
+    void publish(std::vector<Plugin> plugins);
+
     std::function<std::shared_ptr<IIPCCore>()> ipc_;
     std::function<std::shared_ptr<ResponseParser>()> responseParser_;
     std::vector<Plugin> plugins_;
+
+    // swapped atomically so search threads can pin a consistent snapshot
+    PluginCatalogPtr catalog_;
+    uint64_t catalogVersion_ = 0;
+
+    // also serialises catalog builds, so versions go out in order
+    std::mutex aliasesMutex_;
+    PluginAliases aliases_;
+
+    std::mutex listenersMutex_;
+    std::vector<std::function<void()>> catalogListeners_;
 };
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+// A hierarchical timer wheel: LEVELS rings of SLOTS lists, each level's
+// slots a SLOTS times coarser span of ticks than the one below. A timer
+// sits in the finest level that can tell its tick apart from now, and
+// drops a level each time the clock reaches the start of its slot, so
+// scheduling, cancelling and firing a timer are O(1) however many are
+// pending.
+//
+// Timers live in a slab and are linked into their slot in place, so a
+// steady stream of them doesn't allocate once the slab has grown. It
+// keeps no clock and takes no lock: the owner says what tick it is.
+class TimerWheel {
+public:
+    using Tick = uint64_t;
+
+    static constexpr size_t SLOT_BITS = 6;
+    static constexpr size_t SLOTS = size_t{1} << SLOT_BITS;
+    static constexpr size_t LEVELS = 4;
+    // timers further out than this are held at the top level and placed
+    // again as the clock gets there; 2^24 ticks, hours at a tick a ms
+    static constexpr Tick SPAN = Tick{1} << (SLOT_BITS * LEVELS);
+
+    // names a scheduled timer. One that has fired or been cancelled
+    // doesn't match the slot's next occupant
+    struct Handle {
+        uint32_t index = NONE;
+        uint32_t generation = 0;
+
+        [[nodiscard]] auto valid() const -> bool { return index != NONE; }
+    };
+
+    explicit TimerWheel(Tick now = 0);
+
+    // `token` is handed back when it fires. A tick that's already passed
+    // fires on the next one
+    auto schedule(Tick due, uint64_t token) -> Handle;
+
+    // false if it already fired or was cancelled
+    auto cancel(Handle handle) -> bool;
+
+    // moves the clock up to `to`, calling fire(token) for each timer that
+    // comes due, in tick order. Each is off the wheel before it's fired,
+    // so `fire` may schedule or cancel
+    template <typename Fire>
+    void advance(Tick to, Fire&& fire) {
+        while (now_ < to) {
+            if (size_ == 0) {
+                now_ = to;
+                return;
+            }
+            ++now_;
+            cascade();
+
+            uint32_t& head = heads_[now_ & (SLOTS - 1)];
+            while (head != NONE) {
+                const uint32_t index = head;
+                unlink(index);
+                const uint64_t token = nodes_[index].token;
+                release(index);
+                fire(token);
+            }
+        }
+    }
+
+    // the next tick advance() has work on: a timer's, or a slot boundary
+    // where one moves down a level. nullopt when nothing is scheduled
+    [[nodiscard]] auto nextWake() const -> std::optional<Tick>;
+
+    [[nodiscard]] auto now() const -> Tick { return now_; }
+    [[nodiscard]] auto size() const -> size_t { return size_; }
+
+private:
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    struct Node {
+        Tick due = 0;
+        uint64_t token = 0;
+        uint32_t prev = NONE;
+        uint32_t next = NONE;
+        uint32_t generation = 0;
+        // index into heads_, or NONE when not on the wheel
+        uint32_t slot = NONE;
+    };
+
+    // links `index` into the slot its due tick belongs in from now_
+    void place(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+
+    // at a slot boundary, moves the timers in the slots just reached at
+    // the coarser levels down to where they now belong
+    void cascade();
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_;
+    std::array<uint32_t, LEVELS * SLOTS> heads_;
+    Tick now_;
+    size_t size_ = 0;
+};
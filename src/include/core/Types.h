@@ -1,10 +1,13 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <utility>
 #include <variant>
@@ -29,19 +32,58 @@ struct ERect {
 };
 
 // Actions
+// a remap step or menu entry names one of these, optionally followed
+// by ".argument"; compiled macros refer to them by ActionId. Each is
+// X(identifier, spelling) since not every spelling is an identifier.
+// Cached remaps store the ActionId, so new ones go on the end
+#define LIM_NAMED_ACTIONS(X) \
+    X(load_item,          "load_item") \
+    X(plugin,             "plugin") \
+    X(searchbox,          "searchbox") \
+    X(closeFocusedPlugin, "closeFocusedPlugin") \
+    X(closeAllPlugins,    "closeAllPlugins") \
+    X(openAllPlugins,     "openAllPlugins") \
+    X(tilePluginWindows,  "tilePluginWindows") \
+    X(delay,              "delay") \
+    X(wait,               "wait") \
+    X(write_request,      "write-request")
+
+enum class ActionId : uint16_t {
+#define LIM_ACTION_ID(id, spelling) id,
+    LIM_NAMED_ACTIONS(LIM_ACTION_ID)
+#undef LIM_ACTION_ID
+};
+
 struct NamedActions {
+    static constexpr std::array NAMES = {
+#define LIM_ACTION_NAME(id, spelling) std::string_view(spelling),
+        LIM_NAMED_ACTIONS(LIM_ACTION_NAME)
+#undef LIM_ACTION_NAME
+    };
+
     static auto get() -> const std::unordered_set<std::string>& {
-        static const std::unordered_set<std::string> namedActions = {
-            "load_item"
-            , "plugin"
-            , "searchbox"
-            , "closeFocusedPlugin"
-            , "closeAllPlugins"
-            , "openAllPlugins"
-            , "tilePluginWindows"
-        };
+        static const std::unordered_set<std::string> namedActions = []() {
+            std::unordered_set<std::string> names;
+            for (auto name : NAMES) {
+                names.emplace(name);
+            }
+            return names;
+        }();
         return namedActions;
     }
+
+    static auto find(std::string_view name) -> std::optional<ActionId> {
+        for (size_t i = 0; i < NAMES.size(); ++i) {
+            if (NAMES[i] == name) {
+                return static_cast<ActionId>(i);
+            }
+        }
+        return std::nullopt;
+    }
+
+    static auto name(ActionId id) -> std::string_view {
+        return NAMES[static_cast<size_t>(id)];
+    }
 };
 
 struct Action {
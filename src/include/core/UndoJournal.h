@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <utility>
+#include <vector>
+
+// Bounded undo/redo history of edits that carry what they replaced, so
+// stepping back or forward costs as much as the edit itself rather than
+// a copy of whatever it was made to.
+//
+// The history is capped both by how many edits it holds and by roughly
+// how much memory they take; the caller says what each edit costs when
+// recording it. The oldest edits are forgotten first.
+template <typename Edit>
+class UndoJournal {
+public:
+    UndoJournal(size_t maxDepth, size_t maxBytes)
+        : maxDepth_(maxDepth)
+        , maxBytes_(maxBytes)
+    {}
+
+    // drops whatever could have been redone; false if the edit alone is
+    // over the budget and so wasn't kept
+    auto record(Edit edit, size_t bytes) -> bool {
+        for (const auto& entry : undone_) {
+            bytes_ -= entry.bytes;
+        }
+        undone_.clear();
+
+        if (maxDepth_ == 0 || bytes > maxBytes_) {
+            done_.clear();
+            bytes_ = 0;
+            return false;
+        }
+
+        done_.push_back({std::move(edit), bytes});
+        bytes_ += bytes;
+        while (done_.size() > maxDepth_ || bytes_ > maxBytes_) {
+            bytes_ -= done_.front().bytes;
+            done_.pop_front();
+        }
+        return true;
+    }
+
+    // the edit to reverse, now redoable; null if there is none. Valid
+    // until the journal is next changed
+    auto undo() -> const Edit* {
+        if (done_.empty()) {
+            return nullptr;
+        }
+        undone_.push_back(std::move(done_.back()));
+        done_.pop_back();
+        return &undone_.back().edit;
+    }
+
+    // the edit to make again, now undoable; null if there is none
+    auto redo() -> const Edit* {
+        if (undone_.empty()) {
+            return nullptr;
+        }
+        done_.push_back(std::move(undone_.back()));
+        undone_.pop_back();
+        return &done_.back().edit;
+    }
+
+    [[nodiscard]] auto canUndo() const -> bool { return !done_.empty(); }
+    [[nodiscard]] auto canRedo() const -> bool { return !undone_.empty(); }
+
+    [[nodiscard]] auto depth() const -> size_t { return done_.size(); }
+    [[nodiscard]] auto bytes() const -> size_t { return bytes_; }
+
+    void clear() {
+        done_.clear();
+        undone_.clear();
+        bytes_ = 0;
+    }
+
+private:
+    struct Entry {
+        Edit edit;
+        size_t bytes;
+    };
+
+    size_t maxDepth_;
+    size_t maxBytes_;
+
+    std::deque<Entry> done_;
+    std::vector<Entry> undone_;
+
+    // of done_ and undone_ together
+    size_t bytes_ = 0;
+};
@@ -5,19 +5,39 @@
 #import <CoreGraphics/CoreGraphics.h>
 #endif
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #include "Types.h"
 #include "IActionHandler.h"
+#include "IIPCCore.h"
+#include "KeyChord.h"
+#include "KeyContext.h"
+#include "KeySequencer.h"
+#include "LatencyHistogram.h"
+#include "PacingController.h"
+#include "RemapTable.h"
+#include "WaitCondition.h"
 
 class IEventHandler;
-class IIPCCore;
 class ILiveInterface;
 class IPluginManager;
 
 class ConfigManager;
+class Executor;
+class FocusTracker;
 class KeyMapper;
+class MacroProgram;
 class ResponseParser;
+class UsageStore;
+class WaitScheduler;
 class WindowManager;
 
 class ActionHandler : public IActionHandler {
@@ -28,25 +48,33 @@ public:
                 , std::function<std::shared_ptr<IIPCCore>()>       ipc
                 , std::function<std::shared_ptr<IEventHandler>()>   eventHandler
                 , std::function<std::shared_ptr<ILiveInterface>()> liveInterface
+                , std::function<std::shared_ptr<UsageStore>()>     usageStore
+                , std::function<std::shared_ptr<FocusTracker>()>   focusTracker
+                , std::function<std::shared_ptr<Executor>()>       executor
+                , std::function<std::shared_ptr<WaitScheduler>()>  waits
     );
 
     ~ActionHandler() override;
 
-    ActionHandler(const ActionHandler &) = default;
+    ActionHandler(const ActionHandler &) = delete;
     ActionHandler(ActionHandler &&) = delete;
-    auto operator=(const ActionHandler &) -> ActionHandler & = default;
+    auto operator=(const ActionHandler &) -> ActionHandler & = delete;
     auto operator=(ActionHandler &&) -> ActionHandler & = delete;
 
     void handleAction(std::string) override;
 
-    // returns if the event should be blocking
-    auto handleKeyEvent(EKeyPress pressedKey) -> bool override;
+    // returns if the event should be blocking; remaps are looked up in
+    // whatever context the focus tracker last saw. Keys that start or
+    // continue a sequence are held back until it completes or falls apart
+    auto handleKeyEvent(KeyChord pressed) -> bool override;
 
     void handleDoubleRightClick() override;
 
     auto loadItem(int itemIndex) -> bool override;
     auto loadItemByName(const std::string &itemName) -> bool override;
 
+    [[nodiscard]] auto commandNames() const -> std::vector<std::string> override;
+
 private:
     std::function<std::shared_ptr<IIPCCore>()> ipc_;
     std::function<std::shared_ptr<IPluginManager>()> pluginManager_;
@@ -54,14 +82,79 @@ private:
     std::function<std::shared_ptr<WindowManager>()> windowManager_;
     std::function<std::shared_ptr<IEventHandler>()> eventHandler_;
     std::function<std::shared_ptr<ILiveInterface>()> liveInterface_;
-
-    using ActionHandlerFunction = std::function<void(const std::optional<std::string>& args)>;
+    std::function<std::shared_ptr<UsageStore>()> usageStore_;
+    std::function<std::shared_ptr<FocusTracker>()> focusTracker_;
+    // where actions that block (window moves, IPC round trips) run
+    std::function<std::shared_ptr<Executor>()> executor_;
+    // where wait steps wait
+    std::function<std::shared_ptr<WaitScheduler>()> waits_;
+
+    // the future is ready once the action is done, so the macro step
+    // after it can go; invalid if it's done on return
+    using ActionHandlerFunction = std::function<std::future<void>(const std::optional<std::string>& args)>;
     std::unordered_map<std::string, ActionHandlerFunction> actionMap;
 
+    // actionMap by ActionId, for compiled macros
+    std::array<ActionHandlerFunction, NamedActions::NAMES.size()> actionTable_;
+
+    // what MacroProgram::run drives
+    struct MacroRunner;
+
     void getMostRecentFloatingWindowDelayed(std::function<void(int)> callback);
 
     void initializeActionMap();
-    void executeMacro(const EMacro& macro);
+    void executeMacro(const MacroProgram& program);
+
+    // through MacroPipeline on the executor's pool if its steps wait on
+    // each other; `owner` keeps the program alive
+    void runMacro(const MacroProgram& program, std::shared_ptr<const void> owner);
+
+    // loadItemByName, calling `onLoaded` when Live has answered
+    auto loadPlugin(const std::string& itemName, IIPCCore::ResponseCallback onLoaded) -> bool;
+
+    // `then`, counted in ipcInFlight_ until it's called or dropped; the
+    // last one out signals WaitCondition::Ipc
+    auto trackIpc(IIPCCore::ResponseCallback then) -> IIPCCore::ResponseCallback;
+
+    // a wait step for the macro run `group`. `since` is the condition's
+    // signals() count when the step before it went out
+    auto waitFor(WaitCondition condition, uint32_t ms, uint64_t group
+                 , std::optional<uint64_t> since) -> std::future<void>;
+
+    // replays, then runs, what a sequencer step asks for
+    void runSequenceStep(const KeySequencer::Step& step, const SequenceTriePtr& trie
+                         , const RemapTablePtr& remaps, KeyContext context);
+
+    // a key a sequence held back, handled as if it had just been pressed
+    void replayKey(KeyChord chord, const RemapTablePtr& remaps, KeyContext context);
+
+    // ends sequences nobody finishes once their timeout passes
+    void sequenceTimerLoop();
+
+    // press() runs on the event tap's thread, expire() on sequenceTimer_
+    std::mutex sequenceMutex_;
+    std::condition_variable sequenceWake_;
+    KeySequencer sequencer_;
+    bool stopping_ = false;
+    std::thread sequenceTimer_;
+
+    // first step issued to last step done, for macros run as a pipeline
+    LatencyHistogram macroLatency_;
+
+    // how far apart pipelined macros send keys and actions
+    PacingController pacer_;
+
+    // pipelined macros run so far; each one's waits are a group of this
+    // number, and starting it cancels the waits of the ones before
+    std::atomic<uint64_t> macroRuns_{0};
+
+    // requests to Live not yet answered
+    std::atomic<int> ipcInFlight_{0};
 
     auto closeWindows() -> bool;
+
+    // runs `work` on the message thread, straight away if that's this
+    // one. Pipelined macros run their steps on the executor, and windows
+    // can only be touched from there. Ready once `work` has run
+    auto onMessageThread(std::function<void()> work) -> std::future<void>;
 };
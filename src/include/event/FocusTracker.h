@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include "KeyContext.h"
+
+// What has focus, kept up to date by whoever observes it (accessibility
+// notifications on macOS, the window manager for our own windows), so the
+// key handler reads one atomic per key press instead of asking the OS.
+//
+// Each observer reports its own piece; context() is the most specific
+// one that holds:
+//   SearchBox open > text field focused > plugin window focused > Live's view
+class FocusTracker {
+public:
+    FocusTracker() = default;
+
+    FocusTracker(const FocusTracker&) = delete;
+    auto operator=(const FocusTracker&) -> FocusTracker& = delete;
+    FocusTracker(FocusTracker&&) = delete;
+    auto operator=(FocusTracker&&) -> FocusTracker& = delete;
+
+    // any thread, never blocks
+    [[nodiscard]] auto context() const -> KeyContext {
+        return context_.load(std::memory_order_acquire);
+    }
+
+    // Arrangement, Session or Browser; Global when it isn't known
+    void setLiveView(KeyContext view) {
+        std::lock_guard lock(mutex_);
+        liveView_ = view;
+        publishLocked();
+    }
+
+    void setPluginWindowFocused(bool focused) {
+        std::lock_guard lock(mutex_);
+        pluginWindow_ = focused;
+        publishLocked();
+    }
+
+    void setTextFieldFocused(bool focused) {
+        std::lock_guard lock(mutex_);
+        textField_ = focused;
+        publishLocked();
+    }
+
+    void setSearchBoxOpen(bool open) {
+        std::lock_guard lock(mutex_);
+        searchBox_ = open;
+        publishLocked();
+    }
+
+private:
+    void publishLocked() {
+        KeyContext context = liveView_;
+        if (searchBox_) {
+            context = KeyContext::SearchBox;
+        } else if (textField_) {
+            context = KeyContext::TextField;
+        } else if (pluginWindow_) {
+            context = KeyContext::PluginWindow;
+        }
+        context_.store(context, std::memory_order_release);
+    }
+
+    // serialises observers; context_ is what readers see
+    std::mutex mutex_;
+    KeyContext liveView_ = KeyContext::Global;
+    bool pluginWindow_ = false;
+    bool textField_ = false;
+    bool searchBox_ = false;
+
+    std::atomic<KeyContext> context_{KeyContext::Global};
+};
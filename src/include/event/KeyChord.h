@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "Types.h"
+
+// A key plus modifiers packed into one integer. The platform event
+// handler builds one per key press straight from the key code and flags,
+// and remaps are found by indexing a flat table with it, so the hot path
+// never touches a string. EKeyPress stays for parsing and writing config.
+// The encoding is 32 bits wide with room to spare.
+//
+//   bits 0-6   key id, 0 for a key with no name here
+//   bits 7-10  ModifierBit
+class KeyChord {
+public:
+    enum ModifierBit : uint8_t {
+        ShiftBit  = 1
+        , CtrlBit = 2
+        , AltBit  = 4
+        , CmdBit  = 8
+    };
+
+    static constexpr uint32_t KEY_BITS = 7;
+    static constexpr uint32_t MODIFIER_BITS = 4;
+    // every chord's index() is below this
+    static constexpr uint32_t SPACE = 1U << (KEY_BITS + MODIFIER_BITS);
+
+    constexpr KeyChord() = default;
+    constexpr KeyChord(uint8_t key, uint8_t modifiers)
+        : bits_((static_cast<uint32_t>(modifiers & 0xF) << KEY_BITS) | (key & 0x7FU)) // NOLINT
+    {}
+
+    // 0 for names that aren't keys. Case and spaces don't matter, so the
+    // names the platforms give keys ("Left Arrow", "Page Up") resolve too
+    static constexpr auto keyId(std::string_view name) -> uint8_t {
+        for (size_t i = 0; i < KEY_NAMES.size(); ++i) {
+            if (sameName(name, KEY_NAMES[i])) {
+                return static_cast<uint8_t>(i + 1);
+            }
+        }
+        for (const auto& [alias, canonical] : KEY_ALIASES) {
+            if (sameName(name, alias)) {
+                return keyId(canonical);
+            }
+        }
+        return 0;
+    }
+
+    // the name remaps use for the key; empty for 0
+    static constexpr auto keyName(uint8_t id) -> std::string_view {
+        return id == 0 || id > KEY_NAMES.size() ? std::string_view() : KEY_NAMES[id - 1];
+    }
+
+    // from Modifier flags (the CGEventFlags masks)
+    static constexpr auto modifierBits(uint32_t flags) -> uint8_t {
+        return static_cast<uint8_t>(((flags & Modifier::Shift) != 0 ? ShiftBit : 0)
+                                    | ((flags & Modifier::Ctrl) != 0 ? CtrlBit : 0)
+                                    | ((flags & Modifier::Alt) != 0 ? AltBit : 0)
+                                    | ((flags & Modifier::Cmd) != 0 ? CmdBit : 0));
+    }
+
+    // back to Modifier flags, for sending the chord on
+    [[nodiscard]] constexpr auto modifierFlags() const -> uint32_t {
+        return ((modifiers() & ShiftBit) != 0 ? static_cast<uint32_t>(Modifier::Shift) : 0U)
+               | ((modifiers() & CtrlBit) != 0 ? static_cast<uint32_t>(Modifier::Ctrl) : 0U)
+               | ((modifiers() & AltBit) != 0 ? static_cast<uint32_t>(Modifier::Alt) : 0U)
+               | ((modifiers() & CmdBit) != 0 ? static_cast<uint32_t>(Modifier::Cmd) : 0U);
+    }
+
+    static auto fromKeyPress(const EKeyPress& kp) -> KeyChord {
+        return {keyId(kp.key), static_cast<uint8_t>((kp.shift ? ShiftBit : 0)
+                                                    | (kp.ctrl ? CtrlBit : 0)
+                                                    | (kp.alt ? AltBit : 0)
+                                                    | (kp.cmd ? CmdBit : 0))};
+    }
+
+    [[nodiscard]] auto toKeyPress() const -> EKeyPress {
+        EKeyPress kp;
+        kp.key = std::string(keyName(key()));
+        kp.shift = (modifiers() & ShiftBit) != 0;
+        kp.ctrl = (modifiers() & CtrlBit) != 0;
+        kp.alt = (modifiers() & AltBit) != 0;
+        kp.cmd = (modifiers() & CmdBit) != 0;
+        return kp;
+    }
+
+    [[nodiscard]] constexpr auto key() const -> uint8_t { return static_cast<uint8_t>(bits_ & 0x7FU); } // NOLINT
+    [[nodiscard]] constexpr auto modifiers() const -> uint8_t { return static_cast<uint8_t>(bits_ >> KEY_BITS); }
+    [[nodiscard]] constexpr auto valid() const -> bool { return key() != 0; }
+
+    // dense, below SPACE
+    [[nodiscard]] constexpr auto index() const -> uint32_t { return bits_; }
+
+    constexpr auto operator==(const KeyChord& other) const -> bool = default;
+
+private:
+    static constexpr auto KEY_NAMES = std::to_array<std::string_view>({
+        "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m"
+        , "n", "o", "p", "q", "r", "s", "t", "u", "v", "w", "x", "y", "z"
+        , "0", "1", "2", "3", "4", "5", "6", "7", "8", "9"
+        , "f1", "f2", "f3", "f4", "f5", "f6", "f7", "f8", "f9", "f10", "f11", "f12"
+        , "delete", "enter", "escape", "space", "tab", "backspace", "forwarddelete"
+        , "leftarrow", "uparrow", "downarrow", "rightarrow"
+        , "home", "end", "pageup", "pagedown", "help"
+        , "equal", "minus", "leftbracket", "rightbracket", "backslash"
+        , "semicolon", "quote", "comma", "period", "slash", "grave"
+    });
+
+    struct KeyAlias {
+        std::string_view alias;
+        std::string_view canonical;
+    };
+
+    static constexpr auto KEY_ALIASES = std::to_array<KeyAlias>({
+        {"return", "enter"}
+        , {"esc", "escape"}
+        , {"left", "leftarrow"}, {"up", "uparrow"}, {"down", "downarrow"}, {"right", "rightarrow"}
+        , {"=", "equal"}, {"-", "minus"}, {"[", "leftbracket"}, {"]", "rightbracket"}
+        , {"\\", "backslash"}, {";", "semicolon"}, {"'", "quote"}, {",", "comma"}, {".", "period"}
+        , {"/", "slash"}, {"`", "grave"}
+    });
+
+    static constexpr auto lower(char c) -> char {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    // `canonical` is lower case without spaces
+    static constexpr auto sameName(std::string_view name, std::string_view canonical) -> bool {
+        size_t j = 0;
+        for (char c : name) {
+            if (c == ' ') {
+                continue;
+            }
+            if (j == canonical.size() || lower(c) != canonical[j]) {
+                return false;
+            }
+            ++j;
+        }
+        return j == canonical.size();
+    }
+
+    uint32_t bits_ = 0;
+};
+
+static_assert(KeyChord::keyId("a") == 1);
+static_assert(KeyChord::keyId("Left Arrow") == KeyChord::keyId("leftarrow"));
+static_assert(KeyChord::keyName(KeyChord::keyId("Return")) == "enter");
+static_assert(KeyChord(127, 15).index() < KeyChord::SPACE); // NOLINT
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+// Key names as remaps spell them ("a", "f5", "leftarrow") to the virtual
+// key codes the platform's input APIs take: CGKeyCode on macOS, VK_* on
+// Windows. Looked up when a macro is compiled, never while it runs.
+namespace KeyCodes {
+    // case-insensitive
+    [[nodiscard]] auto find(std::string_view key) -> std::optional<uint16_t>;
+}
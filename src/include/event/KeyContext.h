@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+// Where a key press lands, for remaps that only apply there. Global is
+// the plain `remap:` section and is where every other context starts
+// from; the rest are overrides written as a map under their name:
+//
+//   remap:
+//     ctrl+d: cmd+a
+//     session:
+//       ctrl+d: cmd+b
+//
+// Text fields only inherit global remaps that have a modifier, so typing
+// into one still types.
+#define LIM_KEY_CONTEXTS(X) \
+    X(Global, "global") \
+    X(Arrangement, "arrangement") \
+    X(Session, "session") \
+    X(PluginWindow, "plugin-window") \
+    X(Browser, "browser") \
+    X(TextField, "text-field") \
+    X(SearchBox, "searchbox")
+
+enum class KeyContext : uint8_t {
+#define LIM_KEY_CONTEXT_ID(id, name) id,
+    LIM_KEY_CONTEXTS(LIM_KEY_CONTEXT_ID)
+#undef LIM_KEY_CONTEXT_ID
+};
+
+struct KeyContexts {
+    static constexpr std::array NAMES = {
+#define LIM_KEY_CONTEXT_NAME(id, name) std::string_view(name),
+        LIM_KEY_CONTEXTS(LIM_KEY_CONTEXT_NAME)
+#undef LIM_KEY_CONTEXT_NAME
+    };
+
+    static constexpr size_t COUNT = NAMES.size();
+
+    static constexpr auto find(std::string_view name) -> std::optional<KeyContext> {
+        for (size_t i = 0; i < NAMES.size(); ++i) {
+            if (NAMES[i] == name) {
+                return static_cast<KeyContext>(i);
+            }
+        }
+        return std::nullopt;
+    }
+
+    static constexpr auto name(KeyContext context) -> std::string_view {
+        return NAMES[static_cast<size_t>(context)];
+    }
+
+    static constexpr auto index(KeyContext context) -> size_t {
+        return static_cast<size_t>(context);
+    }
+};
+
+static_assert(KeyContexts::find("session") == KeyContext::Session);
+static_assert(KeyContexts::name(KeyContext::TextField) == "text-field");
@@ -1,9 +1,22 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <string>
+#include <string_view>
 
+#include "KeyChord.h"
 #include "Types.h"
 
+// what KeyMapper::parseChord makes of "cmd+shift+a"
+struct ChordParse {
+    KeyChord chord;
+    size_t errorAt = 0;         // byte offset of the offending token
+    std::string_view error;     // empty when the text parsed
+
+    [[nodiscard]] constexpr auto ok() const -> bool { return error.empty(); }
+};
+
 class KeyMapper {
 public:
   KeyMapper();
@@ -14,18 +27,100 @@ public:
   ~KeyMapper();
 
   // Method to process a keypress string and return a KeyPress object
+  // throws std::runtime_error naming the column that didn't parse
   auto processKeyPress(const std::string &keypress) -> EKeyPress;
   auto EKeyPressToString(const EKeyPress &keypress) -> std::string;
 
   [[nodiscard]] auto isValid() const -> bool;
   [[nodiscard]] auto getKeyPress() const -> const EKeyPress&;
 
+  // One pass over "mod+mod+key": any number of modifiers (cmd, shift,
+  // ctrl, alt, in any order and case), then exactly one key KeyChord has
+  // a name for. Tokens are checked against constexpr tables as they are
+  // split off, so nothing is allocated and it can run at compile time.
+  static constexpr auto parseChord(std::string_view text) -> ChordParse {
+    ChordParse result;
+    uint8_t modifiers = 0;
+    size_t start = 0;
+
+    while (true) {
+      size_t end = start;
+      while (end < text.size() && text[end] != '+') {
+        ++end;
+      }
+      const std::string_view token = text.substr(start, end - start);
+      const bool last = end == text.size();
+
+      if (token.empty()) {
+        result.errorAt = start;
+        result.error = start == 0 && last ? "empty" : "expected a key or modifier";
+        return result;
+      }
+
+      if (const uint8_t bit = modifierBit(token); bit != 0) {
+        if (last) {
+          result.errorAt = start;
+          result.error = "ends in a modifier, expected a key after it";
+          return result;
+        }
+        modifiers |= bit;
+        start = end + 1;
+        continue;
+      }
+
+      const uint8_t key = KeyChord::keyId(token);
+      if (key == 0) {
+        result.errorAt = start;
+        result.error = "not a key or modifier";
+        return result;
+      }
+      if (!last) {
+        result.errorAt = start;
+        result.error = "only modifiers can come before '+'";
+        return result;
+      }
+
+      result.chord = KeyChord(key, modifiers);
+      return result;
+    }
+  }
+
+  // "not a valid keypress format: cmd++a (column 5: expected a key or modifier)"
+  [[nodiscard]] static auto describe(std::string_view text, const ChordParse& parse) -> std::string;
+
 private:
     bool valid;
     EKeyPress keypress;
 
-    [[nodiscard]] auto validateHotkey(const std::string& keypress) const -> bool;
-    [[nodiscard]] auto parseKeyPress(const std::string& keypress) const -> EKeyPress;
-    [[nodiscard]] auto buildRegexPattern() const -> std::string;
-    [[nodiscard]] auto toLowerCase(const std::string& input) const -> std::string;
+    struct ModifierName {
+        std::string_view name;
+        uint8_t bit;
+    };
+
+    static constexpr std::array<ModifierName, 4> MODIFIER_NAMES = {{
+        {"cmd", KeyChord::CmdBit}
+        , {"shift", KeyChord::ShiftBit}
+        , {"ctrl", KeyChord::CtrlBit}
+        , {"alt", KeyChord::AltBit}
+    }};
+
+    static constexpr auto modifierBit(std::string_view token) -> uint8_t {
+        for (const auto& [name, bit] : MODIFIER_NAMES) {
+            if (name.size() != token.size()) {
+                continue;
+            }
+            bool same = true;
+            for (size_t i = 0; i < name.size() && same; ++i) {
+                const char c = token[i];
+                same = (c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c) == name[i];
+            }
+            if (same) {
+                return bit;
+            }
+        }
+        return 0;
+    }
 };
+
+static_assert(KeyMapper::parseChord("cmd+shift+a").chord == KeyChord(KeyChord::keyId("a"), KeyChord::CmdBit | KeyChord::ShiftBit));
+static_assert(KeyMapper::parseChord("cmd++a").errorAt == 4);
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <future>
+
 #include "Types.h"
 
 class KeySender {
@@ -17,6 +20,14 @@ public:
     }
     void sendKeyPress(const EKeyPress& kp);
 
+    // one key transition with a resolved key code (see KeyCodes) and
+    // Modifier flags; what compiled macros send, so it doesn't allocate
+    void sendKey(uint16_t keyCode, uint32_t modifiers, bool keyDown);
+
+    // ready once every key sent before it has been posted to the system;
+    // invalid where sending doesn't return until then
+    auto posted() -> std::future<void>;
+
 private:
     void sendIndividualKeyPress(const EKeyPress& kp);
 };
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "KeyChord.h"
+#include "SequenceTrie.h"
+
+class MacroProgram;
+
+// Where the keys pressed so far stand in a SequenceTrie. A pure state
+// machine: it's told each key press and the time it happened, and when
+// its deadline has passed, and answers with what to do. Nothing here
+// reads a clock, sends a key or allocates, so the key handler can call it
+// for every key press and tests can drive it with made-up times.
+//
+// A key that starts or continues a sequence is swallowed. When the
+// sequence completes, its program runs. When the next key doesn't fit,
+// or nothing follows before the timeout, a sequence that can end where it
+// is runs; otherwise the swallowed keys are handed back to be replayed as
+// if no sequence had been there. Replayed keys don't start sequences.
+//
+// Not thread safe; the caller serialises press() and expire().
+class KeySequencer {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    // what one call asks for, in this order: replay(), then program, then
+    // the key itself unless it was consumed
+    struct Step {
+        std::array<KeyChord, SequenceTrie::MAX_LENGTH> replayed{};
+        uint8_t replayCount = 0;
+
+        // valid until the sequencer is next given a different trie
+        const MacroProgram* program = nullptr;
+
+        // the key pressed is part of a sequence; don't handle it further
+        bool consumed = false;
+
+        [[nodiscard]] auto replay() const -> std::span<const KeyChord> {
+            return {replayed.data(), replayCount};
+        }
+
+        [[nodiscard]] auto empty() const -> bool {
+            return replayCount == 0 && program == nullptr && !consumed;
+        }
+    };
+
+    // `trie` is the one current for this key press; a change of trie
+    // abandons a pending sequence, replaying it
+    auto press(const SequenceTriePtr& trie, KeyChord chord, TimePoint now) -> Step;
+
+    // ends a pending sequence whose deadline is at or before `now`
+    auto expire(TimePoint now) -> Step;
+
+    [[nodiscard]] auto pending() const -> bool { return node_ != SequenceTrie::ROOT; }
+
+    // when expire() should next be called; none while nothing is pending
+    [[nodiscard]] auto deadline() const -> std::optional<TimePoint> {
+        return pending() ? std::optional(deadline_) : std::nullopt;
+    }
+
+    // what programs in a Step point into
+    [[nodiscard]] auto trie() const -> const SequenceTriePtr& { return trie_; }
+
+private:
+    // takes `chord` on to `next`, running the program if it ends there
+    void advance(SequenceTrie::Node next, KeyChord chord, TimePoint now, Step& step);
+
+    // ends the pending sequence: its program if it can end here, the
+    // swallowed keys otherwise
+    void resolve(Step& step);
+
+    void replayPending(Step& step);
+    void clear();
+
+    SequenceTriePtr trie_;
+    SequenceTrie::Node node_ = SequenceTrie::ROOT;
+    TimePoint deadline_{};
+
+    std::array<KeyChord, SequenceTrie::MAX_LENGTH> pending_{};
+    uint8_t pendingCount_ = 0;
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <optional>
+#include <string>
+
+#include "MacroProgram.h"
+#include "WaitCondition.h"
+
+// what a step the pipeline waited on came to
+enum class StepOutcome : uint8_t {
+    Done
+    , TimedOut
+    , Failed
+};
+
+// how a pipelined macro went
+struct MacroRun {
+    // from the first step issued to the last one completing
+    std::chrono::nanoseconds elapsed{};
+    // steps issued; short of the program if one failed
+    size_t steps = 0;
+    // steps that were given up on and carried on past
+    size_t timedOut = 0;
+    bool failed = false;
+    std::string error;
+};
+
+// Runs a MacroProgram with each step issued as soon as the one before it
+// has completed, instead of all at once or after a fixed sleep, so
+// `cmd+a, plugin.Serum` can't load the plugin before the keys are in.
+//
+// `sink` provides what MacroProgram::run wants, except that
+//   invoke(ActionId, const std::optional<std::string>& argument)
+//     returns a std::future<void> that's ready once the action is done;
+//     an invalid one means it is already
+//   keysPosted() returns the same for the keys sent so far
+//   wait(WaitCondition, uint32_t milliseconds) returns the same for a
+//     wait step, throwing StepTimedOut if what it waits for never came
+//     and StepCancelled if it was called off
+//   settled(std::optional<ActionId>, StepOutcome) hears how each step
+//     it waited on went; nullopt for keys
+// Keys don't wait on each other, as they go out in order regardless.
+//
+// A step still running after `stepTimeout`, or a wait step `stepTimeout`
+// past its own milliseconds, is given up on and the macro carries on, as
+// it does past a StepTimedOut. One whose future throws anything else
+// (the action failed, was never run, or the wait was cancelled) ends it,
+// since the steps after it were counting on it.
+class MacroPipeline {
+public:
+    static constexpr auto DEFAULT_STEP_TIMEOUT = std::chrono::milliseconds(2000); // NOLINT
+
+    template <typename Sink>
+    static auto run(const MacroProgram& program, Sink& sink
+                    , std::chrono::milliseconds stepTimeout = DEFAULT_STEP_TIMEOUT) -> MacroRun {
+        const auto startedAt = std::chrono::steady_clock::now();
+        MacroRun result;
+
+        // the last step that hasn't been seen to complete
+        Pending pending;
+        bool keysSent = false;
+
+        const auto settle = [&]() {
+            if (keysSent) {
+                pending = {sink.keysPosted(), std::nullopt, true, stepTimeout};
+                keysSent = false;
+            }
+            return await(pending, sink, result);
+        };
+
+        for (const MacroInstr& instr : program.code()) {
+            switch (instr.op) {
+                case MacroOp::KeyDown:
+                case MacroOp::KeyUp:
+                    if (!keysSent && !await(pending, sink, result)) {
+                        return finish(result, startedAt);
+                    }
+                    sink.key(instr.operand, instr.arg, instr.op == MacroOp::KeyDown);
+                    keysSent = true;
+                    break;
+                case MacroOp::Invoke: {
+                    if (!settle()) {
+                        return finish(result, startedAt);
+                    }
+                    const auto id = static_cast<ActionId>(instr.operand);
+                    pending = {sink.invoke(id, program.arguments()[instr.arg]), id, true, stepTimeout};
+                    break;
+                }
+                case MacroOp::Delay:
+                    if (!settle()) {
+                        return finish(result, startedAt);
+                    }
+                    sink.delay(instr.arg);
+                    break;
+                case MacroOp::Wait:
+                    if (!settle()) {
+                        return finish(result, startedAt);
+                    }
+                    pending = {sink.wait(static_cast<WaitCondition>(instr.operand), instr.arg), ActionId::wait, true
+                               , std::chrono::milliseconds(instr.arg) + stepTimeout};
+                    break;
+            }
+            ++result.steps;
+        }
+
+        settle();
+        return finish(result, startedAt);
+    }
+
+private:
+    struct Pending {
+        std::future<void> future;
+        // nullopt for keys
+        std::optional<ActionId> action;
+        bool issued = false;
+        std::chrono::milliseconds timeout{};
+    };
+
+    // false if the step failed
+    template <typename Sink>
+    static auto await(Pending& step, Sink& sink, MacroRun& result) -> bool {
+        if (!step.issued) {
+            return true;
+        }
+        step.issued = false;
+
+        StepOutcome outcome = StepOutcome::Done;
+        if (!step.future.valid()) {
+            // done on return
+        } else if (step.future.wait_for(step.timeout) == std::future_status::timeout) {
+            ++result.timedOut;
+            outcome = StepOutcome::TimedOut;
+        } else {
+            try {
+                step.future.get();
+            } catch (const StepTimedOut&) {
+                ++result.timedOut;
+                outcome = StepOutcome::TimedOut;
+            } catch (const std::exception& e) {
+                result.error = e.what();
+                outcome = StepOutcome::Failed;
+            } catch (...) {
+                result.error = "unknown error";
+                outcome = StepOutcome::Failed;
+            }
+        }
+        step.future = {};
+
+        sink.settled(step.action, outcome);
+        result.failed = outcome == StepOutcome::Failed;
+        return !result.failed;
+    }
+
+    static auto finish(MacroRun& result, std::chrono::steady_clock::time_point startedAt) -> MacroRun {
+        result.elapsed = std::chrono::steady_clock::now() - startedAt;
+        return result;
+    }
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Types.h"
+#include "WaitCondition.h"
+
+enum class MacroOp : uint8_t {
+    KeyDown         // operand: key code, arg: Modifier flags
+    , KeyUp         // operand: key code, arg: Modifier flags
+    , Invoke        // operand: ActionId, arg: index into arguments()
+    , Delay         // arg: milliseconds
+    , Wait          // operand: WaitCondition, arg: milliseconds
+};
+
+struct MacroInstr {
+    MacroOp op;
+    uint16_t operand;
+    uint32_t arg;
+};
+
+// A remap's steps compiled when the config is loaded: key names resolved
+// to platform key codes, modifiers to event flags, action names to ids and
+// arguments interned, so running a macro is a walk over a flat array that
+// neither hashes a string nor allocates.
+class MacroProgram {
+public:
+    // steps whose key has no code on this platform, or whose action,
+    // delay or wait can't be compiled, are logged and left out
+    [[nodiscard]] static auto compile(const EMacro& macro) -> MacroProgram;
+
+    [[nodiscard]] auto code() const -> const std::vector<MacroInstr>& { return code_; }
+
+    // arguments()[0] is the missing argument
+    [[nodiscard]] auto arguments() const -> const std::vector<std::optional<std::string>>& { return arguments_; }
+
+    [[nodiscard]] auto hasDelay() const -> bool { return hasDelay_; }
+
+    // some step has to wait for the one before it to complete, or for
+    // its turn: there's a delay or wait, an action alongside other steps,
+    // or more than one key press to pace. Those go through MacroPipeline;
+    // the rest can run straight off
+    [[nodiscard]] auto waits() const -> bool { return waits_; }
+
+    // The interpreter. `sink` provides
+    //   key(uint16_t keyCode, uint32_t modifiers, bool down)
+    //   invoke(ActionId, const std::optional<std::string>& argument)
+    //   delay(uint32_t milliseconds)
+    //   wait(WaitCondition, uint32_t milliseconds)
+    template <typename Sink>
+    void run(Sink& sink) const {
+        for (const MacroInstr& instr : code_) {
+            switch (instr.op) {
+                case MacroOp::KeyDown:
+                    sink.key(instr.operand, instr.arg, true);
+                    break;
+                case MacroOp::KeyUp:
+                    sink.key(instr.operand, instr.arg, false);
+                    break;
+                case MacroOp::Invoke:
+                    sink.invoke(static_cast<ActionId>(instr.operand), arguments_[instr.arg]);
+                    break;
+                case MacroOp::Delay:
+                    sink.delay(instr.arg);
+                    break;
+                case MacroOp::Wait:
+                    sink.wait(static_cast<WaitCondition>(instr.operand), instr.arg);
+                    break;
+            }
+        }
+    }
+
+private:
+    MacroProgram();
+
+    auto intern(const std::optional<std::string>& argument) -> uint32_t;
+
+    std::vector<MacroInstr> code_;
+    std::vector<std::optional<std::string>> arguments_;
+    bool hasDelay_ = false;
+    bool waits_ = false;
+};
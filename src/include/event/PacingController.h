@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+
+// What synthesized input is paced by. Each class learns its own rate:
+// Live takes key presses at a different pace than the remote script
+// answers requests or windows move. Columns are the interval in ms to
+// start from, and the shortest and longest it may get.
+#define LIM_PACE_CLASSES(X) \
+    X(Key, "key", 30, 2, 250) \
+    X(Window, "window", 10, 1, 500) \
+    X(Ipc, "ipc", 20, 1, 1000)
+
+enum class PaceClass : uint8_t {
+#define LIM_PACE_CLASS_ID(id, name, initial, min, max) id,
+    LIM_PACE_CLASSES(LIM_PACE_CLASS_ID)
+#undef LIM_PACE_CLASS_ID
+};
+
+struct PaceLimits {
+    std::chrono::nanoseconds initial;
+    std::chrono::nanoseconds min;
+    std::chrono::nanoseconds max;
+    // sends a second added per acknowledged send
+    double increase = 1.0;
+    // the rate is multiplied by this on a drop
+    double decrease = 0.5;
+};
+
+// Learns how fast each class of synthesized input can go before Live
+// starts losing it, by AIMD on the send rate: each send acknowledged in
+// time adds a little, a dropped one halves it. Sends are spaced at the
+// resulting interval, so a macro runs as fast as Live keeps up with and
+// no faster, with no sleeps written into it.
+//
+// It keeps no clock of its own, so the same feedback always gives the
+// same pacing; the tests drive it against a simulated Live.
+class PacingController {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    using Limits = PaceLimits;
+
+    static constexpr std::array NAMES = {
+#define LIM_PACE_CLASS_NAME(id, name, initial, min, max) std::string_view(name),
+        LIM_PACE_CLASSES(LIM_PACE_CLASS_NAME)
+#undef LIM_PACE_CLASS_NAME
+    };
+
+    static constexpr size_t COUNT = NAMES.size();
+
+    static constexpr std::array<Limits, COUNT> DEFAULT_LIMITS = {
+#define LIM_PACE_CLASS_LIMITS(id, name, initial, min, max) \
+        Limits{std::chrono::milliseconds(initial), std::chrono::milliseconds(min), std::chrono::milliseconds(max)},
+        LIM_PACE_CLASSES(LIM_PACE_CLASS_LIMITS)
+#undef LIM_PACE_CLASS_LIMITS
+    };
+
+    struct Stats {
+        uint64_t sent = 0;
+        uint64_t accepted = 0;
+        uint64_t dropped = 0;
+        // drops that halved the rate; the rest were from the same flight
+        uint64_t decreases = 0;
+    };
+
+    explicit PacingController(const std::array<Limits, COUNT>& limits = DEFAULT_LIMITS);
+
+    // when a send asked for at `now` may go: an interval after the one
+    // before it. The slot is taken, so pass what's returned to dropped()
+    auto reserve(PaceClass pace, TimePoint now) -> TimePoint;
+
+    // Live took it
+    void accepted(PaceClass pace);
+
+    // Live lost it, or never showed it took it. Only the first drop of
+    // what was sent before the last decrease counts, so one overrun
+    // halves the rate once, not once per key it swallowed
+    void dropped(PaceClass pace, TimePoint sentAt);
+
+    [[nodiscard]] auto interval(PaceClass pace) const -> std::chrono::nanoseconds;
+    [[nodiscard]] auto stats(PaceClass pace) const -> Stats;
+
+    static constexpr auto name(PaceClass pace) -> std::string_view {
+        return NAMES[static_cast<size_t>(pace)];
+    }
+
+private:
+    struct State {
+        // sends a second
+        double rate = 0;
+        double minRate = 0;
+        double maxRate = 0;
+        double increase = 0;
+        double decrease = 0;
+
+        TimePoint nextSend{};
+        TimePoint lastDecrease{};
+        Stats stats;
+    };
+
+    static auto toRate(std::chrono::nanoseconds interval) -> double;
+    static auto toInterval(double rate) -> std::chrono::nanoseconds;
+
+    auto state(PaceClass pace) -> State& { return states_[static_cast<size_t>(pace)]; }
+    [[nodiscard]] auto state(PaceClass pace) const -> const State& { return states_[static_cast<size_t>(pace)]; }
+
+    mutable std::mutex mutex_;
+    std::array<State, COUNT> states_;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "KeyChord.h"
+#include "KeyContext.h"
+#include "SequenceTrie.h"
+#include "Types.h"
+
+class MacroProgram;
+
+// The compiled remaps as one immutable snapshot. ConfigManager builds a
+// new table whenever a remap changes and swaps it in atomically; the key
+// handler pins whichever table is current for the length of one key
+// press, so a lookup never copies, allocates or waits on a writer.
+//
+// Programs are shared between successive tables, so changing one remap
+// doesn't recompile the rest. Lookups go through a direct-indexed slot per
+// possible KeyChord (2048 pointers), so finding a remap is a mask and a load.
+//
+// Context overrides are merged when the table is built: each context gets
+// a flat table of the global remaps with its own laid over them, so a
+// lookup in any context is still one probe. Contexts that would come out
+// identical to the global table share it.
+//
+// Multi-chord sequences ride along as their own trie, which is shared
+// between tables until the sequences themselves change.
+class RemapTable {
+public:
+    using Programs = std::unordered_map<EKeyPress, std::shared_ptr<const MacroProgram>, EMacroHash>;
+    // by context other than Global, whose remaps are the plain Programs
+    using Layers = std::map<KeyContext, Programs>;
+
+    RemapTable();
+    // an empty trie when `sequences` is null
+    explicit RemapTable(Programs programs, Layers layers = {}, SequenceTriePtr sequences = nullptr);
+
+    // valid as long as the table is
+    [[nodiscard]] auto find(KeyContext context, KeyChord chord) const -> const MacroProgram* {
+        return chord.valid() ? slots_[tables_[KeyContexts::index(context)] + chord.index()] : nullptr;
+    }
+
+    [[nodiscard]] auto find(KeyChord chord) const -> const MacroProgram* {
+        return find(KeyContext::Global, chord);
+    }
+
+    [[nodiscard]] auto find(const EKeyPress& key) const -> const MacroProgram* {
+        return find(KeyChord::fromKeyPress(key));
+    }
+
+    // of the global remaps
+    [[nodiscard]] auto size() const -> size_t { return programs_.size(); }
+
+    [[nodiscard]] auto programs() const -> const Programs& { return programs_; }
+    [[nodiscard]] auto layers() const -> const Layers& { return layers_; }
+
+    // never null
+    [[nodiscard]] auto sequences() const -> const SequenceTriePtr& { return sequences_; }
+
+private:
+    // fills the SPACE slots at `table`, skipping invalid chords and, for
+    // text fields, global remaps without a modifier
+    void fill(uint32_t table, const Programs& programs, bool modifiedOnly);
+
+    Programs programs_;
+    Layers layers_;
+    SequenceTriePtr sequences_;
+
+    // where each context's table starts in slots_
+    std::array<uint32_t, KeyContexts::COUNT> tables_{};
+    std::vector<const MacroProgram*> slots_;
+};
+
+using RemapTablePtr = std::shared_ptr<const RemapTable>;
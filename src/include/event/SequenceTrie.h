@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "KeyChord.h"
+
+class MacroProgram;
+
+// Multi-chord sequences ("cmd+b p s") compiled into a trie of chords.
+// Built once per config change and never modified, so a key sequencer can
+// hold on to one across key presses while the config moves on.
+//
+// A transition is one load for the first chord, which is tried on every
+// key press, and one probe of an open-addressed edge table after that;
+// neither allocates. A node can both end a sequence and lead on to longer
+// ones, in which case the timeout decides.
+class SequenceTrie {
+public:
+    using Node = uint32_t;
+    static constexpr Node ROOT = 0;
+    static constexpr Node NONE = std::numeric_limits<Node>::max();
+
+    // longest sequence that compiles; what a sequencer buffers
+    static constexpr size_t MAX_LENGTH = 8;
+    static constexpr std::chrono::milliseconds DEFAULT_TIMEOUT{1000};
+
+    struct Sequence {
+        std::vector<KeyChord> chords;
+        std::shared_ptr<const MacroProgram> program;
+    };
+
+    SequenceTrie();
+    // sequences shorter than two chords, longer than MAX_LENGTH or with a
+    // chord that isn't a key are logged and left out; a repeated sequence
+    // replaces the earlier one
+    SequenceTrie(std::vector<Sequence> sequences, std::chrono::milliseconds timeout);
+
+    [[nodiscard]] auto next(Node node, KeyChord chord) const -> Node {
+        if (!chord.valid()) {
+            return NONE;
+        }
+        if (node == ROOT) {
+            return root_[chord.index()];
+        }
+        const uint64_t key = edgeKey(node, chord);
+        for (size_t i = slot(key);; i = (i + 1) & mask_) {
+            if (edges_[i].key == key) {
+                return edges_[i].child;
+            }
+            if (edges_[i].key == 0) {
+                return NONE;
+            }
+        }
+    }
+
+    // what reaching `node` runs; null if it only leads on
+    [[nodiscard]] auto program(Node node) const -> const MacroProgram* { return nodes_[node].program; }
+
+    [[nodiscard]] auto leadsOn(Node node) const -> bool { return nodes_[node].children != 0; }
+
+    [[nodiscard]] auto timeout() const -> std::chrono::milliseconds { return timeout_; }
+
+    // sequences compiled
+    [[nodiscard]] auto size() const -> size_t { return size_; }
+    [[nodiscard]] auto empty() const -> bool { return size_ == 0; }
+
+private:
+    struct NodeInfo {
+        const MacroProgram* program = nullptr;
+        uint32_t children = 0;
+    };
+
+    // 0 marks a free slot; root edges live in root_, so no real key is 0
+    struct Edge {
+        uint64_t key = 0;
+        Node child = NONE;
+    };
+
+    static constexpr auto edgeKey(Node node, KeyChord chord) -> uint64_t {
+        return (static_cast<uint64_t>(node) * KeyChord::SPACE) + chord.index();
+    }
+
+    [[nodiscard]] auto slot(uint64_t key) const -> size_t {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32U) & mask_; // NOLINT
+    }
+
+    std::chrono::milliseconds timeout_;
+    size_t size_ = 0;
+    std::vector<std::shared_ptr<const MacroProgram>> programs_;
+    std::vector<NodeInfo> nodes_;
+    std::vector<Node> root_;
+    std::vector<Edge> edges_;
+    size_t mask_ = 0;
+};
+
+using SequenceTriePtr = std::shared_ptr<const SequenceTrie>;
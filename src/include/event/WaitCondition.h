@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+// What a macro's `wait` step can wait for, written `wait.<name>` with an
+// optional `.<ms>` after it:
+//
+//   cmd+i: plugin.Serum, wait.pluginWindow, tilePluginWindows
+//
+// Time waits its milliseconds, which it must be given. The others wait
+// for their event, giving up after the milliseconds given or
+// DEFAULT_TIMEOUT_MS:
+//   pluginWindow  a plugin window opened since the step before went out
+//   ipc           no request to Live is waiting on its answer
+#define LIM_WAIT_CONDITIONS(X) \
+    X(Time, "ms") \
+    X(PluginWindow, "pluginWindow") \
+    X(Ipc, "ipc")
+
+enum class WaitCondition : uint8_t {
+#define LIM_WAIT_CONDITION_ID(id, name) id,
+    LIM_WAIT_CONDITIONS(LIM_WAIT_CONDITION_ID)
+#undef LIM_WAIT_CONDITION_ID
+};
+
+// what a wait step compiles to
+struct WaitStep {
+    WaitCondition condition;
+    uint32_t ms;
+};
+
+struct WaitConditions {
+    static constexpr uint32_t DEFAULT_TIMEOUT_MS = 2000; // NOLINT
+
+    static constexpr std::array NAMES = {
+#define LIM_WAIT_CONDITION_NAME(id, name) std::string_view(name),
+        LIM_WAIT_CONDITIONS(LIM_WAIT_CONDITION_NAME)
+#undef LIM_WAIT_CONDITION_NAME
+    };
+
+    static constexpr size_t COUNT = NAMES.size();
+
+    static constexpr auto name(WaitCondition condition) -> std::string_view {
+        return NAMES[static_cast<size_t>(condition)];
+    }
+
+    // a wait step's argument, "pluginWindow" or "ms.50"; nullopt if it
+    // names no condition or its milliseconds aren't a number
+    static auto parse(std::string_view argument) -> std::optional<WaitStep> {
+        const size_t dot = argument.find('.');
+        const std::string_view name = argument.substr(0, dot);
+
+        std::optional<WaitCondition> condition;
+        for (size_t i = 0; i < NAMES.size(); ++i) {
+            if (NAMES[i] == name) {
+                condition = static_cast<WaitCondition>(i);
+            }
+        }
+        if (!condition) {
+            return std::nullopt;
+        }
+
+        if (dot == std::string_view::npos) {
+            if (*condition == WaitCondition::Time) {
+                return std::nullopt;
+            }
+            return WaitStep{*condition, DEFAULT_TIMEOUT_MS};
+        }
+
+        const std::string_view value = argument.substr(dot + 1);
+        uint32_t ms = 0;
+        auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), ms);
+        if (value.empty() || ec != std::errc() || end != value.data() + value.size()) {
+            return std::nullopt;
+        }
+        return WaitStep{*condition, ms};
+    }
+};
+
+// what a wait's future throws when its condition didn't come about in
+// time. The macro carries on past it, as it does past a slow action
+class StepTimedOut : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// what it throws when a newer macro took over, or the app is quitting.
+// The macro stops there
+class StepCancelled : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "TimerWheel.h"
+#include "WaitCondition.h"
+
+// Holds the wait steps of running macros until what they wait for comes
+// about. A wait is a promise subscribed to its condition's event plus a
+// timer on a TimerWheel at a millisecond a tick, so setting one up,
+// meeting it, timing it out or cancelling it is O(1) however many are
+// pending, and one thread serves them all by sleeping until the next
+// timer is due.
+//
+// Waits belong to the macro that made them. Each macro run gets a
+// higher group than the last, and preempting a group cancels the waits
+// of every macro started before it.
+class WaitScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        uint64_t met = 0;
+        uint64_t timedOut = 0;
+        uint64_t cancelled = 0;
+    };
+
+    // the group of waits no macro owns, such as the app's own waits on
+    // Live; no macro run preempts it
+    static constexpr uint64_t UNOWNED = std::numeric_limits<uint64_t>::max();
+
+    WaitScheduler();
+    // stop()s
+    ~WaitScheduler();
+
+    WaitScheduler(const WaitScheduler&) = delete;
+    auto operator=(const WaitScheduler&) -> WaitScheduler& = delete;
+    WaitScheduler(WaitScheduler&&) = delete;
+    auto operator=(WaitScheduler&&) -> WaitScheduler& = delete;
+
+    // ready once `condition` is signalled, or for Time once `ms` have
+    // passed. Any other condition not signalled within `ms` throws
+    // StepTimedOut. If it was signalled since `since`, a count from
+    // signals(), it's ready at once, so an event that came in between
+    // reading the count and waiting isn't missed. A wait in a preempted
+    // group, or made once stopped, throws StepCancelled
+    auto wait(WaitCondition condition, uint32_t ms, uint64_t group
+              , std::optional<uint64_t> since = std::nullopt) -> std::future<void>;
+
+    // meets every wait on `condition`
+    void signal(WaitCondition condition);
+
+    // how many times `condition` has been signalled
+    [[nodiscard]] auto signals(WaitCondition condition) const -> uint64_t;
+
+    // cancels the waits of every group below `group`, and any they make
+    // from now on
+    void preempt(uint64_t group);
+
+    // cancels what's waiting and joins the timer thread; later waits are
+    // cancelled straight away. Logs the stats
+    void stop();
+
+    [[nodiscard]] auto pending() const -> size_t;
+    [[nodiscard]] auto stats() const -> Stats;
+
+private:
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    struct Waiter {
+        std::promise<void> promise;
+        WaitCondition condition = WaitCondition::Time;
+        uint64_t group = 0;
+        TimerWheel::Handle timer;
+        // in subscribers_; Time waits aren't
+        uint32_t prev = NONE;
+        uint32_t next = NONE;
+        uint32_t generation = 0;
+        bool active = false;
+    };
+
+    struct WaiterRef {
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    struct Group {
+        size_t live = 0;
+        std::vector<WaiterRef> waiters;
+    };
+
+    enum class Outcome : uint8_t {
+        Met
+        , TimedOut
+        , Cancelled
+    };
+
+    void timerLoop();
+
+    // with mutex_ held
+    void advanceLocked();
+    void resolveLocked(uint32_t index, Outcome outcome);
+    // cancels the waits of the oldest group and takes it out
+    void cancelOldestLocked();
+    [[nodiscard]] auto tick() const -> TimerWheel::Tick;
+
+    const Clock::time_point start_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    TimerWheel wheel_;
+    // what the timer thread is asleep until; nullopt if nothing
+    std::optional<TimerWheel::Tick> sleepingUntil_;
+
+    std::vector<Waiter> waiters_;
+    std::vector<uint32_t> free_;
+    size_t pending_ = 0;
+
+    // the first waiter on each condition's list
+    std::array<uint32_t, WaitConditions::COUNT> subscribers_;
+    std::array<uint64_t, WaitConditions::COUNT> signals_{};
+
+    // by macro, oldest first
+    std::map<uint64_t, Group> groups_;
+    // groups below this are cancelled
+    uint64_t floor_ = 0;
+
+    Stats stats_;
+    bool stopping_ = false;
+    std::thread timer_;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "PluginCatalog.h"
+
+// Draws a result row with the matched parts of the name bolded and tinted.
+//
+// Shaping text is the expensive part of painting a row, so each row's glyph
+// layout is cached, keyed by (catalog version, query generation, row). Both
+// colours are applied at draw time, which means selection changes and
+// scrolling back over rows already seen never reshape anything.
+class MatchRowRenderer {
+public:
+    MatchRowRenderer() = default;
+    ~MatchRowRenderer() = default;
+
+    MatchRowRenderer(const MatchRowRenderer&) = delete;
+    auto operator=(const MatchRowRenderer&) -> MatchRowRenderer& = delete;
+    MatchRowRenderer(MatchRowRenderer&&) = delete;
+    auto operator=(MatchRowRenderer&&) -> MatchRowRenderer& = delete;
+
+    // drops every cached layout unless the rows are the same ones as before
+    void setRows(uint64_t catalogVersion, uint64_t generation);
+
+    void paint(juce::Graphics& g
+               , int row
+               , const std::string& name
+               , std::span<const MatchSpan> spans
+               , juce::Rectangle<float> area
+               , juce::Colour textColour
+               , juce::Colour highlightColour);
+
+    [[nodiscard]] auto cacheHits() const -> uint64_t { return hits_; }
+    [[nodiscard]] auto cacheMisses() const -> uint64_t { return misses_; }
+
+private:
+    // a list box never shows more than a screenful; this is several
+    static constexpr size_t MAX_CACHED_ROWS = 256;
+
+    struct Layout {
+        juce::GlyphArrangement glyphs;
+
+        // glyph index ranges drawn in the highlight colour
+        std::vector<juce::Range<int>> highlighted;
+    };
+
+    auto layoutFor(int row, const std::string& name, std::span<const MatchSpan> spans, float height) -> const Layout&;
+    void build(Layout& layout, const std::string& name, std::span<const MatchSpan> spans, float height) const;
+
+    uint64_t catalogVersion_ = 0;
+    uint64_t generation_ = 0;
+
+    juce::Font font_;
+    float rowHeight_ = 0.0f;
+
+    std::unordered_map<int, Layout> layouts_;
+
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
@@ -2,21 +2,26 @@
 
 #include <JuceHeader.h>
 
+#include <chrono>
 #include <memory>
 #include <vector>
 
 #include "IWindow.h"
+#include "LatencyHistogram.h"
+#include "Types.h"
 
 class IActionHandler;
 class IEventHandler;
-class IPluginManager;
 
+class CommandIndex;
 class LimLookAndFeel;
-class Plugin;
 class Theme;
 class WindowManager;
 
 class PluginListModel;
+class SearchWorker;
+class UsageStore;
+struct SearchResult;
 
 class OverlayComponent : public juce::Component
 {
@@ -92,23 +97,25 @@ public:
 
 class SearchBox : public juce::TopLevelWindow, public IWindow,
                   public juce::KeyListener,
-                  public juce::TextEditor::Listener,
-                  public juce::ListBoxModel {
+                  public juce::TextEditor::Listener {
 public:
     SearchBox(
-              std::function<std::shared_ptr<IPluginManager>()> pluginManager
+              std::function<std::shared_ptr<CommandIndex>()> commandIndex
               , std::function<std::shared_ptr<IEventHandler>()> eventHandler
               , std::function<std::shared_ptr<IActionHandler>()> actionHandler
               , std::function<std::shared_ptr<WindowManager>()> windowManager
               , std::function<std::shared_ptr<Theme>()> theme
               , std::function<std::shared_ptr<LimLookAndFeel>()> limLookAndFeel
+              , std::function<std::shared_ptr<UsageStore>()> usageStore
         );
     ~SearchBox() override;
 
     SearchBox(SearchBox&&) noexcept = delete;
     SearchBox& operator=(SearchBox&&) noexcept = delete;
 
+    void prewarm() override;
     void open() override;
+    void openRequestedAt(std::chrono::steady_clock::time_point requestedAt) override;
     void close() override;
 
     auto keyPressed(const juce::KeyPress& key, juce::Component* originatingComponent) -> bool override;
@@ -122,12 +129,14 @@ protected:
     // JUCE overrides for layout and input handling
     void resized() override;
     void paint(juce::Graphics& g) override;
-
-    auto getNumRows() -> int override;
-    void paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
+    void lookAndFeelChanged() override;
+    void activeWindowStatusChanged() override;
+    void focusOfChildComponentChanged(FocusChangeType cause) override;
 
 private:
-    static constexpr int DELAY_BEFORE_FOCUS = 100;
+    // macOS sometimes drops the first focus grab; retry every frame for a while
+    static constexpr int FOCUS_RETRY_INTERVAL = 16;
+    static constexpr int MAX_FOCUS_RETRIES    = 30;
     static constexpr int DELAY_BEFORE_CLOSE = 100;
 
     static constexpr int WIDGET_WIDTH  = 350;
@@ -141,25 +150,51 @@ private:
 
     static constexpr int SEARCHBOX_REMOVE_FROM_TOP = 30;
 
-    std::function<std::shared_ptr<IPluginManager>()> pluginManager_;
+    std::function<std::shared_ptr<CommandIndex>()> commandIndex_;
     std::function<std::shared_ptr<IEventHandler>()> eventHandler_;
     std::function<std::shared_ptr<IActionHandler>()> actionHandler_;
     std::function<std::shared_ptr<WindowManager>()> windowManager_;
     std::function<std::shared_ptr<Theme>()> theme_;
     std::function<std::shared_ptr<LimLookAndFeel>()> limLookAndFeel_;
+    std::function<std::shared_ptr<UsageStore>()> usageStore_;
 
     CenteredTextEditor searchField_;
     juce::ListBox listBox_;
     OverlayComponent overlayComponent_;
     std::unique_ptr<PluginListModel> pluginListModel_;
 
-    std::vector<Plugin> options_;
-    std::vector<Plugin> filteredOptions_;
+    std::unique_ptr<SearchWorker> searchWorker_;
+    uint64_t displayedGeneration_ = 0;
+    LatencyHistogram searchLatency_;
+
+    // from the hotkey to the window painting / the search field owning the keyboard
+    LatencyHistogram firstPaintLatency_;
+    LatencyHistogram focusLatency_;
+    std::chrono::steady_clock::time_point openRequestedAt_;
+    bool awaitingFirstPaint_ = false;
+    bool awaitingFocus_ = false;
+
+    // Live's window, measured when nobody is waiting on it: at prewarm,
+    // after the first paint of each open, and on close
+    ERect liveBounds_{};
+
+    // usage ranking for the pinned catalog, refreshed like liveBounds_
+    std::shared_ptr<const std::vector<uint16_t>> rankingBoosts_;
 
     void setSelectedRow(int row);
     int selectedRow_;
 
-    void focus();
+    // message thread only
+    void applySearchResult(const SearchResult& result);
+
+    void focus(int attempt);
+    void recordFocusIfGained();
+    void refreshLiveBounds();
+
+    // pins the newest catalog and its usage boosts; true if either
+    // changed. Hashes every name when usage has, so not on the open path
+    auto refreshRanking() -> bool;
+
     void setWindowGeometry();
     void resetFilters();
 
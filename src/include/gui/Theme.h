@@ -2,22 +2,136 @@
 
 #include <JuceHeader.h>
 
+#include <array>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
-#include <pugixml.hpp>
+class FileWatcher;
 
-class Theme {
+// Every Live theme key the UI reads. ThemeColour and the name table are
+// both generated from this list, so using a new colour is one line here.
+#define LIM_THEME_COLOURS(X)          \
+    X(Alert)                          \
+    X(Background)                     \
+    X(ControlBackground)              \
+    X(ControlContrastFrame)           \
+    X(ControlForeground)              \
+    X(ControlOnForeground)            \
+    X(ControlTextBack)                \
+    X(Desktop)                        \
+    X(RetroDisplayForegroundDisabled) \
+    X(SceneContrast)                  \
+    X(ScrollbarInnerHandleHover)      \
+    X(SearchIndication)               \
+    X(SelectionBackground)            \
+    X(SelectionForeground)            \
+    X(SelectionFrame)                 \
+    X(ShadowDark)                     \
+    X(SurfaceBackground)              \
+    X(SurfaceHighlight)               \
+    X(TreeColumnHeadControl)
+
+enum class ThemeColour : uint16_t {
+#define LIM_THEME_ENUM(name) name,
+    LIM_THEME_COLOURS(LIM_THEME_ENUM)
+#undef LIM_THEME_ENUM
+    Count
+};
+
+// One theme file, parsed into colours. Immutable once built, so a reload
+// can prepare a new one off the message thread and swap it in whole.
+class ThemePalette {
 public:
-    Theme(const std::filesystem::path& filePath);
+    static constexpr size_t SIZE = static_cast<size_t>(ThemeColour::Count);
 
-    auto getControlTextBack() -> juce::Colour;
+    // null if the file can't be read or isn't a theme
+    [[nodiscard]] static auto load(const std::filesystem::path& filePath) -> std::shared_ptr<const ThemePalette>;
 
-    auto getControlForeground() -> juce::Colour;
+    [[nodiscard]] static auto name(ThemeColour id) -> std::string_view;
+    [[nodiscard]] static auto find(std::string_view key) -> std::optional<ThemeColour>;
 
-    auto getColorValue(const std::string& tagName) -> juce::Colour;
+    // transparent when the theme doesn't define the key
+    [[nodiscard]] auto colour(ThemeColour id) const -> juce::Colour {
+        return colours_[static_cast<size_t>(id)];
+    }
+    [[nodiscard]] auto colour(std::string_view key) const -> juce::Colour;
 
 private:
-    pugi::xml_document doc;
+    std::array<juce::Colour, SIZE> colours_;
+
+    // keys that aren't in LIM_THEME_COLOURS, for lookups by name
+    std::unordered_map<std::string, juce::Colour> others_;
+};
+
+// Where Live records the theme it's showing.
+struct LiveThemeSelection {
+    // Live's Preferences.cfg
+    std::filesystem::path preferences;
+
+    // the folder the .ask files it picks from are in
+    std::filesystem::path themes;
+
+    // the theme `preferences` names, if it's one of those in `themes`.
+    // Preferences.cfg isn't documented, so this looks for the names of
+    // the themes there are, as UTF-16 or plain text, and takes the
+    // longest one found ("Default Dark" is part of "Default Dark High")
+    [[nodiscard]] auto selected() const -> std::optional<std::filesystem::path>;
+};
+
+// A Live theme file's colours. Reloads itself when the file changes on
+// disk and sends a change message (on the message thread) once the new
+// palette is in place. Given a LiveThemeSelection it also follows a theme
+// switch in Live, moving on to the newly selected file. The palette is
+// published with std::atomic_store, so lookups from paint code never wait
+// on a reload; code reading several colours should pin palette() once.
+class Theme : public juce::ChangeBroadcaster {
+public:
+    // `filePath` is used until, or unless, `selection` names a theme
+    explicit Theme(std::filesystem::path filePath, std::optional<LiveThemeSelection> selection = std::nullopt);
+    ~Theme() override;
+
+    Theme(const Theme&) = delete;
+    auto operator=(const Theme&) -> Theme& = delete;
+    Theme(Theme&&) = delete;
+    auto operator=(Theme&&) -> Theme& = delete;
+
+    [[nodiscard]] auto colour(ThemeColour id) const -> juce::Colour;
+
+    // for keys only known at runtime; prefer the ThemeColour overload
+    [[nodiscard]] auto getColorValue(const std::string& tagName) const -> juce::Colour;
+
+    [[nodiscard]] auto getControlTextBack() const -> juce::Colour;
+    [[nodiscard]] auto getControlForeground() const -> juce::Colour;
+
+    [[nodiscard]] auto palette() const -> std::shared_ptr<const ThemePalette>;
+
+    // re-reads the file, keeping the current palette if the new one is unusable
+    void reload();
+
+private:
+    // moves to the theme Live now has selected, if that's another file
+    void followSelection();
+
+    // the watcher for filePath_
+    [[nodiscard]] auto watchFile() -> std::unique_ptr<FileWatcher>;
+
+    // filePath_ changes when the selection does; reloads read it under this
+    std::mutex fileMutex_;
+    std::filesystem::path filePath_;
+
+    std::optional<LiveThemeSelection> selection_;
+
+    // written with std::atomic_store, read with std::atomic_load
+    std::shared_ptr<const ThemePalette> palette_;
 
+    // replaced from selectionWatcher_'s thread when the theme switches,
+    // and only touched from there once that's running
+    std::unique_ptr<FileWatcher> fileWatcher_;
+    std::unique_ptr<FileWatcher> selectionWatcher_;
 };
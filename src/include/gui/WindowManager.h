@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <unordered_map>
 #include <string>
 #include <memory>
@@ -12,9 +13,12 @@ class IEventHandler;
 class IPluginManager;
 class IWindow;
 
+class CommandIndex;
 class ConfigMenu;
+class FocusTracker;
 class LimLookAndFeel;
 class Theme;
+class UsageStore;
 
 class WindowManager {
 public:
@@ -26,13 +30,19 @@ public:
                  , std::function<std::shared_ptr<Theme>()> theme
                  , std::function<std::shared_ptr<LimLookAndFeel>()> limLookAndFeel
                  , std::function<std::shared_ptr<ConfigMenu>()> configMenu
+                 , std::function<std::shared_ptr<UsageStore>()> usageStore
+                 , std::function<std::shared_ptr<CommandIndex>()> commandIndex
+                 , std::function<std::shared_ptr<FocusTracker>()> focusTracker
        );
 
     // TODO remove unused "override callback" param
     void registerWindow(const std::string& windowName, std::function<void()> callback = nullptr);
     [[nodiscard]] auto getWindowHandle(const std::string& windowName) const -> void*;
 
-    void openWindow(const std::string& windowName);
+    // creates the window if needed and lets it get ready while hidden
+    void prewarmWindow(const std::string& windowName);
+
+    void openWindow(const std::string& windowName, std::chrono::steady_clock::time_point requestedAt = std::chrono::steady_clock::now());
 
     void closeWindow(const std::string& windowName);
 
@@ -49,6 +59,12 @@ private:
     std::function<std::shared_ptr<Theme>()> theme_;
     std::function<std::shared_ptr<LimLookAndFeel>()> limLookAndFeel_;
     std::function<std::shared_ptr<ConfigMenu>()> configMenu_;
+    std::function<std::shared_ptr<UsageStore>()> usageStore_;
+    std::function<std::shared_ptr<CommandIndex>()> commandIndex_;
+    std::function<std::shared_ptr<FocusTracker>()> focusTracker_;
+
+    // records the state and tells the focus tracker about the search box
+    void setWindowState(const std::string& windowName, bool open);
 
     // Factory function to create window instances based on window name
     auto createWindowInstance(const std::string& windowName) -> std::unique_ptr<IWindow>;
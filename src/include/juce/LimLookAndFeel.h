@@ -1,9 +1,13 @@
 #pragma once
 
 #include <JuceHeader.h>
+
+#include <functional>
+#include <memory>
+
 #include "Theme.h"
 
-class LimLookAndFeel : public juce::LookAndFeel_V4 {
+class LimLookAndFeel : public juce::LookAndFeel_V4, private juce::ChangeListener {
 public:
     LimLookAndFeel(std::function<std::shared_ptr<Theme>()> theme)
         : theme_(std::move(theme))
@@ -41,24 +45,27 @@ public:
     //
     //    Hex: #bed6f4 (RGB: 190, 214, 244)
     //    This is a light blue, close to the desired color but a little lighter and more saturated.
-        setColour(juce::TextEditor::backgroundColourId, theme_()->getColorValue("SurfaceBackground"));
-        setColour(juce::TextEditor::textColourId, theme_()->getColorValue("ControlForeground"));
-
-        setColour(juce::TextEditor::highlightColourId, theme_()->getColorValue("SelectionBackground"));
-        setColour(juce::TextEditor::highlightedTextColourId, theme_()->getColorValue("ControlOnForeground"));
-        setColour(juce::TextEditor::outlineColourId, theme_()->getColorValue("Desktop"));
-        setColour(juce::TextEditor::focusedOutlineColourId, theme_()->getColorValue("ControlContrastFrame"));
-        setColour(juce::TextEditor::shadowColourId, theme_()->getColorValue("ShadowDark"));
 
-        setColour(juce::ListBox::backgroundColourId, theme_()->getColorValue("SurfaceBackground"));
-        setColour(juce::ListBox::textColourId, theme_()->getColorValue("ControlForeground"));
-        //setColour(juce::ListBox::outlineColourId, theme_()->getColorValue("ControlBackground"));
+        applyColours();
 
-        setColour(juce::ScrollBar::backgroundColourId, theme_()->getColorValue("Desktop"));
-        setColour(juce::ScrollBar::thumbColourId, theme_()->getColorValue("ScrollbarInnerHandleHover"));
+        // picks up Live theme switches
+        if (auto theme = theme_()) {
+            theme->addChangeListener(this);
+            subscribedTheme_ = theme;
+        }
+    }
 
+    ~LimLookAndFeel() override {
+        if (auto theme = subscribedTheme_.lock()) {
+            theme->removeChangeListener(this);
+        }
     }
 
+    LimLookAndFeel(const LimLookAndFeel&) = delete;
+    auto operator=(const LimLookAndFeel&) -> LimLookAndFeel& = delete;
+    LimLookAndFeel(LimLookAndFeel&&) = delete;
+    auto operator=(LimLookAndFeel&&) -> LimLookAndFeel& = delete;
+
     void drawListBoxOutline(juce::Graphics& g, int width, int height);
 
     juce::Typeface::Ptr getTypefaceForFont(const juce::Font& font) override {
@@ -66,7 +73,7 @@ public:
     }
 
     juce::CaretComponent* createCaretComponent(juce::Component* keyFocusOwner) override {
-        cursorColor_ = theme_()->getColorValue("Alert");
+        cursorColor_ = theme_()->colour(ThemeColour::Alert);
         auto caret = juce::LookAndFeel_V4::createCaretComponent(keyFocusOwner);
         if (caret != nullptr) {
             caret->setColour(juce::CaretComponent::caretColourId, cursorColor_);
@@ -106,7 +113,7 @@ public:
         //}
 
         // Draw scrollbar thumb
-        g.setColour(theme_()->getColorValue("TreeColumnHeadControl"));
+        g.setColour(theme_()->colour(ThemeColour::TreeColumnHeadControl));
 
         float padding = 2.0f;
         //float cornerRadius = juce::jmin(width, height) * 0.5f;
@@ -139,9 +146,9 @@ public:
 
     void drawTextEditorOutline (juce::Graphics& g, int width, int height, juce::TextEditor& textEditor) override {
         // Set the color for the outline (use different colors if it's focused or not)
-        juce::Colour outlineColour = textEditor.hasKeyboardFocus (true)
-                                     ? theme_()->getColorValue("ControlForeground")
-                                     : theme_()->getColorValue("SelectionForeground");
+        juce::Colour outlineColour = theme_()->colour(textEditor.hasKeyboardFocus (true)
+                                                      ? ThemeColour::ControlForeground
+                                                      : ThemeColour::SelectionForeground);
 
         // Set the thickness of the border
         const float borderThickness = 1.0f;  // Customize the border thickness
@@ -154,9 +161,44 @@ public:
 
 private:
     std::function<std::shared_ptr<Theme>()> theme_;
+    std::weak_ptr<Theme> subscribedTheme_;
     juce::MemoryBlock fontData_;
     juce::Typeface::Ptr customTypeface_;
     juce::Colour cursorColor_;
+
+    void applyColours() {
+        auto palette = theme_()->palette();
+        auto colour = [&palette](ThemeColour id) { return palette->colour(id); };
+
+        setColour(juce::TextEditor::backgroundColourId, colour(ThemeColour::SurfaceBackground));
+        setColour(juce::TextEditor::textColourId, colour(ThemeColour::ControlForeground));
+
+        setColour(juce::TextEditor::highlightColourId, colour(ThemeColour::SelectionBackground));
+        setColour(juce::TextEditor::highlightedTextColourId, colour(ThemeColour::ControlOnForeground));
+        setColour(juce::TextEditor::outlineColourId, colour(ThemeColour::Desktop));
+        setColour(juce::TextEditor::focusedOutlineColourId, colour(ThemeColour::ControlContrastFrame));
+        setColour(juce::TextEditor::shadowColourId, colour(ThemeColour::ShadowDark));
+
+        setColour(juce::ListBox::backgroundColourId, colour(ThemeColour::SurfaceBackground));
+        setColour(juce::ListBox::textColourId, colour(ThemeColour::ControlForeground));
+        //setColour(juce::ListBox::outlineColourId, colour(ThemeColour::ControlBackground));
+
+        setColour(juce::ScrollBar::backgroundColourId, colour(ThemeColour::Desktop));
+        setColour(juce::ScrollBar::thumbColourId, colour(ThemeColour::ScrollbarInnerHandleHover));
+    }
+
+    // the theme reloaded; re-read the colour IDs and let every window
+    // know, since components cache colours in lookAndFeelChanged()
+    void changeListenerCallback(juce::ChangeBroadcaster*) override {
+        applyColours();
+
+        auto& desktop = juce::Desktop::getInstance();
+        for (int i = 0; i < desktop.getNumComponents(); ++i) {
+            if (auto* component = desktop.getComponent(i)) {
+                component->sendLookAndFeelChange();
+            }
+        }
+    }
 };
 
 
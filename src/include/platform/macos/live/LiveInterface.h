@@ -13,12 +13,16 @@
 
 #include "ILiveInterface.h"
 
+class FocusTracker;
 class IEventHandler;
+class WaitScheduler;
 
 class LiveInterface : public ILiveInterface {
 public:
     LiveInterface(
           std::function<std::shared_ptr<IEventHandler>()> eventHandler
+          , std::function<std::shared_ptr<FocusTracker>()> focusTracker
+          , std::function<std::shared_ptr<WaitScheduler>()> waits
     );
 
     ~LiveInterface() override;
@@ -41,6 +45,9 @@ public:
 
 private:
     std::function<std::shared_ptr<IEventHandler>()> eventHandler_;
+    std::function<std::shared_ptr<FocusTracker>()> focusTracker_;
+    // told when a plugin window opens, for macros waiting on one
+    std::function<std::shared_ptr<WaitScheduler>()> waits_;
     void setWindowBounds(AXUIElementRef window, int x, int y, int width, int height);
     std::map<AXUIElementRef, CGRect> cachedWindowBounds_;
     CGRect getWindowBounds(AXUIElementRef window);
@@ -57,4 +64,12 @@ private:
     static void pluginWindowDestroyCallback(AXObserverRef observer, AXUIElementRef element,
                                      CFStringRef notification, void* context);
 
+    // keeps the focus tracker current as focus moves around Live, so the
+    // key handler never has to ask accessibility on a key press
+    AXObserverRef focusObserver_;
+    void setupFocusObserver();
+    void refreshFocus();
+    static void focusChangedCallback(AXObserverRef observer, AXUIElementRef element,
+                                     CFStringRef notification, void* context);
+
 };
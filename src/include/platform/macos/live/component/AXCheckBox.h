@@ -12,6 +12,7 @@ namespace AXCheckBox {
 
     // for closing and re-opening opened plugin windows
     // so that the plugin window order is correct in
-    // the main window's AXChildren
+    // the main window's AXChildren. Returns once both presses
+    // are handled; the window reopens after that
     bool toggleOffOn(AXUIElementRef checkbox);
 }
@@ -7,12 +7,16 @@
 
 #include "ILiveInterface.h"
 
+class FocusTracker;
 class IEventHandler;
+class WaitScheduler;
 
 class LiveInterface : public ILiveInterface {
 public:
     LiveInterface(
         std::function<std::shared_ptr<IEventHandler>()> eventHandler
+        , std::function<std::shared_ptr<FocusTracker>()> focusTracker
+        , std::function<std::shared_ptr<WaitScheduler>()> waits
     );
 
     ~LiveInterface() override;
@@ -28,4 +32,11 @@ public:
 private:
     std::function<std::shared_ptr<EventHandler>()> eventHandler_;
 
+    // TODO nothing reports focus on Windows yet, so only the search box
+    // context (set by WindowManager) and Global apply there
+    std::function<std::shared_ptr<FocusTracker>()> focusTracker_;
+    // nothing watches for plugin windows here yet, so wait.pluginWindow
+    // steps run out their timeout
+    std::function<std::shared_ptr<WaitScheduler>()> waits_;
+
 };
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "IWindow.h"
+#include "PluginCatalog.h"
+
+// Everything the search box can run: the plugin catalog, the context menu
+// entries and the named actions, merged into one catalog so a single
+// search covers all of them and picking a row knows what to dispatch.
+//
+// Each source is replaced on its own. A plugin refresh doesn't re-flatten
+// the menu, and a menu or action change doesn't refold the plugin names:
+// the new snapshot copies the plugin part of the last one and only builds
+// keys for the commands.
+class CommandIndex {
+public:
+    CommandIndex();
+    ~CommandIndex() = default;
+
+    CommandIndex(const CommandIndex&) = delete;
+    auto operator=(const CommandIndex&) -> CommandIndex& = delete;
+    CommandIndex(CommandIndex&&) = delete;
+    auto operator=(CommandIndex&&) -> CommandIndex& = delete;
+
+    // any thread; each publishes a new snapshot
+    void setPlugins(PluginCatalogPtr plugins);
+    void setMenu(const std::vector<MenuItem>& menu);
+    void setActions(const std::vector<std::string>& actions);
+
+    // plugins first, then menu items in menu order, then actions
+    [[nodiscard]] auto snapshot() const -> PluginCatalogPtr;
+
+    // leaf items of the context menu, with the path of categories leading
+    // to them as the detail; separators and entries that only repeat a
+    // plugin's own name are left out, the plugin row already covers those
+    [[nodiscard]] static auto menuCommands(const std::vector<MenuItem>& menu) -> std::vector<Command>;
+
+    // "closeAllPlugins" -> "Close All Plugins"
+    [[nodiscard]] static auto actionLabel(std::string_view name) -> std::string;
+
+private:
+    // with mutex_ held
+    void publish();
+
+    mutable std::mutex mutex_;
+    PluginCatalogPtr plugins_;
+    std::vector<Command> menu_;
+    std::vector<Command> actions_;
+    uint64_t version_ = 0;
+
+    // swapped atomically so search threads can pin it without the mutex
+    PluginCatalogPtr snapshot_;
+};
+
+using CommandIndexPtr = std::shared_ptr<CommandIndex>;
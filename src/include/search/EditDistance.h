@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// Myers' bit-parallel edit distance (Hyyro's formulation) for patterns of
+// up to 64 bytes. The pattern is compiled once into per-byte match masks;
+// each text byte then costs a handful of word operations.
+class BoundedEditMatcher {
+public:
+    static constexpr size_t MAX_PATTERN = 64;
+
+    BoundedEditMatcher() = default;
+    explicit BoundedEditMatcher(std::string_view pattern);
+
+    void assign(std::string_view pattern);
+
+    [[nodiscard]] auto patternLength() const -> size_t { return length_; }
+
+    // Levenshtein distance between the pattern and the closest prefix of
+    // `text`, or maxErrors + 1 if every prefix needs more than maxErrors
+    // edits. Matching against prefixes keeps a half-typed word matching.
+    [[nodiscard]] auto prefixDistance(std::string_view text, uint32_t maxErrors) const -> uint32_t;
+
+    // plain Levenshtein distance between the pattern and the whole of `text`
+    [[nodiscard]] auto distance(std::string_view text) const -> uint32_t;
+
+private:
+    std::array<uint64_t, 256> peq_{}; // NOLINT
+    uint64_t highBit_ = 0;
+    size_t length_ = 0;
+};
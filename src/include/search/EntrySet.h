@@ -0,0 +1,84 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// A set of catalog indices as a bitmap, one bit per entry. Query
+// predicates are combined with word-wide and/or before any string
+// matching, and the scorer only visits the bits left standing.
+class EntrySet {
+public:
+    // resizes to `size` entries, all in or all out; keeps the storage
+    void reset(uint32_t size, bool value) {
+        size_ = size;
+        words_.assign((size + WORD_BITS - 1) / WORD_BITS, value ? ~uint64_t(0) : 0);
+        if (value && size % WORD_BITS != 0) {
+            words_.back() = (uint64_t(1) << (size % WORD_BITS)) - 1;
+        }
+    }
+
+    // entries past the old size start out; shrinking drops the ones cut off
+    void resize(uint32_t size) {
+        words_.resize((size + WORD_BITS - 1) / WORD_BITS, 0);
+        size_ = size;
+        if (size % WORD_BITS != 0) {
+            words_.back() &= (uint64_t(1) << (size % WORD_BITS)) - 1;
+        }
+    }
+
+    void insert(uint32_t index) {
+        words_[index / WORD_BITS] |= uint64_t(1) << (index % WORD_BITS);
+    }
+
+    [[nodiscard]] auto contains(uint32_t index) const -> bool {
+        return index < size_ && (words_[index / WORD_BITS] >> (index % WORD_BITS) & 1) != 0;
+    }
+
+    // both sets have to cover the same catalog
+    void intersect(const EntrySet& other) {
+        for (size_t w = 0; w < words_.size(); ++w) {
+            words_[w] &= other.words_[w];
+        }
+    }
+
+    void unite(const EntrySet& other) {
+        for (size_t w = 0; w < words_.size(); ++w) {
+            words_[w] |= other.words_[w];
+        }
+    }
+
+    [[nodiscard]] auto count() const -> uint32_t {
+        uint32_t total = 0;
+        for (uint64_t word : words_) {
+            total += static_cast<uint32_t>(std::popcount(word));
+        }
+        return total;
+    }
+
+    [[nodiscard]] auto size() const -> uint32_t { return size_; }
+
+    // calls fn(index) for every member in ascending order; stops early
+    // and returns false as soon as fn does
+    template <typename Fn>
+    auto forEach(Fn&& fn) const -> bool {
+        for (size_t w = 0; w < words_.size(); ++w) {
+            uint64_t word = words_[w];
+            while (word != 0) {
+                const auto bit = static_cast<uint32_t>(std::countr_zero(word));
+                if (!fn(static_cast<uint32_t>(w) * WORD_BITS + bit)) {
+                    return false;
+                }
+                word &= word - 1;
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr uint32_t WORD_BITS = 64;
+
+    std::vector<uint64_t> words_;
+    uint32_t size_ = 0;
+};
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "EntrySet.h"
+#include "Types.h"
+
+// a run of word bytes inside a search key, offsets relative to the key
+struct KeyToken {
+    uint16_t offset;
+    uint16_t length;
+};
+
+// a byte range of the original (display) name, e.g. a highlighted match
+struct MatchSpan {
+    uint16_t offset;
+    uint16_t length;
+};
+
+// the plugin formats Live reports, collapsed to what people filter by
+enum class PluginFormat : uint8_t {
+    VST3
+    , VST2
+    , AU
+    , Other
+    , Count
+};
+
+// what picking an entry does
+enum class EntryKind : uint8_t {
+    Plugin
+    , MenuItem
+    , Action
+};
+
+// a searchable entry that isn't a plugin: a context menu item or a named action
+struct Command {
+    EntryKind kind;
+    std::string label;      // shown and searched
+    std::string detail;     // where it comes from, e.g. the menu path
+    std::string action;     // for IActionHandler::handleAction
+};
+
+// why a name didn't resolve to a plugin
+enum class NameMiss : uint8_t {
+    None
+    , Empty
+    , NotInstalled
+    , NotInFormat           // "Pro-Q 3 AU" when only the VST3 is installed
+    , AliasTargetMissing    // the alias is configured, its plugin isn't there
+};
+
+struct PluginLookup {
+    uint32_t index = UINT32_MAX;
+    NameMiss miss = NameMiss::None;
+
+    // the configured target, for AliasTargetMissing
+    std::string_view target;
+
+    [[nodiscard]] auto found() const -> bool { return miss == NameMiss::None; }
+};
+
+// alias -> plugin name, optionally format qualified ("Pro-Q 3 AU")
+using PluginAliases = std::unordered_map<std::string, std::string>;
+
+// Immutable snapshot of the plugin list plus everything the search path
+// needs precomputed. Built once per plugin refresh and shared by pointer,
+// so readers on any thread can pin a version without locking.
+//
+// Plugins come first, at [0, pluginCount()); commands follow them.
+class PluginCatalog {
+public:
+    static constexpr uint32_t NO_VENDOR = UINT32_MAX;
+
+    explicit PluginCatalog(std::vector<Plugin> plugins, uint64_t version = 0, const PluginAliases& aliases = {});
+
+    // the plugins of `plugins` followed by `commands`; the plugin keys and
+    // columns are copied rather than rebuilt, so only the commands are folded
+    PluginCatalog(const PluginCatalog& plugins, std::vector<Command> commands, uint64_t version);
+
+    PluginCatalog(const PluginCatalog&) = delete;
+    auto operator=(const PluginCatalog&) -> PluginCatalog& = delete;
+    PluginCatalog(PluginCatalog&&) = delete;
+    auto operator=(PluginCatalog&&) -> PluginCatalog& = delete;
+    ~PluginCatalog() = default;
+
+    [[nodiscard]] auto size() const -> uint32_t;
+    [[nodiscard]] auto empty() const -> bool;
+    [[nodiscard]] auto version() const -> uint64_t;
+
+    [[nodiscard]] auto pluginCount() const -> uint32_t;
+    [[nodiscard]] auto kind(uint32_t index) const -> EntryKind;
+
+    // what the row shows, whatever the kind
+    [[nodiscard]] auto name(uint32_t index) const -> const std::string&;
+
+    // index < pluginCount()
+    [[nodiscard]] auto plugin(uint32_t index) const -> const Plugin&;
+    [[nodiscard]] auto plugins() const -> const std::vector<Plugin>&;
+
+    // index >= pluginCount()
+    [[nodiscard]] auto command(uint32_t index) const -> const Command&;
+    [[nodiscard]] auto commands() const -> const std::vector<Command>&;
+
+    // case-folded, accent-stripped name bytes (UTF-8) used by the matchers;
+    // queries have to go through TextFold as well to compare against them
+    [[nodiscard]] auto searchKey(uint32_t index) const -> std::string_view;
+
+    // word boundaries of the search key, for the per-token matchers
+    [[nodiscard]] auto tokens(uint32_t index) const -> std::span<const KeyToken>;
+
+    // maps search key bytes [keyBegin, keyEnd) back onto the display name;
+    // folding changes lengths ("ü" is two bytes, "ß" becomes "ss")
+    [[nodiscard]] auto nameSpan(uint32_t index, uint32_t keyBegin, uint32_t keyEnd) const -> MatchSpan;
+
+    // Columns for query predicates. Every plugin has exactly one format and
+    // one vendor; the vendor is the part of the uri before the first ':'.
+    // Commands are format Other and have NO_VENDOR.
+    [[nodiscard]] static auto formatOf(std::string_view type) -> PluginFormat;
+    [[nodiscard]] auto format(uint32_t index) const -> PluginFormat;
+    [[nodiscard]] auto formatEntries(PluginFormat format) const -> const EntrySet&;
+
+    [[nodiscard]] auto vendorCount() const -> uint32_t;
+    [[nodiscard]] auto vendor(uint32_t index) const -> uint32_t;
+    [[nodiscard]] auto vendorName(uint32_t vendor) const -> std::string_view;
+    [[nodiscard]] auto vendorKey(uint32_t vendor) const -> std::string_view;   // folded
+
+    // plugins by that vendor, ascending
+    [[nodiscard]] auto vendorEntries(uint32_t vendor) const -> std::span<const uint32_t>;
+
+    // Resolves a name the way a "plugin.X" step or a menu item gives it:
+    // case and accent insensitive, then through the configured aliases,
+    // then as "<name> <format>" (VST3, VST2/VST, AU/AUv2/AUv3). With the
+    // same name in several formats the first in catalog order wins. One
+    // hash probe per step.
+    [[nodiscard]] auto findPlugin(std::string_view name) const -> PluginLookup;
+
+    // the plugin Live numbers `number`, as in a "load_item,N" request;
+    // UINT32_MAX if there's none. A binary search
+    [[nodiscard]] auto findNumber(int number) const -> uint32_t;
+
+    // "Pro-Q 3 AU is installed, but not as AU" and so on, for logging
+    [[nodiscard]] static auto missReason(std::string_view name, const PluginLookup& lookup) -> std::string;
+
+private:
+    // open addressing, linear probing; a slot holds the hash of a folded
+    // name and what it points at, aliases tagged with ALIAS_BIT
+    struct NameSlot {
+        uint32_t hash;
+        uint32_t value;
+    };
+
+    static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+    static constexpr uint32_t ALIAS_BIT = 0x80000000U;
+
+    void appendKey(std::string_view name);
+    void tokenize(std::string_view key);
+    void buildColumns();
+    void buildNameIndex(const PluginAliases& aliases);
+    void buildNumberIndex();
+
+    void insertName(uint32_t hash, uint32_t value);
+
+    // first plugin whose folded name is `key`, in `format` unless Count
+    [[nodiscard]] auto findName(std::string_view key, uint32_t hash, PluginFormat format) const -> uint32_t;
+    [[nodiscard]] auto findAlias(std::string_view key, uint32_t hash) const -> uint32_t;
+    [[nodiscard]] auto findQualified(std::string_view key, PluginLookup& lookup) const -> bool;
+
+    std::vector<Plugin> plugins_;
+    std::vector<Command> commands_;
+
+    // all keys packed back to back, keyOffsets_[i]..keyOffsets_[i + 1]
+    std::string keyData_;
+    std::vector<uint32_t> keyOffsets_;
+
+    // for every byte of keyData_, where in the name its character starts
+    std::vector<uint16_t> nameOffsets_;
+
+    // tokens for entry i live at tokenOffsets_[i]..tokenOffsets_[i + 1]
+    std::vector<KeyToken> tokens_;
+    std::vector<uint32_t> tokenOffsets_;
+
+    std::vector<PluginFormat> formats_;
+    std::array<EntrySet, static_cast<size_t>(PluginFormat::Count)> formatEntries_;
+
+    std::vector<uint32_t> vendors_;
+    std::vector<std::string> vendorNames_;
+    std::vector<std::string> vendorKeys_;
+
+    // entries of vendor v at vendorPostings_[vendorOffsets_[v]..vendorOffsets_[v + 1]]
+    std::vector<uint32_t> vendorPostings_;
+    std::vector<uint32_t> vendorOffsets_;
+
+    // power-of-two sized, at most half full
+    std::vector<NameSlot> nameSlots_;
+
+    // alias i: folded key, target as configured, the plugin it resolved to
+    std::vector<std::string> aliasKeys_;
+    std::vector<std::string> aliasTargets_;
+    std::vector<uint32_t> aliasEntries_;
+
+    // (Plugin::number, plugin index), ascending by number
+    std::vector<std::pair<int, uint32_t>> numberIndex_;
+
+    uint64_t version_;
+};
+
+using PluginCatalogPtr = std::shared_ptr<const PluginCatalog>;
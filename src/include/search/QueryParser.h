@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// the catalog columns a query can filter on
+enum class QueryField : uint8_t {
+    Format
+    , Vendor
+};
+
+struct QueryPredicate {
+    QueryField field;
+    std::string value;      // folded like search keys
+};
+
+// A search box query split into field predicates and the free text the
+// matchers score. Several values for one field widen it ("fmt:vst3 fmt:au"
+// or "fmt:vst3,au"); different fields narrow each other.
+struct ParsedQuery {
+    std::string text;
+    std::vector<QueryPredicate> predicates;
+};
+
+namespace QueryParser {
+    // Recognises "fmt:" (or "format:") and "vendor:" at the start of a word,
+    // with the value running to the next space, or to the closing quote for
+    // `vendor:"native instruments"`. A predicate without a value is dropped,
+    // so the list doesn't empty while a value is still being typed. Anything
+    // else, including unknown fields, is free text.
+    //
+    // Reuses the storage already in `out`.
+    void parse(std::string_view query, ParsedQuery& out);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "PluginCatalog.h"
+#include "SearchEngine.h"
+
+// What the search box list shows: catalog indices plus the highlighted
+// parts of each name, resolved through the catalog snapshot they were
+// computed against. Buffers are reused, so once they've grown to the
+// catalog size, replacing the rows doesn't allocate.
+class ResultList {
+public:
+    ResultList() = default;
+    ~ResultList() = default;
+
+    ResultList(const ResultList&) = delete;
+    auto operator=(const ResultList&) -> ResultList& = delete;
+    ResultList(ResultList&&) = delete;
+    auto operator=(ResultList&&) -> ResultList& = delete;
+
+    // sizes the buffers for a catalog so later updates stay allocation free
+    void reserve(const PluginCatalog& catalog);
+
+    // every catalog entry in catalog order, nothing highlighted
+    void showAll(PluginCatalogPtr catalog);
+
+    // spans for row i are spans[spanOffsets[i]..spanOffsets[i + 1]]
+    void assign(PluginCatalogPtr catalog, std::span<const SearchMatch> matches, std::span<const MatchSpan> spans, std::span<const uint32_t> spanOffsets);
+
+    [[nodiscard]] auto size() const -> uint32_t;
+    [[nodiscard]] auto catalog() const -> const PluginCatalogPtr&;
+
+    [[nodiscard]] auto catalogIndex(uint32_t row) const -> uint32_t;
+
+    // nullptr when the row is out of range
+    [[nodiscard]] auto name(int row) const -> const std::string*;
+
+    // nullptr as well when the row is a command rather than a plugin
+    [[nodiscard]] auto plugin(int row) const -> const Plugin*;
+    [[nodiscard]] auto spans(uint32_t row) const -> std::span<const MatchSpan>;
+
+private:
+    PluginCatalogPtr catalog_;
+    std::vector<uint32_t> indices_;
+    std::vector<MatchSpan> spans_;
+    std::vector<uint32_t> spanOffsets_;
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "EditDistance.h"
+#include "EntrySet.h"
+#include "QueryParser.h"
+
+class PluginCatalog;
+enum class PluginFormat : uint8_t;
+struct MatchSpan;
+
+// Lets a long scan notice that a newer query has been submitted
+// and bail out early. A default constructed token never cancels.
+class CancellationToken {
+public:
+    CancellationToken() = default;
+    CancellationToken(const std::atomic<uint64_t>& latestGeneration, uint64_t generation)
+        : latestGeneration_(&latestGeneration)
+        , generation_(generation)
+    {}
+
+    [[nodiscard]] auto isCancelled() const -> bool {
+        return latestGeneration_ != nullptr
+            && latestGeneration_->load(std::memory_order_relaxed) != generation_;
+    }
+
+private:
+    const std::atomic<uint64_t>* latestGeneration_ = nullptr;
+    uint64_t generation_ = 0;
+};
+
+// higher tiers always rank above lower ones, regardless of in-tier score
+enum class MatchTier : uint8_t {
+    Approximate = 0
+    , Fuzzy = 1
+    , Substring = 2
+    , Prefix = 3
+};
+
+struct SearchMatch {
+    uint32_t index;
+    int32_t score;
+};
+
+// Per-entry ranking nudge aligned with catalog indices, e.g. from usage
+// history. Only reorders matches within a tier, never across tiers.
+using RankingBoosts = std::vector<uint16_t>;
+using RankingBoostsPtr = std::shared_ptr<const RankingBoosts>;
+
+struct SearchOptions {
+    // the typo-tolerant tier only runs when the exact and fuzzy tiers
+    // together found fewer than this many entries
+    uint32_t approximateThreshold = 5;
+
+    // upper bound on edits per query word; short words get less slack
+    uint32_t maxErrors = 2;
+};
+
+class SearchEngine {
+public:
+    explicit SearchEngine(SearchOptions options = {});
+
+    // the largest boost; a fully boosted entry outranks anything else in its tier
+    static constexpr uint16_t MAX_BOOST = 999;
+
+    // Scores every catalog entry against the query and writes the matches to
+    // `out`, best first. Returns false if the token was cancelled mid-scan,
+    // in which case `out` holds a partial result and should be discarded.
+    // Boosts that don't line up with the catalog are ignored.
+    //
+    // Field predicates in the query ("fmt:vst3", "vendor:fabfilter", see
+    // QueryParser) are resolved to a set of entries first; only those are
+    // scored against the remaining text.
+    auto search(const PluginCatalog& catalog, std::string_view query, const CancellationToken& token, std::vector<SearchMatch>& out, std::span<const uint16_t> boosts = {}) -> bool;
+
+    // Appends the parts of the entry's display name that matched the most
+    // recent search() query, in name order. Call it for the entries that
+    // search() returned, before the next search().
+    void highlight(const PluginCatalog& catalog, uint32_t index, std::vector<MatchSpan>& out) const;
+
+    // 0 means no match
+    [[nodiscard]] static auto score(std::string_view key, std::string_view normalizedQuery) -> int32_t;
+
+private:
+    static constexpr int32_t TIER_WIDTH = 1000;
+
+    // how many entries to score between cancellation checks
+    static constexpr uint32_t CANCEL_CHECK_INTERVAL = 256;
+
+    // query words beyond this are ignored by the approximate tier
+    static constexpr size_t MAX_APPROXIMATE_WORDS = 8;
+
+    // spreads tiers apart so in-tier score plus boost can't reach the next tier
+    [[nodiscard]] static auto blend(int32_t score, uint16_t boost) -> int32_t;
+
+    [[nodiscard]] static auto fuzzyScore(std::string_view key, std::string_view query) -> int32_t;
+    [[nodiscard]] static auto isWordStart(std::string_view key, size_t pos) -> bool;
+
+    void normalizeQuery(std::string_view query);
+
+    // builds filter_ from the parsed predicates; false when there are none
+    auto compileFilter(const PluginCatalog& catalog) -> bool;
+    [[nodiscard]] static auto formatMatches(PluginFormat format, std::string_view value) -> bool;
+    [[nodiscard]] static auto vendorMatches(std::string_view vendorKey, std::string_view value) -> bool;
+
+    // every entry, or just the filtered ones; stops when fn returns false
+    template <typename Fn>
+    auto forEachCandidate(uint32_t count, Fn&& fn) const -> bool {
+        if (filtered_) {
+            return filter_.forEach(fn);
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            if (!fn(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // compiles each query word into a bit-parallel matcher, returns false
+    // when no word is long enough to be worth matching approximately
+    auto prepareApproximate() -> bool;
+    [[nodiscard]] auto approximateScore(const PluginCatalog& catalog, uint32_t index) const -> int32_t;
+    [[nodiscard]] auto errorBudget(size_t wordLength) const -> uint32_t;
+
+    auto searchApproximate(const PluginCatalog& catalog, const CancellationToken& token, std::vector<SearchMatch>& out) -> bool;
+
+    SearchOptions options_;
+    ParsedQuery parsed_;
+    std::string query_;
+
+    // entries that pass the query's predicates, when it has any
+    EntrySet filter_;
+    EntrySet fieldEntries_;
+    bool filtered_ = false;
+
+    std::vector<BoundedEditMatcher> wordMatchers_;
+    std::vector<uint32_t> wordBudgets_;
+
+    // whether wordMatchers_ belong to the current query
+    bool approximatePrepared_ = false;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PluginCatalog.h"
+#include "SearchEngine.h"
+
+struct SearchResult {
+    uint64_t generation = 0;
+    PluginCatalogPtr catalog;
+    std::string query;
+    std::vector<SearchMatch> matches;
+
+    // highlighted name ranges; match i owns spans[spanOffsets[i]..spanOffsets[i + 1]]
+    std::vector<MatchSpan> spans;
+    std::vector<uint32_t> spanOffsets;
+
+    // when the query was handed to the worker; the UI measures input-to-result from here
+    std::chrono::steady_clock::time_point submittedAt;
+};
+
+// Runs queries on a dedicated thread. Every submit() bumps a generation
+// counter; a job that is still queued when a newer one arrives is dropped,
+// and a job already scanning checks the counter and abandons itself.
+// Only completed, current results are handed to the callback, which is
+// invoked on the worker thread -- the caller decides where to marshal it.
+class SearchWorker {
+public:
+    using ResultCallback = std::function<void(std::shared_ptr<SearchResult>)>;
+
+    explicit SearchWorker(ResultCallback onResult);
+    ~SearchWorker();
+
+    SearchWorker(const SearchWorker&) = delete;
+    auto operator=(const SearchWorker&) -> SearchWorker& = delete;
+    SearchWorker(SearchWorker&&) = delete;
+    auto operator=(SearchWorker&&) -> SearchWorker& = delete;
+
+    // returns the generation assigned to this query; boosts, when given,
+    // must be aligned with the catalog
+    auto submit(PluginCatalogPtr catalog, std::string query, RankingBoostsPtr boosts = nullptr) -> uint64_t;
+
+    [[nodiscard]] auto latestGeneration() const -> uint64_t;
+
+    void stop();
+
+private:
+    struct Job {
+        uint64_t generation;
+        PluginCatalogPtr catalog;
+        std::string query;
+        RankingBoostsPtr boosts;
+        std::chrono::steady_clock::time_point submittedAt;
+    };
+
+    void run();
+
+    // Results the UI has let go of, kept to be filled again, which keeps
+    // the per-keystroke path free of large allocations. A result's deleter
+    // puts it back under the lock, so whatever the UI did with it happens
+    // before the worker writes to it again. Shared with those deleters, as
+    // the UI may let go after the worker is gone.
+    struct ResultPool {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<SearchResult>> free;
+    };
+
+    // a result from the pool, or a fresh one
+    auto acquireResult() -> std::shared_ptr<SearchResult>;
+
+    static constexpr size_t RESULT_POOL_SIZE = 3;
+
+    ResultCallback onResult_;
+    SearchEngine engine_;
+    std::shared_ptr<ResultPool> resultPool_;
+    // results created for the pool so far; worker thread only
+    size_t pooledResults_ = 0;
+
+    std::atomic<uint64_t> generation_{0};
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::optional<Job> pending_;
+    bool stopping_ = false;
+
+    std::thread thread_;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Case folding and accent stripping for search keys, without ICU.
+//
+// Covers what plugin and vendor names actually contain: ASCII, Latin-1,
+// Latin Extended-A, Greek and Cyrillic case pairs, fullwidth ASCII, a few
+// typographic look-alikes, and combining marks (so decomposed NFD names,
+// as macOS likes to hand out, fold the same as precomposed ones).
+// Anything else passes through unchanged, so the output is still UTF-8.
+namespace TextFold {
+    // Appends the folded form of `text` to `out`. When `sourceOffsets` is
+    // given, one entry per appended byte records where in `text` the code
+    // point it came from starts, for mapping matches back onto the name.
+    void appendFolded(std::string_view text, std::string& out, std::vector<uint16_t>* sourceOffsets = nullptr);
+
+    [[nodiscard]] auto fold(std::string_view text) -> std::string;
+
+    // letters, digits and any non-ASCII byte; multi-byte characters are
+    // never split into separate words
+    [[nodiscard]] inline auto isWordByte(unsigned char c) -> bool {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80; // NOLINT
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "SearchEngine.h"
+
+class PluginCatalog;
+
+struct UsageOptions {
+    // a load this long ago counts half as much as one right now
+    std::chrono::seconds halfLife = std::chrono::hours(24 * 14); // NOLINT
+
+    // bursts of loads are coalesced into one write
+    std::chrono::milliseconds flushDelay = std::chrono::milliseconds(2000); // NOLINT
+};
+
+// Remembers which plugins actually get loaded, weighted by recency.
+//
+// Every load adds exp(lambda * (t - epoch)) to the plugin's weight, kept in
+// log space so it never overflows; reading it back as of `now` is one
+// subtraction. That makes record() O(1) with no periodic decay pass, and
+// lets the stored weights be compared directly without knowing the time.
+//
+// The table is written to disk by a background thread from a snapshot,
+// and mapped back in on construction.
+class UsageStore {
+public:
+    using Clock = std::function<std::chrono::system_clock::time_point()>;
+
+    explicit UsageStore(std::filesystem::path path, UsageOptions options = {}, Clock clock = std::chrono::system_clock::now);
+    ~UsageStore();
+
+    UsageStore(const UsageStore&) = delete;
+    auto operator=(const UsageStore&) -> UsageStore& = delete;
+    UsageStore(UsageStore&&) = delete;
+    auto operator=(UsageStore&&) -> UsageStore& = delete;
+
+    void record(std::string_view pluginName);
+
+    // decayed load count as of now; a plugin loaded once just now is ~1.0
+    [[nodiscard]] auto weight(std::string_view pluginName) const -> double;
+    [[nodiscard]] auto size() const -> size_t;
+
+    // one boost per catalog entry, aligned by index; null when nothing has
+    // been recorded yet. Cached until the catalog or the usage changes.
+    [[nodiscard]] auto rankingBoosts(const PluginCatalog& catalog) -> RankingBoostsPtr;
+
+    // writes synchronously if anything changed since the last write
+    void flush();
+
+private:
+    struct Slot {
+        uint64_t key = 0;           // 0 marks an empty slot
+        double logWeight = 0.0;     // log of the sum of exp(lambda * (t - epoch))
+        uint32_t count = 0;
+        uint32_t reserved = 0;
+    };
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        int64_t epoch;
+        uint64_t count;
+    };
+
+    static constexpr uint32_t FILE_MAGIC = 0x554d494c; // NOLINT "LIMU"
+    static constexpr uint32_t FILE_VERSION = 1;
+    static constexpr size_t INITIAL_CAPACITY = 256;
+
+    // weight at which a plugin gets half the maximum boost
+    static constexpr double HALF_BOOST_WEIGHT = 3.0;
+
+    [[nodiscard]] static auto hashName(std::string_view name) -> uint64_t;
+
+    [[nodiscard]] auto secondsSinceEpoch() const -> double;
+    [[nodiscard]] auto findSlot(uint64_t key) const -> const Slot*;
+    auto insertSlot(uint64_t key) -> Slot&;
+    void grow();
+
+    void load();
+    auto snapshotLocked() const -> std::vector<Slot>;
+    void write(const std::vector<Slot>& slots);
+    void flushLoop();
+
+    std::filesystem::path path_;
+    UsageOptions options_;
+    Clock clock_;
+    double lambda_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+
+    // seconds since the unix epoch that log weights are relative to
+    int64_t epoch_ = 0;
+    std::vector<Slot> slots_;
+    size_t used_ = 0;
+
+    uint64_t revision_ = 0;
+    bool dirty_ = false;
+    bool stopping_ = false;
+
+    uint64_t boostsCatalogVersion_ = 0;
+    uint64_t boostsRevision_ = 0;
+    RankingBoostsPtr boosts_;
+
+    // serialises writers so an explicit flush() can't race the thread
+    std::mutex writeMutex_;
+
+    std::thread flushThread_;
+};
@@ -16,8 +16,12 @@ namespace PathFinder {
     auto liveBinary() -> std::optional<std::filesystem::path>;
     auto liveThemes() -> std::optional<std::filesystem::path>;
     auto liveTheme() -> std::optional<std::filesystem::path>;
+    auto livePreferences() -> std::optional<std::filesystem::path>;
     auto config() -> std::optional<std::filesystem::path>;
     auto configMenu() -> std::optional<std::filesystem::path>;
+
+    // created on first write, so no existence check
+    auto usage() -> std::filesystem::path;
     auto getLivePrefsDir() -> NSString*;
     auto getRemoteScriptsPath() -> std::filesystem::path;
     auto getLIMPrefsDirNS() -> NSString*;
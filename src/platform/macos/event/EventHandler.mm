@@ -3,6 +3,7 @@
 #import <Cocoa/Cocoa.h>
 #import <AppKit/AppKit.h>
 #include <algorithm> // Required for std::transform
+#include <array>
 #include <cctype>    // Required for std::tolower
 #include <chrono>
 #include <fstream>
@@ -20,10 +21,10 @@
 
 #include "EventHandler.h"
 #include "IActionHandler.h"
+#include "KeyChord.h"
 #include "LiveInterface.h"
 #include "PID.h"
 #include "WindowManager.h"
-#include "AXFinder.h"
 
 // TODO: unsuckify this
 // TODO: build out the rest of the map and put it in... somewhere else
@@ -91,6 +92,26 @@ std::string keyCodeToString(CGKeyCode keyCode) {
     }
 }
 
+// The chord key id for a key code. The first press of each key resolves
+// it through the keyboard layout; every later one is an array load. Only
+// ever called from the event tap's thread.
+auto keyIdForCode(CGKeyCode keyCode) -> uint8_t {
+    constexpr int16_t UNRESOLVED = -1;
+    static std::array<int16_t, 128> ids = []() { // NOLINT
+        std::array<int16_t, 128> unresolved{}; // NOLINT
+        unresolved.fill(UNRESOLVED);
+        return unresolved;
+    }();
+
+    if (keyCode >= ids.size()) {
+        return 0;
+    }
+    if (ids[keyCode] == UNRESOLVED) {
+        ids[keyCode] = KeyChord::keyId(keyCodeToString(keyCode));
+    }
+    return static_cast<uint8_t>(ids[keyCode]);
+}
+
 @class GUISearchBoxWindowController;
 
 EventHandler::EventHandler(
@@ -490,37 +511,23 @@ CGEventRef EventHandler::eventTapCallback(CGEventTapProxy proxy, CGEventType ogE
         CGKeyCode keyCode = CGEventGetIntegerValueField(event, kCGKeyboardEventKeycode);
         CGEventFlags flags = CGEventGetFlags(event);
 
-        EKeyPress pressedKey;
-        pressedKey.state = KeyState::Down;
-        pressedKey.shift = (flags & Shift) != 0;
-        pressedKey.ctrl  = (flags & Ctrl ) != 0;
-        pressedKey.cmd   = (flags & Cmd  ) != 0;
-        pressedKey.alt   = (flags & Alt  ) != 0;
-        pressedKey.key   = keyCodeToString(keyCode);
+        const KeyChord pressed(keyIdForCode(keyCode), KeyChord::modifierBits(static_cast<uint32_t>(flags)));
 
         // to handle remapping of menu items, e.g. cmd+shift+w = open second window (why??)
         // these are handled at the OS level, so the PID of the event will never match Live's PID
         // TODO: limit this to only Live menu shortcuts
-        if (pressedKey.isModifierPressed()) {
+        if (pressed.modifiers() != 0) {
             pid_t frontPID = [[[NSWorkspace sharedWorkspace] frontmostApplication] processIdentifier];
             if (frontPID == PID::getInstance().livePID()) {
-                bool shouldPassEvent = actionHandler->handleKeyEvent(pressedKey);
+                bool shouldPassEvent = actionHandler->handleKeyEvent(pressed);
                 return shouldPassEvent ? ogEvent : nullptr;
             }
         }
 
         if (eventPID == PID::getInstance().livePID()) {
-            // if no modifiers are pressed, and we're in an AXTextField,
-            // just pass the original event
-            if (!pressedKey.isModifierPressed()) {
-                logger->debug("{}", AXFinder::getFocusedElementTypeStr());
-                if (AXFinder::getFocusedElementTypeStr() == "AXTextField") {
-                    logger->debug("Ableton Live text field has focus. Passing event.");
-                    return ogEvent;
-                }
-            }
-
-            bool shouldPassEvent = actionHandler->handleKeyEvent(pressedKey);
+            // unmodified keys typed into a text field aren't remapped; the
+            // text-field context's table leaves them out
+            bool shouldPassEvent = actionHandler->handleKeyEvent(pressed);
             return shouldPassEvent ? ogEvent : nullptr;
         }
     }
@@ -1,172 +1,86 @@
 #include <ApplicationServices/ApplicationServices.h>
 #include <CoreFoundation/CoreFoundation.h>
 #include <Cocoa/Cocoa.h>
-#include <unordered_map>
-#include <string>
+#include <cstdint>
+#include <future>
 #include <optional>
+#include <string>
 
 #include "LogGlobal.h"
 #include "Types.h"
 
+#include "KeyCodes.h"
 #include "KeySender.h"
 
-std::string toLower(const std::string& str) {
-    std::string lowerStr = str;
-    std::transform(lowerStr.begin(), lowerStr.end(), lowerStr.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
-    return lowerStr;
-}
-
-std::unordered_map<std::string, CGKeyCode> const keyCodeMap = {
-    // NOLINTBEGIN
-    {"a", 0}
-    , {"s", 1}
-    , {"d", 2}
-    , {"f", 3}
-    , {"h", 4}
-    , {"g", 5}
-    , {"z", 6}
-    , {"x", 7}
-    , {"c", 8}
-    , {"v", 9}
-    , {"b", 11}
-    , {"q", 12}
-    , {"w", 13}
-    , {"e", 14}
-    , {"r", 15}
-    , {"y", 16}
-    , {"t", 17}
-    , {"1", 18}
-    , {"2", 19}
-    , {"3", 20}
-    , {"4", 21}
-    , {"6", 22}
-    , {"5", 23}
-    , {"equal", 24}
-    , {"9", 25}
-    , {"7", 26}
-    , {"minus", 27}
-    , {"8", 28}
-    , {"0", 29}
-    , {"rightbracket", 30}
-    , {"o", 31}
-    , {"u", 32}
-    , {"leftbracket", 33}
-    , {"i", 34}
-    , {"p", 35}
-    , {"n", 36}
-    , {"l", 37}
-    , {"j", 38}
-    , {"quote", 39}
-    , {"k", 40}
-    , {"semicolon", 41}
-    , {"backslash", 42}
-    , {"comma", 43}
-    , {"slash", 44}
-    , {"n", 45}
-    , {"m", 46}
-    , {"period", 47}
-    , {"tab", 48}
-    , {"space", 49}
-    , {"grave", 50}
-    , {"delete", 51}
-    , {"escape", 53}
-
-    , {"rightcommand", 54}
-    , {"command", 55}
-    , {"shift", 56}
-    , {"capslock", 57}
-    , {"option", 58}
-    , {"control", 59}
-    , {"rightshift", 60}
-    , {"rightoption", 61}
-    , {"rightcontrol", 62}
+namespace {
+    // the key transition travels as dispatch_async_f's context pointer,
+    // so posting one doesn't copy a block to the heap
+    static_assert(sizeof(uintptr_t) >= 8); // NOLINT
 
-    , {"f1", 122}
-    , {"f2", 120}
-    , {"f3", 99}
-    , {"f4", 118}
-    , {"f5", 96}
-    , {"f6", 97}
-    , {"f7", 98}
-    , {"f8", 100}
-    , {"f9", 101}
-    , {"f10", 109}
-    , {"f11", 103}
-    , {"f12", 111}
-
-    , {"uparrow", 126}
-    , {"downarrow", 125}
-    , {"leftarrow", 123}
-    , {"rightarrow", 124}
+    auto packKey(uint16_t keyCode, uint32_t modifiers, bool keyDown) -> uintptr_t {
+        return (uintptr_t(modifiers) << 32) | (uintptr_t(keyDown) << 16) | keyCode; // NOLINT
+    }
 
-    , {"home", 115}
-    , {"end", 119}
-    , {"pageup", 116}
-    , {"pagedown", 121}
-    , {"help", 114}
-    , {"forwarddelete", 117}
-    // NOLINTEND
-};
+    void postKey(void* context) {
+        auto packed = reinterpret_cast<uintptr_t>(context);
+        auto keyCode = static_cast<CGKeyCode>(packed & 0xFFFF); // NOLINT
+        bool keyDown = ((packed >> 16) & 1) != 0; // NOLINT
+        // Modifier uses the CGEventFlags mask values
+        auto flags = static_cast<CGEventFlags>(packed >> 32); // NOLINT
+
+        CGEventRef event = CGEventCreateKeyboardEvent(nullptr, keyCode, keyDown);
+        CGEventSetFlags(event, flags);
+        CGEventPost(kCGAnnotatedSessionEventTap, event);
+        CFRelease(event);
+    }
 
-std::optional<CGKeyCode> getKeyCode(const std::string& key) {
-    auto it = keyCodeMap.find(key);
-    if (it != keyCodeMap.end()) {
-        return it->second;
+    auto modifierFlags(const EKeyPress& kp) -> uint32_t {
+        uint32_t flags = Modifier::None;
+        if (kp.cmd)   flags |= Modifier::Cmd;
+        if (kp.ctrl)  flags |= Modifier::Ctrl;
+        if (kp.alt)   flags |= Modifier::Alt;
+        if (kp.shift) flags |= Modifier::Shift;
+        return flags;
     }
-    return std::nullopt;
 }
 
 KeySender::KeySender() = default;
 
 KeySender::~KeySender() = default;
 
-CGEventFlags getEventFlags(const EKeyPress& kp) {
-    CGEventFlags flags = 0;
-
-    if (kp.cmd) {
-        flags |= kCGEventFlagMaskCommand;
-    }
-    if (kp.ctrl) {
-        flags |= kCGEventFlagMaskControl;
-    }
-    if (kp.alt) {
-        flags |= kCGEventFlagMaskAlternate;
-    }
-    if (kp.shift) {
-        flags |= kCGEventFlagMaskShift;
-    }
-
-    return flags;
+void KeySender::sendKey(uint16_t keyCode, uint32_t modifiers, bool keyDown) {
+    // posted in order on the main queue, as they always have been
+    dispatch_async_f(dispatch_get_main_queue()
+                     , reinterpret_cast<void*>(packKey(keyCode, modifiers, keyDown))
+                     , postKey);
 }
 
-void KeySender::sendKeyPress(const EKeyPress& kpRef) {
-    EKeyPress kp = kpRef; // create a copy
-
-    dispatch_async(dispatch_get_main_queue(), ^{
-        CGEventFlags flags = getEventFlags(kp);
-        std::optional<CGKeyCode> keyCodeOpt = getKeyCode(toLower(kp.key));
-
-        logger->debug("KeySender:: Keypress cmd: {}", std::to_string(kp.cmd)   );
-        logger->debug("KeySender:: Keypress ctrl: {}", std::to_string(kp.ctrl)  );
-        logger->debug("KeySender:: Keypress alt: {}", std::to_string(kp.alt)   );
-        logger->debug("KeySender:: Keypress shift: {}", std::to_string(kp.shift) );
-        logger->debug("KeySender:: Keypress key: {}", kp.key                   );
+auto KeySender::posted() -> std::future<void> {
+    // the main queue is serial, so this runs after every key before it
+    auto* done = new std::promise<void>();
+    auto future = done->get_future();
+    dispatch_async_f(dispatch_get_main_queue(), done, [](void* context) {
+        auto* promise = static_cast<std::promise<void>*>(context);
+        promise->set_value();
+        delete promise;
+    });
+    return future;
+}
 
-        if (keyCodeOpt) {
-            CGKeyCode keyCode = *keyCodeOpt;
-            logger->debug("KeySender:: keycode: {}", std::to_string(keyCode));
+void KeySender::sendKeyPress(const EKeyPress& kp) {
+    logger->debug("KeySender:: Keypress cmd: {}", std::to_string(kp.cmd)   );
+    logger->debug("KeySender:: Keypress ctrl: {}", std::to_string(kp.ctrl)  );
+    logger->debug("KeySender:: Keypress alt: {}", std::to_string(kp.alt)   );
+    logger->debug("KeySender:: Keypress shift: {}", std::to_string(kp.shift) );
+    logger->debug("KeySender:: Keypress key: {}", kp.key                   );
 
-            CGEventRef keyDown = CGEventCreateKeyboardEvent(nullptr, keyCode, true);
-            CGEventSetFlags(keyDown, flags);
-            CGEventPost(kCGAnnotatedSessionEventTap, keyDown);
-            CFRelease(keyDown);
+    std::optional<uint16_t> keyCode = KeyCodes::find(kp.key);
+    if (!keyCode) {
+        return;
+    }
+    logger->debug("KeySender:: keycode: {}", std::to_string(*keyCode));
 
-            //logger->info("sending keyUp: {}", std::to_string(keyCode));
-            CGEventRef keyUp = CGEventCreateKeyboardEvent(nullptr, keyCode, false);
-            CGEventSetFlags(keyUp, flags);
-            CGEventPost(kCGAnnotatedSessionEventTap, keyUp);
-            CFRelease(keyUp);
-        }
-    });
+    const uint32_t flags = modifierFlags(kp);
+    sendKey(*keyCode, flags, true);
+    sendKey(*keyCode, flags, false);
 }
@@ -118,10 +118,9 @@
     NSString *action = (NSString *)menuItem.representedObject;
     if (action) {
         if (_actionHandler) {
+            // a trailing " VST3" / " AU" picks that format; the catalog resolves it
             std::string actionString = "plugin." + std::string([action UTF8String]);
             Utils::trim(actionString);
-            std::vector<std::string> toRemove = {" VST3", " AU", " VST"};
-            Utils::removeSubstrings(actionString, toRemove);
 
             if (![NSThread isMainThread]) {
                 dispatch_async(dispatch_get_main_queue(), ^{
@@ -214,6 +213,8 @@ void ContextMenu::generateMenu() {
         if (menuGenerator) {
             this->menuGenerator_ = menuGenerator;
 
+            // the menu file may have been reloaded since the last time
+            menuItems_ = configMenu_()->getMenuData();
             NSMenu *contextMenu = [menuGenerator createContextMenuWithItems:menuItems_];
             this->contextMenu_ = contextMenu;
             
@@ -23,18 +23,80 @@
 #include "AXPrinter.h"
 #include "AXWindow.h"
 
+#include "FocusTracker.h"
 #include "LiveInterface.h"
 #include "PID.h"
+#include "WaitScheduler.h"
 
-LiveInterface::LiveInterface(std::function<std::shared_ptr<IEventHandler>()> eventHandler)
+LiveInterface::LiveInterface(std::function<std::shared_ptr<IEventHandler>()> eventHandler
+                             , std::function<std::shared_ptr<FocusTracker>()> focusTracker
+                             , std::function<std::shared_ptr<WaitScheduler>()> waits)
     : ILiveInterface()
     , eventHandler_(std::move(eventHandler))
+    , focusTracker_(std::move(focusTracker))
+    , waits_(std::move(waits))
     , pluginWindowCreateObserver_()
     , pluginWindowDestroyObserver_()
+    , focusObserver_()
 {
     setupPluginWindowChangeObserver([]() {
         // logger->info("Window change detected!");
     });
+    setupFocusObserver();
+}
+
+void LiveInterface::setupFocusObserver() {
+    pid_t livePID = PID::getInstance().livePID();
+    if (livePID == -1) {
+        logger->error("Live is not running");
+        return;
+    }
+
+    AXUIElementRef appElement = AXFinder::appElement();
+    if (!AXAttribute::isValid(appElement)) {
+        logger->error("unable to get app element");
+        return;
+    }
+
+    AXError error = AXObserverCreate(livePID, focusChangedCallback, &focusObserver_);
+    if (error != kAXErrorSuccess) {
+        logger->error("Failed to create focus observer. Error: {}", axerror::toString(error));
+        CFRelease(appElement);
+        return;
+    }
+
+    for (CFStringRef notification : {kAXFocusedUIElementChangedNotification, kAXFocusedWindowChangedNotification}) {
+        error = AXObserverAddNotification(focusObserver_, appElement, notification, this);
+        if (error != kAXErrorSuccess) {
+            logger->error("Failed to add focus notification. Error: {}", axerror::toString(error));
+        }
+    }
+    CFRelease(appElement);
+
+    CFRunLoopAddSource(CFRunLoopGetMain(), AXObserverGetRunLoopSource(focusObserver_), kCFRunLoopDefaultMode);
+
+    // whatever has focus before the first change
+    refreshFocus();
+}
+
+void LiveInterface::refreshFocus() {
+    auto tracker = focusTracker_();
+
+    tracker->setTextFieldFocused(AXFinder::getFocusedElementTypeStr() == "AXTextField");
+
+    AXUIElementRef window = AXFinder::findApplicationWindow();
+    tracker->setPluginWindowFocused(window != nullptr && AXWindow::isPluginWindow(window));
+    if (window) CFRelease(window);
+
+    logger->debug("focus context: {}", KeyContexts::name(tracker->context()));
+}
+
+void LiveInterface::focusChangedCallback(AXObserverRef observer, AXUIElementRef element,
+                                         CFStringRef notification, void* context) {
+    auto* interface = static_cast<LiveInterface*>(context);
+    if (interface) {
+        interface->refreshFocus();
+    }
 }
 
 LiveInterface::~LiveInterface() = default;
@@ -115,6 +177,10 @@ void LiveInterface::pluginWindowCreateCallback(AXObserverRef observer, AXUIEleme
         logger->error("Failed to raise window. AXError: {}", std::to_string(error));
     }
 
+    if (interface && interface->waits_) {
+        interface->waits_()->signal(WaitCondition::PluginWindow);
+    }
+
     if (interface && interface->createCallback_) {
         interface->createCallback_();
     }
@@ -171,38 +237,62 @@ void LiveInterface::openAllPlugins() {
 // TODO -- if the plugins take up MORE than the screen, cycle
 // TODO -- compact tiling (fill in the blank space where possible while keeping order)
 
-std::vector<AXUIElementRef> orderPluginWindows() {
-    // find the devices in TrackView and toggle the ones that are enabled
-    // to correctly order the plugins reported by Live AX
-    std::vector<AXUIElementRef> trackViewDevices = AXFinder::getTrackViewDevices();
-    for (const auto& device : trackViewDevices) {
-        CFRetain(device);
-        std::vector<AXUIElementRef> checkboxes = AXFinder::getTrackViewDeviceCheckBoxes(device);
-        if (checkboxes.empty()) {
-            logger->warn("couldn't find device on/off checkboxes");
-            return {};
+namespace {
+    // how long a toggled device gets to reopen its plugin window. Devices
+    // without one never do, so this is what each of those costs
+    constexpr uint32_t REOPEN_TIMEOUT_MS = 50;
+
+    // blocks until a plugin window has been created since `since`, a
+    // signals() count, or REOPEN_TIMEOUT_MS have passed
+    void awaitReopened(WaitScheduler& waits, uint64_t since) {
+        try {
+            waits.wait(WaitCondition::PluginWindow, REOPEN_TIMEOUT_MS, WaitScheduler::UNOWNED, since).get();
+        } catch (const StepTimedOut&) {
+            logger->debug("no plugin window reopened within {}ms", REOPEN_TIMEOUT_MS);
+        } catch (const StepCancelled&) {
+            // quitting
         }
+    }
 
-        for (const auto& checkbox : checkboxes) {
-            // TODO get the enable/disable checkbox and skip the ones that
-            // aren't enabled
-            AXCheckBox::toggleOffOn(checkbox);
-            CFRelease(checkbox);
-            usleep(20000);
+    // `waits` is null if the create observer can't run while this does,
+    // which is when it's on the main thread; nothing is waited for then
+    std::vector<AXUIElementRef> orderPluginWindows(WaitScheduler* waits) {
+        // find the devices in TrackView and toggle the ones that are enabled
+        // to correctly order the plugins reported by Live AX. Each toggle
+        // reopens the device's window, which has to be in place before the
+        // next one's is, or they come back out of order
+        std::vector<AXUIElementRef> trackViewDevices = AXFinder::getTrackViewDevices();
+        for (const auto& device : trackViewDevices) {
+            CFRetain(device);
+            std::vector<AXUIElementRef> checkboxes = AXFinder::getTrackViewDeviceCheckBoxes(device);
+            if (checkboxes.empty()) {
+                logger->warn("couldn't find device on/off checkboxes");
+                return {};
+            }
+
+            for (const auto& checkbox : checkboxes) {
+                // TODO get the enable/disable checkbox and skip the ones that
+                // aren't enabled
+                const uint64_t opened = waits ? waits->signals(WaitCondition::PluginWindow) : 0;
+                if (AXCheckBox::toggleOffOn(checkbox) && waits) {
+                    awaitReopened(*waits, opened);
+                }
+                CFRelease(checkbox);
+            }
+
+            CFRelease(device);
         }
 
-        CFRelease(device);
-    }
+        std::vector<AXUIElementRef> pluginWindows = AXFinder::getPluginWindowsFromLiveAX();
+        if (pluginWindows.empty()) {
+            logger->warn("no plugin windows found");
+            return {};
+        }
 
-    std::vector<AXUIElementRef> pluginWindows = AXFinder::getPluginWindowsFromLiveAX();
-    if (pluginWindows.empty()) {
-        logger->warn("no plugin windows found");
-        return {};
-    }
+        std::reverse(pluginWindows.begin(), pluginWindows.end());
 
-    std::reverse(pluginWindows.begin(), pluginWindows.end());
-    
-    return pluginWindows;
+        return pluginWindows;
+    }
 }
 
 void LiveInterface::tilePluginWindows() {
@@ -211,7 +301,9 @@ void LiveInterface::tilePluginWindows() {
         logger->warn("unable to find valid TrackView");
     }
 
-    std::vector<AXUIElementRef> pluginWindows = orderPluginWindows();
+    // the create observer is on the main run loop
+    auto waits = waits_ && ![NSThread isMainThread] ? waits_() : nullptr;
+    std::vector<AXUIElementRef> pluginWindows = orderPluginWindows(waits.get());
 
     CGRect screenBounds = [[NSScreen mainScreen] frame];
     int screenWidth = screenBounds.size.width;
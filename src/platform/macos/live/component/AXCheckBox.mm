@@ -69,7 +69,9 @@ namespace AXCheckBox {
 
     // for closing and re-opening opened plugin windows
     // so that the plugin window order is correct in
-    // the main window's AXChildren
+    // the main window's AXChildren. Live has handled a press
+    // by the time it returns, so the second one can go straight
+    // after the first
     bool toggleOffOn(AXUIElementRef checkbox) {
         if (!AXAttribute::isValid(checkbox)) {
             logger->warn("checkbox is invalid");
@@ -77,7 +79,6 @@ namespace AXCheckBox {
         }
         if (isChecked(checkbox)) {
             bool offPress = toggle(checkbox);
-            usleep(10000);
             bool onPress = toggle(checkbox);
             if (onPress && offPress) {
                 return true;
@@ -179,17 +179,47 @@ namespace PathFinder {
         return configMenuPath;
     }
 
-    // TODO default theme if !liveTheme
-    // TODO get theme from last access time
-    PathOptional liveTheme() {
+    std::filesystem::path usage() {
+        return getLIMPrefsDir() / "usage.bin";
+    }
+
+    PathOptional livePreferences() {
+        std::filesystem::path preferencesPath = [[getLivePrefsDir() stringByAppendingPathComponent:@"Preferences.cfg"] UTF8String];
+
+        if (!pathutil::isFile(preferencesPath)) {
+            logger->error("Live preferences do not exist or are not a regular file: {}", preferencesPath.string());
+            return std::nullopt;
+        }
+
+        return preferencesPath;
+    }
+
+    PathOptional liveThemes() {
         auto bundlePath = liveBundle();
         if (!bundlePath) {
             logger->error("Unable to get live bundle path");
             return std::nullopt;
         }
 
-        std::filesystem::path themeFilePath = *bundlePath
-            / "Contents" / "App-Resources" / "Themes" / "Default Dark Neutral High.ask";
+        std::filesystem::path themesPath = *bundlePath / "Contents" / "App-Resources" / "Themes";
+
+        if (!pathutil::isDirectory(themesPath)) {
+            logger->error("Themes folder does not exist or is not a directory: {}", themesPath.string());
+            return std::nullopt;
+        }
+
+        return themesPath;
+    }
+
+    // the bundled default; the theme picked in Live's preferences is
+    // found from livePreferences() by Theme, which follows it from there
+    PathOptional liveTheme() {
+        auto themesPath = liveThemes();
+        if (!themesPath) {
+            return std::nullopt;
+        }
+
+        std::filesystem::path themeFilePath = *themesPath / "Default Dark Neutral High.ask";
 
         if (!pathutil::isFile(themeFilePath)) {
             logger->error("Theme file does not exist or is not a regular file: {}", themeFilePath.string());
@@ -1,6 +1,7 @@
 #define NOMINMAX
 #include <Windows.h>
 
+#include <array>
 #include <chrono>
 #include <functional>
 #include <iostream>
@@ -13,6 +14,7 @@
 
 #include "IActionHandler.h"
 #include "EventHandler.h"
+#include "KeyChord.h"
 #include "PID.h"
 #include "WindowManager.h"
 
@@ -75,6 +77,26 @@ std::string keyCodeToString(DWORD keyCode) {
     }
 }
 
+// The chord key id for a virtual key code, resolved through the keyboard
+// layout on the first press of each key and cached after that. Only ever
+// called from the hook's thread.
+auto keyIdForCode(DWORD keyCode) -> uint8_t {
+    constexpr int16_t UNRESOLVED = -1;
+    static std::array<int16_t, 256> ids = []() { // NOLINT
+        std::array<int16_t, 256> unresolved{}; // NOLINT
+        unresolved.fill(UNRESOLVED);
+        return unresolved;
+    }();
+
+    if (keyCode >= ids.size()) {
+        return 0;
+    }
+    if (ids[keyCode] == UNRESOLVED) {
+        ids[keyCode] = KeyChord::keyId(keyCodeToString(keyCode));
+    }
+    return static_cast<uint8_t>(ids[keyCode]);
+}
+
 HHOOK keyboardHook__ = NULL;
 HHOOK mouseHook_ = NULL;
 
@@ -194,17 +216,13 @@ LRESULT CALLBACK EventHandler::LowLevelKeyboardProc(int nCode, WPARAM wParam, LP
 			#endif
 
             // Handle key events
-            // TODO cross platform send EKeyPress
-            DWORD vkCode = kbdStruct->vkCode;
-            std::string keyString = keyCodeToString(vkCode);
-            EKeyPress pressedKey;
-            pressedKey.shift = (GetAsyncKeyState(VK_SHIFT)   & 0x8000) != 0;
-            pressedKey.ctrl  = (GetAsyncKeyState(VK_CONTROL) & 0x8000) != 0;
-            pressedKey.cmd   = (GetAsyncKeyState(VK_LWIN)    & 0x8000) != 0;
-            pressedKey.alt   = (GetAsyncKeyState(VK_MENU)    & 0x8000) != 0;
-            pressedKey.key   = keyCodeToString(kbdStruct->vkCode);
-            pressedKey.state = KeyState::Down;
-            bool shouldPassEvent = instance_->actionHandler_()->handleKeyEvent(pressedKey);
+            uint32_t flags = Modifier::None;
+            if (GetAsyncKeyState(VK_SHIFT)   & 0x8000) flags |= Modifier::Shift;
+            if (GetAsyncKeyState(VK_CONTROL) & 0x8000) flags |= Modifier::Ctrl;
+            if (GetAsyncKeyState(VK_LWIN)    & 0x8000) flags |= Modifier::Cmd;
+            if (GetAsyncKeyState(VK_MENU)    & 0x8000) flags |= Modifier::Alt;
+            const KeyChord pressed(keyIdForCode(kbdStruct->vkCode), KeyChord::modifierBits(flags));
+            bool shouldPassEvent = instance_->actionHandler_()->handleKeyEvent(pressed);
 
             if (!shouldPassEvent) {
                 return 1;  // Block the event if not to be passed
@@ -1,44 +1,16 @@
 #include <windows.h>
-#include <unordered_map>
-#include <string>
+#include <cstdint>
+#include <future>
 #include <optional>
-#include <algorithm>
+#include <string>
 
 #include "LogGlobal.h"
 #include "Types.h"
 
+#include "KeyCodes.h"
 #include "KeySender.h"
 
 namespace {
-    std::unordered_map<std::string, WORD> keyCodeMap = {
-        {"a", 0x41}, {"s", 0x53}, {"d", 0x44}, {"f", 0x46}, {"h", 0x48},
-        {"g", 0x47}, {"z", 0x5A}, {"x", 0x58}, {"c", 0x43}, {"v", 0x56},
-        {"b", 0x42}, {"q", 0x51}, {"w", 0x57}, {"e", 0x45}, {"r", 0x52},
-        {"y", 0x59}, {"t", 0x54}, {"1", 0x31}, {"2", 0x32}, {"3", 0x33},
-        {"4", 0x34}, {"5", 0x35}, {"6", 0x36}, {"7", 0x37}, {"8", 0x38},
-        {"9", 0x39}, {"0", 0x30}, {"tab", VK_TAB}, {"space", VK_SPACE},
-        {"escape", VK_ESCAPE}, {"left", VK_LEFT}, {"right", VK_RIGHT},
-        {"up", VK_UP}, {"down", VK_DOWN}, {"home", VK_HOME}, {"end", VK_END},
-        {"pageup", VK_PRIOR}, {"pagedown", VK_NEXT}, {"f1", VK_F1}, {"f2", VK_F2},
-        {"f3", VK_F3}, {"f4", VK_F4}, {"f5", VK_F5}, {"f6", VK_F6}, {"f7", VK_F7},
-        {"f8", VK_F8}, {"f9", VK_F9}, {"f10", VK_F10}, {"f11", VK_F11}, {"f12", VK_F12}
-    };
-
-    std::string toLower(const std::string& str) {
-        std::string lowerStr = str;
-        std::transform(lowerStr.begin(), lowerStr.end(), lowerStr.begin(),
-            [](unsigned char c) { return std::tolower(c); });
-        return lowerStr;
-    }
-
-    std::optional<WORD> getKeyCode(const std::string& key) {
-        auto it = keyCodeMap.find(key);
-        if (it != keyCodeMap.end()) {
-            return it->second;
-        }
-        return std::nullopt;
-    }
-
     void sendInputKey(WORD keyCode, bool keyDown) {
         INPUT input = {0};
         input.type = INPUT_KEYBOARD;
@@ -48,28 +20,49 @@ namespace {
         SendInput(1, &input, sizeof(INPUT));
     }
 
-    void pressModifierKeys(const EKeyPress& kp, bool keyDown) {
-        if (kp.ctrl) sendInputKey(VK_CONTROL, keyDown);
-        if (kp.alt) sendInputKey(VK_MENU, keyDown);  // Alt key
-        if (kp.shift) sendInputKey(VK_SHIFT, keyDown);
-        if (kp.cmd) sendInputKey(VK_LWIN, keyDown);  // Windows key (cmd equivalent)
+    void pressModifierKeys(uint32_t modifiers, bool keyDown) {
+        if (modifiers & Modifier::Ctrl) sendInputKey(VK_CONTROL, keyDown);
+        if (modifiers & Modifier::Alt) sendInputKey(VK_MENU, keyDown);  // Alt key
+        if (modifiers & Modifier::Shift) sendInputKey(VK_SHIFT, keyDown);
+        if (modifiers & Modifier::Cmd) sendInputKey(VK_LWIN, keyDown);  // Windows key (cmd equivalent)
+    }
+
+    auto modifierFlags(const EKeyPress& kp) -> uint32_t {
+        uint32_t flags = Modifier::None;
+        if (kp.ctrl)  flags |= Modifier::Ctrl;
+        if (kp.alt)   flags |= Modifier::Alt;
+        if (kp.shift) flags |= Modifier::Shift;
+        if (kp.cmd)   flags |= Modifier::Cmd;
+        return flags;
     }
 }
 
-void KeySender::sendIndividualKeyPress(const EKeyPress& kp) {
-    std::optional<WORD> keyCodeOpt = getKeyCode(toLower(kp.key));
-    if (keyCodeOpt) {
-        WORD keyCode = *keyCodeOpt;
+KeySender::KeySender() = default;
 
-        // Press down the modifier keys
-        pressModifierKeys(kp, true);
+KeySender::~KeySender() = default;
 
-        // Press and release the main key
-        sendInputKey(keyCode, true);  // Key down
-        sendInputKey(keyCode, false); // Key up
+void KeySender::sendKey(uint16_t keyCode, uint32_t modifiers, bool keyDown) {
+    // modifiers go down before the key and come up after it
+    if (keyDown) {
+        pressModifierKeys(modifiers, true);
+        sendInputKey(keyCode, true);
+    } else {
+        sendInputKey(keyCode, false);
+        pressModifierKeys(modifiers, false);
+    }
+}
 
-        // Release the modifier keys
-        pressModifierKeys(kp, false);
+auto KeySender::posted() -> std::future<void> {
+    // SendInput has already put them in the input stream
+    return {};
+}
+
+void KeySender::sendIndividualKeyPress(const EKeyPress& kp) {
+    std::optional<uint16_t> keyCode = KeyCodes::find(kp.key);
+    if (keyCode) {
+        const uint32_t flags = modifierFlags(kp);
+        sendKey(*keyCode, flags, true);
+        sendKey(*keyCode, flags, false);
     }
 }
 
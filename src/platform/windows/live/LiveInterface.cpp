@@ -6,9 +6,13 @@
 #include "LiveInterface.h"
 #include "PID.h"
 
-LiveInterface::LiveInterface(std::function<std::shared_ptr<IEventHandler>()> eventHandler)
+LiveInterface::LiveInterface(std::function<std::shared_ptr<IEventHandler>()> eventHandler
+                             , std::function<std::shared_ptr<FocusTracker>()> focusTracker
+                             , std::function<std::shared_ptr<WaitScheduler>()> waits)
     : ILiveInterface()
     , eventHandler_(std::move(eventHandler))
+    , focusTracker_(std::move(focusTracker))
+    , waits_(std::move(waits))
 {}
 
 LiveInterface::~LiveInterface() = default;
@@ -38,6 +38,10 @@ namespace PathFinder {
         throw std::runtime_error("Failed to get config menu file path");
     }
 
+    fs::path usage() {
+        return fs::path(documents()) / "Ableton" / "User Library" / "LiveImproved" / "usage.bin";
+    }
+
     fs::path documents() {
         PWSTR path = nullptr;
         HRESULT result = SHGetKnownFolderPath(FOLDERID_Documents, 0, nullptr, &path);
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "LogGlobal.h"
+#include "Utils.h"
+
+#include "CommandIndex.h"
+
+namespace {
+    // format suffixes a menu item's action may carry
+    const std::vector<std::string> FORMAT_SUFFIXES = {" VST3", " AU", " VST"};
+
+    void flattenMenu(const std::vector<MenuItem>& items, std::string& path, std::vector<Command>& out) {
+        for (const auto& item : items) {
+            if (item.action == "separator") {
+                continue;
+            }
+
+            if (!item.children.empty() || item.action == "category") {
+                const size_t length = path.size();
+                if (!path.empty()) {
+                    path += " / ";
+                }
+                path += item.label;
+                flattenMenu(item.children, path, out);
+                path.resize(length);
+                continue;
+            }
+
+            // the same target the menu itself hands to the action handler;
+            // a format suffix stays on it and picks that format
+            std::string target = item.action;
+            Utils::trim(target);
+            std::string plainTarget = target;
+            Utils::removeSubstrings(plainTarget, FORMAT_SUFFIXES);
+            if (target.empty() || plainTarget == item.label) {
+                continue;
+            }
+
+            out.push_back({EntryKind::MenuItem, item.label, path, "plugin." + target});
+        }
+    }
+}
+
+CommandIndex::CommandIndex()
+    : plugins_(std::make_shared<const PluginCatalog>(std::vector<Plugin>{}))
+    , snapshot_(plugins_)
+{}
+
+void CommandIndex::setPlugins(PluginCatalogPtr plugins) {
+    if (!plugins) {
+        return;
+    }
+    std::lock_guard lock(mutex_);
+    plugins_ = std::move(plugins);
+    publish();
+}
+
+void CommandIndex::setMenu(const std::vector<MenuItem>& menu) {
+    auto commands = menuCommands(menu);
+
+    std::lock_guard lock(mutex_);
+    menu_ = std::move(commands);
+    publish();
+}
+
+void CommandIndex::setActions(const std::vector<std::string>& actions) {
+    std::vector<Command> commands;
+    commands.reserve(actions.size());
+    for (const auto& action : actions) {
+        commands.push_back({EntryKind::Action, actionLabel(action), "Action", action});
+    }
+    std::sort(commands.begin(), commands.end(), [](const Command& a, const Command& b) {
+        return a.label < b.label;
+    });
+
+    std::lock_guard lock(mutex_);
+    actions_ = std::move(commands);
+    publish();
+}
+
+auto CommandIndex::snapshot() const -> PluginCatalogPtr {
+    return std::atomic_load(&snapshot_);
+}
+
+void CommandIndex::publish() {
+    std::vector<Command> commands;
+    commands.reserve(menu_.size() + actions_.size());
+    commands.insert(commands.end(), menu_.begin(), menu_.end());
+    commands.insert(commands.end(), actions_.begin(), actions_.end());
+
+    auto snapshot = std::make_shared<const PluginCatalog>(*plugins_, std::move(commands), ++version_);
+    logger->debug("command index {}: {} plugins, {} menu items, {} actions"
+                  , version_, snapshot->pluginCount(), menu_.size(), actions_.size());
+    std::atomic_store(&snapshot_, PluginCatalogPtr(std::move(snapshot)));
+}
+
+auto CommandIndex::menuCommands(const std::vector<MenuItem>& menu) -> std::vector<Command> {
+    std::vector<Command> commands;
+    std::string path;
+    flattenMenu(menu, path, commands);
+    return commands;
+}
+
+auto CommandIndex::actionLabel(std::string_view name) -> std::string {
+    std::string label;
+    label.reserve(name.size() + 4); // NOLINT
+
+    bool wordStart = true;
+    bool previousLower = false;
+    for (char c : name) {
+        if (c == '-' || c == '_' || c == ' ') {
+            wordStart = true;
+            previousLower = false;
+            continue;
+        }
+
+        // a capital after a lower case letter starts a word, so runs of capitals stay together
+        const bool lower = c >= 'a' && c <= 'z';
+        if (c >= 'A' && c <= 'Z' && previousLower) {
+            wordStart = true;
+        }
+        if (wordStart && !label.empty()) {
+            label.push_back(' ');
+        }
+        label.push_back(wordStart && lower ? static_cast<char>(c - ('a' - 'A')) : c);
+        wordStart = false;
+        previousLower = lower;
+    }
+    return label;
+}
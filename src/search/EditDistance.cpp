@@ -0,0 +1,93 @@
+#include <algorithm>
+
+#include "EditDistance.h"
+
+BoundedEditMatcher::BoundedEditMatcher(std::string_view pattern) {
+    assign(pattern);
+}
+
+void BoundedEditMatcher::assign(std::string_view pattern) {
+    peq_.fill(0);
+    length_ = std::min(pattern.size(), MAX_PATTERN);
+
+    for (size_t i = 0; i < length_; ++i) {
+        peq_[static_cast<unsigned char>(pattern[i])] |= uint64_t{1} << i;
+    }
+    highBit_ = length_ == 0 ? 0 : uint64_t{1} << (length_ - 1);
+}
+
+// Column-wise Myers: Pv/Mv hold the +1/-1 vertical deltas of the current
+// DP column, `score` tracks the bottom cell D[m][j]. Shifting a 1 into Ph
+// encodes the D[0][j] = j boundary, i.e. the text must be consumed from
+// its start rather than matched anywhere inside it.
+auto BoundedEditMatcher::prefixDistance(std::string_view text, uint32_t maxErrors) const -> uint32_t {
+    const auto m = static_cast<uint32_t>(length_);
+    if (m == 0) {
+        return 0;
+    }
+
+    uint64_t pv = ~uint64_t{0};
+    uint64_t mv = 0;
+    uint32_t score = m;
+    uint32_t best = m;
+
+    // past column m + k the bottom row can only grow beyond the bound
+    const size_t limit = std::min<size_t>(text.size(), m + maxErrors);
+
+    for (size_t j = 0; j < limit; ++j) {
+        const uint64_t eq = peq_[static_cast<unsigned char>(text[j])];
+        const uint64_t xv = eq | mv;
+        const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+
+        if ((ph & highBit_) != 0) {
+            ++score;
+        } else if ((mh & highBit_) != 0) {
+            --score;
+        }
+
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        best = std::min(best, score);
+    }
+
+    return best <= maxErrors ? best : maxErrors + 1;
+}
+
+auto BoundedEditMatcher::distance(std::string_view text) const -> uint32_t {
+    const auto m = static_cast<uint32_t>(length_);
+    if (m == 0) {
+        return static_cast<uint32_t>(text.size());
+    }
+
+    uint64_t pv = ~uint64_t{0};
+    uint64_t mv = 0;
+    uint32_t score = m;
+
+    for (char c : text) {
+        const uint64_t eq = peq_[static_cast<unsigned char>(c)];
+        const uint64_t xv = eq | mv;
+        const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+
+        if ((ph & highBit_) != 0) {
+            ++score;
+        } else if ((mh & highBit_) != 0) {
+            --score;
+        }
+
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+
+    return score;
+}
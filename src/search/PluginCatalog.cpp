@@ -0,0 +1,468 @@
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+#include "PluginCatalog.h"
+#include "TextFold.h"
+
+namespace {
+    // FNV-1a over the folded name
+    auto hashKey(std::string_view key) -> uint32_t {
+        uint32_t hash = 2166136261U; // NOLINT
+        for (char c : key) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 16777619U; // NOLINT
+        }
+        return hash;
+    }
+
+    auto trimmed(std::string_view text) -> std::string_view {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    // the last word of a folded name, when it names a format
+    auto formatSuffix(std::string_view word) -> PluginFormat {
+        if (word == "vst3") {
+            return PluginFormat::VST3;
+        }
+        if (word == "vst2" || word == "vst") {
+            return PluginFormat::VST2;
+        }
+        if (word == "au" || word == "auv2" || word == "auv3") {
+            return PluginFormat::AU;
+        }
+        return PluginFormat::Count;
+    }
+}
+
+PluginCatalog::PluginCatalog(std::vector<Plugin> plugins, uint64_t version, const PluginAliases& aliases)
+    : plugins_(std::move(plugins))
+    , version_(version)
+{
+    size_t totalBytes = 0;
+    for (const auto& plugin : plugins_) {
+        totalBytes += plugin.name.size();
+    }
+
+    keyData_.reserve(totalBytes);
+    nameOffsets_.reserve(totalBytes);
+    keyOffsets_.reserve(plugins_.size() + 1);
+    keyOffsets_.push_back(0);
+    tokenOffsets_.reserve(plugins_.size() + 1);
+    tokenOffsets_.push_back(0);
+
+    for (const auto& plugin : plugins_) {
+        appendKey(plugin.name);
+    }
+
+    buildColumns();
+    buildNameIndex(aliases);
+    buildNumberIndex();
+}
+
+PluginCatalog::PluginCatalog(const PluginCatalog& plugins, std::vector<Command> commands, uint64_t version)
+    : plugins_(plugins.plugins_)
+    , commands_(std::move(commands))
+    , version_(version)
+{
+    // only the plugin part of `plugins` is kept; it may carry commands of its own
+    const uint32_t count = plugins.pluginCount();
+    const uint32_t keyBytes = plugins.keyOffsets_[count];
+
+    keyData_.assign(plugins.keyData_, 0, keyBytes);
+    nameOffsets_.assign(plugins.nameOffsets_.begin(), plugins.nameOffsets_.begin() + keyBytes);
+    keyOffsets_.assign(plugins.keyOffsets_.begin(), plugins.keyOffsets_.begin() + count + 1);
+    tokens_.assign(plugins.tokens_.begin(), plugins.tokens_.begin() + plugins.tokenOffsets_[count]);
+    tokenOffsets_.assign(plugins.tokenOffsets_.begin(), plugins.tokenOffsets_.begin() + count + 1);
+
+    for (const auto& command : commands_) {
+        appendKey(command.label);
+    }
+
+    formats_.assign(plugins.formats_.begin(), plugins.formats_.begin() + count);
+    formats_.resize(size(), PluginFormat::Other);
+    formatEntries_ = plugins.formatEntries_;
+    for (auto& entries : formatEntries_) {
+        entries.resize(count);
+        entries.resize(size());
+    }
+    for (uint32_t i = count; i < size(); ++i) {
+        formatEntries_[static_cast<size_t>(PluginFormat::Other)].insert(i);
+    }
+
+    // postings only ever hold plugins, so they carry over as they are
+    vendors_.assign(plugins.vendors_.begin(), plugins.vendors_.begin() + count);
+    vendors_.resize(size(), NO_VENDOR);
+    vendorNames_ = plugins.vendorNames_;
+    vendorKeys_ = plugins.vendorKeys_;
+    vendorPostings_ = plugins.vendorPostings_;
+    vendorOffsets_ = plugins.vendorOffsets_;
+
+    // commands are never looked up by name
+    nameSlots_ = plugins.nameSlots_;
+    aliasKeys_ = plugins.aliasKeys_;
+    aliasTargets_ = plugins.aliasTargets_;
+    aliasEntries_ = plugins.aliasEntries_;
+    numberIndex_ = plugins.numberIndex_;
+}
+
+void PluginCatalog::appendKey(std::string_view name) {
+    TextFold::appendFolded(name, keyData_, &nameOffsets_);
+    keyOffsets_.push_back(static_cast<uint32_t>(keyData_.size()));
+
+    tokenize(searchKey(static_cast<uint32_t>(keyOffsets_.size() - 2)));
+    tokenOffsets_.push_back(static_cast<uint32_t>(tokens_.size()));
+}
+
+void PluginCatalog::buildColumns() {
+    const auto count = static_cast<uint32_t>(plugins_.size());
+
+    formats_.reserve(count);
+    for (auto& entries : formatEntries_) {
+        entries.reset(count, false);
+    }
+
+    vendors_.reserve(count);
+    std::unordered_map<std::string, uint32_t> vendorIds;
+    std::string key;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto& plugin = plugins_[i];
+
+        const PluginFormat format = formatOf(plugin.type);
+        formats_.push_back(format);
+        formatEntries_[static_cast<size_t>(format)].insert(i);
+
+        const std::string_view uri = plugin.uri;
+        const std::string_view name = uri.substr(0, std::min(uri.find(':'), uri.size()));
+        key.clear();
+        TextFold::appendFolded(name, key);
+
+        auto [it, inserted] = vendorIds.try_emplace(key, static_cast<uint32_t>(vendorKeys_.size()));
+        if (inserted) {
+            vendorNames_.emplace_back(name);
+            vendorKeys_.push_back(key);
+        }
+        vendors_.push_back(it->second);
+    }
+
+    // postings by counting sort, so each list comes out in index order
+    vendorOffsets_.assign(vendorKeys_.size() + 1, 0);
+    for (uint32_t vendor : vendors_) {
+        ++vendorOffsets_[vendor + 1];
+    }
+    for (size_t v = 1; v < vendorOffsets_.size(); ++v) {
+        vendorOffsets_[v] += vendorOffsets_[v - 1];
+    }
+    vendorPostings_.resize(count);
+    std::vector<uint32_t> cursor(vendorOffsets_.begin(), vendorOffsets_.end() - 1);
+    for (uint32_t i = 0; i < count; ++i) {
+        vendorPostings_[cursor[vendors_[i]]++] = i;
+    }
+}
+
+void PluginCatalog::buildNumberIndex() {
+    const uint32_t count = pluginCount();
+    numberIndex_.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        numberIndex_.emplace_back(plugins_[i].number, i);
+    }
+    // stable, so a repeated number keeps its first plugin first
+    std::stable_sort(numberIndex_.begin(), numberIndex_.end()
+                     , [](const auto& a, const auto& b) { return a.first < b.first; });
+}
+
+void PluginCatalog::buildNameIndex(const PluginAliases& aliases) {
+    const uint32_t count = pluginCount();
+
+    size_t capacity = 16; // NOLINT
+    while (capacity < 2 * (count + aliases.size())) {
+        capacity *= 2;
+    }
+    nameSlots_.assign(capacity, {0, EMPTY_SLOT});
+
+    for (uint32_t i = 0; i < count; ++i) {
+        insertName(hashKey(searchKey(i)), i);
+    }
+
+    // targets resolve against plugin names only, so aliases never chain
+    for (const auto& [alias, target] : aliases) {
+        std::string key = TextFold::fold(trimmed(alias));
+        if (key.empty()) {
+            continue;
+        }
+
+        PluginLookup lookup;
+        const std::string targetKey = TextFold::fold(trimmed(target));
+        uint32_t entry = findName(targetKey, hashKey(targetKey), PluginFormat::Count);
+        if (entry == EMPTY_SLOT && findQualified(targetKey, lookup) && lookup.found()) {
+            entry = lookup.index;
+        }
+
+        const auto id = static_cast<uint32_t>(aliasKeys_.size());
+        insertName(hashKey(key), ALIAS_BIT | id);
+        aliasKeys_.push_back(std::move(key));
+        aliasTargets_.push_back(target);
+        aliasEntries_.push_back(entry);
+    }
+}
+
+void PluginCatalog::insertName(uint32_t hash, uint32_t value) {
+    const size_t mask = nameSlots_.size() - 1;
+    size_t slot = hash & mask;
+    while (nameSlots_[slot].value != EMPTY_SLOT) {
+        slot = (slot + 1) & mask;
+    }
+    nameSlots_[slot] = {hash, value};
+}
+
+auto PluginCatalog::findName(std::string_view key, uint32_t hash, PluginFormat format) const -> uint32_t {
+    // the same name in several formats sits further along the same run,
+    // in insertion (catalog) order
+    const size_t mask = nameSlots_.size() - 1;
+    for (size_t slot = hash & mask; nameSlots_[slot].value != EMPTY_SLOT; slot = (slot + 1) & mask) {
+        const NameSlot& candidate = nameSlots_[slot];
+        if (candidate.hash != hash || (candidate.value & ALIAS_BIT) != 0) {
+            continue;
+        }
+        if (searchKey(candidate.value) == key && (format == PluginFormat::Count || formats_[candidate.value] == format)) {
+            return candidate.value;
+        }
+    }
+    return EMPTY_SLOT;
+}
+
+auto PluginCatalog::findAlias(std::string_view key, uint32_t hash) const -> uint32_t {
+    const size_t mask = nameSlots_.size() - 1;
+    for (size_t slot = hash & mask; nameSlots_[slot].value != EMPTY_SLOT; slot = (slot + 1) & mask) {
+        const NameSlot& candidate = nameSlots_[slot];
+        if (candidate.hash == hash && (candidate.value & ALIAS_BIT) != 0 && aliasKeys_[candidate.value & ~ALIAS_BIT] == key) {
+            return candidate.value & ~ALIAS_BIT;
+        }
+    }
+    return EMPTY_SLOT;
+}
+
+// "pro-q 3 au": the name without its last word, in the format that word names
+auto PluginCatalog::findQualified(std::string_view key, PluginLookup& lookup) const -> bool {
+    const size_t space = key.rfind(' ');
+    if (space == std::string_view::npos) {
+        return false;
+    }
+    const PluginFormat format = formatSuffix(key.substr(space + 1));
+    if (format == PluginFormat::Count) {
+        return false;
+    }
+
+    const std::string_view base = trimmed(key.substr(0, space));
+    const uint32_t hash = hashKey(base);
+    if (uint32_t entry = findName(base, hash, format); entry != EMPTY_SLOT) {
+        lookup = {entry, NameMiss::None, {}};
+        return true;
+    }
+    if (findName(base, hash, PluginFormat::Count) != EMPTY_SLOT) {
+        lookup = {EMPTY_SLOT, NameMiss::NotInFormat, {}};
+        return true;
+    }
+    return false;
+}
+
+auto PluginCatalog::findNumber(int number) const -> uint32_t {
+    auto it = std::lower_bound(numberIndex_.begin(), numberIndex_.end(), number
+                               , [](const auto& entry, int n) { return entry.first < n; });
+    if (it == numberIndex_.end() || it->first != number) {
+        return EMPTY_SLOT;
+    }
+    return it->second;
+}
+
+auto PluginCatalog::findPlugin(std::string_view name) const -> PluginLookup {
+    const std::string key = TextFold::fold(trimmed(name));
+    if (key.empty()) {
+        return {EMPTY_SLOT, NameMiss::Empty, {}};
+    }
+
+    const uint32_t hash = hashKey(key);
+    if (uint32_t entry = findName(key, hash, PluginFormat::Count); entry != EMPTY_SLOT) {
+        return {entry, NameMiss::None, {}};
+    }
+
+    if (uint32_t alias = findAlias(key, hash); alias != EMPTY_SLOT) {
+        if (aliasEntries_[alias] != EMPTY_SLOT) {
+            return {aliasEntries_[alias], NameMiss::None, {}};
+        }
+        return {EMPTY_SLOT, NameMiss::AliasTargetMissing, aliasTargets_[alias]};
+    }
+
+    PluginLookup lookup;
+    if (findQualified(key, lookup)) {
+        return lookup;
+    }
+    return {EMPTY_SLOT, NameMiss::NotInstalled, {}};
+}
+
+auto PluginCatalog::missReason(std::string_view name, const PluginLookup& lookup) -> std::string {
+    const std::string quoted = "\"" + std::string(name) + "\"";
+    switch (lookup.miss) {
+        case NameMiss::None:
+            return "found";
+        case NameMiss::Empty:
+            return "no plugin name given";
+        case NameMiss::NotInstalled:
+            return "no plugin named " + quoted + " is installed";
+        case NameMiss::NotInFormat:
+            return quoted + " is installed, but not in that format";
+        case NameMiss::AliasTargetMissing:
+            return quoted + " is an alias for \"" + std::string(lookup.target) + "\", which isn't installed";
+    }
+    return "unknown";
+}
+
+void PluginCatalog::tokenize(std::string_view key) {
+    // names longer than this don't occur in practice; clamp rather than overflow
+    const size_t length = std::min<size_t>(key.size(), UINT16_MAX);
+
+    size_t i = 0;
+    while (i < length) {
+        while (i < length && !TextFold::isWordByte(static_cast<unsigned char>(key[i]))) {
+            ++i;
+        }
+        size_t start = i;
+        while (i < length && TextFold::isWordByte(static_cast<unsigned char>(key[i]))) {
+            ++i;
+        }
+        if (i > start) {
+            tokens_.push_back({static_cast<uint16_t>(start), static_cast<uint16_t>(i - start)});
+        }
+    }
+}
+
+auto PluginCatalog::size() const -> uint32_t {
+    return static_cast<uint32_t>(plugins_.size() + commands_.size());
+}
+
+auto PluginCatalog::empty() const -> bool {
+    return plugins_.empty() && commands_.empty();
+}
+
+auto PluginCatalog::version() const -> uint64_t {
+    return version_;
+}
+
+auto PluginCatalog::pluginCount() const -> uint32_t {
+    return static_cast<uint32_t>(plugins_.size());
+}
+
+auto PluginCatalog::kind(uint32_t index) const -> EntryKind {
+    return index < plugins_.size() ? EntryKind::Plugin : commands_[index - plugins_.size()].kind;
+}
+
+auto PluginCatalog::name(uint32_t index) const -> const std::string& {
+    return index < plugins_.size() ? plugins_[index].name : commands_[index - plugins_.size()].label;
+}
+
+auto PluginCatalog::plugin(uint32_t index) const -> const Plugin& {
+    return plugins_[index];
+}
+
+auto PluginCatalog::plugins() const -> const std::vector<Plugin>& {
+    return plugins_;
+}
+
+auto PluginCatalog::command(uint32_t index) const -> const Command& {
+    return commands_[index - plugins_.size()];
+}
+
+auto PluginCatalog::commands() const -> const std::vector<Command>& {
+    return commands_;
+}
+
+auto PluginCatalog::searchKey(uint32_t index) const -> std::string_view {
+    return {keyData_.data() + keyOffsets_[index], keyOffsets_[index + 1] - keyOffsets_[index]};
+}
+
+auto PluginCatalog::tokens(uint32_t index) const -> std::span<const KeyToken> {
+    return {tokens_.data() + tokenOffsets_[index], tokenOffsets_[index + 1] - tokenOffsets_[index]};
+}
+
+auto PluginCatalog::nameSpan(uint32_t index, uint32_t keyBegin, uint32_t keyEnd) const -> MatchSpan {
+    const uint32_t base = keyOffsets_[index];
+    const uint32_t keyLength = keyOffsets_[index + 1] - base;
+    const auto nameLength = static_cast<uint16_t>(std::min<size_t>(name(index).size(), UINT16_MAX));
+
+    keyEnd = std::min(keyEnd, keyLength);
+    if (keyBegin >= keyEnd) {
+        return {0, 0};
+    }
+
+    const uint16_t begin = nameOffsets_[base + keyBegin];
+
+    // the end is wherever the next source character starts, so a range
+    // ending inside an expansion still covers the whole character
+    uint16_t end = nameLength;
+    const uint16_t last = nameOffsets_[base + keyEnd - 1];
+    for (uint32_t k = keyEnd; k < keyLength; ++k) {
+        if (nameOffsets_[base + k] != last) {
+            end = nameOffsets_[base + k];
+            break;
+        }
+    }
+
+    return {begin, static_cast<uint16_t>(end - begin)};
+}
+
+// Live reports "VST3:", "VST2:", "AUv2:"; anything it adds later is Other
+auto PluginCatalog::formatOf(std::string_view type) -> PluginFormat {
+    std::string folded;
+    for (char c : type) {
+        if (!TextFold::isWordByte(static_cast<unsigned char>(c))) {
+            break;
+        }
+        folded.push_back(c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c);
+    }
+
+    if (folded == "vst3") {
+        return PluginFormat::VST3;
+    }
+    if (folded == "vst2" || folded == "vst") {
+        return PluginFormat::VST2;
+    }
+    if (folded.starts_with("au")) {
+        return PluginFormat::AU;
+    }
+    return PluginFormat::Other;
+}
+
+auto PluginCatalog::format(uint32_t index) const -> PluginFormat {
+    return formats_[index];
+}
+
+auto PluginCatalog::formatEntries(PluginFormat format) const -> const EntrySet& {
+    return formatEntries_[static_cast<size_t>(format)];
+}
+
+auto PluginCatalog::vendorCount() const -> uint32_t {
+    return static_cast<uint32_t>(vendorKeys_.size());
+}
+
+auto PluginCatalog::vendor(uint32_t index) const -> uint32_t {
+    return vendors_[index];
+}
+
+auto PluginCatalog::vendorName(uint32_t vendor) const -> std::string_view {
+    return vendorNames_[vendor];
+}
+
+auto PluginCatalog::vendorKey(uint32_t vendor) const -> std::string_view {
+    return vendorKeys_[vendor];
+}
+
+auto PluginCatalog::vendorEntries(uint32_t vendor) const -> std::span<const uint32_t> {
+    return {vendorPostings_.data() + vendorOffsets_[vendor], vendorOffsets_[vendor + 1] - vendorOffsets_[vendor]};
+}
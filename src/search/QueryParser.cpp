@@ -0,0 +1,124 @@
+#include <array>
+
+#include "QueryParser.h"
+#include "TextFold.h"
+
+namespace {
+    struct FieldName {
+        std::string_view name;
+        QueryField field;
+    };
+
+    constexpr std::array<FieldName, 3> FIELD_NAMES = {{
+        {"fmt", QueryField::Format}
+        , {"format", QueryField::Format}
+        , {"vendor", QueryField::Vendor}
+    }};
+
+    auto isSpace(char c) -> bool {
+        return c == ' ' || c == '\t';
+    }
+
+    auto findField(std::string_view name, QueryField& field) -> bool {
+        for (const auto& candidate : FIELD_NAMES) {
+            if (candidate.name.size() != name.size()) {
+                continue;
+            }
+            bool same = true;
+            for (size_t i = 0; i < name.size() && same; ++i) {
+                const char c = name[i];
+                same = (c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c) == candidate.name[i];
+            }
+            if (same) {
+                field = candidate.field;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void addPredicate(ParsedQuery& out, QueryField field, std::string_view value) {
+        while (!value.empty() && isSpace(value.front())) {
+            value.remove_prefix(1);
+        }
+        while (!value.empty() && isSpace(value.back())) {
+            value.remove_suffix(1);
+        }
+        if (value.empty()) {
+            return;
+        }
+
+        auto& predicate = out.predicates.emplace_back();
+        predicate.field = field;
+        TextFold::appendFolded(value, predicate.value);
+    }
+}
+
+namespace QueryParser {
+    void parse(std::string_view query, ParsedQuery& out) {
+        out.text.clear();
+        out.predicates.clear();
+
+        bool sawField = false;
+        size_t i = 0;
+        while (i < query.size()) {
+            while (i < query.size() && isSpace(query[i])) {
+                ++i;
+            }
+            if (i == query.size()) {
+                break;
+            }
+
+            const size_t start = i;
+            size_t colon = start;
+            while (colon < query.size() && !isSpace(query[colon]) && query[colon] != ':') {
+                ++colon;
+            }
+
+            QueryField field{};
+            if (colon < query.size() && query[colon] == ':' && findField(query.substr(start, colon - start), field)) {
+                sawField = true;
+                const size_t valueStart = colon + 1;
+
+                if (valueStart < query.size() && query[valueStart] == '"') {
+                    // an unclosed quote runs to the end, as it does while typing
+                    size_t close = query.find('"', valueStart + 1);
+                    const size_t end = close == std::string_view::npos ? query.size() : close;
+                    addPredicate(out, field, query.substr(valueStart + 1, end - valueStart - 1));
+                    i = close == std::string_view::npos ? query.size() : close + 1;
+                    continue;
+                }
+
+                size_t end = valueStart;
+                while (end < query.size() && !isSpace(query[end])) {
+                    ++end;
+                }
+
+                // "fmt:vst3,au" is the same as "fmt:vst3 fmt:au"
+                std::string_view values = query.substr(valueStart, end - valueStart);
+                while (!values.empty()) {
+                    const size_t comma = values.find(',');
+                    addPredicate(out, field, values.substr(0, comma));
+                    values = comma == std::string_view::npos ? std::string_view() : values.substr(comma + 1);
+                }
+                i = end;
+                continue;
+            }
+
+            size_t end = start;
+            while (end < query.size() && !isSpace(query[end])) {
+                ++end;
+            }
+            if (!out.text.empty()) {
+                out.text.push_back(' ');
+            }
+            out.text.append(query.substr(start, end - start));
+            i = end;
+        }
+
+        // without fields the text goes through exactly as typed
+        if (!sawField) {
+            out.text.assign(query);
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#include "ResultList.h"
+
+void ResultList::reserve(const PluginCatalog& catalog) {
+    indices_.reserve(catalog.size());
+    spanOffsets_.reserve(catalog.size() + 1);
+}
+
+void ResultList::showAll(PluginCatalogPtr catalog) {
+    catalog_ = std::move(catalog);
+    indices_.clear();
+    spans_.clear();
+    spanOffsets_.clear();
+
+    if (!catalog_) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < catalog_->size(); ++i) {
+        indices_.push_back(i);
+    }
+}
+
+void ResultList::assign(PluginCatalogPtr catalog, std::span<const SearchMatch> matches, std::span<const MatchSpan> spans, std::span<const uint32_t> spanOffsets) {
+    catalog_ = std::move(catalog);
+
+    indices_.clear();
+    for (const auto& match : matches) {
+        indices_.push_back(match.index);
+    }
+
+    // spans are optional; without them rows just aren't highlighted
+    spans_.clear();
+    spanOffsets_.clear();
+    if (spanOffsets.size() == matches.size() + 1) {
+        spans_.insert(spans_.end(), spans.begin(), spans.end());
+        spanOffsets_.insert(spanOffsets_.end(), spanOffsets.begin(), spanOffsets.end());
+    }
+}
+
+auto ResultList::size() const -> uint32_t {
+    return static_cast<uint32_t>(indices_.size());
+}
+
+auto ResultList::catalog() const -> const PluginCatalogPtr& {
+    return catalog_;
+}
+
+auto ResultList::catalogIndex(uint32_t row) const -> uint32_t {
+    return indices_[row];
+}
+
+auto ResultList::name(int row) const -> const std::string* {
+    if (row < 0 || static_cast<size_t>(row) >= indices_.size()) {
+        return nullptr;
+    }
+    return &catalog_->name(indices_[static_cast<size_t>(row)]);
+}
+
+auto ResultList::plugin(int row) const -> const Plugin* {
+    if (row < 0 || static_cast<size_t>(row) >= indices_.size()) {
+        return nullptr;
+    }
+    const uint32_t index = indices_[static_cast<size_t>(row)];
+    return index < catalog_->pluginCount() ? &catalog_->plugin(index) : nullptr;
+}
+
+auto ResultList::spans(uint32_t row) const -> std::span<const MatchSpan> {
+    if (row + 1 >= spanOffsets_.size()) {
+        return {};
+    }
+    return {spans_.data() + spanOffsets_[row], spanOffsets_[row + 1] - spanOffsets_[row]};
+}
@@ -0,0 +1,435 @@
+#include <algorithm>
+#include <array>
+
+#include "PluginCatalog.h"
+#include "SearchEngine.h"
+#include "TextFold.h"
+
+namespace {
+    constexpr int32_t tierBase(MatchTier tier, int32_t tierWidth) {
+        return static_cast<int32_t>(tier) * tierWidth;
+    }
+
+    struct FormatName {
+        std::string_view name;
+        PluginFormat format;
+    };
+
+    // what people type after "fmt:"; a prefix picks every format it starts
+    constexpr std::array<FormatName, 5> FORMAT_NAMES = {{
+        {"vst3", PluginFormat::VST3}
+        , {"vst2", PluginFormat::VST2}
+        , {"au", PluginFormat::AU}
+        , {"auv2", PluginFormat::AU}
+        , {"audiounit", PluginFormat::AU}
+    }};
+}
+
+SearchEngine::SearchEngine(SearchOptions options)
+    : options_(options)
+{
+    wordMatchers_.reserve(MAX_APPROXIMATE_WORDS);
+    wordBudgets_.reserve(MAX_APPROXIMATE_WORDS);
+}
+
+auto SearchEngine::search(const PluginCatalog& catalog, std::string_view query, const CancellationToken& token, std::vector<SearchMatch>& out, std::span<const uint16_t> boosts) -> bool {
+    out.clear();
+    QueryParser::parse(query, parsed_);
+    normalizeQuery(parsed_.text);
+    approximatePrepared_ = false;
+    filtered_ = compileFilter(catalog);
+
+    const uint32_t count = catalog.size();
+    if (boosts.size() != count) {
+        boosts = {};
+    }
+
+    // empty query lists the whole catalog in its natural (alphabetical) order,
+    // or most used first when there is usage to go on
+    if (query_.empty()) {
+        if (!boosts.empty()) {
+            // only the handful with history need sorting; the rest follow untouched
+            forEachCandidate(count, [&](uint32_t i) {
+                if (boosts[i] > 0) {
+                    out.push_back({i, static_cast<int32_t>(boosts[i])});
+                }
+                return true;
+            });
+            std::sort(out.begin(), out.end(), [](const SearchMatch& a, const SearchMatch& b) {
+                return a.score != b.score ? a.score > b.score : a.index < b.index;
+            });
+        }
+        forEachCandidate(count, [&](uint32_t i) {
+            if (boosts.empty() || boosts[i] == 0) {
+                out.push_back({i, 0});
+            }
+            return true;
+        });
+        return true;
+    }
+
+    uint32_t visited = 0;
+    const bool completed = forEachCandidate(count, [&](uint32_t i) {
+        if (visited++ % CANCEL_CHECK_INTERVAL == 0 && token.isCancelled()) {
+            return false;
+        }
+
+        int32_t s = score(catalog.searchKey(i), query_);
+        if (s > 0) {
+            out.push_back({i, s});
+        }
+        return true;
+    });
+
+    if (!completed || token.isCancelled()) {
+        return false;
+    }
+
+    if (out.size() < options_.approximateThreshold && !searchApproximate(catalog, token, out)) {
+        return false;
+    }
+
+    if (!boosts.empty()) {
+        for (auto& match : out) {
+            match.score = blend(match.score, boosts[match.index]);
+        }
+    }
+
+    // ties keep catalog order so equally good matches stay alphabetical
+    std::sort(out.begin(), out.end(), [](const SearchMatch& a, const SearchMatch& b) {
+        return a.score != b.score ? a.score > b.score : a.index < b.index;
+    });
+
+    return true;
+}
+
+auto SearchEngine::score(std::string_view key, std::string_view query) -> int32_t {
+    if (query.empty() || query.size() > key.size()) {
+        return 0;
+    }
+
+    // shorter names win within a tier: "Pro-Q" before "Pro-Q 3 Dynamic"
+    const auto lengthPenalty = static_cast<int32_t>(std::min<size_t>(key.size(), TIER_WIDTH / 2 - 1));
+
+    size_t pos = key.find(query);
+    if (pos == 0) {
+        return tierBase(MatchTier::Prefix, TIER_WIDTH) + (TIER_WIDTH - 1) - lengthPenalty;
+    }
+
+    if (pos != std::string_view::npos) {
+        const int32_t boundaryBonus = isWordStart(key, pos) ? TIER_WIDTH / 2 : 0;
+        const auto positionPenalty = static_cast<int32_t>(std::min<size_t>(pos, TIER_WIDTH / 2 - 1));
+        return tierBase(MatchTier::Substring, TIER_WIDTH) + boundaryBonus + (TIER_WIDTH / 2 - 1) - positionPenalty;
+    }
+
+    int32_t fuzzy = fuzzyScore(key, query);
+    if (fuzzy > 0) {
+        return tierBase(MatchTier::Fuzzy, TIER_WIDTH) + fuzzy;
+    }
+
+    return 0;
+}
+
+void SearchEngine::highlight(const PluginCatalog& catalog, uint32_t index, std::vector<MatchSpan>& out) const {
+    if (query_.empty()) {
+        return;
+    }
+
+    const std::string_view key = catalog.searchKey(index);
+
+    size_t pos = key.find(query_);
+    if (pos != std::string_view::npos) {
+        out.push_back(catalog.nameSpan(index, static_cast<uint32_t>(pos), static_cast<uint32_t>(pos + query_.size())));
+        return;
+    }
+
+    // same greedy walk as fuzzyScore, one span per consecutive run
+    const size_t first = out.size();
+    size_t keyPos = 0;
+    size_t runStart = std::string_view::npos;
+    size_t previous = std::string_view::npos;
+    bool matched = true;
+
+    for (char qc : query_) {
+        while (keyPos < key.size() && key[keyPos] != qc) {
+            ++keyPos;
+        }
+        if (keyPos == key.size()) {
+            matched = false;
+            break;
+        }
+        if (runStart == std::string_view::npos || keyPos != previous + 1) {
+            if (runStart != std::string_view::npos) {
+                out.push_back(catalog.nameSpan(index, static_cast<uint32_t>(runStart), static_cast<uint32_t>(previous + 1)));
+            }
+            runStart = keyPos;
+        }
+        previous = keyPos;
+        ++keyPos;
+    }
+
+    if (matched) {
+        out.push_back(catalog.nameSpan(index, static_cast<uint32_t>(runStart), static_cast<uint32_t>(previous + 1)));
+        return;
+    }
+    out.resize(first);
+
+    if (!approximatePrepared_) {
+        return;
+    }
+
+    // typo matches: mark the name word each query word landed on
+    const auto tokens = catalog.tokens(index);
+    for (size_t w = 0; w < wordMatchers_.size(); ++w) {
+        const KeyToken* best = nullptr;
+        uint32_t bestDistance = wordBudgets_[w] + 1;
+        for (const auto& token : tokens) {
+            uint32_t distance = wordMatchers_[w].prefixDistance(key.substr(token.offset, token.length), wordBudgets_[w]);
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                best = &token;
+            }
+        }
+        if (best != nullptr) {
+            out.push_back(catalog.nameSpan(index, best->offset, best->offset + best->length));
+        }
+    }
+
+    // several words can land on the same token, and not in name order
+    std::sort(out.begin() + static_cast<std::ptrdiff_t>(first), out.end(), [](const MatchSpan& a, const MatchSpan& b) {
+        return a.offset < b.offset;
+    });
+    out.erase(std::unique(out.begin() + static_cast<std::ptrdiff_t>(first), out.end(), [](const MatchSpan& a, const MatchSpan& b) {
+        return a.offset == b.offset;
+    }), out.end());
+}
+
+auto SearchEngine::blend(int32_t score, uint16_t boost) -> int32_t {
+    static_assert(MAX_BOOST < TIER_WIDTH);
+    const int32_t tier = score / TIER_WIDTH;
+    const int32_t inTier = score % TIER_WIDTH;
+    return tier * 2 * TIER_WIDTH + inTier + std::min<int32_t>(boost, MAX_BOOST);
+}
+
+// greedy in-order subsequence match, rewarding runs and word starts
+auto SearchEngine::fuzzyScore(std::string_view key, std::string_view query) -> int32_t {
+    // NOLINTBEGIN
+    constexpr int32_t MATCH_SCORE       = 10;
+    constexpr int32_t CONSECUTIVE_BONUS = 15;
+    constexpr int32_t WORD_START_BONUS  = 20;
+    constexpr int32_t MAX_GAP_PENALTY   = 5;
+    // NOLINTEND
+
+    int32_t total = 0;
+    size_t keyPos = 0;
+    size_t previous = std::string_view::npos;
+
+    for (char qc : query) {
+        while (keyPos < key.size() && key[keyPos] != qc) {
+            ++keyPos;
+        }
+        if (keyPos == key.size()) {
+            return 0;
+        }
+
+        total += MATCH_SCORE;
+        if (previous != std::string_view::npos && keyPos == previous + 1) {
+            total += CONSECUTIVE_BONUS;
+        } else if (previous != std::string_view::npos) {
+            total -= static_cast<int32_t>(std::min<size_t>(keyPos - previous - 1, MAX_GAP_PENALTY));
+        }
+        if (isWordStart(key, keyPos)) {
+            total += WORD_START_BONUS;
+        }
+
+        previous = keyPos;
+        ++keyPos;
+    }
+
+    return std::clamp(total, 1, TIER_WIDTH - 1);
+}
+
+auto SearchEngine::searchApproximate(const PluginCatalog& catalog, const CancellationToken& token, std::vector<SearchMatch>& out) -> bool {
+    if (!prepareApproximate()) {
+        return true;
+    }
+
+    // everything found so far is known to be fewer than the threshold
+    const size_t alreadyMatched = out.size();
+    uint32_t visited = 0;
+
+    return forEachCandidate(catalog.size(), [&](uint32_t i) {
+        if (visited++ % CANCEL_CHECK_INTERVAL == 0 && token.isCancelled()) {
+            return false;
+        }
+
+        for (size_t m = 0; m < alreadyMatched; ++m) {
+            if (out[m].index == i) {
+                return true;
+            }
+        }
+
+        int32_t s = approximateScore(catalog, i);
+        if (s > 0) {
+            out.push_back({i, s});
+        }
+        return true;
+    });
+}
+
+auto SearchEngine::prepareApproximate() -> bool {
+    wordMatchers_.clear();
+    wordBudgets_.clear();
+    approximatePrepared_ = true;
+
+    size_t i = 0;
+    while (i < query_.size() && wordMatchers_.size() < MAX_APPROXIMATE_WORDS) {
+        while (i < query_.size() && !TextFold::isWordByte(static_cast<unsigned char>(query_[i]))) {
+            ++i;
+        }
+        size_t start = i;
+        while (i < query_.size() && TextFold::isWordByte(static_cast<unsigned char>(query_[i]))) {
+            ++i;
+        }
+        if (i > start) {
+            auto word = std::string_view(query_).substr(start, i - start);
+            wordMatchers_.emplace_back(word);
+            wordBudgets_.push_back(errorBudget(wordMatchers_.back().patternLength()));
+        }
+    }
+
+    return std::any_of(wordBudgets_.begin(), wordBudgets_.end(), [](uint32_t budget) { return budget > 0; });
+}
+
+// every query word has to land within its budget on some name word
+auto SearchEngine::approximateScore(const PluginCatalog& catalog, uint32_t index) const -> int32_t {
+    // NOLINTNEXTLINE
+    constexpr int32_t ERROR_PENALTY = 200;
+
+    const std::string_view key = catalog.searchKey(index);
+    const auto tokens = catalog.tokens(index);
+
+    uint32_t totalErrors = 0;
+
+    for (size_t w = 0; w < wordMatchers_.size(); ++w) {
+        const auto& matcher = wordMatchers_[w];
+        const uint32_t budget = wordBudgets_[w];
+        const size_t minLength = matcher.patternLength() > budget ? matcher.patternLength() - budget : 0;
+
+        uint32_t best = budget + 1;
+        for (const auto& token : tokens) {
+            if (token.length < minLength) {
+                continue;
+            }
+            best = std::min(best, matcher.prefixDistance(key.substr(token.offset, token.length), budget));
+            if (best == 0) {
+                break;
+            }
+        }
+
+        if (best > budget) {
+            return 0;
+        }
+        totalErrors += best;
+    }
+
+    const auto lengthPenalty = static_cast<int32_t>(std::min<size_t>(key.size(), ERROR_PENALTY - 1));
+    const int32_t s = (TIER_WIDTH - 1) - static_cast<int32_t>(totalErrors) * ERROR_PENALTY - lengthPenalty;
+
+    return tierBase(MatchTier::Approximate, TIER_WIDTH) + std::max<int32_t>(s, 1);
+}
+
+auto SearchEngine::errorBudget(size_t wordLength) const -> uint32_t {
+    // NOLINTBEGIN
+    if (wordLength < 3) {
+        return 0;
+    }
+    if (wordLength < 5) {
+        return std::min<uint32_t>(1, options_.maxErrors);
+    }
+    // NOLINTEND
+    return options_.maxErrors;
+}
+
+auto SearchEngine::isWordStart(std::string_view key, size_t pos) -> bool {
+    if (pos == 0) {
+        return true;
+    }
+    return !TextFold::isWordByte(static_cast<unsigned char>(key[pos - 1]));
+}
+
+void SearchEngine::normalizeQuery(std::string_view query) {
+    query_.clear();
+
+    size_t begin = query.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) {
+        return;
+    }
+    size_t end = query.find_last_not_of(" \t");
+
+    // same folding as the catalog keys, so "tonebrunder" finds "Tonebründer"
+    TextFold::appendFolded(query.substr(begin, end - begin + 1), query_);
+}
+
+// Values of one field widen the set, fields narrow it. Everything is
+// whole-word bitmap operations over the catalog's columns; no names are
+// looked at.
+auto SearchEngine::compileFilter(const PluginCatalog& catalog) -> bool {
+    if (parsed_.predicates.empty()) {
+        return false;
+    }
+
+    const uint32_t count = catalog.size();
+    filter_.reset(count, true);
+
+    for (QueryField field : {QueryField::Format, QueryField::Vendor}) {
+        bool constrained = false;
+        fieldEntries_.reset(count, false);
+
+        for (const auto& predicate : parsed_.predicates) {
+            if (predicate.field != field) {
+                continue;
+            }
+            constrained = true;
+
+            if (field == QueryField::Format) {
+                for (size_t f = 0; f < static_cast<size_t>(PluginFormat::Count); ++f) {
+                    const auto format = static_cast<PluginFormat>(f);
+                    if (formatMatches(format, predicate.value)) {
+                        fieldEntries_.unite(catalog.formatEntries(format));
+                    }
+                }
+            } else {
+                for (uint32_t v = 0; v < catalog.vendorCount(); ++v) {
+                    if (vendorMatches(catalog.vendorKey(v), predicate.value)) {
+                        for (uint32_t i : catalog.vendorEntries(v)) {
+                            fieldEntries_.insert(i);
+                        }
+                    }
+                }
+            }
+        }
+
+        if (constrained) {
+            filter_.intersect(fieldEntries_);
+        }
+    }
+
+    return true;
+}
+
+auto SearchEngine::formatMatches(PluginFormat format, std::string_view value) -> bool {
+    return std::any_of(FORMAT_NAMES.begin(), FORMAT_NAMES.end(), [&](const FormatName& name) {
+        return name.format == format && name.name.starts_with(value);
+    });
+}
+
+// "fab" finds FabFilter, "instruments" finds Native Instruments
+auto SearchEngine::vendorMatches(std::string_view vendorKey, std::string_view value) -> bool {
+    for (size_t pos = vendorKey.find(value); pos != std::string_view::npos; pos = vendorKey.find(value, pos + 1)) {
+        if (isWordStart(vendorKey, pos)) {
+            return true;
+        }
+    }
+    return false;
+}
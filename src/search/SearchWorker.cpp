@@ -0,0 +1,136 @@
+#include "LogGlobal.h"
+
+#include "SearchWorker.h"
+
+SearchWorker::SearchWorker(ResultCallback onResult)
+    : onResult_(std::move(onResult))
+    , resultPool_(std::make_shared<ResultPool>())
+{
+    resultPool_->free.reserve(RESULT_POOL_SIZE);
+    thread_ = std::thread([this]() { run(); });
+}
+
+SearchWorker::~SearchWorker() {
+    stop();
+}
+
+auto SearchWorker::submit(PluginCatalogPtr catalog, std::string query, RankingBoostsPtr boosts) -> uint64_t {
+    const auto now = std::chrono::steady_clock::now();
+    uint64_t generation = 0;
+    {
+        std::lock_guard lock(mutex_);
+        generation = generation_.fetch_add(1, std::memory_order_relaxed) + 1;
+
+        // replaces (and thereby cancels) any job that hasn't started yet
+        pending_ = Job{generation, std::move(catalog), std::move(query), std::move(boosts), now};
+    }
+    cv_.notify_one();
+    return generation;
+}
+
+auto SearchWorker::latestGeneration() const -> uint64_t {
+    return generation_.load(std::memory_order_relaxed);
+}
+
+void SearchWorker::stop() {
+    {
+        std::lock_guard lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+        pending_.reset();
+    }
+    // bumping the generation cancels a scan that is in flight
+    generation_.fetch_add(1, std::memory_order_relaxed);
+    cv_.notify_one();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+auto SearchWorker::acquireResult() -> std::shared_ptr<SearchResult> {
+    std::unique_ptr<SearchResult> result;
+    {
+        std::lock_guard lock(resultPool_->mutex);
+        if (!resultPool_->free.empty()) {
+            result = std::move(resultPool_->free.back());
+            resultPool_->free.pop_back();
+        }
+    }
+
+    if (!result) {
+        if (pooledResults_ == RESULT_POOL_SIZE) {
+            // the UI is holding on to all of them
+            return std::make_shared<SearchResult>();
+        }
+        result = std::make_unique<SearchResult>();
+        ++pooledResults_;
+    }
+
+    return {result.release(), [pool = resultPool_](SearchResult* released) {
+        // a pooled result mustn't keep a replaced catalog alive; dropped
+        // outside the lock since it may be the last reference
+        released->catalog.reset();
+
+        std::lock_guard lock(pool->mutex);
+        // reserved up front, so this never allocates
+        pool->free.emplace_back(released);
+    }};
+}
+
+void SearchWorker::run() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || pending_.has_value(); });
+            if (stopping_) {
+                return;
+            }
+            job = std::move(*pending_);
+            pending_.reset();
+        }
+
+        if (!job.catalog) {
+            continue;
+        }
+
+        auto result = acquireResult();
+        result->generation = job.generation;
+        result->catalog = job.catalog;
+        result->query = job.query;
+        result->submittedAt = job.submittedAt;
+        result->matches.reserve(job.catalog->size());
+        result->spans.clear();
+        result->spanOffsets.clear();
+
+        std::span<const uint16_t> boosts;
+        if (job.boosts) {
+            boosts = *job.boosts;
+        }
+
+        CancellationToken token(generation_, job.generation);
+        if (!engine_.search(*result->catalog, result->query, token, result->matches, boosts)) {
+            logger->trace("search generation {} superseded", job.generation);
+            continue;
+        }
+
+        result->spanOffsets.reserve(result->matches.size() + 1);
+        for (const auto& match : result->matches) {
+            result->spanOffsets.push_back(static_cast<uint32_t>(result->spans.size()));
+            engine_.highlight(*result->catalog, match.index, result->spans);
+        }
+        result->spanOffsets.push_back(static_cast<uint32_t>(result->spans.size()));
+
+        // a newer query arrived while we were sorting; don't bother the UI
+        if (token.isCancelled()) {
+            continue;
+        }
+
+        if (onResult_) {
+            onResult_(std::move(result));
+        }
+    }
+}
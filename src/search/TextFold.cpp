@@ -0,0 +1,204 @@
+#include <algorithm>
+
+#include "TextFold.h"
+
+namespace {
+    // Replacement for U+00C0..U+00FF, upper half then lower half.
+    // '.' keeps the original character; the other markers expand below.
+    constexpr std::string_view LATIN_1 =
+        "aaaaaa&ceeeeiiiidnooooo.ouuuuy^%"
+        "aaaaaa&ceeeeiiiidnooooo.ouuuuy^y";
+
+    // U+0100..U+017F, which alternates upper/lower almost throughout
+    constexpr std::string_view LATIN_EXTENDED_A =
+        "aaaaaa" "cccccccc" "dddd" "eeeeeeeeee" "gggggggg" "hhhh" "iiiiiiiiii" "**" "jj" "kkk"
+        "llllllllll" "nnnnnnnnn" "oooooo" "##" "rrrrrr" "ssssssss" "tttttt" "uuuuuuuuuuuu"
+        "ww" "yyy" "zzzzzz" "s";
+
+    static_assert(LATIN_1.size() == 0x40);
+    static_assert(LATIN_EXTENDED_A.size() == 0x80);
+
+    auto expandMarker(char marker) -> std::string_view {
+        switch (marker) {
+            case '&': return "ae";
+            case '#': return "oe";
+            case '*': return "ij";
+            case '^': return "th";
+            case '%': return "ss";
+            default:  return {};
+        }
+    }
+
+    auto isCombiningMark(char32_t cp) -> bool {
+        // NOLINTBEGIN
+        return (cp >= 0x0300 && cp <= 0x036F)
+            || (cp >= 0x1AB0 && cp <= 0x1AFF)
+            || (cp >= 0x1DC0 && cp <= 0x1DFF)
+            || (cp >= 0x20D0 && cp <= 0x20FF)
+            || (cp >= 0xFE20 && cp <= 0xFE2F);
+        // NOLINTEND
+    }
+
+    // returns the byte length of the sequence at `pos`, 0 if it isn't valid UTF-8
+    auto decode(std::string_view text, size_t pos, char32_t& cp) -> size_t {
+        // NOLINTBEGIN
+        const auto lead = static_cast<unsigned char>(text[pos]);
+        size_t length = 0;
+        if (lead < 0x80) {
+            cp = lead;
+            return 1;
+        } else if ((lead & 0xE0) == 0xC0) {
+            cp = lead & 0x1F;
+            length = 2;
+        } else if ((lead & 0xF0) == 0xE0) {
+            cp = lead & 0x0F;
+            length = 3;
+        } else if ((lead & 0xF8) == 0xF0) {
+            cp = lead & 0x07;
+            length = 4;
+        } else {
+            return 0;
+        }
+
+        if (pos + length > text.size()) {
+            return 0;
+        }
+        for (size_t i = 1; i < length; ++i) {
+            const auto next = static_cast<unsigned char>(text[pos + i]);
+            if ((next & 0xC0) != 0x80) {
+                return 0;
+            }
+            cp = (cp << 6) | (next & 0x3F);
+        }
+        // NOLINTEND
+        return length;
+    }
+
+    void appendUtf8(std::string& out, char32_t cp) {
+        // NOLINTBEGIN
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        // NOLINTEND
+    }
+
+    auto lowerAscii(char32_t cp) -> char {
+        return static_cast<char>(cp >= 'A' && cp <= 'Z' ? cp + ('a' - 'A') : cp);
+    }
+
+    // Writes the folded form of one code point. Returns false when there is
+    // no rule for it and the original bytes should be copied instead.
+    auto foldCodePoint(char32_t cp, std::string& out) -> bool {
+        // NOLINTBEGIN
+        if (cp < 0x80) {
+            out.push_back(lowerAscii(cp));
+            return true;
+        }
+        if (cp == 0x00A0) {
+            out.push_back(' ');
+            return true;
+        }
+        if (cp >= 0x00C0 && cp <= 0x00FF) {
+            const char c = LATIN_1[cp - 0x00C0];
+            if (c == '.') {
+                return false;
+            }
+            auto expanded = expandMarker(c);
+            out.append(expanded.empty() ? std::string_view(&c, 1) : expanded);
+            return true;
+        }
+        if (cp >= 0x0100 && cp <= 0x017F) {
+            const char c = LATIN_EXTENDED_A[cp - 0x0100];
+            auto expanded = expandMarker(c);
+            out.append(expanded.empty() ? std::string_view(&c, 1) : expanded);
+            return true;
+        }
+        if (isCombiningMark(cp)) {
+            return true;
+        }
+
+        // Greek and Cyrillic: case only, accents there carry meaning
+        if (cp >= 0x0391 && cp <= 0x03A9 && cp != 0x03A2) {
+            appendUtf8(out, cp + 0x20);
+            return true;
+        }
+        if (cp == 0x03C2) {
+            appendUtf8(out, 0x03C3);
+            return true;
+        }
+        if (cp >= 0x0410 && cp <= 0x042F) {
+            appendUtf8(out, cp + 0x20);
+            return true;
+        }
+        if (cp >= 0x0400 && cp <= 0x040F) {
+            appendUtf8(out, cp + 0x50);
+            return true;
+        }
+
+        // typographic dashes and quotes people can't type in a search box
+        if (cp >= 0x2010 && cp <= 0x2015) {
+            out.push_back('-');
+            return true;
+        }
+        if (cp == 0x2018 || cp == 0x2019) {
+            out.push_back('\'');
+            return true;
+        }
+        if (cp == 0x201C || cp == 0x201D) {
+            out.push_back('"');
+            return true;
+        }
+
+        if (cp >= 0xFF01 && cp <= 0xFF5E) {
+            out.push_back(lowerAscii(cp - 0xFEE0));
+            return true;
+        }
+        // NOLINTEND
+
+        return false;
+    }
+}
+
+namespace TextFold {
+    void appendFolded(std::string_view text, std::string& out, std::vector<uint16_t>* sourceOffsets) {
+        size_t pos = 0;
+        while (pos < text.size()) {
+            const size_t before = out.size();
+
+            char32_t cp = 0;
+            size_t length = decode(text, pos, cp);
+            if (length == 0) {
+                // stray byte; keep it so nothing silently disappears
+                out.push_back(text[pos]);
+                length = 1;
+            } else if (!foldCodePoint(cp, out)) {
+                out.append(text.substr(pos, length));
+            }
+
+            if (sourceOffsets != nullptr) {
+                const auto source = static_cast<uint16_t>(std::min<size_t>(pos, UINT16_MAX));
+                sourceOffsets->insert(sourceOffsets->end(), out.size() - before, source);
+            }
+            pos += length;
+        }
+    }
+
+    auto fold(std::string_view text) -> std::string {
+        std::string out;
+        out.reserve(text.size());
+        appendFolded(text, out);
+        return out;
+    }
+}
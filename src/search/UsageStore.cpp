@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "LogGlobal.h"
+
+#include "AtomicFile.h"
+#include "PluginCatalog.h"
+#include "UsageStore.h"
+
+UsageStore::UsageStore(std::filesystem::path path, UsageOptions options, Clock clock)
+    : path_(std::move(path))
+    , options_(options)
+    , clock_(std::move(clock))
+    , lambda_(std::log(2.0) / static_cast<double>(std::max<int64_t>(options_.halfLife.count(), 1)))
+    , slots_(INITIAL_CAPACITY)
+{
+    load();
+
+    if (epoch_ == 0) {
+        epoch_ = std::chrono::duration_cast<std::chrono::seconds>(clock_().time_since_epoch()).count();
+    }
+
+    flushThread_ = std::thread([this]() { flushLoop(); });
+}
+
+UsageStore::~UsageStore() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+
+    if (flushThread_.joinable()) {
+        flushThread_.join();
+    }
+
+    flush();
+}
+
+void UsageStore::record(std::string_view pluginName) {
+    if (pluginName.empty()) {
+        return;
+    }
+
+    const uint64_t key = hashName(pluginName);
+    {
+        std::lock_guard lock(mutex_);
+        const double contribution = lambda_ * secondsSinceEpoch();
+
+        Slot& slot = insertSlot(key);
+        if (slot.count == 0) {
+            slot.logWeight = contribution;
+        } else {
+            // log(exp(a) + exp(b)) without leaving log space
+            const double high = std::max(slot.logWeight, contribution);
+            const double low = std::min(slot.logWeight, contribution);
+            slot.logWeight = high + std::log1p(std::exp(low - high));
+        }
+        ++slot.count;
+
+        ++revision_;
+        dirty_ = true;
+    }
+    cv_.notify_one();
+}
+
+auto UsageStore::weight(std::string_view pluginName) const -> double {
+    std::lock_guard lock(mutex_);
+    const Slot* slot = findSlot(hashName(pluginName));
+    if (slot == nullptr) {
+        return 0.0;
+    }
+    return std::exp(slot->logWeight - lambda_ * secondsSinceEpoch());
+}
+
+auto UsageStore::size() const -> size_t {
+    std::lock_guard lock(mutex_);
+    return used_;
+}
+
+auto UsageStore::rankingBoosts(const PluginCatalog& catalog) -> RankingBoostsPtr {
+    std::lock_guard lock(mutex_);
+
+    if (used_ == 0) {
+        return nullptr;
+    }
+    if (boosts_ && boostsCatalogVersion_ == catalog.version() && boostsRevision_ == revision_ && boosts_->size() == catalog.size()) {
+        return boosts_;
+    }
+
+    const double now = lambda_ * secondsSinceEpoch();
+    auto boosts = std::make_shared<RankingBoosts>(catalog.size(), 0);
+
+    for (uint32_t i = 0; i < catalog.size(); ++i) {
+        const Slot* slot = findSlot(hashName(catalog.name(i)));
+        if (slot == nullptr) {
+            continue;
+        }
+        // saturates, so a plugin loaded a thousand times doesn't bury
+        // a better textual match used a dozen times
+        const double weight = std::exp(slot->logWeight - now);
+        const double boost = SearchEngine::MAX_BOOST * weight / (weight + HALF_BOOST_WEIGHT);
+        (*boosts)[i] = static_cast<uint16_t>(std::lround(boost));
+    }
+
+    boosts_ = std::move(boosts);
+    boostsCatalogVersion_ = catalog.version();
+    boostsRevision_ = revision_;
+
+    return boosts_;
+}
+
+void UsageStore::flush() {
+    std::vector<Slot> snapshot;
+    {
+        std::lock_guard lock(mutex_);
+        if (!dirty_) {
+            return;
+        }
+        snapshot = snapshotLocked();
+        dirty_ = false;
+    }
+    write(snapshot);
+}
+
+// FNV-1a; names are unique within a catalog and collisions merely share a weight
+auto UsageStore::hashName(std::string_view name) -> uint64_t {
+    // NOLINTBEGIN
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : name) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    // NOLINTEND
+    return hash == 0 ? 1 : hash;
+}
+
+auto UsageStore::secondsSinceEpoch() const -> double {
+    const auto now = std::chrono::duration_cast<std::chrono::seconds>(clock_().time_since_epoch()).count();
+    return static_cast<double>(now - epoch_);
+}
+
+auto UsageStore::findSlot(uint64_t key) const -> const Slot* {
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = key & mask; ; i = (i + 1) & mask) {
+        if (slots_[i].key == key) {
+            return &slots_[i];
+        }
+        if (slots_[i].key == 0) {
+            return nullptr;
+        }
+    }
+}
+
+auto UsageStore::insertSlot(uint64_t key) -> Slot& {
+    // keep the load factor under a half so probes stay short
+    if ((used_ + 1) * 2 > slots_.size()) {
+        grow();
+    }
+
+    const size_t mask = slots_.size() - 1;
+    size_t i = key & mask;
+    while (slots_[i].key != 0 && slots_[i].key != key) {
+        i = (i + 1) & mask;
+    }
+    if (slots_[i].key == 0) {
+        slots_[i].key = key;
+        ++used_;
+    }
+    return slots_[i];
+}
+
+void UsageStore::grow() {
+    std::vector<Slot> old(slots_.size() * 2);
+    old.swap(slots_);
+    used_ = 0;
+
+    for (const auto& slot : old) {
+        if (slot.key != 0) {
+            insertSlot(slot.key) = slot;
+        }
+    }
+}
+
+void UsageStore::load() {
+    std::error_code ec;
+    if (!std::filesystem::exists(path_, ec)) {
+        logger->info("no usage history at {}, starting fresh", path_.string());
+        return;
+    }
+
+    auto ingest = [this](const unsigned char* data, size_t size) {
+        FileHeader header{};
+        if (size < sizeof(header)) {
+            logger->warn("usage history {} is truncated, ignoring", path_.string());
+            return;
+        }
+        std::memcpy(&header, data, sizeof(header));
+
+        if (header.magic != FILE_MAGIC || header.version != FILE_VERSION
+            || header.count > (size - sizeof(header)) / sizeof(Slot))
+        {
+            logger->warn("usage history {} is not in a format we understand, ignoring", path_.string());
+            return;
+        }
+
+        epoch_ = header.epoch;
+        const unsigned char* records = data + sizeof(header);
+        for (uint64_t i = 0; i < header.count; ++i) {
+            Slot slot;
+            std::memcpy(&slot, records + i * sizeof(Slot), sizeof(Slot));
+            if (slot.key != 0 && slot.count > 0 && std::isfinite(slot.logWeight)) {
+                insertSlot(slot.key) = slot;
+            }
+        }
+        logger->info("loaded usage history for {} plugins", used_);
+    };
+
+#ifndef _WIN32
+    int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        logger->warn("unable to open usage history {}: {}", path_.string(), std::strerror(errno));
+        return;
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+        const auto size = static_cast<size_t>(info.st_size);
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            ingest(static_cast<const unsigned char*>(mapped), size);
+            ::munmap(mapped, size);
+        } else {
+            logger->warn("unable to map usage history {}: {}", path_.string(), std::strerror(errno));
+        }
+    }
+    ::close(fd);
+#else
+    std::ifstream file(path_, std::ios::binary);
+    std::vector<unsigned char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    ingest(buffer.data(), buffer.size());
+#endif
+}
+
+auto UsageStore::snapshotLocked() const -> std::vector<Slot> {
+    std::vector<Slot> snapshot;
+    snapshot.reserve(used_);
+    for (const auto& slot : slots_) {
+        if (slot.key != 0) {
+            snapshot.push_back(slot);
+        }
+    }
+    return snapshot;
+}
+
+// atomically, so a crash mid-write leaves the previous history intact
+void UsageStore::write(const std::vector<Slot>& slots) {
+    std::lock_guard lock(writeMutex_);
+
+    std::error_code ec;
+    std::filesystem::create_directories(path_.parent_path(), ec);
+
+    const FileHeader header{FILE_MAGIC, FILE_VERSION, epoch_, slots.size()};
+    ec = writeFileAtomically(path_, {
+        std::string_view(reinterpret_cast<const char*>(&header), sizeof(header)) // NOLINT
+        , std::string_view(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(Slot)) // NOLINT
+    });
+    if (ec) {
+        logger->error("unable to write usage history {}: {}", path_.string(), ec.message());
+        return;
+    }
+
+    logger->trace("wrote usage history for {} plugins", slots.size());
+}
+
+void UsageStore::flushLoop() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this]() { return stopping_ || dirty_; });
+        if (stopping_) {
+            return;
+        }
+
+        // let a burst of loads settle before touching the disk;
+        // the destructor does the final write if we're cut short
+        if (cv_.wait_for(lock, options_.flushDelay, [this]() { return stopping_; })) {
+            return;
+        }
+
+        auto snapshot = snapshotLocked();
+        dirty_ = false;
+
+        lock.unlock();
+        write(snapshot);
+        lock.lock();
+    }
+}
@@ -0,0 +1,122 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <JuceHeader.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "LatencyHistogram.h"
+#include "MatchRowRenderer.h"
+#include "MockLogHandler.h"
+#include "PluginCatalog.h"
+#include "ResultList.h"
+#include "SearchEngine.h"
+#include "fixtures/PluginFixture.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+// Paints the search box list into an offscreen image, a screenful of rows
+// per frame, the way juce::ListBox drives PluginListModel::paintListBoxItem.
+namespace {
+    // NOLINTBEGIN
+    constexpr int LIST_WIDTH   = 320;
+    constexpr int ROW_HEIGHT   = 20;
+    constexpr int VISIBLE_ROWS = 20;
+    constexpr int FRAMES       = 3000;
+    // NOLINTEND
+
+    const juce::Colour TEXT_COLOUR(0xffd0d0d0);
+    const juce::Colour SELECTED_TEXT_COLOUR(0xff101010);
+    const juce::Colour SELECTED_BACKGROUND(0xffb0ddeb);
+    const juce::Colour HIGHLIGHT_COLOUR(0xffffad56);
+
+    struct List {
+        PluginCatalogPtr catalog = fixture::syntheticCatalog(50000); // NOLINT
+        ResultList rows;
+        SearchEngine engine;
+        std::vector<SearchMatch> matches;
+        std::vector<MatchSpan> spans;
+        std::vector<uint32_t> spanOffsets;
+
+        void search(const std::string& query) {
+            engine.search(*catalog, query, {}, matches);
+            spans.clear();
+            spanOffsets.clear();
+            for (const auto& match : matches) {
+                spanOffsets.push_back(static_cast<uint32_t>(spans.size()));
+                engine.highlight(*catalog, match.index, spans);
+            }
+            spanOffsets.push_back(static_cast<uint32_t>(spans.size()));
+            rows.assign(catalog, matches, spans, spanOffsets);
+        }
+    };
+
+    template <typename PaintRow>
+    void paintFrame(juce::Graphics& g, int firstRow, int selectedRow, int rowCount, PaintRow&& paintRow) {
+        g.fillAll(juce::Colours::black);
+        for (int i = 0; i < VISIBLE_ROWS && firstRow + i < rowCount; ++i) {
+            const int row = firstRow + i;
+            juce::Graphics::ScopedSaveState state(g);
+            g.setOrigin(0, i * ROW_HEIGHT);
+            g.reduceClipRegion(0, 0, LIST_WIDTH, ROW_HEIGHT);
+
+            const bool selected = row == selectedRow;
+            g.fillAll(selected ? SELECTED_BACKGROUND : juce::Colours::transparentBlack);
+            paintRow(g, row, selected);
+        }
+    }
+
+    // scroll down by wheel-sized steps, back up over rows already seen,
+    // then hold still and move the selection like arrow keys do
+    template <typename PaintRow>
+    auto run(const char* label, int rowCount, PaintRow&& paintRow) -> std::string {
+        juce::Image image(juce::Image::ARGB, LIST_WIDTH, ROW_HEIGHT * VISIBLE_ROWS, true);
+        juce::Graphics g(image);
+        LatencyHistogram frames(label);
+
+        const int maxFirst = std::max(0, rowCount - VISIBLE_ROWS);
+        int first = 0;
+        for (int frame = 0; frame < FRAMES; ++frame) {
+            if (frame < FRAMES / 3) {
+                first = std::min(maxFirst, first + 3);
+            } else if (frame < 2 * FRAMES / 3) {
+                first = std::max(0, first - 3);
+            }
+            const int selected = first + (frame % VISIBLE_ROWS);
+
+            auto start = std::chrono::steady_clock::now();
+            paintFrame(g, first, selected, rowCount, paintRow);
+            frames.recordSince(start);
+        }
+        return frames.summary();
+    }
+}
+
+TEST_CASE("bench: scrolling a 50k result list") {
+    juce::ScopedJuceInitialiser_GUI juce;
+    List list;
+
+    for (const char* query : {"", "s", "vvv"}) {
+        list.search(query);
+        const auto rowCount = static_cast<int>(list.rows.size());
+        MESSAGE(fmt::format("query \"{}\": {} rows", query, rowCount));
+
+        // what paintListBoxItem did before: drawText, reshaping every row every frame
+        MESSAGE(run("  drawText      ", rowCount, [&](juce::Graphics& g, int row, bool selected) {
+            g.setColour(selected ? SELECTED_TEXT_COLOUR : TEXT_COLOUR);
+            g.drawText(list.rows.plugin(row)->name, 2, 0, LIST_WIDTH - 4, ROW_HEIGHT, juce::Justification::centredLeft, true);
+        }));
+
+        MatchRowRenderer renderer;
+        renderer.setRows(list.catalog->version(), 1);
+        MESSAGE(run("  cached layout ", rowCount, [&](juce::Graphics& g, int row, bool selected) {
+            const auto r = static_cast<uint32_t>(row);
+            renderer.paint(g, row, list.rows.plugin(row)->name, list.rows.spans(r)
+                , juce::Rectangle<float>(0.0f, 0.0f, LIST_WIDTH - 2.0f, static_cast<float>(ROW_HEIGHT))
+                , selected ? SELECTED_TEXT_COLOUR : TEXT_COLOUR, HIGHLIGHT_COLOUR);
+        }));
+        MESSAGE(fmt::format("  layout cache: {} hits, {} misses", renderer.cacheHits(), renderer.cacheMisses()));
+    }
+}
@@ -0,0 +1,143 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "ConfigManager.h"
+#include "KeyChord.h"
+#include "KeyMapper.h"
+#include "MockLogHandler.h"
+#include "RemapTable.h"
+#include "fixtures/RemapFixture.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // runs `body` until it has taken at least minTime and reports the mean
+    template <typename Fn>
+    auto meanMicros(Fn&& body, std::chrono::milliseconds minTime = std::chrono::milliseconds(200)) -> double { // NOLINT
+        size_t iterations = 0;
+        auto start = Clock::now();
+        auto elapsed = Clock::duration::zero();
+        do {
+            body();
+            ++iterations;
+            elapsed = Clock::now() - start;
+        } while (elapsed < minTime);
+        return std::chrono::duration<double, std::micro>(elapsed).count() / static_cast<double>(iterations);
+    }
+}
+
+TEST_CASE("bench: remap lookup per key press") {
+    for (size_t count : {50, 500}) { // NOLINT
+        const std::string path = "bench_remap_table.yaml";
+        {
+            std::ofstream out(path);
+            out << fixture::remapConfig(count);
+        }
+        ConfigManager config(path);
+
+        KeyMapper km;
+        std::vector<EKeyPress> keys;
+        std::vector<KeyChord> chords;
+        for (const auto& chord : fixture::remapChords(count)) {
+            keys.push_back(km.processKeyPress(chord));
+            chords.push_back(KeyChord::fromKeyPress(keys.back()));
+        }
+        size_t next = 0;
+        size_t found = 0;
+
+        // what handleKeyEvent used to do: copy the whole map, then find
+        double copyUs = meanMicros([&]() {
+            auto remap = config.getRemap();
+            found += remap.count(keys[next++ % keys.size()]);
+        });
+        double snapshotUs = meanMicros([&]() {
+            auto remaps = config.getRemapTable();
+            found += remaps->find(keys[next++ % keys.size()]) != nullptr ? 1 : 0;
+        });
+        // what the event handlers send now: the chord, looked up by index
+        double chordUs = meanMicros([&]() {
+            auto remaps = config.getRemapTable();
+            found += remaps->find(chords[next++ % chords.size()]) != nullptr ? 1 : 0;
+        });
+        auto remaps = config.getRemapTable();
+        double indexUs = meanMicros([&]() {
+            found += remaps->find(chords[next++ % chords.size()]) != nullptr ? 1 : 0;
+        });
+
+        MESSAGE(fmt::format("remap lookup  {:>4} remaps  copy {:>9.2f} us  snapshot+EKeyPress {:.3f} us"
+                            "  snapshot+chord {:.3f} us  chord only {:.4f} us  ({})"
+                            , count, copyUs, snapshotUs, chordUs, indexUs, found));
+        std::remove(path.c_str());
+        std::remove((path + ".cache").c_str());
+    }
+}
+
+namespace {
+    // what KeyMapper did before parseChord: build the pattern and compile
+    // the regex for every chord it was asked about
+    auto regexValid(const std::string& keypress) -> bool {
+        const std::string pattern = "^(?:(?:cmd|shift|ctrl|alt)\\+)*(?:[a-zA-Z0-9]|F[1-9]|F1[0-2]|delete|enter"
+                                    "|escape|space|tab|backspace|leftarrow|uparrow|downarrow|rightarrow)$";
+        const std::regex regex(pattern);
+        return std::regex_match(keypress, regex);
+    }
+}
+
+TEST_CASE("bench: chord parsing") {
+    const auto chords = fixture::remapChords(16 * 36); // NOLINT
+    size_t next = 0;
+    size_t valid = 0;
+
+    double regexUs = meanMicros([&]() {
+        valid += regexValid(chords[next++ % chords.size()]) ? 1 : 0;
+    });
+    double parseUs = meanMicros([&]() {
+        valid += KeyMapper::parseChord(chords[next++ % chords.size()]).ok() ? 1 : 0;
+    });
+    KeyMapper km;
+    double processUs = meanMicros([&]() {
+        valid += km.processKeyPress(chords[next++ % chords.size()]).cmd ? 1 : 0;
+    });
+
+    MESSAGE(fmt::format("chord parse  regex {:.3f} us  parseChord {:.4f} us  processKeyPress {:.3f} us  ({})"
+                        , regexUs, parseUs, processUs, valid));
+}
+
+TEST_CASE("bench: config load, cold parse vs cache") {
+    for (size_t count : {500, 5000}) { // NOLINT
+        const std::string path = "bench_remap_load.yaml";
+        const std::string cache = path + ".cache";
+        {
+            std::ofstream out(path);
+            out << fixture::remapConfig(count);
+        }
+
+        size_t remaps = 0;
+        // no cache: parse the YAML, then write the cache
+        double coldUs = meanMicros([&]() {
+            std::remove(cache.c_str());
+            ConfigManager config(path);
+            remaps += config.getRemapTable()->size();
+        }, std::chrono::milliseconds(1000)); // NOLINT
+
+        // the file hasn't changed since the last run: map the cache in
+        double cachedUs = meanMicros([&]() {
+            ConfigManager config(path);
+            remaps += config.getRemapTable()->size();
+        }, std::chrono::milliseconds(1000)); // NOLINT
+
+        MESSAGE(fmt::format("config load  {:>4} remaps  cold parse {:>9.1f} us  cache hit {:>9.1f} us  ({:.1f}x)  ({})"
+                            , count, coldUs, cachedUs, coldUs / cachedUs, remaps));
+        std::remove(path.c_str());
+        std::remove(cache.c_str());
+    }
+}
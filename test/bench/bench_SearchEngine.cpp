@@ -0,0 +1,190 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "CommandIndex.h"
+#include "EditDistance.h"
+#include "MockLogHandler.h"
+#include "PluginCatalog.h"
+#include "SearchEngine.h"
+#include "fixtures/PluginFixture.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // runs `body` until it has taken at least minTime and reports the mean
+    template <typename Fn>
+    auto meanMicros(Fn&& body, std::chrono::milliseconds minTime = std::chrono::milliseconds(200)) -> double { // NOLINT
+        size_t iterations = 0;
+        auto start = Clock::now();
+        auto elapsed = Clock::duration::zero();
+        do {
+            body();
+            ++iterations;
+            elapsed = Clock::now() - start;
+        } while (elapsed < minTime);
+        return std::chrono::duration<double, std::micro>(elapsed).count() / static_cast<double>(iterations);
+    }
+}
+
+TEST_CASE("bench: per-keystroke query cost, 50k entries") {
+    auto catalog = fixture::syntheticCatalog(50000); // NOLINT
+    SearchEngine engine;
+    std::vector<SearchMatch> matches;
+    matches.reserve(catalog->size());
+
+    for (const char* query : {"s", "se", "ser", "seru", "serum", "pro-q", "vvv"}) {
+        double us = meanMicros([&]() { engine.search(*catalog, query, {}, matches); });
+        MESSAGE(fmt::format("exact/fuzzy  {:>8} -> {:>6} matches  {:>9.1f} us", query, matches.size(), us));
+    }
+}
+
+TEST_CASE("bench: approximate tier, 50k entries") {
+    auto catalog = fixture::syntheticCatalog(50000); // NOLINT
+    SearchEngine engine;
+    std::vector<SearchMatch> matches;
+    matches.reserve(catalog->size());
+
+    // typos and misses; the ones that fall under the threshold pay for a Myers pass
+    for (const char* query : {"sreum", "valhala", "decapitatr", "valhala shimer", "qzxwv"}) {
+        double us = meanMicros([&]() { engine.search(*catalog, query, {}, matches); });
+        MESSAGE(fmt::format("approximate  {:>14} -> {:>6} matches  {:>9.1f} us", query, matches.size(), us));
+    }
+}
+
+TEST_CASE("bench: field predicates, 50k entries") {
+    auto catalog = fixture::syntheticCatalog(50000); // NOLINT
+    SearchEngine engine;
+    std::vector<SearchMatch> matches;
+    matches.reserve(catalog->size());
+
+    // the same text with and without a filter; filtered entries are never scored
+    for (const char* query : {"comp", "fmt:vst3 comp", "fmt:vst2 comp", "fmt:au", "vendor:fabfilter pro", "vendor:waves fmt:vst3 c"}) {
+        double us = meanMicros([&]() { engine.search(*catalog, query, {}, matches); });
+        MESSAGE(fmt::format("fields  {:>24} -> {:>6} matches  {:>9.1f} us", query, matches.size(), us));
+    }
+}
+
+TEST_CASE("bench: Myers prefix distance per candidate") {
+    BoundedEditMatcher matcher("valhala");
+    const std::vector<std::string> words = {"valhalla", "vintageverb", "serum", "shimmer", "decapitator", "kontakt"};
+    volatile uint32_t sink = 0;
+
+    double us = meanMicros([&]() {
+        for (int i = 0; i < 1000; ++i) { // NOLINT
+            for (const auto& word : words) {
+                sink = sink + matcher.prefixDistance(word, 2);
+            }
+        }
+    });
+    MESSAGE(fmt::format("prefixDistance  {:.1f} ns/candidate", us * 1000.0 / (1000.0 * static_cast<double>(words.size())))); // NOLINT
+}
+
+TEST_CASE("bench: usage boosts, 50k entries") {
+    auto catalog = fixture::syntheticCatalog(50000); // NOLINT
+    SearchEngine engine;
+    std::vector<SearchMatch> matches;
+    matches.reserve(catalog->size());
+
+    // a heavy user: a few hundred distinct plugins with history
+    std::vector<uint16_t> boosts(catalog->size(), 0);
+    for (uint32_t i = 0; i < catalog->size(); i += 97) { // NOLINT
+        boosts[i] = static_cast<uint16_t>(i % SearchEngine::MAX_BOOST);
+    }
+
+    for (const char* query : {"", "s", "ser", "serum", "sreum"}) {
+        double plain = meanMicros([&]() { engine.search(*catalog, query, {}, matches); });
+        double boosted = meanMicros([&]() { engine.search(*catalog, query, {}, matches, boosts); });
+        MESSAGE(fmt::format("boosts  {:>8} plain {:>9.1f} us  boosted {:>9.1f} us  ({:+.1f}%)"
+            , std::string("\"") + query + "\"", plain, boosted, (boosted - plain) * 100.0 / plain)); // NOLINT
+    }
+}
+
+TEST_CASE("bench: catalog build with folded keys, 50k entries") {
+    auto plugins = fixture::syntheticPlugins(50000); // NOLINT
+    size_t keyBytes = 0;
+
+    double us = meanMicros([&]() {
+        PluginCatalog catalog(plugins, 1);
+        keyBytes = 0;
+        for (uint32_t i = 0; i < catalog.size(); ++i) {
+            keyBytes += catalog.searchKey(i).size();
+        }
+    });
+    MESSAGE(fmt::format("catalog build  {:.1f} ms for {} key bytes (plugin vector copy included)", us / 1000.0, keyBytes)); // NOLINT
+}
+
+TEST_CASE("bench: command index update, 50k plugins") {
+    auto plugins = fixture::syntheticCatalog(50000); // NOLINT
+
+    // a menu the size of a big LES config, plus the named actions
+    std::vector<MenuItem> menu(1, MenuItem{"Plugins", "category", {}});
+    for (uint32_t i = 0; i < 500; ++i) { // NOLINT
+        menu[0].children.push_back({fmt::format("Alias {}", i), plugins->plugin(i).name, {}});
+    }
+    const std::vector<std::string> actions = {"closeAllPlugins", "closeFocusedPlugin", "openAllPlugins", "tilePluginWindows"};
+
+    CommandIndex index;
+    index.setPlugins(plugins);
+    index.setActions(actions);
+
+    // a menu change reuses the folded plugin keys instead of rebuilding them
+    double us = meanMicros([&]() { index.setMenu(menu); });
+    MESSAGE(fmt::format("command index  menu update {:.1f} ms for {} entries", us / 1000.0, index.snapshot()->size())); // NOLINT
+}
+
+TEST_CASE("bench: load by name, 50k entries") {
+    auto catalog = fixture::syntheticCatalog(50000); // NOLINT
+
+    // a spread of names, so nothing about one lookup can be reused for the next
+    std::vector<std::string> names;
+    std::vector<std::string> qualified;
+    for (uint32_t i = catalog->size() - 1; names.size() < 32; i -= 997) { // NOLINT
+        names.push_back(catalog->plugin(i).name);
+        qualified.push_back(names.back() + " VST3");
+    }
+    size_t next = 0;
+    uint64_t found = 0;
+
+    // what loadItemByName used to do: an exact compare against every plugin
+    double scanUs = meanMicros([&]() {
+        const std::string& name = names[next++ % names.size()];
+        for (const auto& plugin : catalog->plugins()) {
+            if (plugin.name == name) {
+                found += static_cast<uint64_t>(plugin.number);
+                break;
+            }
+        }
+    });
+    double hashUs = meanMicros([&]() { found += catalog->findPlugin(names[next++ % names.size()]).index; });
+    double qualifiedUs = meanMicros([&]() { found += catalog->findPlugin(qualified[next++ % qualified.size()]).index; });
+    double missUs = meanMicros([&]() { found += catalog->findPlugin("not installed anywhere").index; });
+
+    MESSAGE(fmt::format("load by name  scan {:.2f} us, hash {:.3f} us, qualified {:.3f} us, miss {:.3f} us ({})"
+                        , scanUs, hashUs, qualifiedUs, missUs, found));
+}
+
+TEST_CASE("bench: highlight spans for every match, 50k entries") {
+    auto catalog = fixture::syntheticCatalog(50000); // NOLINT
+    SearchEngine engine;
+    std::vector<SearchMatch> matches;
+    std::vector<MatchSpan> spans;
+    matches.reserve(catalog->size());
+    spans.reserve(catalog->size());
+
+    for (const char* query : {"s", "ser", "serum", "vvv"}) {
+        engine.search(*catalog, query, {}, matches);
+        double us = meanMicros([&]() {
+            spans.clear();
+            for (const auto& match : matches) {
+                engine.highlight(*catalog, match.index, spans);
+            }
+        });
+        MESSAGE(fmt::format("highlight  {:>6} -> {:>6} matches {:>7} spans  {:>9.1f} us", query, matches.size(), spans.size(), us));
+    }
+}
@@ -0,0 +1,46 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "AtomicFile.h"
+#include "MockLogHandler.h"
+#include "fixtures/TempDir.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+TEST_CASE("writeFileAtomically replaces the file with its chunks") {
+    fixture::TempDir dir("atomic");
+    const auto path = dir.path / "config.yaml";
+    std::ofstream(path) << "old";
+
+    CHECK_FALSE(writeFileAtomically(path, {"remap:\n", "", "  cmd+k: searchbox\n"}));
+    CHECK(fixture::readAll(path) == "remap:\n  cmd+k: searchbox\n");
+    CHECK_FALSE(std::filesystem::exists(dir.path / "config.yaml.tmp"));
+
+    CHECK_FALSE(writeFileAtomically(dir.path / "new.bin", {}));
+    CHECK(std::filesystem::file_size(dir.path / "new.bin") == 0);
+}
+
+TEST_CASE("writeFileAtomically writes through a symlink") {
+    fixture::TempDir dir("atomic_link");
+    const auto target = dir.path / "dotfiles" / "config.yaml";
+    const auto link = dir.path / "config.yaml";
+    std::filesystem::create_directories(target.parent_path());
+    std::ofstream(target) << "old";
+    std::filesystem::create_symlink(target, link);
+
+    CHECK_FALSE(writeFileAtomically(link, {"new"}));
+    CHECK(std::filesystem::is_symlink(link));
+    CHECK(fixture::readAll(target) == "new");
+    CHECK(fixture::readAll(link) == "new");
+}
+
+TEST_CASE("writeFileAtomically reports what went wrong") {
+    fixture::TempDir dir("atomic_fail");
+    auto ec = writeFileAtomically(dir.path / "missing" / "config.yaml", {"x"});
+    CHECK(ec);
+    CHECK_FALSE(std::filesystem::exists(dir.path / "missing"));
+}
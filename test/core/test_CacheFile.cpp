@@ -0,0 +1,150 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "CacheFile.h"
+#include "MockLogHandler.h"
+#include "fixtures/TempDir.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    // what read() handed over, or "" on a miss
+    auto readPayload(const std::filesystem::path& path, CacheFile::Kind kind, uint64_t* sourceHash = nullptr) -> std::string {
+        std::string payload;
+        CacheFile::read(path, kind, [&](uint64_t hash, std::string_view bytes) {
+            if (sourceHash != nullptr) {
+                *sourceHash = hash;
+            }
+            payload = bytes;
+            return true;
+        });
+        return payload;
+    }
+}
+
+TEST_CASE("CacheFile - hash") {
+    CHECK(CacheFile::hash("") == CacheFile::hash(""));
+    CHECK(CacheFile::hash("remap: {}") == CacheFile::hash("remap: {}"));
+    CHECK(CacheFile::hash("remap: {}") != CacheFile::hash("remap: {} "));
+    CHECK(CacheFile::hash("ab") != CacheFile::hash("ba"));
+}
+
+TEST_CASE("CacheFile - write and read") {
+    fixture::TempDir dir("cache");
+    const auto path = dir.path / "config.yaml.cache";
+
+    SUBCASE("round trips the payload and hash") {
+        const std::string payload("compiled\0bytes", 14); // NOLINT
+        REQUIRE(CacheFile::write(path, CacheFile::ConfigKind, 42, payload)); // NOLINT
+        CHECK_FALSE(std::filesystem::exists(dir.path / "config.yaml.cache.tmp"));
+
+        uint64_t hash = 0;
+        CHECK(readPayload(path, CacheFile::ConfigKind, &hash) == payload);
+        CHECK(hash == 42); // NOLINT
+    }
+
+    SUBCASE("an empty payload is still a hit") {
+        REQUIRE(CacheFile::write(path, CacheFile::MenuKind, 1, ""));
+        CHECK(CacheFile::read(path, CacheFile::MenuKind, [](uint64_t, std::string_view bytes) { return bytes.empty(); }));
+    }
+
+    SUBCASE("a missing file is a miss") {
+        CHECK_FALSE(CacheFile::read(path, CacheFile::ConfigKind, [](uint64_t, std::string_view) { return true; }));
+    }
+
+    SUBCASE("another kind of cache is a miss") {
+        REQUIRE(CacheFile::write(path, CacheFile::MenuKind, 1, "menu"));
+        CHECK_FALSE(CacheFile::read(path, CacheFile::ConfigKind, [](uint64_t, std::string_view) { return true; }));
+    }
+
+    SUBCASE("a truncated or extended file is a miss") {
+        REQUIRE(CacheFile::write(path, CacheFile::ConfigKind, 1, "payload"));
+        const std::string bytes = fixture::readAll(path);
+
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes.substr(0, bytes.size() - 1);
+        CHECK(readPayload(path, CacheFile::ConfigKind).empty());
+
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes << "x";
+        CHECK(readPayload(path, CacheFile::ConfigKind).empty());
+
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a cache";
+        CHECK(readPayload(path, CacheFile::ConfigKind).empty());
+    }
+
+    SUBCASE("the ingest result is the result") {
+        REQUIRE(CacheFile::write(path, CacheFile::ConfigKind, 1, "payload"));
+        CHECK_FALSE(CacheFile::read(path, CacheFile::ConfigKind, [](uint64_t, std::string_view) { return false; }));
+    }
+
+    SUBCASE("a rewrite replaces the old cache") {
+        REQUIRE(CacheFile::write(path, CacheFile::ConfigKind, 1, "a long first payload"));
+        REQUIRE(CacheFile::write(path, CacheFile::ConfigKind, 2, "short"));
+        uint64_t hash = 0;
+        CHECK(readPayload(path, CacheFile::ConfigKind, &hash) == "short");
+        CHECK(hash == 2);
+    }
+}
+
+TEST_CASE("CacheFile - writer and reader") {
+    CacheWriter out;
+    out.u8(7); // NOLINT
+    out.u16(0xBEEF); // NOLINT
+    out.u32(123456); // NOLINT
+    out.i32(-5); // NOLINT
+    out.str("plugin.Serum");
+    out.str("");
+
+    SUBCASE("reads back what was written") {
+        CacheReader in(out.bytes());
+        CHECK(in.u8() == 7);
+        CHECK(in.u16() == 0xBEEF);
+        CHECK(in.u32() == 123456);
+        CHECK(in.i32() == -5);
+        CHECK(in.str() == "plugin.Serum");
+        CHECK(in.str().empty());
+        CHECK(in.ok());
+    }
+
+    SUBCASE("leftover bytes aren't ok") {
+        CacheReader in(out.bytes());
+        in.u8();
+        CHECK_FALSE(in.ok());
+    }
+
+    SUBCASE("reading past the end isn't ok, and reads nothing after") {
+        CacheReader in(std::string_view(out.bytes()).substr(0, 9)); // NOLINT
+        CHECK(in.u8() == 7);
+        CHECK(in.u16() == 0xBEEF);
+        CHECK(in.u32() == 123456);
+        CHECK(in.i32() == 0);
+        CHECK(in.str().empty());
+        CHECK_FALSE(in.ok());
+    }
+
+    SUBCASE("a length longer than what's left isn't ok") {
+        CacheWriter lying;
+        lying.u32(1000); // NOLINT
+        lying.u8('x');
+        CacheReader in(lying.bytes());
+        CHECK(in.str().empty());
+        CHECK_FALSE(in.ok());
+    }
+
+    SUBCASE("a count that can't fit isn't ok") {
+        CacheWriter lying;
+        lying.u32(0xFFFFFFFF); // NOLINT
+        lying.u32(0);
+        CacheReader in(lying.bytes());
+        CHECK(in.count(4) == 0);
+        CHECK_FALSE(in.ok());
+
+        CacheReader fits(lying.bytes());
+        fits.u32();
+        CHECK(fits.count(4) == 0);
+        CHECK(fits.ok());
+    }
+}
@@ -2,12 +2,20 @@
 #define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
 #include "doctest/doctest.h"
 #include "ConfigManager.h"
+#include "KeyMapper.h"
+#include "MacroProgram.h"
 #include "DependencyContainer.h"
 #include "MockLogHandler.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
 #include <fstream>
 #include <optional>
 #include <iostream>
+#include <iterator>
+#include <thread>
 
 DependencyContainer& container = DependencyContainer::getInstance();
 std::shared_ptr<ILogger> logger = nullptr;
@@ -48,9 +56,11 @@ std::string createTempConfigFile(const std::string& content) {
     return tempFileName;
 }
 
-// Helper function to delete the temporary config file
+// Helper function to delete the temporary config file, and the cache
+// loading it leaves, which a later case reusing the name would pick up
 void deleteTempConfigFile(const std::string &filename) {
     std::remove(filename.c_str());
+    std::remove((filename + ".cache").c_str());
 }
 
 // Custom comparison function for std::optional
@@ -108,6 +118,10 @@ remap:
 rename-plugins:
   Serum: Daddy Duda's Special Synth
 
+plugin-aliases:
+  eq: Pro-Q 3
+  verb: Valhalla VintageVerb AU
+
 remove-plugins:
   - TerribleSynth
   - I'mTooLazyToUninstallSynth
@@ -160,6 +174,19 @@ window:
 
         CHECK_MESSAGE(remap.find(actionKPFrom) != remap.end(), "Remap should contain 'alt+a' key");
         CHECK_MESSAGE(remap[actionKPFrom] == actionMacro, "Remap 'alt+a' should map to plugin.Serum action");
+
+        auto remaps = configManager->getRemapTable();
+        CHECK(remaps->size() == remap.size());
+        const auto* program = remaps->find(actionKPFrom);
+        REQUIRE(program != nullptr);
+        REQUIRE(program->code().size() == 1);
+        CHECK(program->code()[0].op == MacroOp::Invoke);
+        CHECK(static_cast<ActionId>(program->code()[0].operand) == ActionId::plugin);
+        CHECK(program->arguments()[program->code()[0].arg] == "Serum");
+
+        EKeyPress unmapped;
+        unmapped.key = "z";
+        CHECK(remaps->find(unmapped) == nullptr);
     }
 
     SUBCASE("Check rename plugins") {
@@ -168,6 +195,13 @@ window:
         CHECK_MESSAGE(renamePlugins["Serum"] == "Daddy Duda's Special Synth", "Serum should be renamed to 'Daddy Duda's Special Synth'");
     }
 
+    SUBCASE("Check plugin aliases") {
+        auto aliases = configManager->getPluginAliases();
+        REQUIRE_MESSAGE(aliases.size() == 2, "Plugin aliases should contain 2 items");
+        CHECK_MESSAGE(aliases["eq"] == "Pro-Q 3", "eq should be an alias for 'Pro-Q 3'");
+        CHECK_MESSAGE(aliases["verb"] == "Valhalla VintageVerb AU", "verb should keep its format suffix");
+    }
+
     SUBCASE("Check remove plugins") {
         auto removePlugins = configManager->getRemovePlugins();
         CHECK_MESSAGE(!removePlugins.empty(), "Remove plugins should not be empty");
@@ -197,7 +231,7 @@ window:
     //CHECK(messages[0].first == "INFO");
     //CHECK(messages[0].second.find("Config loaded successfully") != std::string::npos);
 
-    std::remove(configFile.c_str());
+    deleteTempConfigFile(configFile);
 }
 
 TEST_CASE("ConfigManager - Undo") {
@@ -245,10 +279,620 @@ window:
 
     configManager->undo();
     CHECK_MESSAGE(configManager->getInitRetries() == 3, "retries after undo is 3");
+    configManager->flush();
 
     auto newManager = std::make_shared<ConfigManager>(configFile);
     newManager->loadConfig();
     CHECK(newManager->getInitRetries() == 3);
 
-    std::remove(configFile.c_str());
+    deleteTempConfigFile(configFile);
+}
+
+TEST_CASE("ConfigManager - Reload") {
+    std::string configFile = "test_reload_config.yaml";
+    auto write = [&](const std::string& content) {
+        std::ofstream outFile(configFile, std::ios::trunc);
+        outFile << content;
+    };
+
+    write(R"(
+remap:
+  ctrl+d: cmd+a
+  cmd+b: cmd+d, cmd+d
+  alt+a: plugin.Serum
+
+plugin-aliases:
+  eq: Pro-Q 3
+
+init:
+  retries: 3
+)");
+
+    auto configManager = std::make_shared<ConfigManager>(configFile);
+    auto before = configManager->getRemapTable();
+
+    EKeyPress ctrlD;
+    ctrlD.ctrl = true;
+    ctrlD.key = "d";
+    EKeyPress cmdB;
+    cmdB.cmd = true;
+    cmdB.key = "b";
+    EKeyPress altA;
+    altA.alt = true;
+    altA.key = "a";
+
+    std::vector<ConfigChanges> seen;
+    configManager->onChanged([&](const ConfigChanges& changes) { seen.push_back(changes); });
+
+    SUBCASE("only what changed is replaced") {
+        write(R"(
+remap:
+  ctrl+d: cmd+a
+  cmd+b: cmd+d, cmd+d, cmd+d
+  shift+f1: searchbox
+
+plugin-aliases:
+  eq: Pro-Q 3
+
+init:
+  retries: 3
+)");
+        REQUIRE(configManager->reload());
+        REQUIRE(seen.size() == 1);
+        CHECK(seen[0].remapsChanged == 2);
+        CHECK(seen[0].remapsRemoved == 1);
+        CHECK_FALSE(seen[0].init);
+        CHECK_FALSE(seen[0].pluginAliases);
+
+        auto after = configManager->getRemapTable();
+        CHECK(after != before);
+        CHECK(after->size() == 3);
+        CHECK(after->find(altA) == nullptr);
+        CHECK(after->find(cmdB)->code().size() == 6);
+        // unchanged remaps keep the program they were compiled to
+        CHECK(after->find(ctrlD) == before->find(ctrlD));
+
+        // and the table in use before the reload still works
+        CHECK(before->find(altA) != nullptr);
+        CHECK(before->find(cmdB)->code().size() == 4);
+    }
+
+    SUBCASE("a reload with nothing new is a no-op") {
+        REQUIRE(configManager->reload());
+        CHECK(seen.empty());
+        CHECK(configManager->getRemapTable() == before);
+    }
+
+    SUBCASE("other sections") {
+        write(R"(
+remap:
+  ctrl+d: cmd+a
+  cmd+b: cmd+d, cmd+d
+  alt+a: plugin.Serum
+
+plugin-aliases:
+  eq: FabFilter Pro-Q 3
+
+init:
+  retries: 7
+)");
+        REQUIRE(configManager->reload());
+        REQUIRE(seen.size() == 1);
+        CHECK(seen[0].pluginAliases);
+        CHECK(seen[0].init);
+        CHECK(seen[0].remapsChanged == 0);
+        CHECK(configManager->getPluginAliases().at("eq") == "FabFilter Pro-Q 3");
+        CHECK(configManager->getInitRetries() == 7);
+        CHECK(configManager->getRemapTable() == before);
+    }
+
+    SUBCASE("a broken file keeps the last good config") {
+        write("remap:\n  ctrl+d: [cmd+a\ninit: {retries: 9\n");
+        CHECK_FALSE(configManager->reload());
+        CHECK(configManager->lastError().find("line") != std::string::npos);
+        CHECK(seen.empty());
+        CHECK(configManager->getInitRetries() == 3);
+        CHECK(configManager->getRemapTable() == before);
+
+        write("remap:\n  ctrl+d:\n    nested: map\n");
+        CHECK_FALSE(configManager->reload());
+        CHECK(configManager->getRemapTable() == before);
+
+        std::remove(configFile.c_str());
+        CHECK_FALSE(configManager->reload());
+        CHECK(configManager->getRemapTable()->size() == 3);
+    }
+
+    SUBCASE("saving round trips") {
+        configManager->setRemap("cmd+shift+z", "searchbox");
+        auto saved = configManager->getRemapTable();
+
+        // the file is behind until the save lands; it mustn't win
+        REQUIRE(configManager->reload());
+        CHECK(configManager->getRemapTable() == saved);
+
+        configManager->flush();
+        REQUIRE(configManager->reload());
+        CHECK(seen.empty());
+        CHECK(configManager->getRemapTable() == saved);
+        CHECK(configManager->lastError().empty());
+
+        auto fresh = std::make_shared<ConfigManager>(configFile);
+        CHECK(fresh->getRemap() == configManager->getRemap());
+    }
+
+    deleteTempConfigFile(configFile);
+}
+
+TEST_CASE("ConfigManager - Watch") {
+    using namespace std::chrono_literals;
+    std::string configFile = "test_watch_config.yaml";
+    {
+        std::ofstream outFile(configFile);
+        outFile << "remap:\n  ctrl+d: cmd+a\n";
+    }
+
+    auto configManager = std::make_shared<ConfigManager>(configFile);
+    std::atomic<int> reloads = 0;
+    configManager->onChanged([&](const ConfigChanges&) { ++reloads; });
+
+    FileWatchOptions options;
+    options.debounce = 40ms; // NOLINT
+    options.pollInterval = 50ms; // NOLINT
+    configManager->watch(options);
+
+    std::this_thread::sleep_for(20ms);
+    {
+        std::ofstream outFile(configFile, std::ios::trunc);
+        outFile << "remap:\n  ctrl+d: cmd+a\n  ctrl+e: cmd+e\n";
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (reloads.load() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(5ms);
+    }
+    CHECK(reloads.load() == 1);
+    CHECK(configManager->getRemapTable()->size() == 2);
+
+    configManager.reset();
+    deleteTempConfigFile(configFile);
+}
+
+TEST_CASE("ConfigManager - Save") {
+    using namespace std::chrono_literals;
+    std::string configFile = "test_save_config.yaml";
+    const std::string original = "remap:\n  ctrl+d: cmd+a\ninit:\n  retries: 3\n";
+    auto contents = [&]() {
+        std::ifstream in(configFile);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    };
+    {
+        std::ofstream outFile(configFile);
+        outFile << original;
+    }
+
+    SUBCASE("setters return before the write and share one") {
+        ConfigOptions options;
+        options.saveDelay = 10s; // NOLINT
+        auto configManager = std::make_shared<ConfigManager>(configFile, options);
+
+        configManager->setInitRetries(4);
+        configManager->setPluginAlias("eq", "Pro-Q 3");
+        configManager->setRemap("cmd+e", "searchbox");
+        CHECK(contents() == original);
+
+        configManager->flush();
+        auto reloaded = std::make_shared<ConfigManager>(configFile);
+        CHECK(reloaded->getInitRetries() == 4);
+        CHECK(reloaded->getPluginAliases().at("eq") == "Pro-Q 3");
+        CHECK(reloaded->getRemap().size() == 2);
+        CHECK_FALSE(std::filesystem::exists(configFile + ".tmp"));
+    }
+
+    SUBCASE("the background thread writes after the delay") {
+        ConfigOptions options;
+        options.saveDelay = 20ms; // NOLINT
+        auto configManager = std::make_shared<ConfigManager>(configFile, options);
+        configManager->setInitRetries(6);
+
+        auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (contents() == original && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(5ms);
+        }
+        CHECK(contents() != original);
+
+        // the cache is written just after the file; let that land too
+        configManager.reset();
+        CHECK(std::make_shared<ConfigManager>(configFile)->getInitRetries() == 6);
+    }
+
+    SUBCASE("a pending save is written on destruction") {
+        ConfigOptions options;
+        options.saveDelay = 10s; // NOLINT
+        auto configManager = std::make_shared<ConfigManager>(configFile, options);
+        configManager->setInitRetries(8);
+        configManager.reset();
+        CHECK(std::make_shared<ConfigManager>(configFile)->getInitRetries() == 8);
+    }
+
+
+    deleteTempConfigFile(configFile);
+}
+
+TEST_CASE("ConfigManager - Undo and redo") {
+    std::string configFile = "test_undo_config.yaml";
+    {
+        std::ofstream outFile(configFile);
+        outFile << "remap:\n  ctrl+d: cmd+a\nplugin-aliases:\n  eq: Pro-Q 3\ninit:\n  retries: 3\n";
+    }
+
+    EKeyPress ctrlD;
+    ctrlD.ctrl = true;
+    ctrlD.key = "d";
+    EKeyPress cmdE;
+    cmdE.cmd = true;
+    cmdE.key = "e";
+
+    auto configManager = std::make_shared<ConfigManager>(configFile);
+    const auto loaded = configManager->getRemap();
+
+    configManager->setInitRetries(4);
+    configManager->setRemap("ctrl+d", "searchbox");
+    configManager->setRemap("cmd+e", "tilePluginWindows");
+    configManager->setPluginAlias("eq", "FabFilter Pro-Q 3");
+    configManager->setPluginAlias("verb", "ValhallaRoom");
+    configManager->setRemovePlugin("TerribleSynth");
+    const auto edited = configManager->getRemap();
+
+    for (int i = 0; i < 6; ++i) { // NOLINT
+        REQUIRE(configManager->canUndo());
+        configManager->undo();
+    }
+    CHECK_FALSE(configManager->canUndo());
+    CHECK(configManager->getInitRetries() == 3);
+    CHECK(configManager->getRemap() == loaded);
+    CHECK(configManager->getRemapTable()->find(cmdE) == nullptr);
+    CHECK(configManager->getRemapTable()->find(ctrlD) != nullptr);
+    CHECK(configManager->getPluginAliases().size() == 1);
+    CHECK(configManager->getPluginAliases().at("eq") == "Pro-Q 3");
+    CHECK(configManager->getRemovePlugins().empty());
+
+    for (int i = 0; i < 6; ++i) { // NOLINT
+        REQUIRE(configManager->canRedo());
+        configManager->redo();
+    }
+    CHECK_FALSE(configManager->canRedo());
+    CHECK(configManager->getInitRetries() == 4);
+    CHECK(configManager->getRemap() == edited);
+    CHECK(configManager->getRemapTable()->find(cmdE) != nullptr);
+    CHECK(configManager->getPluginAliases().at("verb") == "ValhallaRoom");
+    CHECK(configManager->getRemovePlugins() == std::vector<std::string>{"TerribleSynth"});
+
+    SUBCASE("a new change drops the redo side") {
+        configManager->undo();
+        configManager->setInitRetries(9);
+        CHECK_FALSE(configManager->canRedo());
+    }
+
+    configManager.reset();
+    deleteTempConfigFile(configFile);
+}
+
+TEST_CASE("ConfigManager - Undo history is bounded") {
+    std::string configFile = "test_undo_bounded_config.yaml";
+    {
+        std::ofstream outFile(configFile);
+        outFile << "init:\n  retries: 0\n";
+    }
+
+    ConfigOptions options;
+    options.undoDepth = 5; // NOLINT
+    auto configManager = std::make_shared<ConfigManager>(configFile, options);
+    for (int i = 1; i <= 50; ++i) { // NOLINT
+        configManager->setInitRetries(i);
+    }
+
+    int undone = 0;
+    while (configManager->canUndo()) {
+        configManager->undo();
+        ++undone;
+    }
+    CHECK(undone == 5);
+    CHECK(configManager->getInitRetries() == 45);
+
+    configManager.reset();
+    deleteTempConfigFile(configFile);
+}
+
+TEST_CASE("ConfigManager - Cache") {
+    using namespace std::chrono_literals;
+    std::string configFile = "test_cache_config.yaml";
+    const std::string cacheFile = configFile + ".cache";
+    auto write = [&](const std::string& content) {
+        std::ofstream outFile(configFile, std::ios::trunc);
+        outFile << content;
+    };
+    auto log = std::dynamic_pointer_cast<MockLogHandler>(logger);
+    REQUIRE(log);
+    auto logged = [&](const std::string& text) {
+        auto messages = log->getMessages();
+        return std::any_of(messages.begin(), messages.end(), [&](const auto& m) {
+            return m.second.find(text) != std::string::npos;
+        });
+    };
+
+    write(R"(
+remap:
+  ctrl+d: cmd+a, plugin.Serum, delay.50
+  cmd+shift+f1: searchbox
+  d: delete
+rename-plugins:
+  Serum: Daddy Duda's Special Synth
+plugin-aliases:
+  eq: Pro-Q 3
+remove-plugins:
+  - TerribleSynth
+window:
+  search: 100,200,500,500
+shortcuts:
+  - key: /location/1
+init:
+  retries: 7
+)");
+    auto parsed = std::make_shared<ConfigManager>(configFile);
+    REQUIRE(std::filesystem::exists(cacheFile));
+
+    SUBCASE("an unchanged file loads from the cache") {
+        log->clear();
+        auto cached = std::make_shared<ConfigManager>(configFile);
+        CHECK(logged("Config loaded from cache"));
+
+        CHECK(cached->getInitRetries() == 7);
+        CHECK(cached->getRemap() == parsed->getRemap());
+        CHECK(cached->getRemapTable()->size() == 3);
+        CHECK(cached->getRenamePlugins() == parsed->getRenamePlugins());
+        CHECK(cached->getPluginAliases() == parsed->getPluginAliases());
+        CHECK(cached->getRemovePlugins() == parsed->getRemovePlugins());
+        CHECK(cached->getWindowSettings() == parsed->getWindowSettings());
+        CHECK(cached->getShortcuts() == parsed->getShortcuts());
+    }
+
+    SUBCASE("an edited file is served from the old cache, then reparsed") {
+        write("remap:\n  ctrl+d: cmd+b\ninit:\n  retries: 8\n");
+        log->clear();
+        auto configManager = std::make_shared<ConfigManager>(configFile);
+        CHECK(logged("reparsing in the background"));
+
+        auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (configManager->getInitRetries() != 8 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(5ms);
+        }
+        CHECK(configManager->getInitRetries() == 8);
+        CHECK(configManager->getRemapTable()->size() == 1);
+
+        // the reparse refreshed the cache
+        configManager.reset();
+        log->clear();
+        auto next = std::make_shared<ConfigManager>(configFile);
+        CHECK(logged("Config loaded from cache"));
+        CHECK(next->getInitRetries() == 8);
+    }
+
+    SUBCASE("a damaged cache is parsed past and replaced") {
+        {
+            std::ofstream out(cacheFile, std::ios::binary | std::ios::trunc);
+            out << "LIMC but not really";
+        }
+        log->clear();
+        auto configManager = std::make_shared<ConfigManager>(configFile);
+        CHECK_FALSE(logged("cache"));
+        CHECK(configManager->getRemap() == parsed->getRemap());
+
+        log->clear();
+        auto next = std::make_shared<ConfigManager>(configFile);
+        CHECK(logged("Config loaded from cache"));
+    }
+
+    SUBCASE("saving refreshes the cache") {
+        parsed->setRemap("cmd+e", "searchbox");
+        parsed->flush();
+
+        log->clear();
+        auto next = std::make_shared<ConfigManager>(configFile);
+        CHECK(logged("Config loaded from cache"));
+        CHECK(next->getRemap() == parsed->getRemap());
+    }
+
+    parsed.reset();
+    deleteTempConfigFile(configFile);
+}
+
+TEST_CASE("ConfigManager - Context remaps") {
+    std::string configFile = "test_context_config.yaml";
+    auto write = [&](const std::string& content) {
+        std::ofstream outFile(configFile, std::ios::trunc);
+        outFile << content;
+    };
+
+    write(R"(
+remap:
+  ctrl+d: cmd+a
+  session:
+    ctrl+d: cmd+b
+    cmd+e: searchbox
+  text-field:
+    cmd+f: searchbox
+  browser: {}
+)");
+    auto configManager = std::make_shared<ConfigManager>(configFile);
+
+    EKeyPress ctrlD;
+    ctrlD.ctrl = true;
+    ctrlD.key = "d";
+
+    SUBCASE("overrides are kept apart from the global remaps") {
+        CHECK(configManager->getRemap().size() == 1);
+        CHECK(configManager->getRemap(KeyContext::Session).size() == 2);
+        CHECK(configManager->getRemap(KeyContext::TextField).size() == 1);
+        CHECK(configManager->getRemap(KeyContext::Browser).empty());
+        CHECK(configManager->getRemap(KeyContext::Global) == configManager->getRemap());
+
+        auto remaps = configManager->getRemapTable();
+        CHECK(remaps->layers().size() == 2);
+        REQUIRE(remaps->find(KeyContext::Session, KeyChord::fromKeyPress(ctrlD)) != nullptr);
+        CHECK(remaps->find(KeyContext::Session, KeyChord::fromKeyPress(ctrlD)) != remaps->find(ctrlD));
+    }
+
+    SUBCASE("reloading diffs each context") {
+        std::vector<ConfigChanges> seen;
+        configManager->onChanged([&](const ConfigChanges& changes) { seen.push_back(changes); });
+        auto before = configManager->getRemapTable();
+
+        write(R"(
+remap:
+  ctrl+d: cmd+a
+  session:
+    ctrl+d: cmd+c
+    cmd+e: searchbox
+)");
+        REQUIRE(configManager->reload());
+        REQUIRE(seen.size() == 1);
+        CHECK(seen[0].remapsChanged == 1);
+        CHECK(seen[0].remapsRemoved == 1);
+        CHECK(configManager->getRemap(KeyContext::TextField).empty());
+
+        auto after = configManager->getRemapTable();
+        CHECK(after->layers().size() == 1);
+        CHECK(after->find(ctrlD) == before->find(ctrlD));
+        EKeyPress cmdE;
+        cmdE.cmd = true;
+        cmdE.key = "e";
+        CHECK(after->find(KeyContext::Session, KeyChord::fromKeyPress(cmdE))
+              == before->find(KeyContext::Session, KeyChord::fromKeyPress(cmdE)));
+    }
+
+    SUBCASE("an unknown context is a broken remap, not a layer") {
+        write("remap:\n  sesion:\n    ctrl+d: cmd+b\n");
+        CHECK_FALSE(configManager->reload());
+        CHECK(configManager->getRemap(KeyContext::Session).size() == 2);
+    }
+
+    SUBCASE("saving and the cache keep the overrides") {
+        configManager->setRemap("cmd+shift+z", "searchbox");
+        configManager->flush();
+
+        auto fresh = std::make_shared<ConfigManager>(configFile);
+        CHECK(fresh->getRemap() == configManager->getRemap());
+        CHECK(fresh->getRemap(KeyContext::Session) == configManager->getRemap(KeyContext::Session));
+        CHECK(fresh->getRemap(KeyContext::TextField) == configManager->getRemap(KeyContext::TextField));
+        CHECK(fresh->getRemapTable()->layers().size() == 2);
+
+        // parsed from the saved text rather than the cache
+        std::remove((configFile + ".cache").c_str());
+        auto reparsed = std::make_shared<ConfigManager>(configFile);
+        CHECK(reparsed->getRemap(KeyContext::Session) == configManager->getRemap(KeyContext::Session));
+        CHECK(reparsed->getRemap(KeyContext::TextField) == configManager->getRemap(KeyContext::TextField));
+    }
+
+    configManager.reset();
+    deleteTempConfigFile(configFile);
+}
+
+TEST_CASE("ConfigManager - Sequences") {
+    std::string configFile = "test_sequence_config.yaml";
+    auto write = [&](const std::string& content) {
+        std::ofstream outFile(configFile, std::ios::trunc);
+        outFile << content;
+    };
+
+    write(R"(
+app-shortcuts:
+  leader: Cmd+B
+  sequence-timeout: 500
+remap:
+  ctrl+d: cmd+a
+sequences:
+  leader p s: plugin.Serum
+  leader   w: closeAllPlugins
+  ctrl+x ctrl+s: cmd+s
+  leader nope+x: searchbox
+)");
+    auto configManager = std::make_shared<ConfigManager>(configFile);
+    const KeyChord leader = KeyMapper::parseChord("cmd+b").chord;
+
+    SUBCASE("sequences are read canonical and compiled with the leader") {
+        CHECK(configManager->getLeader() == "cmd+b");
+        auto sequences = configManager->getSequences();
+        CHECK(sequences.size() == 3);
+        CHECK(sequences.contains("leader p s"));
+        CHECK(sequences.contains("leader w"));
+        CHECK(sequences.contains("ctrl+x ctrl+s"));
+
+        auto trie = configManager->getRemapTable()->sequences();
+        CHECK(trie->size() == 3);
+        CHECK(trie->timeout() == std::chrono::milliseconds(500));
+        const auto first = trie->next(SequenceTrie::ROOT, leader);
+        REQUIRE(first != SequenceTrie::NONE);
+        CHECK(trie->program(trie->next(first, KeyMapper::parseChord("w").chord)) != nullptr);
+    }
+
+    SUBCASE("changing the leader recompiles the sequences") {
+        std::vector<ConfigChanges> seen;
+        configManager->onChanged([&](const ConfigChanges& changes) { seen.push_back(changes); });
+        auto before = configManager->getRemapTable();
+
+        write(R"(
+app-shortcuts:
+  leader: cmd+l
+  sequence-timeout: 500
+remap:
+  ctrl+d: cmd+a
+sequences:
+  leader p s: plugin.Serum
+  leader w: closeAllPlugins
+  ctrl+x ctrl+s: cmd+s
+)");
+        REQUIRE(configManager->reload());
+        REQUIRE(seen.size() == 1);
+        CHECK(seen[0].sequences);
+        CHECK(seen[0].remapsChanged == 0);
+
+        auto trie = configManager->getRemapTable()->sequences();
+        CHECK(trie != before->sequences());
+        CHECK(trie->next(SequenceTrie::ROOT, leader) == SequenceTrie::NONE);
+        CHECK(trie->next(SequenceTrie::ROOT, KeyMapper::parseChord("cmd+l").chord) != SequenceTrie::NONE);
+    }
+
+    SUBCASE("remap edits keep the compiled sequences") {
+        auto before = configManager->getRemapTable()->sequences();
+        configManager->setRemap("cmd+e", "searchbox");
+        CHECK(configManager->getRemapTable()->sequences() == before);
+    }
+
+    SUBCASE("without a leader, sequences that use it are left out") {
+        write("sequences:\n  leader w: closeAllPlugins\n  ctrl+x ctrl+s: cmd+s\n");
+        REQUIRE(configManager->reload());
+        CHECK(configManager->getLeader().empty());
+        CHECK(configManager->getRemapTable()->sequences()->size() == 1);
+        CHECK(configManager->getRemapTable()->sequences()->timeout() == SequenceTrie::DEFAULT_TIMEOUT);
+    }
+
+    SUBCASE("saving and the cache keep them") {
+        configManager->setRemap("cmd+e", "searchbox");
+        configManager->flush();
+
+        auto cached = std::make_shared<ConfigManager>(configFile);
+        CHECK(cached->getLeader() == "cmd+b");
+        CHECK(cached->getSequences() == configManager->getSequences());
+        CHECK(cached->getRemapTable()->sequences()->timeout() == std::chrono::milliseconds(500));
+
+        std::remove((configFile + ".cache").c_str());
+        auto reparsed = std::make_shared<ConfigManager>(configFile);
+        CHECK(reparsed->getLeader() == "cmd+b");
+        CHECK(reparsed->getSequences() == configManager->getSequences());
+        CHECK(reparsed->getRemapTable()->sequences()->size() == 3);
+    }
+
+    configManager.reset();
+    deleteTempConfigFile(configFile);
 }
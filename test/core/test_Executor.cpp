@@ -0,0 +1,251 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Executor.h"
+#include "MockLogHandler.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    using namespace std::chrono_literals;
+
+    // holds jobs until opened, so tests can line work up behind it
+    class Gate {
+    public:
+        void wait() {
+            std::unique_lock lock(mutex_);
+            ++waiting_;
+            changed_.notify_all();
+            changed_.wait(lock, [this]() { return open_; });
+        }
+
+        void open() {
+            {
+                std::lock_guard lock(mutex_);
+                open_ = true;
+            }
+            changed_.notify_all();
+        }
+
+        // true once `n` jobs are held at the gate at the same time
+        auto waitForWaiting(int n) -> bool {
+            std::unique_lock lock(mutex_);
+            return changed_.wait_for(lock, 5s, [&]() { return waiting_ >= n; });
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable changed_;
+        int waiting_ = 0;
+        bool open_ = false;
+    };
+}
+
+TEST_CASE("Executor runs a serial queue in order, one at a time") {
+    Executor executor({.workers = 4, .maxQueued = 256});
+
+    std::mutex mutex;
+    std::vector<int> order;
+    std::atomic<int> running{0};
+    std::atomic<int> overlapped{0};
+
+    for (int i = 0; i < 100; ++i) {
+        CHECK(executor.post(ExecutorQueue::Windows, "job", [&, i]() {
+            if (running.fetch_add(1) != 0) {
+                overlapped.fetch_add(1);
+            }
+            {
+                std::lock_guard lock(mutex);
+                order.push_back(i);
+            }
+            running.fetch_sub(1);
+        }));
+    }
+    executor.drain();
+
+    CHECK(overlapped.load() == 0);
+    REQUIRE(order.size() == 100);
+    for (int i = 0; i < 100; ++i) {
+        CHECK(order[i] == i);
+    }
+
+    const ExecutorStats stats = executor.stats(ExecutorQueue::Windows);
+    CHECK(stats.posted == 100);
+    CHECK(stats.completed == 100);
+    CHECK(stats.failed == 0);
+    CHECK(stats.depth == 0);
+    CHECK(stats.maxDepth >= 1);
+    CHECK(executor.runTime(ExecutorQueue::Windows).count() == 100);
+    CHECK(executor.waitTime(ExecutorQueue::Windows).count() == 100);
+}
+
+TEST_CASE("Executor runs pool jobs side by side") {
+    Executor executor({.workers = 3});
+    Gate gate;
+
+    for (int i = 0; i < 3; ++i) {
+        executor.post(ExecutorQueue::Pool, "held", [&]() { gate.wait(); });
+    }
+
+    // all three only get there if they run at once
+    CHECK(gate.waitForWaiting(3));
+    gate.open();
+    executor.drain();
+    CHECK(executor.stats(ExecutorQueue::Pool).completed == 3);
+}
+
+TEST_CASE("Executor keeps serial queues apart from each other and the pool") {
+    Executor executor({.workers = 2});
+    Gate gate;
+    std::atomic<bool> ipcRan{false};
+
+    // the windows queue is stuck, but only its own thread is
+    executor.post(ExecutorQueue::Windows, "stuck", [&]() { gate.wait(); });
+    executor.post(ExecutorQueue::Windows, "behind", []() {});
+    REQUIRE(gate.waitForWaiting(1));
+
+    executor.post(ExecutorQueue::Ipc, "ipc", [&]() { ipcRan = true; });
+
+    const auto until = std::chrono::steady_clock::now() + 5s;
+    while (!ipcRan && std::chrono::steady_clock::now() < until) {
+        std::this_thread::sleep_for(1ms);
+    }
+    CHECK(ipcRan.load());
+    CHECK(executor.stats(ExecutorQueue::Windows).depth == 2);
+
+    gate.open();
+    executor.drain();
+    CHECK(executor.stats(ExecutorQueue::Windows).completed == 2);
+}
+
+TEST_CASE("Executor lets a pool job wait on the serial queues") {
+    // the one pool worker is held by jobs that wait on IPC and window
+    // work, as a macro waiting on its plugin load does; that work
+    // mustn't need it
+    Executor executor({.workers = 1});
+    std::atomic<int> finished{0};
+
+    for (int i = 0; i < 4; ++i) {
+        executor.post(ExecutorQueue::Pool, "macro", [&]() {
+            std::promise<void> loaded;
+            executor.post(ExecutorQueue::Ipc, "plugin", [&]() {
+                std::this_thread::sleep_for(1ms);
+                loaded.set_value();
+            });
+            REQUIRE(loaded.get_future().wait_for(5s) == std::future_status::ready);
+            std::promise<void> tiled;
+            executor.post(ExecutorQueue::Windows, "tilePluginWindows", [&]() { tiled.set_value(); });
+            REQUIRE(tiled.get_future().wait_for(5s) == std::future_status::ready);
+            finished.fetch_add(1);
+        });
+    }
+    executor.drain();
+
+    CHECK(finished.load() == 4);
+    CHECK(executor.stats(ExecutorQueue::Ipc).completed == 4);
+    CHECK(executor.stats(ExecutorQueue::Windows).completed == 4);
+}
+
+TEST_CASE("Executor logs and counts jobs that throw") {
+    Executor executor({.workers = 1});
+    std::atomic<int> after{0};
+
+    executor.post(ExecutorQueue::Ipc, "plugin", []() {
+        throw std::runtime_error("plugin action requires an argument");
+    });
+    executor.post(ExecutorQueue::Ipc, "odd", []() { throw 42; }); // NOLINT
+    executor.post(ExecutorQueue::Ipc, "fine", [&]() { after.fetch_add(1); });
+    executor.drain();
+
+    // the queue carries on past them
+    CHECK(after.load() == 1);
+    const ExecutorStats stats = executor.stats(ExecutorQueue::Ipc);
+    CHECK(stats.completed == 3);
+    CHECK(stats.failed == 2);
+}
+
+TEST_CASE("Executor hands back a future for submitted jobs") {
+    Executor executor({.workers = 1, .maxQueued = 1});
+    Gate gate;
+    std::atomic<bool> ran{false};
+
+    auto done = executor.submit(ExecutorQueue::Windows, "tilePluginWindows", [&]() {
+        gate.wait();
+        ran = true;
+    });
+    REQUIRE(gate.waitForWaiting(1));
+    CHECK(done.wait_for(0ms) == std::future_status::timeout);
+
+    auto failed = executor.submit(ExecutorQueue::Windows, "closeFocusedPlugin", []() {
+        throw std::runtime_error("no focused plugin");
+    });
+    // the queue is full, so this one never runs
+    auto dropped = executor.submit(ExecutorQueue::Windows, "openAllPlugins", []() {});
+
+    gate.open();
+    done.get();
+    CHECK(ran.load());
+    CHECK_THROWS_AS(failed.get(), std::runtime_error);
+    CHECK_THROWS_AS(dropped.get(), std::future_error);
+
+    executor.drain();
+    const ExecutorStats stats = executor.stats(ExecutorQueue::Windows);
+    CHECK(stats.failed == 1);
+    CHECK(stats.dropped == 1);
+}
+
+TEST_CASE("Executor drops what doesn't fit") {
+    Executor executor({.workers = 1, .maxQueued = 4});
+    Gate gate;
+
+    executor.post(ExecutorQueue::Windows, "stuck", [&]() { gate.wait(); });
+    REQUIRE(gate.waitForWaiting(1));
+
+    // a held-down hotkey
+    int accepted = 0;
+    for (int i = 0; i < 20; ++i) {
+        accepted += executor.post(ExecutorQueue::Windows, "tilePluginWindows", []() {}) ? 1 : 0;
+    }
+    CHECK(accepted == 4);
+
+    // the limit is per queue
+    CHECK(executor.post(ExecutorQueue::Ipc, "ipc", []() {}));
+
+    gate.open();
+    executor.drain();
+
+    const ExecutorStats stats = executor.stats(ExecutorQueue::Windows);
+    CHECK(stats.posted == 5);
+    CHECK(stats.completed == 5);
+    CHECK(stats.dropped == 16);
+    CHECK(stats.maxDepth == 5);
+}
+
+TEST_CASE("Executor finishes queued work when stopped") {
+    std::atomic<int> ran{0};
+    {
+        Executor executor({.workers = 2});
+        for (int i = 0; i < 50; ++i) {
+            executor.post(i % 2 == 0 ? ExecutorQueue::Windows : ExecutorQueue::Pool, "job", [&]() {
+                std::this_thread::sleep_for(100us);
+                ran.fetch_add(1);
+            });
+        }
+        executor.stop();
+        CHECK(ran.load() == 50);
+
+        CHECK_FALSE(executor.post(ExecutorQueue::Pool, "late", [&]() { ran.fetch_add(1); }));
+        // and again from the destructor, harmlessly
+    }
+    CHECK(ran.load() == 50);
+}
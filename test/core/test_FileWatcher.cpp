@@ -0,0 +1,120 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "FileWatcher.h"
+#include "MockLogHandler.h"
+#include "fixtures/TempDir.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    using namespace std::chrono_literals;
+
+    void writeFile(const std::filesystem::path& path, const std::string& contents) {
+        std::ofstream out(path, std::ios::trunc);
+        out << contents;
+    }
+
+    auto options() -> FileWatchOptions {
+        FileWatchOptions o;
+        o.debounce = 40ms; // NOLINT
+        o.pollInterval = 50ms; // NOLINT
+        return o;
+    }
+
+    // waits up to `limit` for the count to reach `expected`
+    auto waitFor(const std::atomic<int>& count, int expected, std::chrono::milliseconds limit = 2000ms) -> bool {
+        auto deadline = std::chrono::steady_clock::now() + limit;
+        while (count.load() < expected && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(5ms);
+        }
+        return count.load() >= expected;
+    }
+}
+
+TEST_CASE("FileWatcher reports an in-place write") {
+    fixture::TempDir dir("watch_write");
+    auto file = dir.path / "theme.ask";
+    writeFile(file, "one");
+
+    std::atomic<int> calls = 0;
+    FileWatcher watcher({file}, [&]() { ++calls; }, options());
+
+    std::this_thread::sleep_for(20ms);
+    writeFile(file, "two, longer");
+
+    CHECK(waitFor(calls, 1));
+    CHECK(watcher.changes() == 1);
+}
+
+TEST_CASE("FileWatcher coalesces a burst of writes") {
+    fixture::TempDir dir("watch_burst");
+    auto file = dir.path / "config.txt";
+    writeFile(file, "");
+
+    std::atomic<int> calls = 0;
+    FileWatcher watcher({file}, [&]() { ++calls; }, options());
+
+    for (int i = 0; i < 5; ++i) {
+        writeFile(file, std::string(static_cast<size_t>(i + 1), 'x'));
+        std::this_thread::sleep_for(10ms);
+    }
+
+    CHECK(waitFor(calls, 1));
+    std::this_thread::sleep_for(200ms);
+    CHECK(calls == 1);
+}
+
+TEST_CASE("FileWatcher follows a file replaced by rename") {
+    fixture::TempDir dir("watch_rename");
+    auto file = dir.path / "config.txt";
+    writeFile(file, "old");
+
+    std::atomic<int> calls = 0;
+    FileWatcher watcher({file}, [&]() { ++calls; }, options());
+
+    auto tmp = dir.path / "config.txt.tmp";
+    writeFile(tmp, "new contents");
+    std::filesystem::rename(tmp, file);
+    CHECK(waitFor(calls, 1));
+
+    // and keeps following the replacement
+    writeFile(file, "newer contents");
+    CHECK(waitFor(calls, 2));
+}
+
+TEST_CASE("FileWatcher notices a file that didn't exist yet") {
+    fixture::TempDir dir("watch_create");
+    auto file = dir.path / "menu.txt";
+
+    std::atomic<int> calls = 0;
+    FileWatcher watcher({dir.path / "other.txt", file}, [&]() { ++calls; }, options());
+
+    writeFile(file, "created");
+    CHECK(waitFor(calls, 1));
+}
+
+TEST_CASE("FileWatcher stays quiet and stops promptly") {
+    fixture::TempDir dir("watch_quiet");
+    auto file = dir.path / "theme.ask";
+    writeFile(file, "same");
+
+    std::atomic<int> calls = 0;
+    auto watcher = std::make_unique<FileWatcher>(std::vector<std::filesystem::path>{file}, [&]() { ++calls; }, options());
+
+    // a sibling changing doesn't count
+    writeFile(dir.path / "unrelated.txt", "noise");
+    std::this_thread::sleep_for(200ms);
+    CHECK(calls == 0);
+
+    auto start = std::chrono::steady_clock::now();
+    watcher.reset();
+    CHECK(std::chrono::steady_clock::now() - start < 40ms);
+}
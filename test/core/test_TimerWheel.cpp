@@ -0,0 +1,175 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "MockLogHandler.h"
+#include "TimerWheel.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    using Tick = TimerWheel::Tick;
+
+    // (tick, token) as each fired
+    auto advance(TimerWheel& wheel, Tick to) -> std::vector<std::pair<Tick, uint64_t>> {
+        std::vector<std::pair<Tick, uint64_t>> fired;
+        wheel.advance(to, [&](uint64_t token) { fired.emplace_back(wheel.now(), token); });
+        return fired;
+    }
+}
+
+TEST_CASE("TimerWheel fires timers on their tick") {
+    TimerWheel wheel;
+    wheel.schedule(5, 1);
+    wheel.schedule(3, 2);
+    wheel.schedule(5, 3);
+    CHECK(wheel.size() == 3);
+    CHECK(wheel.nextWake() == Tick{3});
+
+    CHECK(advance(wheel, 2).empty());
+    const auto fired = advance(wheel, 10);
+    REQUIRE(fired.size() == 3);
+    CHECK(fired[0] == std::pair<Tick, uint64_t>{3, 2});
+    CHECK(fired[1].first == 5);
+    CHECK(fired[2].first == 5);
+    CHECK(wheel.size() == 0);
+    CHECK_FALSE(wheel.nextWake());
+    CHECK(wheel.now() == 10);
+}
+
+TEST_CASE("TimerWheel fires what's overdue on the next tick") {
+    TimerWheel wheel(100);
+    wheel.schedule(40, 1);
+    wheel.schedule(100, 2);
+    const auto fired = advance(wheel, 101);
+    REQUIRE(fired.size() == 2);
+    CHECK(fired[0].first == 101);
+    CHECK(fired[1].first == 101);
+}
+
+TEST_CASE("TimerWheel carries timers down the levels on time") {
+    TimerWheel wheel(7);
+    // one in each level, and one past the horizon
+    const std::vector<Tick> dues = {50, 64 + 9, 4096 * 3 + 17, 262144 * 5 + 1, TimerWheel::SPAN * 2 + 3};
+    for (size_t i = 0; i < dues.size(); ++i) {
+        wheel.schedule(dues[i], i);
+    }
+
+    std::vector<Tick> fired;
+    while (wheel.size() > 0) {
+        const auto wake = wheel.nextWake();
+        REQUIRE(wake);
+        REQUIRE(*wake > wheel.now());
+        wheel.advance(*wake, [&](uint64_t token) {
+            CHECK(wheel.now() == dues[token]);
+            fired.push_back(wheel.now());
+        });
+    }
+    CHECK(fired == dues);
+}
+
+TEST_CASE("TimerWheel cancels in place") {
+    TimerWheel wheel;
+    const auto a = wheel.schedule(10, 1);
+    const auto b = wheel.schedule(5000, 2);
+    wheel.schedule(10, 3);
+
+    CHECK(wheel.cancel(a));
+    CHECK_FALSE(wheel.cancel(a));
+    CHECK(wheel.cancel(b));
+    CHECK(wheel.size() == 1);
+
+    const auto fired = advance(wheel, 10000);
+    REQUIRE(fired.size() == 1);
+    CHECK(fired[0].second == 3);
+
+    // a stale handle doesn't cancel whoever has the slot now
+    std::vector<TimerWheel::Handle> reused;
+    for (uint64_t token = 4; token < 7; ++token) {
+        reused.push_back(wheel.schedule(10100, token));
+    }
+    CHECK_FALSE(wheel.cancel(a));
+    for (const auto handle : reused) {
+        CHECK(wheel.cancel(handle));
+    }
+    CHECK_FALSE(wheel.cancel({}));
+}
+
+TEST_CASE("TimerWheel lets a fired timer schedule another") {
+    TimerWheel wheel;
+    wheel.schedule(1, 0);
+    std::vector<Tick> fired;
+    wheel.advance(1000, [&](uint64_t token) {
+        fired.push_back(wheel.now());
+        if (token < 4) {
+            wheel.schedule(wheel.now() + 100, token + 1);
+        }
+    });
+    CHECK(fired == std::vector<Tick>{1, 101, 201, 301, 401});
+}
+
+TEST_CASE("TimerWheel agrees with a sorted map under load") {
+    std::mt19937_64 rng(20240501); // NOLINT
+    std::uniform_int_distribution<Tick> near(0, 300);
+    std::uniform_int_distribution<Tick> far(0, 400000);
+    std::uniform_int_distribution<int> coin(0, 9);
+
+    TimerWheel wheel;
+    // due -> tokens, and token -> handle
+    std::multimap<Tick, uint64_t> expected;
+    std::map<uint64_t, std::pair<TimerWheel::Handle, Tick>> live;
+    uint64_t next = 0;
+
+    for (int round = 0; round < 400; ++round) {
+        for (int i = 0; i < 25; ++i) {
+            const Tick due = wheel.now() + (coin(rng) < 7 ? near(rng) : far(rng));
+            const auto handle = wheel.schedule(due, next);
+            expected.emplace(std::max(due, wheel.now() + 1), next);
+            live[next] = {handle, std::max(due, wheel.now() + 1)};
+            ++next;
+        }
+        // drop a few
+        for (int i = 0; i < 5 && !live.empty(); ++i) {
+            auto it = live.lower_bound(next - 1 - near(rng) % next);
+            if (it == live.end()) {
+                continue;
+            }
+            CHECK(wheel.cancel(it->second.first));
+            auto [first, last] = expected.equal_range(it->second.second);
+            for (auto e = first; e != last; ++e) {
+                if (e->second == it->first) {
+                    expected.erase(e);
+                    break;
+                }
+            }
+            live.erase(it);
+        }
+
+        const Tick to = wheel.now() + near(rng) * 4;
+        wheel.advance(to, [&](uint64_t token) {
+            REQUIRE(!expected.empty());
+            CHECK(expected.begin()->first == wheel.now());
+            auto [first, last] = expected.equal_range(wheel.now());
+            bool found = false;
+            for (auto e = first; e != last; ++e) {
+                if (e->second == token) {
+                    expected.erase(e);
+                    found = true;
+                    break;
+                }
+            }
+            CHECK(found);
+            live.erase(token);
+        });
+        CHECK(wheel.size() == expected.size());
+        if (!expected.empty()) {
+            CHECK(expected.begin()->first > wheel.now());
+        }
+    }
+}
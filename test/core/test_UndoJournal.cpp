@@ -0,0 +1,70 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <string>
+
+#include "MockLogHandler.h"
+#include "UndoJournal.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+TEST_CASE("UndoJournal steps back and forth") {
+    UndoJournal<std::string> journal(10, 1000); // NOLINT
+    CHECK_FALSE(journal.canUndo());
+    CHECK(journal.undo() == nullptr);
+    CHECK(journal.redo() == nullptr);
+
+    journal.record("a", 1);
+    journal.record("b", 1);
+    journal.record("c", 1);
+
+    CHECK(*journal.undo() == "c");
+    CHECK(*journal.undo() == "b");
+    CHECK(journal.canRedo());
+    CHECK(*journal.redo() == "b");
+    CHECK(*journal.undo() == "b");
+    CHECK(journal.depth() == 1);
+    CHECK(journal.bytes() == 3);
+
+    SUBCASE("recording drops the redo side") {
+        journal.record("d", 1);
+        CHECK_FALSE(journal.canRedo());
+        CHECK(journal.bytes() == 2);
+        CHECK(*journal.undo() == "d");
+        CHECK(*journal.undo() == "a");
+        CHECK(journal.undo() == nullptr);
+    }
+}
+
+TEST_CASE("UndoJournal forgets the oldest edits first") {
+    SUBCASE("by depth") {
+        UndoJournal<int> journal(3, 1000); // NOLINT
+        for (int i = 0; i < 10; ++i) { // NOLINT
+            journal.record(i, 1);
+        }
+        CHECK(journal.depth() == 3);
+        CHECK(journal.bytes() == 3);
+        CHECK(*journal.undo() == 9);
+        CHECK(*journal.undo() == 8);
+        CHECK(*journal.undo() == 7);
+        CHECK(journal.undo() == nullptr);
+    }
+
+    SUBCASE("by size") {
+        UndoJournal<int> journal(100, 100); // NOLINT
+        for (int i = 0; i < 10; ++i) { // NOLINT
+            journal.record(i, 30); // NOLINT
+        }
+        CHECK(journal.depth() == 3);
+        CHECK(journal.bytes() == 90);
+        CHECK(*journal.undo() == 9);
+    }
+
+    SUBCASE("an edit over the budget clears the history") {
+        UndoJournal<int> journal(100, 100); // NOLINT
+        journal.record(1, 10); // NOLINT
+        CHECK_FALSE(journal.record(2, 101)); // NOLINT
+        CHECK_FALSE(journal.canUndo());
+        CHECK(journal.bytes() == 0);
+    }
+}
@@ -0,0 +1,93 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <atomic>
+#include <thread>
+
+#include "FocusTracker.h"
+#include "KeyContext.h"
+#include "MockLogHandler.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+TEST_CASE("KeyContexts names") {
+    for (size_t i = 0; i < KeyContexts::COUNT; ++i) {
+        const auto context = static_cast<KeyContext>(i);
+        CHECK(KeyContexts::find(KeyContexts::name(context)) == context);
+    }
+    CHECK(KeyContexts::find("plugin-window") == KeyContext::PluginWindow);
+    CHECK_FALSE(KeyContexts::find("ctrl+d").has_value());
+    CHECK_FALSE(KeyContexts::find("").has_value());
+}
+
+TEST_CASE("FocusTracker context") {
+    FocusTracker focus;
+    CHECK(focus.context() == KeyContext::Global);
+
+    SUBCASE("Live's view when nothing else has focus") {
+        focus.setLiveView(KeyContext::Session);
+        CHECK(focus.context() == KeyContext::Session);
+        focus.setLiveView(KeyContext::Global);
+        CHECK(focus.context() == KeyContext::Global);
+    }
+
+    SUBCASE("the most specific context wins") {
+        focus.setLiveView(KeyContext::Arrangement);
+        focus.setPluginWindowFocused(true);
+        CHECK(focus.context() == KeyContext::PluginWindow);
+        focus.setTextFieldFocused(true);
+        CHECK(focus.context() == KeyContext::TextField);
+        focus.setSearchBoxOpen(true);
+        CHECK(focus.context() == KeyContext::SearchBox);
+
+        // and letting go falls back through them
+        focus.setSearchBoxOpen(false);
+        CHECK(focus.context() == KeyContext::TextField);
+        focus.setTextFieldFocused(false);
+        CHECK(focus.context() == KeyContext::PluginWindow);
+        focus.setPluginWindowFocused(false);
+        CHECK(focus.context() == KeyContext::Arrangement);
+    }
+
+    SUBCASE("the view is remembered under a plugin window") {
+        focus.setPluginWindowFocused(true);
+        focus.setLiveView(KeyContext::Browser);
+        CHECK(focus.context() == KeyContext::PluginWindow);
+        focus.setPluginWindowFocused(false);
+        CHECK(focus.context() == KeyContext::Browser);
+    }
+}
+
+TEST_CASE("FocusTracker readers only see contexts that were set") {
+    FocusTracker focus;
+    std::atomic<bool> done{false};
+    std::atomic<size_t> unexpected{0};
+
+    std::thread reader([&]() {
+        while (!done) {
+            const auto context = focus.context();
+            if (context != KeyContext::Global && context != KeyContext::PluginWindow
+                && context != KeyContext::SearchBox)
+            {
+                ++unexpected;
+            }
+        }
+    });
+
+    std::thread windows([&]() {
+        for (int i = 0; i < 10000; ++i) { // NOLINT
+            focus.setSearchBoxOpen(i % 2 == 0);
+        }
+        focus.setSearchBoxOpen(false);
+    });
+    for (int i = 0; i < 10000; ++i) { // NOLINT
+        focus.setPluginWindowFocused(i % 3 == 0);
+    }
+    focus.setPluginWindowFocused(false);
+    windows.join();
+    done = true;
+    reader.join();
+
+    CHECK(unexpected.load() == 0);
+    CHECK(focus.context() == KeyContext::Global);
+}
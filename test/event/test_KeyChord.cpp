@@ -0,0 +1,104 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "KeyChord.h"
+#include "KeyMapper.h"
+#include "MacroProgram.h"
+#include "MockLogHandler.h"
+#include "RemapTable.h"
+#include "fixtures/RemapFixture.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+TEST_CASE("KeyChord key ids") {
+    SUBCASE("names the config uses") {
+        for (const char* name : {"a", "z", "0", "9", "f1", "f12", "delete", "enter", "escape", "space"
+                                 , "tab", "backspace", "leftarrow", "uparrow", "downarrow", "rightarrow"}) {
+            CAPTURE(name);
+            const uint8_t id = KeyChord::keyId(name);
+            CHECK(id != 0);
+            CHECK(KeyChord::keyName(id) == name);
+        }
+    }
+
+    SUBCASE("names the platforms give keys") {
+        CHECK(KeyChord::keyId("A") == KeyChord::keyId("a"));
+        CHECK(KeyChord::keyId("F5") == KeyChord::keyId("f5"));
+        CHECK(KeyChord::keyId("Left Arrow") == KeyChord::keyId("leftarrow"));
+        CHECK(KeyChord::keyId("Page Down") == KeyChord::keyId("pagedown"));
+        CHECK(KeyChord::keyId("Return") == KeyChord::keyId("enter"));
+        CHECK(KeyChord::keyId("[") == KeyChord::keyId("leftbracket"));
+    }
+
+    SUBCASE("unknown names") {
+        CHECK(KeyChord::keyId("") == 0);
+        CHECK(KeyChord::keyId("[Unknown Key]") == 0);
+        CHECK(KeyChord::keyId("hyper") == 0);
+        CHECK(KeyChord::keyName(0).empty());
+        CHECK_FALSE(KeyChord().valid());
+    }
+}
+
+TEST_CASE("KeyChord packing") {
+    std::set<uint32_t> indices;
+    for (uint8_t modifiers = 0; modifiers < 16; ++modifiers) { // NOLINT
+        for (uint8_t key = 1; key < 128; ++key) { // NOLINT
+            KeyChord chord(key, modifiers);
+            CHECK(chord.key() == key);
+            CHECK(chord.modifiers() == modifiers);
+            CHECK(chord.index() < KeyChord::SPACE);
+            indices.insert(chord.index());
+        }
+    }
+    CHECK(indices.size() == 16 * 127);
+
+    CHECK(KeyChord::modifierBits(Modifier::Cmd | Modifier::Shift) == (KeyChord::CmdBit | KeyChord::ShiftBit));
+    CHECK(KeyChord::modifierBits(Modifier::None) == 0);
+
+    SUBCASE("round trips through EKeyPress") {
+        KeyMapper km;
+        for (const auto& chordName : fixture::remapChords(16 * 36)) { // NOLINT
+            CAPTURE(chordName);
+            EKeyPress kp = km.processKeyPress(chordName);
+            KeyChord chord = KeyChord::fromKeyPress(kp);
+            REQUIRE(chord.valid());
+            CHECK(chord.toKeyPress() == kp);
+        }
+    }
+}
+
+TEST_CASE("RemapTable finds programs by chord") {
+    KeyMapper km;
+    RemapTable::Programs programs;
+    const auto chords = fixture::remapChords(500); // NOLINT
+    for (const auto& chord : chords) {
+        EMacro macro;
+        macro.addAction(Action("searchbox"));
+        programs[km.processKeyPress(chord)] = std::make_shared<const MacroProgram>(MacroProgram::compile(macro));
+    }
+    // a key with no name here (the old parser let these through); can't be found and doesn't get a slot
+    EKeyPress nameless;
+    nameless.key = "";
+    nameless.cmd = true;
+    programs[nameless] = std::make_shared<const MacroProgram>(MacroProgram::compile(EMacro{}));
+
+    RemapTable table(programs);
+    CHECK(table.size() == 501);
+
+    for (const auto& [key, program] : programs) {
+        CAPTURE(key.key);
+        if (key.key.empty()) {
+            continue;
+        }
+        CHECK(table.find(KeyChord::fromKeyPress(key)) == program.get());
+        CHECK(table.find(key) == program.get());
+    }
+
+    CHECK(table.find(KeyChord()) == nullptr);
+    CHECK(table.find(KeyChord(KeyChord::keyId("f12"), KeyChord::CmdBit)) == nullptr);
+    CHECK(RemapTable().find(KeyChord(KeyChord::keyId("a"), 0)) == nullptr);
+}
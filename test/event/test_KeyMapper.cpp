@@ -0,0 +1,98 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <stdexcept>
+#include <string>
+
+#include "KeyChord.h"
+#include "KeyMapper.h"
+#include "MockLogHandler.h"
+#include "fixtures/RemapFixture.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    auto chord(const char* key, uint8_t modifiers = 0) -> KeyChord {
+        return {KeyChord::keyId(key), modifiers};
+    }
+}
+
+// the parser runs at compile time too
+static_assert(KeyMapper::parseChord("a").ok());
+static_assert(KeyMapper::parseChord("shift+cmd+F12").chord == KeyChord(KeyChord::keyId("f12"), KeyChord::CmdBit | KeyChord::ShiftBit));
+static_assert(KeyMapper::parseChord("cmd+").errorAt == 4);
+static_assert(!KeyMapper::parseChord("hyper+a").ok());
+
+TEST_CASE("parseChord accepts modifiers then one key") {
+    CHECK(KeyMapper::parseChord("a").chord == chord("a"));
+    CHECK(KeyMapper::parseChord("cmd+a").chord == chord("a", KeyChord::CmdBit));
+    CHECK(KeyMapper::parseChord("alt+ctrl+shift+cmd+9").chord
+          == chord("9", KeyChord::AltBit | KeyChord::CtrlBit | KeyChord::ShiftBit | KeyChord::CmdBit));
+
+    SUBCASE("in any order and case") {
+        CHECK(KeyMapper::parseChord("Shift+CMD+A").chord == KeyMapper::parseChord("cmd+shift+a").chord);
+        CHECK(KeyMapper::parseChord("cmd+cmd+a").chord == chord("a", KeyChord::CmdBit));
+    }
+
+    SUBCASE("named and function keys") {
+        for (const char* name : {"delete", "enter", "escape", "space", "tab", "backspace"
+                                 , "leftarrow", "uparrow", "downarrow", "rightarrow", "f1", "F9", "f10", "F12"}) {
+            CAPTURE(name);
+            const ChordParse parse = KeyMapper::parseChord(std::string("ctrl+") + name);
+            CHECK(parse.ok());
+            CHECK(parse.chord == chord(name, KeyChord::CtrlBit));
+        }
+    }
+}
+
+TEST_CASE("parseChord says where it went wrong") {
+    struct Bad {
+        const char* text;
+        size_t at;
+    };
+    for (const Bad& bad : {Bad{"", 0}
+                           , Bad{"+a", 0}
+                           , Bad{"cmd++a", 4}
+                           , Bad{"cmd+", 4}
+                           , Bad{"cmd+shift", 4}
+                           , Bad{"cmd+hyper+a", 4}
+                           , Bad{"cmd+a+b", 4}
+                           , Bad{"f13", 0}
+                           , Bad{"cmd + a", 0}}) {
+        CAPTURE(bad.text);
+        const ChordParse parse = KeyMapper::parseChord(bad.text);
+        CHECK_FALSE(parse.ok());
+        CHECK(parse.errorAt == bad.at);
+    }
+}
+
+TEST_CASE("processKeyPress") {
+    KeyMapper km;
+
+    SUBCASE("canonicalises the key") {
+        EKeyPress kp = km.processKeyPress("shift+cmd+F5");
+        CHECK(kp.key == "f5");
+        CHECK(kp.cmd);
+        CHECK(kp.shift);
+        CHECK_FALSE(kp.alt);
+        CHECK_FALSE(kp.ctrl);
+        CHECK(km.isValid());
+        CHECK(km.getKeyPress() == kp);
+        CHECK(km.EKeyPressToString(kp) == "cmd+shift+f5");
+    }
+
+    SUBCASE("throws with the column") {
+        CHECK_THROWS_WITH_AS(km.processKeyPress("cmd++a")
+                             , "not a valid keypress format: cmd++a (column 5: expected a key or modifier)"
+                             , std::runtime_error);
+        CHECK_FALSE(km.isValid());
+    }
+
+    SUBCASE("round trips every fixture chord") {
+        for (const auto& text : fixture::remapChords(16 * 36)) { // NOLINT
+            CAPTURE(text);
+            EKeyPress kp = km.processKeyPress(text);
+            CHECK(km.processKeyPress(km.EKeyPressToString(kp)) == kp);
+        }
+    }
+}
@@ -0,0 +1,390 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "KeyMapper.h"
+#include "KeySequencer.h"
+#include "MacroProgram.h"
+#include "MockLogHandler.h"
+#include "SequenceTrie.h"
+#include "fixtures/AllocationCounter.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    using namespace std::chrono_literals;
+    using TimePoint = KeySequencer::TimePoint;
+
+    constexpr auto chord(std::string_view text) -> KeyChord {
+        return KeyMapper::parseChord(text).chord;
+    }
+
+    auto program() -> std::shared_ptr<const MacroProgram> {
+        return std::make_shared<const MacroProgram>(MacroProgram::compile(EMacro{}));
+    }
+
+    // sequences from chord lists, keeping each program to compare against
+    struct Sequences {
+        std::vector<SequenceTrie::Sequence> list;
+
+        auto add(std::vector<KeyChord> chords) -> const MacroProgram* {
+            auto compiled = program();
+            const MacroProgram* raw = compiled.get();
+            list.push_back({std::move(chords), std::move(compiled)});
+            return raw;
+        }
+
+        [[nodiscard]] auto build(std::chrono::milliseconds timeout = 1000ms) const -> SequenceTriePtr {
+            return std::make_shared<const SequenceTrie>(list, timeout);
+        }
+    };
+
+    auto replayed(const KeySequencer::Step& step) -> std::vector<KeyChord> {
+        return {step.replay().begin(), step.replay().end()};
+    }
+
+    const TimePoint T0{};
+}
+
+TEST_CASE("SequenceTrie") {
+    const KeyChord leader = chord("cmd+b");
+    Sequences sequences;
+    const MacroProgram* ps = sequences.add({leader, chord("p"), chord("s")});
+    const MacroProgram* p = sequences.add({leader, chord("p")});
+    const MacroProgram* w = sequences.add({leader, chord("w")});
+    auto trie = sequences.build();
+
+    CHECK(trie->size() == 3);
+
+    const auto first = trie->next(SequenceTrie::ROOT, leader);
+    REQUIRE(first != SequenceTrie::NONE);
+    CHECK(trie->program(first) == nullptr);
+    CHECK(trie->leadsOn(first));
+
+    const auto second = trie->next(first, chord("p"));
+    REQUIRE(second != SequenceTrie::NONE);
+    CHECK(trie->program(second) == p);
+    CHECK(trie->leadsOn(second));
+
+    const auto third = trie->next(second, chord("s"));
+    REQUIRE(third != SequenceTrie::NONE);
+    CHECK(trie->program(third) == ps);
+    CHECK_FALSE(trie->leadsOn(third));
+
+    CHECK(trie->program(trie->next(first, chord("w"))) == w);
+    CHECK(trie->next(first, chord("x")) == SequenceTrie::NONE);
+    CHECK(trie->next(SequenceTrie::ROOT, chord("p")) == SequenceTrie::NONE);
+    CHECK(trie->next(first, KeyChord()) == SequenceTrie::NONE);
+
+    SUBCASE("what can't be a sequence is left out") {
+        Sequences bad;
+        bad.add({leader});
+        bad.add({leader, KeyChord()});
+        bad.add(std::vector<KeyChord>(SequenceTrie::MAX_LENGTH + 1, leader));
+        CHECK(bad.build()->empty());
+        CHECK(bad.build()->next(SequenceTrie::ROOT, leader) == SequenceTrie::NONE);
+    }
+
+    SUBCASE("a repeated sequence replaces the first") {
+        Sequences twice;
+        twice.add({leader, chord("p")});
+        const MacroProgram* later = twice.add({leader, chord("p")});
+        auto built = twice.build();
+        CHECK(built->size() == 1);
+        CHECK(built->program(built->next(built->next(SequenceTrie::ROOT, leader), chord("p"))) == later);
+    }
+
+    SUBCASE("an empty trie matches nothing") {
+        SequenceTrie empty;
+        CHECK(empty.empty());
+        CHECK(empty.next(SequenceTrie::ROOT, leader) == SequenceTrie::NONE);
+    }
+}
+
+TEST_CASE("KeySequencer") {
+    const KeyChord leader = chord("cmd+b");
+    const KeyChord p = chord("p");
+    const KeyChord s = chord("s");
+    const KeyChord x = chord("x");
+    Sequences sequences;
+    const MacroProgram* leaderPS = sequences.add({leader, p, s});
+    const MacroProgram* leaderP = sequences.add({leader, p});
+    const MacroProgram* leaderW = sequences.add({leader, chord("w")});
+    auto trie = sequences.build();
+
+    KeySequencer sequencer;
+
+    SUBCASE("keys that aren't sequences go through") {
+        auto step = sequencer.press(trie, x, T0);
+        CHECK(step.empty());
+        CHECK_FALSE(sequencer.pending());
+    }
+
+    SUBCASE("a sequence runs its program when it completes") {
+        CHECK(sequencer.press(trie, leader, T0).consumed);
+        CHECK(sequencer.pending());
+        CHECK(sequencer.deadline() == T0 + 1000ms);
+
+        auto step = sequencer.press(trie, chord("w"), T0 + 10ms);
+        CHECK(step.consumed);
+        CHECK(step.program == leaderW);
+        CHECK(step.replay().empty());
+        CHECK_FALSE(sequencer.pending());
+        CHECK_FALSE(sequencer.deadline().has_value());
+    }
+
+    SUBCASE("each key pushes the deadline back") {
+        sequencer.press(trie, leader, T0);
+        sequencer.press(trie, p, T0 + 900ms);
+        CHECK(sequencer.deadline() == T0 + 1900ms);
+        CHECK(sequencer.press(trie, s, T0 + 1800ms).program == leaderPS);
+    }
+
+    SUBCASE("a key that doesn't fit replays what was held back") {
+        sequencer.press(trie, leader, T0);
+        auto step = sequencer.press(trie, x, T0 + 10ms);
+        CHECK_FALSE(step.consumed);
+        CHECK(step.program == nullptr);
+        CHECK(replayed(step) == std::vector<KeyChord>{leader});
+        CHECK_FALSE(sequencer.pending());
+    }
+
+    SUBCASE("a key that doesn't fit can start the next sequence") {
+        sequencer.press(trie, leader, T0);
+        auto step = sequencer.press(trie, leader, T0 + 10ms);
+        CHECK(step.consumed);
+        CHECK(replayed(step) == std::vector<KeyChord>{leader});
+        CHECK(sequencer.pending());
+        CHECK(sequencer.press(trie, chord("w"), T0 + 20ms).program == leaderW);
+    }
+
+    SUBCASE("a sequence that can end early does so when the next key doesn't fit") {
+        sequencer.press(trie, leader, T0);
+        sequencer.press(trie, p, T0 + 10ms);
+        auto step = sequencer.press(trie, x, T0 + 20ms);
+        CHECK(step.program == leaderP);
+        CHECK(step.replay().empty());
+        CHECK_FALSE(step.consumed);
+    }
+
+    SUBCASE("timing out") {
+        sequencer.press(trie, leader, T0);
+
+        CHECK(sequencer.expire(T0 + 999ms).empty());
+        CHECK(sequencer.pending());
+
+        SUBCASE("replays a sequence that can't end there") {
+            auto step = sequencer.expire(T0 + 1000ms);
+            CHECK(replayed(step) == std::vector<KeyChord>{leader});
+            CHECK_FALSE(sequencer.pending());
+            CHECK(sequencer.expire(T0 + 2000ms).empty());
+        }
+
+        SUBCASE("runs one that can") {
+            sequencer.press(trie, p, T0 + 10ms);
+            auto step = sequencer.expire(T0 + 1010ms);
+            CHECK(step.program == leaderP);
+            CHECK(step.replay().empty());
+        }
+
+        SUBCASE("is noticed by the next key when nothing expired it") {
+            auto step = sequencer.press(trie, p, T0 + 5s);
+            CHECK(replayed(step) == std::vector<KeyChord>{leader});
+            CHECK_FALSE(step.consumed);
+            CHECK_FALSE(sequencer.pending());
+        }
+    }
+
+    SUBCASE("a new trie mid-sequence replays what was held back") {
+        sequencer.press(trie, leader, T0);
+        sequencer.press(trie, p, T0 + 10ms);
+
+        Sequences changed;
+        const MacroProgram* leaderX = changed.add({leader, x});
+        auto next = changed.build();
+
+        auto step = sequencer.press(next, x, T0 + 20ms);
+        CHECK(replayed(step) == std::vector<KeyChord>{leader, p});
+        CHECK(step.program == nullptr);
+        CHECK_FALSE(step.consumed);
+        CHECK(sequencer.trie() == next);
+
+        sequencer.press(next, leader, T0 + 30ms);
+        CHECK(sequencer.press(next, x, T0 + 40ms).program == leaderX);
+    }
+
+    SUBCASE("no trie, no sequences") {
+        CHECK(sequencer.press(nullptr, leader, T0).empty());
+    }
+}
+
+TEST_CASE("KeySequencer doesn't allocate") {
+    const KeyChord leader = chord("cmd+b");
+    Sequences sequences;
+    sequences.add({leader, chord("p"), chord("s")});
+    sequences.add({leader, chord("w")});
+    auto trie = sequences.build();
+    const std::vector<KeyChord> keys = {leader, chord("p"), chord("s"), chord("x"), leader, chord("w")
+                                        , leader, chord("x"), chord("p")};
+
+    KeySequencer sequencer;
+    size_t consumed = 0;
+    fixture::AllocationCounter counter;
+    TimePoint now = T0;
+    for (int pass = 0; pass < 100; ++pass) { // NOLINT
+        for (const KeyChord key : keys) {
+            now += 10ms;
+            consumed += sequencer.press(trie, key, now).consumed ? 1 : 0;
+        }
+        now += 2s;
+        sequencer.expire(now);
+    }
+
+    CHECK(counter.count() == 0);
+    CHECK(consumed == 100 * 6);
+}
+
+namespace {
+    // the same rules, the slow way: every decision is a scan of the
+    // sequences as written
+    struct ReferenceSequencer {
+        std::vector<std::vector<KeyChord>> sequences;
+        std::vector<const MacroProgram*> programs;
+        std::chrono::milliseconds timeout;
+
+        std::vector<KeyChord> pending;
+        TimePoint deadline{};
+
+        struct Step {
+            std::vector<KeyChord> replay;
+            const MacroProgram* program = nullptr;
+            bool consumed = false;
+        };
+
+        [[nodiscard]] auto exact(const std::vector<KeyChord>& keys) const -> const MacroProgram* {
+            const MacroProgram* found = nullptr;
+            for (size_t i = 0; i < sequences.size(); ++i) {
+                if (sequences[i] == keys) {
+                    found = programs[i];
+                }
+            }
+            return found;
+        }
+
+        [[nodiscard]] auto leadsOn(const std::vector<KeyChord>& keys) const -> bool {
+            return std::any_of(sequences.begin(), sequences.end(), [&](const auto& sequence) {
+                return sequence.size() > keys.size() && std::equal(keys.begin(), keys.end(), sequence.begin());
+            });
+        }
+
+        void resolve(Step& step) {
+            if (const auto* program = exact(pending)) {
+                step.program = program;
+            } else {
+                step.replay = pending;
+            }
+            pending.clear();
+        }
+
+        // false if `keys` goes nowhere
+        auto advance(std::vector<KeyChord> keys, TimePoint now, Step& step) -> bool {
+            if (!leadsOn(keys) && exact(keys) == nullptr) {
+                return false;
+            }
+            step.consumed = true;
+            if (leadsOn(keys)) {
+                pending = std::move(keys);
+                deadline = now + timeout;
+            } else {
+                step.program = exact(keys);
+                pending.clear();
+            }
+            return true;
+        }
+
+        auto press(KeyChord chord, TimePoint now) -> Step {
+            Step step;
+            if (!pending.empty() && now >= deadline) {
+                resolve(step);
+            }
+            if (!pending.empty()) {
+                auto keys = pending;
+                keys.push_back(chord);
+                if (advance(keys, now, step)) {
+                    return step;
+                }
+                resolve(step);
+            }
+            advance({chord}, now, step);
+            return step;
+        }
+
+        auto expire(TimePoint now) -> Step {
+            Step step;
+            if (!pending.empty() && now >= deadline) {
+                resolve(step);
+            }
+            return step;
+        }
+    };
+}
+
+TEST_CASE("KeySequencer matches the reference on random input") {
+    // few keys, so sequences share prefixes and typing hits them often
+    const std::vector<KeyChord> alphabet = {chord("cmd+b"), chord("a"), chord("b"), chord("c")};
+    size_t replays = 0;
+    size_t completed = 0;
+
+    for (uint32_t seed = 1; seed <= 300; ++seed) { // NOLINT
+        CAPTURE(seed);
+        std::mt19937 rng(seed);
+        auto pick = [&](size_t n) { return std::uniform_int_distribution<size_t>(0, n - 1)(rng); };
+
+        Sequences sequences;
+        ReferenceSequencer reference;
+        reference.timeout = std::chrono::milliseconds(100 + pick(900)); // NOLINT
+        for (size_t n = 1 + pick(8); n > 0; --n) { // NOLINT
+            std::vector<KeyChord> keys(2 + pick(3)); // NOLINT
+            for (auto& key : keys) {
+                key = alphabet[pick(alphabet.size())];
+            }
+            reference.programs.push_back(sequences.add(keys));
+            reference.sequences.push_back(keys);
+        }
+        auto trie = sequences.build(reference.timeout);
+
+        KeySequencer sequencer;
+        TimePoint now = T0;
+
+        for (int event = 0; event < 400; ++event) { // NOLINT
+            now += std::chrono::milliseconds(pick(reference.timeout.count() * 3 / 2));
+
+            KeySequencer::Step step;
+            ReferenceSequencer::Step expected;
+            if (pick(5) == 0) { // NOLINT
+                step = sequencer.expire(now);
+                expected = reference.expire(now);
+            } else {
+                const KeyChord key = alphabet[pick(alphabet.size())];
+                step = sequencer.press(trie, key, now);
+                expected = reference.press(key, now);
+            }
+
+            REQUIRE(replayed(step) == expected.replay);
+            REQUIRE(step.program == expected.program);
+            REQUIRE(step.consumed == expected.consumed);
+            REQUIRE(sequencer.pending() == !reference.pending.empty());
+
+            replays += step.replayCount;
+            completed += step.program != nullptr ? 1 : 0;
+        }
+    }
+
+    // the input got both ways out of a sequence
+    CHECK(replays > 0);
+    CHECK(completed > 0);
+}
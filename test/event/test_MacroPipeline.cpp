@@ -0,0 +1,348 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <array>
+#include <chrono>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "KeyCodes.h"
+#include "MacroPipeline.h"
+#include "MacroProgram.h"
+#include "MockLogHandler.h"
+#include "WaitScheduler.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    using namespace std::chrono_literals;
+
+    auto key(const std::string& name, bool cmd = false) -> EKeyPress {
+        EKeyPress kp;
+        kp.key = name;
+        kp.cmd = cmd;
+        return kp;
+    }
+
+    // how a fake action finishes
+    enum class Completes : uint8_t {
+        AtOnce      // an invalid future
+        , Later     // from another thread, after a while
+        , Never     // the promise is kept but never set
+        , Throws    // the action failed
+        , Dropped   // the promise went away unset
+    };
+
+    // writes down what the pipeline issued and when the steps completed,
+    // completing them from other threads like the executor and IPC do
+    class AsyncSink {
+    public:
+        std::map<std::string, Completes> actions;
+        std::chrono::milliseconds latency{5};
+        // what settled() heard, in order
+        std::vector<std::string> outcomes;
+
+        AsyncSink() = default;
+        AsyncSink(const AsyncSink&) = delete;
+        auto operator=(const AsyncSink&) -> AsyncSink& = delete;
+        AsyncSink(AsyncSink&&) = delete;
+        auto operator=(AsyncSink&&) -> AsyncSink& = delete;
+
+        ~AsyncSink() {
+            for (auto& thread : threads_) {
+                thread.join();
+            }
+        }
+
+        void key(uint16_t keyCode, uint32_t /*modifiers*/, bool down) {
+            log((down ? "down " : "up ") + std::to_string(keyCode));
+        }
+
+        auto keysPosted() -> std::future<void> {
+            return later("posted");
+        }
+
+        auto invoke(ActionId id, const std::optional<std::string>& argument) -> std::future<void> {
+            const std::string name = std::string(NamedActions::name(id)) + (argument ? "." + *argument : "");
+            log(name);
+
+            switch (actions.count(name) != 0 ? actions[name] : Completes::Later) {
+                case Completes::AtOnce:
+                    return {};
+                case Completes::Later:
+                    return later("done " + name);
+                case Completes::Never:
+                    kept_.emplace_back();
+                    return kept_.back().get_future();
+                case Completes::Throws: {
+                    std::promise<void> failed;
+                    failed.set_exception(std::make_exception_ptr(std::runtime_error(name + " failed")));
+                    return failed.get_future();
+                }
+                case Completes::Dropped: {
+                    std::promise<void> dropped;
+                    return dropped.get_future();
+                }
+            }
+            return {};
+        }
+
+        void settled(std::optional<ActionId> action, StepOutcome outcome) {
+            static constexpr std::array OUTCOMES = {"done", "timed out", "failed"};
+            std::lock_guard lock(mutex_);
+            outcomes.push_back(std::string(action ? NamedActions::name(*action) : "keys")
+                               + " " + OUTCOMES[static_cast<size_t>(outcome)]);
+        }
+
+        void delay(uint32_t ms) {
+            log("delay " + std::to_string(ms));
+            std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+        }
+
+        // waits go to `waits`, as the runner's do
+        auto wait(WaitCondition condition, uint32_t ms) -> std::future<void> {
+            log("wait " + std::string(WaitConditions::name(condition)));
+            return waits->wait(condition, ms, group);
+        }
+        WaitScheduler* waits = nullptr;
+        uint64_t group = 1;
+
+        auto events() -> std::vector<std::string> {
+            std::lock_guard lock(mutex_);
+            return events_;
+        }
+
+    private:
+        void log(const std::string& event) {
+            std::lock_guard lock(mutex_);
+            events_.push_back(event);
+        }
+
+        // logged, then set, from another thread after `latency`
+        auto later(const std::string& event) -> std::future<void> {
+            auto done = std::make_shared<std::promise<void>>();
+            threads_.emplace_back([this, done, event]() {
+                std::this_thread::sleep_for(latency);
+                log(event);
+                done->set_value();
+            });
+            return done->get_future();
+        }
+
+        std::mutex mutex_;
+        std::vector<std::string> events_;
+        std::vector<std::thread> threads_;
+        std::vector<std::promise<void>> kept_;
+    };
+
+    auto code(const std::string& name) -> std::string {
+        return std::to_string(*KeyCodes::find(name));
+    }
+}
+
+TEST_CASE("MacroPipeline issues each step once the one before it is done") {
+    EMacro macro;
+    macro.addKeyPress(key("a", true));
+    macro.addKeyPress(key("b"));
+    macro.addAction(Action("plugin", "Serum"));
+    macro.addAction(Action("tilePluginWindows"));
+    macro.addKeyPress(key("c"));
+    auto program = MacroProgram::compile(macro);
+    REQUIRE(program.waits());
+
+    AsyncSink sink;
+    const MacroRun run = MacroPipeline::run(program, sink);
+
+    // keys go out back to back; actions wait for them to be posted, and
+    // everything after an action waits for it
+    const std::vector<std::string> expected = {
+        "down " + code("a"), "up " + code("a"), "down " + code("b"), "up " + code("b")
+        , "posted"
+        , "plugin.Serum", "done plugin.Serum"
+        , "tilePluginWindows", "done tilePluginWindows"
+        , "down " + code("c"), "up " + code("c")
+        , "posted"
+    };
+    CHECK(sink.events() == expected);
+    CHECK(sink.outcomes == std::vector<std::string>{"keys done", "plugin done", "tilePluginWindows done", "keys done"});
+
+    CHECK_FALSE(run.failed);
+    CHECK(run.steps == program.code().size());
+    CHECK(run.timedOut == 0);
+    // four completions waited on in turn, and the last is in the time
+    CHECK(run.elapsed >= 4 * sink.latency);
+}
+
+TEST_CASE("MacroPipeline doesn't wait on what's already done") {
+    EMacro macro;
+    macro.addAction(Action("searchbox"));
+    macro.addAction(Action("closeAllPlugins"));
+    auto program = MacroProgram::compile(macro);
+
+    AsyncSink sink;
+    sink.actions["searchbox"] = Completes::AtOnce;
+    sink.actions["closeAllPlugins"] = Completes::AtOnce;
+    sink.latency = 10s;
+
+    const MacroRun run = MacroPipeline::run(program, sink);
+    CHECK(sink.events() == std::vector<std::string>{"searchbox", "closeAllPlugins"});
+    CHECK(run.elapsed < 1s);
+}
+
+TEST_CASE("MacroPipeline waits for a step before a delay") {
+    EMacro macro;
+    macro.addAction(Action("plugin", "Serum"));
+    macro.addAction(Action("delay", "10"));
+    macro.addKeyPress(key("d"));
+    auto program = MacroProgram::compile(macro);
+
+    AsyncSink sink;
+    const MacroRun run = MacroPipeline::run(program, sink);
+
+    const std::vector<std::string> expected = {
+        "plugin.Serum", "done plugin.Serum", "delay 10", "down " + code("d"), "up " + code("d"), "posted"
+    };
+    CHECK(sink.events() == expected);
+    CHECK(run.elapsed >= sink.latency + 10ms);
+}
+
+TEST_CASE("MacroPipeline stops at a step that fails") {
+    EMacro macro;
+    macro.addAction(Action("plugin", "Missing"));
+    macro.addKeyPress(key("a", true));
+    macro.addAction(Action("tilePluginWindows"));
+    auto program = MacroProgram::compile(macro);
+
+    SUBCASE("by throwing") {
+        AsyncSink sink;
+        sink.actions["plugin.Missing"] = Completes::Throws;
+        const MacroRun run = MacroPipeline::run(program, sink);
+
+        CHECK(sink.events() == std::vector<std::string>{"plugin.Missing"});
+        CHECK(sink.outcomes == std::vector<std::string>{"plugin failed"});
+        CHECK(run.failed);
+        CHECK(run.error == "plugin.Missing failed");
+        CHECK(run.steps == 1);
+    }
+
+    SUBCASE("by never running") {
+        AsyncSink sink;
+        sink.actions["plugin.Missing"] = Completes::Dropped;
+        const MacroRun run = MacroPipeline::run(program, sink);
+
+        CHECK(sink.events() == std::vector<std::string>{"plugin.Missing"});
+        CHECK(run.failed);
+        CHECK_FALSE(run.error.empty());
+    }
+}
+
+TEST_CASE("MacroPipeline carries on past a step that never completes") {
+    EMacro macro;
+    // Live never answers
+    macro.addAction(Action("plugin", "Serum"));
+    macro.addAction(Action("closeAllPlugins"));
+    auto program = MacroProgram::compile(macro);
+
+    AsyncSink sink;
+    sink.actions["plugin.Serum"] = Completes::Never;
+    const MacroRun run = MacroPipeline::run(program, sink, 20ms);
+
+    const std::vector<std::string> expected = {
+        "plugin.Serum", "closeAllPlugins", "done closeAllPlugins"
+    };
+    CHECK(sink.events() == expected);
+    CHECK(sink.outcomes == std::vector<std::string>{"plugin timed out", "closeAllPlugins done"});
+    CHECK_FALSE(run.failed);
+    CHECK(run.timedOut == 1);
+    CHECK(run.steps == 2);
+}
+
+TEST_CASE("MacroPipeline holds a macro at a wait step until it's met") {
+    EMacro macro;
+    macro.addAction(Action("plugin", "Serum"));
+    macro.addAction(Action("wait", "pluginWindow"));
+    macro.addAction(Action("tilePluginWindows"));
+    auto program = MacroProgram::compile(macro);
+
+    WaitScheduler waits;
+    AsyncSink sink;
+    sink.waits = &waits;
+
+    SUBCASE("met") {
+        // the window opens a while after Live answers
+        std::thread live([&]() {
+            while (waits.pending() == 0) {
+                std::this_thread::sleep_for(1ms);
+            }
+            std::this_thread::sleep_for(10ms);
+            waits.signal(WaitCondition::PluginWindow);
+        });
+        const MacroRun run = MacroPipeline::run(program, sink);
+        live.join();
+
+        const std::vector<std::string> expected = {
+            "plugin.Serum", "done plugin.Serum", "wait pluginWindow", "tilePluginWindows", "done tilePluginWindows"
+        };
+        CHECK(sink.events() == expected);
+        CHECK(sink.outcomes == std::vector<std::string>{"plugin done", "wait done", "tilePluginWindows done"});
+        CHECK_FALSE(run.failed);
+        CHECK(run.elapsed >= 2 * sink.latency + 10ms);
+    }
+
+    SUBCASE("given up on") {
+        EMacro quick;
+        quick.addAction(Action("wait", "pluginWindow.20"));
+        quick.addAction(Action("tilePluginWindows"));
+        auto impatient = MacroProgram::compile(quick);
+
+        const MacroRun run = MacroPipeline::run(impatient, sink);
+        // tiled anyway
+        CHECK(sink.events() == std::vector<std::string>{"wait pluginWindow", "tilePluginWindows", "done tilePluginWindows"});
+        CHECK(sink.outcomes == std::vector<std::string>{"wait timed out", "tilePluginWindows done"});
+        CHECK_FALSE(run.failed);
+        CHECK(run.timedOut == 1);
+        CHECK(run.elapsed >= 20ms);
+    }
+
+    SUBCASE("preempted by a newer macro") {
+        std::thread newer([&]() {
+            while (waits.pending() == 0) {
+                std::this_thread::sleep_for(1ms);
+            }
+            waits.preempt(sink.group + 1);
+        });
+        const MacroRun run = MacroPipeline::run(program, sink);
+        newer.join();
+
+        CHECK(sink.events() == std::vector<std::string>{"plugin.Serum", "done plugin.Serum", "wait pluginWindow"});
+        CHECK(sink.outcomes == std::vector<std::string>{"plugin done", "wait failed"});
+        CHECK(run.failed);
+        CHECK(run.steps == 2);
+    }
+}
+
+TEST_CASE("MacroPipeline waits out time on the scheduler") {
+    EMacro macro;
+    macro.addKeyPress(key("a", true));
+    macro.addAction(Action("wait", "ms.30"));
+    macro.addKeyPress(key("b"));
+    auto program = MacroProgram::compile(macro);
+
+    WaitScheduler waits;
+    AsyncSink sink;
+    sink.waits = &waits;
+    const MacroRun run = MacroPipeline::run(program, sink);
+
+    const std::vector<std::string> expected = {
+        "down " + code("a"), "up " + code("a"), "posted", "wait ms", "down " + code("b"), "up " + code("b"), "posted"
+    };
+    CHECK(sink.events() == expected);
+    CHECK(run.elapsed >= 30ms + 2 * sink.latency);
+    CHECK(waits.pending() == 0);
+}
@@ -0,0 +1,240 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <string>
+#include <vector>
+
+#include "KeyCodes.h"
+#include "MacroProgram.h"
+#include "MockLogHandler.h"
+#include "fixtures/AllocationCounter.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    auto key(const std::string& name, bool cmd = false, bool shift = false) -> EKeyPress {
+        EKeyPress kp;
+        kp.key = name;
+        kp.cmd = cmd;
+        kp.shift = shift;
+        return kp;
+    }
+
+    // writes down what the interpreter asked for
+    struct RecordingSink {
+        std::vector<std::string> events;
+
+        void key(uint16_t keyCode, uint32_t modifiers, bool down) {
+            events.push_back((down ? "down " : "up ") + std::to_string(keyCode) + " " + std::to_string(modifiers));
+        }
+        void invoke(ActionId id, const std::optional<std::string>& argument) {
+            events.push_back(std::string(NamedActions::name(id)) + (argument ? "." + *argument : ""));
+        }
+        void delay(uint32_t ms) {
+            events.push_back("delay " + std::to_string(ms));
+        }
+        void wait(WaitCondition condition, uint32_t ms) {
+            events.push_back("wait " + std::string(WaitConditions::name(condition)) + " " + std::to_string(ms));
+        }
+    };
+
+    // what the real runner does, minus the side effects
+    struct CountingSink {
+        uint32_t keys = 0;
+        uint32_t invokes = 0;
+        uint32_t waited = 0;
+        size_t argumentBytes = 0;
+
+        void key(uint16_t, uint32_t, bool) { ++keys; }
+        void invoke(ActionId, const std::optional<std::string>& argument) {
+            ++invokes;
+            argumentBytes += argument ? argument->size() : 0;
+        }
+        void delay(uint32_t ms) { waited += ms; }
+        void wait(WaitCondition, uint32_t ms) { waited += ms; }
+    };
+}
+
+TEST_CASE("KeyCodes") {
+    CHECK(KeyCodes::find("a").has_value());
+    CHECK(KeyCodes::find("A") == KeyCodes::find("a"));
+    CHECK(KeyCodes::find("F5") == KeyCodes::find("f5"));
+    CHECK(KeyCodes::find("n") != KeyCodes::find("enter"));
+    for (const char* name : {"delete", "enter", "escape", "space", "tab", "backspace"
+                             , "leftarrow", "uparrow", "downarrow", "rightarrow"}) {
+        CAPTURE(name);
+        CHECK(KeyCodes::find(name).has_value());
+    }
+    CHECK_FALSE(KeyCodes::find("").has_value());
+    CHECK_FALSE(KeyCodes::find("hyper").has_value());
+}
+
+TEST_CASE("MacroProgram compiles steps") {
+    const auto a = std::to_string(*KeyCodes::find("a"));
+    const auto d = std::to_string(*KeyCodes::find("d"));
+    const auto cmdShift = std::to_string(Modifier::Cmd | Modifier::Shift);
+
+    EMacro macro;
+    macro.addKeyPress(key("a"));
+    macro.addKeyPress(key("d", true, true));
+    macro.addAction(Action("plugin", "Serum"));
+    macro.addAction(Action("delay", "50"));
+    macro.addAction(Action("closeAllPlugins"));
+    macro.addAction(Action("plugin", "Serum"));
+
+    auto program = MacroProgram::compile(macro);
+    RecordingSink sink;
+    program.run(sink);
+
+    const std::vector<std::string> expected = {
+        "down " + a + " 0", "up " + a + " 0"
+        , "down " + d + " " + cmdShift, "up " + d + " " + cmdShift
+        , "plugin.Serum"
+        , "delay 50"
+        , "closeAllPlugins"
+        , "plugin.Serum"
+    };
+    CHECK(sink.events == expected);
+    CHECK(program.hasDelay());
+
+    SUBCASE("arguments are interned") {
+        CHECK(program.arguments().size() == 2);
+        CHECK_FALSE(program.arguments()[0].has_value());
+        CHECK(program.arguments()[1] == "Serum");
+    }
+
+    SUBCASE("the instructions are flat and small") {
+        CHECK(sizeof(MacroInstr) == 8);
+        CHECK(program.code().size() == 8);
+    }
+}
+
+TEST_CASE("MacroProgram compiles actions whose names aren't identifiers") {
+    EMacro macro;
+    macro.addAction(Action("write-request", "foo"));
+
+    auto program = MacroProgram::compile(macro);
+    REQUIRE(program.code().size() == 1);
+    CHECK(program.code()[0].op == MacroOp::Invoke);
+    CHECK(static_cast<ActionId>(program.code()[0].operand) == ActionId::write_request);
+
+    RecordingSink sink;
+    program.run(sink);
+    CHECK(sink.events == std::vector<std::string>{"write-request.foo"});
+}
+
+TEST_CASE("MacroProgram compiles wait steps") {
+    EMacro macro;
+    macro.addAction(Action("plugin", "Serum"));
+    macro.addAction(Action("wait", "pluginWindow"));
+    macro.addAction(Action("wait", "ms.50"));
+    macro.addAction(Action("wait", "ipc.300"));
+    macro.addAction(Action("tilePluginWindows"));
+
+    auto program = MacroProgram::compile(macro);
+    RecordingSink sink;
+    program.run(sink);
+
+    const std::vector<std::string> expected = {
+        "plugin.Serum"
+        , "wait pluginWindow " + std::to_string(WaitConditions::DEFAULT_TIMEOUT_MS)
+        , "wait ms 50"
+        , "wait ipc 300"
+        , "tilePluginWindows"
+    };
+    CHECK(sink.events == expected);
+    CHECK(program.waits());
+    CHECK_FALSE(program.hasDelay());
+}
+
+TEST_CASE("MacroProgram leaves out what it can't compile") {
+    EMacro macro;
+    macro.addKeyPress(key("hyper"));
+    macro.addAction(Action("nonsense", "x"));
+    macro.addAction(Action("delay", "soon"));
+    macro.addAction(Action("delay"));
+    macro.addAction(Action("delay", "10ms"));
+    macro.addKeyPress(key("b"));
+
+    auto program = MacroProgram::compile(macro);
+    CHECK(program.code().size() == 2);
+    CHECK(program.code()[0].op == MacroOp::KeyDown);
+    CHECK(program.code()[1].op == MacroOp::KeyUp);
+    CHECK_FALSE(program.hasDelay());
+
+    SUBCASE("waits") {
+        EMacro unknown;
+        unknown.addAction(Action("wait", "window"));
+        unknown.addAction(Action("wait", "ms"));
+        unknown.addAction(Action("wait", "ms.soon"));
+        unknown.addAction(Action("wait"));
+        CHECK(MacroProgram::compile(unknown).code().empty());
+        CHECK_FALSE(MacroProgram::compile(unknown).waits());
+    }
+
+    auto empty = MacroProgram::compile(EMacro{});
+    RecordingSink sink;
+    empty.run(sink);
+    CHECK(sink.events.empty());
+}
+
+TEST_CASE("MacroProgram knows when its steps wait on each other") {
+    const auto waits = [](const EMacro& macro) { return MacroProgram::compile(macro).waits(); };
+
+    EMacro press;
+    press.addKeyPress(key("a", true));
+    CHECK_FALSE(waits(press));
+
+    // paced
+    EMacro keys = press;
+    keys.addKeyPress(key("b"));
+    CHECK(waits(keys));
+
+    EMacro action;
+    action.addAction(Action("closeFocusedPlugin"));
+    CHECK_FALSE(waits(action));
+
+    EMacro keysThenAction = press;
+    keysThenAction.addAction(Action("plugin", "Serum"));
+    CHECK(waits(keysThenAction));
+
+    EMacro actions = action;
+    actions.addAction(Action("tilePluginWindows"));
+    CHECK(waits(actions));
+
+    EMacro delayed;
+    delayed.addAction(Action("delay", "10"));
+    CHECK(waits(delayed));
+
+    EMacro waiting;
+    waiting.addAction(Action("wait", "pluginWindow"));
+    CHECK(waits(waiting));
+
+    // what gets left out doesn't count
+    EMacro skipped = action;
+    skipped.addAction(Action("nonsense"));
+    CHECK_FALSE(waits(skipped));
+}
+
+TEST_CASE("running a MacroProgram doesn't allocate") {
+    EMacro macro;
+    for (int i = 0; i < 50; ++i) { // NOLINT
+        macro.addKeyPress(key("a", true));
+        macro.addAction(Action("plugin", "Valhalla VintageVerb with a name too long for SSO"));
+        macro.addAction(Action("tilePluginWindows"));
+        macro.addAction(Action("delay", "1"));
+    }
+    auto program = MacroProgram::compile(macro);
+
+    CountingSink sink;
+    fixture::AllocationCounter counter;
+    for (int i = 0; i < 100; ++i) { // NOLINT
+        program.run(sink);
+    }
+
+    CHECK(counter.count() == 0);
+    CHECK(sink.keys == 100 * 50 * 2);
+    CHECK(sink.invokes == 100 * 50 * 2);
+    CHECK(sink.waited == 100 * 50);
+    CHECK(sink.argumentBytes == 100 * 50 * std::string("Valhalla VintageVerb with a name too long for SSO").size());
+}
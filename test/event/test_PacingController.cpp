@@ -0,0 +1,228 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "MockLogHandler.h"
+#include "PacingController.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    using namespace std::chrono_literals;
+    using TimePoint = PacingController::TimePoint;
+
+    // Live as far as input goes: what arrives between two ticks waits in
+    // a buffer and is handled on the tick, and once the buffer is full
+    // the rest is lost. Whether a key made it is only known on the tick
+    // that should have handled it.
+    class TickConsumer {
+    public:
+        std::chrono::milliseconds tick{100};
+        size_t perTick = 4;
+
+        explicit TickConsumer(TimePoint start) : nextTick_(start + tick) {}
+
+        [[nodiscard]] auto nextTick() const -> TimePoint { return nextTick_; }
+
+        void arrive(TimePoint sentAt) {
+            buffer_.push_back({sentAt, buffer_.size() < perTick});
+        }
+
+        // runs the tick, telling `pacer` how each key since the last went
+        void runTick(PacingController& pacer) {
+            for (const Arrival& arrival : buffer_) {
+                if (arrival.kept) {
+                    pacer.accepted(PaceClass::Key);
+                    ++handled;
+                } else {
+                    pacer.dropped(PaceClass::Key, arrival.sentAt);
+                    ++lost;
+                }
+            }
+            buffer_.clear();
+            nextTick_ += tick;
+        }
+
+        size_t handled = 0;
+        size_t lost = 0;
+
+    private:
+        struct Arrival {
+            TimePoint sentAt;
+            bool kept;
+        };
+
+        TimePoint nextTick_;
+        std::vector<Arrival> buffer_;
+    };
+
+    struct Run {
+        size_t handled = 0;
+        size_t lost = 0;
+        std::chrono::nanoseconds took{};
+        std::vector<std::chrono::nanoseconds> intervals;
+    };
+
+    // sends `keys` as fast as the pacer lets it; a send that comes due
+    // after a tick waits for that tick's feedback first, as the real
+    // one is sleeping meanwhile
+    auto send(PacingController& pacer, TickConsumer& live, size_t keys, TimePoint& now) -> Run {
+        Run run;
+        const size_t handledBefore = live.handled;
+        const size_t lostBefore = live.lost;
+        const TimePoint start = now;
+
+        for (size_t i = 0; i < keys; ++i) {
+            const TimePoint at = pacer.reserve(PaceClass::Key, now);
+            while (live.nextTick() <= at) {
+                live.runTick(pacer);
+            }
+            now = at;
+            live.arrive(at);
+            run.intervals.push_back(pacer.interval(PaceClass::Key));
+        }
+        // whatever's still buffered gets its answer too
+        live.runTick(pacer);
+        now = live.nextTick();
+
+        run.handled = live.handled - handledBefore;
+        run.lost = live.lost - lostBefore;
+        run.took = now - start;
+        return run;
+    }
+
+    auto perSecond(size_t count, std::chrono::nanoseconds took) -> double {
+        return static_cast<double>(count) / std::chrono::duration<double>(took).count();
+    }
+}
+
+TEST_CASE("PacingController spaces sends at its interval") {
+    PacingController pacer;
+    const TimePoint t0{};
+    const auto interval = pacer.interval(PaceClass::Key);
+    CHECK(interval == 30ms);
+
+    CHECK(pacer.reserve(PaceClass::Key, t0) == t0);
+    CHECK(pacer.reserve(PaceClass::Key, t0) == t0 + interval);
+    CHECK(pacer.reserve(PaceClass::Key, t0 + 1ms) == t0 + 2 * interval);
+    // idle long enough, and it goes straight away
+    CHECK(pacer.reserve(PaceClass::Key, t0 + 1s) == t0 + 1s);
+
+    // classes don't share a schedule
+    CHECK(pacer.reserve(PaceClass::Ipc, t0) == t0);
+    CHECK(pacer.stats(PaceClass::Key).sent == 4);
+}
+
+TEST_CASE("PacingController adds on acks and halves on drops") {
+    std::array limits = PacingController::DEFAULT_LIMITS;
+    limits[static_cast<size_t>(PaceClass::Key)] = {10ms, 5ms, 40ms, 10.0, 0.5};
+    PacingController pacer(limits);
+    const TimePoint t0{};
+
+    // 100/s, then 110/s
+    pacer.accepted(PaceClass::Key);
+    CHECK(pacer.interval(PaceClass::Key) == std::chrono::nanoseconds(static_cast<int64_t>(1e9 / 110)));
+
+    // no faster than the shortest interval
+    for (int i = 0; i < 100; ++i) {
+        pacer.accepted(PaceClass::Key);
+    }
+    CHECK(pacer.interval(PaceClass::Key) == 5ms);
+
+    SUBCASE("once per flight") {
+        const TimePoint a = pacer.reserve(PaceClass::Key, t0);
+        const TimePoint b = pacer.reserve(PaceClass::Key, t0);
+        pacer.dropped(PaceClass::Key, a);
+        CHECK(pacer.interval(PaceClass::Key) == 10ms);
+        // sent before the rate came down; no second halving
+        pacer.dropped(PaceClass::Key, b);
+        CHECK(pacer.interval(PaceClass::Key) == 10ms);
+
+        const TimePoint c = pacer.reserve(PaceClass::Key, t0);
+        CHECK(c > b);
+        pacer.dropped(PaceClass::Key, c);
+        CHECK(pacer.interval(PaceClass::Key) == 20ms);
+
+        const auto stats = pacer.stats(PaceClass::Key);
+        CHECK(stats.dropped == 3);
+        CHECK(stats.decreases == 2);
+    }
+
+    SUBCASE("no slower than the longest interval") {
+        for (int i = 0; i < 10; ++i) {
+            pacer.dropped(PaceClass::Key, pacer.reserve(PaceClass::Key, t0 + std::chrono::seconds(i)));
+        }
+        CHECK(pacer.interval(PaceClass::Key) == 40ms);
+    }
+}
+
+TEST_CASE("PacingController finds the rate a tick-based consumer keeps up with") {
+    PacingController pacer;
+    TimePoint now{};
+    TickConsumer live(now);
+    // 4 keys a tick, so 40 a second at best
+    const double capacity = static_cast<double>(live.perTick) * 1000.0 / static_cast<double>(live.tick.count());
+
+    // from the default rate up to where it starts losing keys
+    send(pacer, live, 100, now);
+    const Run run = send(pacer, live, 1000, now);
+
+    const double rate = perSecond(run.handled, run.took);
+
+    CHECK(run.handled + run.lost == 1000);
+    // most of what Live could take, for few losses
+    CHECK(rate > 0.65 * capacity);
+    CHECK(rate <= capacity);
+    CHECK(static_cast<double>(run.lost) < 0.1 * 1000);
+    // and far quicker than a sleep of a tick between keys
+    CHECK(run.took < 1000 * live.tick / 2);
+
+    // it hovers around the limit rather than settling well under it
+    const auto limit = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / capacity));
+    size_t over = 0;
+    for (const auto interval : run.intervals) {
+        over += interval < limit ? 1 : 0;
+        CHECK(interval >= 2ms);
+        CHECK(interval <= 250ms);
+    }
+    CHECK(over > 0);
+    CHECK(over < run.intervals.size() / 2);
+
+    SUBCASE("the same feedback paces the same way") {
+        PacingController again;
+        TimePoint then{};
+        TickConsumer liveAgain(then);
+        send(again, liveAgain, 100, then);
+        const Run replay = send(again, liveAgain, 1000, then);
+        CHECK(replay.intervals == run.intervals);
+        CHECK(replay.lost == run.lost);
+        CHECK(then - TimePoint{} == now - TimePoint{});
+    }
+}
+
+TEST_CASE("PacingController backs off when the consumer slows down") {
+    PacingController pacer;
+    TimePoint now{};
+    TickConsumer live(now);
+
+    send(pacer, live, 300, now);
+    const auto fast = pacer.interval(PaceClass::Key);
+
+    // Live's busy: one key a tick
+    live.perTick = 1;
+    const Run slowed = send(pacer, live, 200, now);
+    CHECK(pacer.interval(PaceClass::Key) > fast);
+
+    const Run settled = send(pacer, live, 300, now);
+    const double rate = perSecond(settled.handled, settled.took);
+    CHECK(rate > 0.5 * 10);
+    CHECK(static_cast<double>(settled.lost) < 0.15 * 300);
+
+    // and speeds back up when it recovers
+    live.perTick = 4;
+    send(pacer, live, 1000, now);
+    CHECK(pacer.interval(PaceClass::Key) < 40ms);
+}
@@ -0,0 +1,227 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ConfigManager.h"
+#include "KeyChord.h"
+#include "KeyMapper.h"
+#include "MacroProgram.h"
+#include "MockLogHandler.h"
+#include "RemapTable.h"
+#include "fixtures/AllocationCounter.h"
+#include "fixtures/RemapFixture.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    constexpr size_t REMAPS = 500;
+
+    // a config file for one case; declared before the ConfigManager using
+    // it, so the manager's final save lands before the file, and the cache
+    // loading it wrote, are removed
+    struct TempConfig {
+        std::string path;
+
+        TempConfig(std::string name, const std::string& body) : path(std::move(name)) {
+            std::remove((path + ".cache").c_str());
+            std::ofstream out(path);
+            out << body;
+        }
+        ~TempConfig() {
+            std::remove(path.c_str());
+            std::remove((path + ".cache").c_str());
+        }
+        TempConfig(const TempConfig&) = delete;
+        auto operator=(const TempConfig&) -> TempConfig& = delete;
+        TempConfig(TempConfig&&) = delete;
+        auto operator=(TempConfig&&) -> TempConfig& = delete;
+    };
+
+    auto pressedChords(size_t count) -> std::vector<KeyChord> {
+        KeyMapper km;
+        std::vector<KeyChord> chords;
+        for (const auto& chord : fixture::remapChords(count)) {
+            chords.push_back(KeyChord::fromKeyPress(km.processKeyPress(chord)));
+        }
+        return chords;
+    }
+
+    auto chordKeys(size_t count) -> std::vector<EKeyPress> {
+        KeyMapper km;
+        std::vector<EKeyPress> keys;
+        for (const auto& chord : fixture::remapChords(count)) {
+            keys.push_back(km.processKeyPress(chord));
+        }
+        return keys;
+    }
+}
+
+TEST_CASE("RemapTable lookups don't allocate") {
+    TempConfig file("test_remap_table.yaml", fixture::remapConfig(REMAPS));
+    ConfigManager config(file.path);
+    auto keys = pressedChords(REMAPS);
+    const KeyChord unmapped(KeyChord::keyId("leftarrow"), KeyChord::CmdBit);
+
+    REQUIRE(config.getRemapTable()->size() == REMAPS);
+
+    // what handleKeyEvent does for every key press
+    size_t found = 0;
+    fixture::AllocationCounter counter;
+    for (int pass = 0; pass < 10; ++pass) { // NOLINT
+        for (const auto& key : keys) {
+            auto remaps = config.getRemapTable();
+            found += remaps->find(key) != nullptr ? 1 : 0;
+        }
+        auto remaps = config.getRemapTable();
+        found += remaps->find(unmapped) != nullptr ? 1 : 0;
+    }
+
+    CHECK(counter.count() == 0);
+    CHECK(found == 10 * REMAPS);
+}
+
+TEST_CASE("setRemap publishes a new table") {
+    TempConfig file("test_remap_swap.yaml", fixture::remapConfig(REMAPS));
+    ConfigManager config(file.path);
+    auto keys = chordKeys(REMAPS);
+
+    auto before = config.getRemapTable();
+    const MacroProgram* oldProgram = before->find(keys[0]);
+    REQUIRE(oldProgram != nullptr);
+
+    config.setRemap(fixture::remapChords(1)[0], "closeAllPlugins");
+    auto after = config.getRemapTable();
+
+    SUBCASE("readers holding the old table still see it") {
+        CHECK(before->find(keys[0]) == oldProgram);
+        REQUIRE(oldProgram->code().size() == 3);
+        CHECK(oldProgram->code()[2].op == MacroOp::Invoke);
+        CHECK(static_cast<ActionId>(oldProgram->code()[2].operand) == ActionId::plugin);
+    }
+
+    SUBCASE("the new table has the change") {
+        CHECK(after != before);
+        CHECK(after->size() == REMAPS);
+        const MacroProgram* newProgram = after->find(keys[0]);
+        REQUIRE(newProgram != nullptr);
+        REQUIRE(newProgram->code().size() == 1);
+        CHECK(static_cast<ActionId>(newProgram->code()[0].operand) == ActionId::closeAllPlugins);
+    }
+
+    SUBCASE("unchanged remaps aren't recompiled") {
+        for (size_t i = 1; i < keys.size(); ++i) {
+            CHECK(after->find(keys[i]) == before->find(keys[i]));
+        }
+    }
+}
+
+TEST_CASE("key presses during setRemap always find a table") {
+    TempConfig file("test_remap_race.yaml", fixture::remapConfig(REMAPS));
+    ConfigManager config(file.path);
+    auto keys = chordKeys(REMAPS);
+
+    std::atomic<bool> done{false};
+    std::atomic<size_t> misses{0};
+    std::thread reader([&]() {
+        while (!done) {
+            for (const auto& key : keys) {
+                auto remaps = config.getRemapTable();
+                if (remaps->find(key) == nullptr) {
+                    ++misses;
+                }
+            }
+        }
+    });
+
+    const auto chords = fixture::remapChords(REMAPS);
+    for (size_t i = 0; i < 20; ++i) { // NOLINT
+        config.setRemap(chords[i * 7], i % 2 == 0 ? "searchbox" : "cmd+z"); // NOLINT
+    }
+    done = true;
+    reader.join();
+
+    CHECK(misses.load() == 0);
+    CHECK(config.getRemapTable()->size() == REMAPS);
+}
+
+TEST_CASE("RemapTable resolves per context") {
+    TempConfig file("test_remap_contexts.yaml", R"(
+remap:
+  ctrl+d: cmd+a
+  d: delete
+  cmd+e: searchbox
+  session:
+    ctrl+d: cmd+b
+    f: cmd+f
+  plugin-window:
+    cmd+e: closeFocusedPlugin
+)");
+    ConfigManager config(file.path);
+    KeyMapper km;
+    const auto ctrlD = KeyChord::fromKeyPress(km.processKeyPress("ctrl+d"));
+    const auto d = KeyChord::fromKeyPress(km.processKeyPress("d"));
+    const auto f = KeyChord::fromKeyPress(km.processKeyPress("f"));
+    const auto cmdE = KeyChord::fromKeyPress(km.processKeyPress("cmd+e"));
+
+    auto remaps = config.getRemapTable();
+    REQUIRE(remaps->size() == 3);
+    REQUIRE(remaps->layers().size() == 2);
+
+    SUBCASE("overrides replace and add to the global remaps") {
+        CHECK(remaps->find(KeyContext::Session, ctrlD) != nullptr);
+        CHECK(remaps->find(KeyContext::Session, ctrlD) != remaps->find(ctrlD));
+        CHECK(remaps->find(KeyContext::Session, f) != nullptr);
+        CHECK(remaps->find(f) == nullptr);
+        // what isn't overridden is the global program itself
+        CHECK(remaps->find(KeyContext::Session, d) == remaps->find(d));
+        CHECK(remaps->find(KeyContext::Session, cmdE) == remaps->find(cmdE));
+        CHECK(remaps->find(KeyContext::PluginWindow, cmdE) != remaps->find(cmdE));
+    }
+
+    SUBCASE("contexts without overrides see the global remaps") {
+        for (auto context : {KeyContext::Arrangement, KeyContext::Browser, KeyContext::SearchBox}) {
+            CHECK(remaps->find(context, ctrlD) == remaps->find(ctrlD));
+            CHECK(remaps->find(context, d) == remaps->find(d));
+            CHECK(remaps->find(context, f) == nullptr);
+        }
+    }
+
+    SUBCASE("text fields only get remaps with a modifier") {
+        CHECK(remaps->find(d) != nullptr);
+        CHECK(remaps->find(KeyContext::TextField, d) == nullptr);
+        CHECK(remaps->find(KeyContext::TextField, ctrlD) == remaps->find(ctrlD));
+        CHECK(remaps->find(KeyContext::TextField, cmdE) == remaps->find(cmdE));
+    }
+
+    SUBCASE("changing a global remap reaches the contexts that inherit it") {
+        config.setRemap("d", "cmd+z");
+        auto after = config.getRemapTable();
+        CHECK(after->find(d) != remaps->find(d));
+        CHECK(after->find(KeyContext::Session, d) == after->find(d));
+        // the override is untouched
+        CHECK(after->find(KeyContext::Session, ctrlD) == remaps->find(KeyContext::Session, ctrlD));
+    }
+}
+
+TEST_CASE("RemapTable context lookups don't allocate") {
+    TempConfig file("test_remap_context_alloc.yaml", fixture::remapConfig(REMAPS) + "  session:\n    ctrl+d: cmd+b\n");
+    ConfigManager config(file.path);
+    auto keys = pressedChords(REMAPS);
+    REQUIRE(config.getRemapTable()->layers().size() == 1);
+
+    size_t found = 0;
+    fixture::AllocationCounter counter;
+    for (const auto& key : keys) {
+        auto remaps = config.getRemapTable();
+        found += remaps->find(KeyContext::Session, key) != nullptr ? 1 : 0;
+        found += remaps->find(KeyContext::TextField, key) != nullptr ? 1 : 0;
+    }
+
+    CHECK(counter.count() == 0);
+    CHECK(found >= REMAPS);
+}
@@ -0,0 +1,169 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "MockLogHandler.h"
+#include "WaitScheduler.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    using namespace std::chrono_literals;
+
+    auto ready(std::future<void>& future) -> bool {
+        return future.wait_for(0ms) == std::future_status::ready;
+    }
+}
+
+TEST_CASE("WaitConditions parses wait step arguments") {
+    auto step = WaitConditions::parse("ms.50");
+    REQUIRE(step);
+    CHECK(step->condition == WaitCondition::Time);
+    CHECK(step->ms == 50);
+
+    step = WaitConditions::parse("pluginWindow");
+    REQUIRE(step);
+    CHECK(step->condition == WaitCondition::PluginWindow);
+    CHECK(step->ms == WaitConditions::DEFAULT_TIMEOUT_MS);
+
+    step = WaitConditions::parse("ipc.300");
+    REQUIRE(step);
+    CHECK(step->condition == WaitCondition::Ipc);
+    CHECK(step->ms == 300);
+
+    // time needs to know how long
+    CHECK_FALSE(WaitConditions::parse("ms"));
+    CHECK_FALSE(WaitConditions::parse("ms.soon"));
+    CHECK_FALSE(WaitConditions::parse("ms.50ms"));
+    CHECK_FALSE(WaitConditions::parse("window"));
+    CHECK_FALSE(WaitConditions::parse(""));
+}
+
+TEST_CASE("WaitScheduler waits out time") {
+    WaitScheduler waits;
+    const auto start = std::chrono::steady_clock::now();
+    auto later = waits.wait(WaitCondition::Time, 30, 1);
+    auto sooner = waits.wait(WaitCondition::Time, 10, 1);
+    auto now = waits.wait(WaitCondition::Time, 0, 1);
+
+    CHECK(ready(now));
+    sooner.get();
+    CHECK(std::chrono::steady_clock::now() - start >= 10ms);
+    CHECK_FALSE(ready(later));
+    later.get();
+    CHECK(std::chrono::steady_clock::now() - start >= 30ms);
+    CHECK(waits.pending() == 0);
+    CHECK(waits.stats().met == 3);
+}
+
+TEST_CASE("WaitScheduler meets waits on their signal") {
+    WaitScheduler waits;
+    auto window = waits.wait(WaitCondition::PluginWindow, 5000, 1);
+    auto other = waits.wait(WaitCondition::PluginWindow, 5000, 2);
+    auto ipc = waits.wait(WaitCondition::Ipc, 5000, 1);
+    CHECK(waits.pending() == 3);
+
+    waits.signal(WaitCondition::PluginWindow);
+    CHECK(ready(window));
+    CHECK(ready(other));
+    CHECK_FALSE(ready(ipc));
+    window.get();
+    CHECK(waits.signals(WaitCondition::PluginWindow) == 1);
+    CHECK(waits.pending() == 1);
+
+    SUBCASE("a signal since `since` counts") {
+        const uint64_t before = waits.signals(WaitCondition::Ipc);
+        waits.signal(WaitCondition::Ipc);
+        CHECK(ready(ipc));
+        auto late = waits.wait(WaitCondition::Ipc, 5000, 1, before);
+        CHECK(ready(late));
+        auto fresh = waits.wait(WaitCondition::Ipc, 5000, 1, waits.signals(WaitCondition::Ipc));
+        CHECK_FALSE(ready(fresh));
+        waits.signal(WaitCondition::Ipc);
+        fresh.get();
+    }
+}
+
+TEST_CASE("WaitScheduler times out a condition that doesn't come") {
+    WaitScheduler waits;
+    const auto start = std::chrono::steady_clock::now();
+    auto window = waits.wait(WaitCondition::PluginWindow, 20, 1);
+    CHECK_THROWS_AS(window.get(), StepTimedOut);
+    CHECK(std::chrono::steady_clock::now() - start >= 20ms);
+
+    // and a timed out wait is off its condition's list
+    waits.signal(WaitCondition::PluginWindow);
+    CHECK(waits.stats().timedOut == 1);
+    CHECK(waits.stats().met == 0);
+}
+
+TEST_CASE("WaitScheduler cancels the waits of preempted macros") {
+    WaitScheduler waits;
+    auto first = waits.wait(WaitCondition::PluginWindow, 5000, 1);
+    auto firstTimer = waits.wait(WaitCondition::Time, 5000, 1);
+    auto second = waits.wait(WaitCondition::Ipc, 5000, 2);
+
+    waits.preempt(2);
+    CHECK_THROWS_AS(first.get(), StepCancelled);
+    CHECK_THROWS_AS(firstTimer.get(), StepCancelled);
+    CHECK_FALSE(ready(second));
+
+    // the old macro can't start waiting again
+    auto again = waits.wait(WaitCondition::Time, 10, 1);
+    CHECK_THROWS_AS(again.get(), StepCancelled);
+
+    waits.signal(WaitCondition::Ipc);
+    second.get();
+    CHECK(waits.pending() == 0);
+    CHECK(waits.stats().cancelled == 3);
+}
+
+TEST_CASE("WaitScheduler holds thousands of waits on one thread") {
+    WaitScheduler waits;
+    std::vector<std::future<void>> windows;
+    std::vector<std::future<void>> timers;
+    for (uint32_t i = 0; i < 5000; ++i) {
+        windows.push_back(waits.wait(WaitCondition::PluginWindow, 60000 + i, i / 100));
+        timers.push_back(waits.wait(WaitCondition::Time, 5 + i % 40, i / 100)); // NOLINT
+    }
+    CHECK(waits.pending() >= 5000);
+
+    for (auto& timer : timers) {
+        timer.get();
+    }
+    // the long ones wait on, until half the macros are preempted
+    waits.preempt(25);
+    waits.signal(WaitCondition::PluginWindow);
+
+    size_t met = 0;
+    size_t cancelled = 0;
+    for (auto& window : windows) {
+        try {
+            window.get();
+            ++met;
+        } catch (const StepCancelled&) {
+            ++cancelled;
+        }
+    }
+    CHECK(met == 2500);
+    CHECK(cancelled == 2500);
+    CHECK(waits.pending() == 0);
+}
+
+TEST_CASE("WaitScheduler cancels what's left when stopped") {
+    std::future<void> window;
+    {
+        WaitScheduler waits;
+        window = waits.wait(WaitCondition::PluginWindow, 60000, 1);
+        auto timer = waits.wait(WaitCondition::Time, 60000, 1);
+        waits.stop();
+        CHECK_THROWS_AS(timer.get(), StepCancelled);
+        auto late = waits.wait(WaitCondition::Time, 1, 2);
+        CHECK_THROWS_AS(late.get(), StepCancelled);
+    }
+    CHECK_THROWS_AS(window.get(), StepCancelled);
+}
@@ -0,0 +1,25 @@
+#include <cstdlib>
+#include <new>
+
+#include "AllocationCounter.h"
+
+namespace fixture {
+    std::atomic<bool> countingAllocations{false};
+    std::atomic<size_t> allocations{0};
+}
+
+// out of line, so the compiler never sees an inlined malloc paired with
+// the library's delete
+// NOLINTBEGIN
+void* operator new(std::size_t size) {
+    if (fixture::countingAllocations.load(std::memory_order_relaxed)) {
+        fixture::allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+// NOLINTEND
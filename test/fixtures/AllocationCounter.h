@@ -0,0 +1,30 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Counts every heap allocation made while an AllocationCounter is alive.
+// The replacement operator new and delete it relies on live in
+// AllocationCounter.cpp, which a test using this has to link in.
+namespace fixture {
+    extern std::atomic<bool> countingAllocations;
+    extern std::atomic<size_t> allocations;
+
+    struct AllocationCounter {
+        AllocationCounter() {
+            allocations = 0;
+            countingAllocations = true;
+        }
+        ~AllocationCounter() {
+            countingAllocations = false;
+        }
+        AllocationCounter(const AllocationCounter&) = delete;
+        auto operator=(const AllocationCounter&) -> AllocationCounter& = delete;
+        AllocationCounter(AllocationCounter&&) = delete;
+        auto operator=(AllocationCounter&&) -> AllocationCounter& = delete;
+
+        [[nodiscard]] auto count() const -> size_t {
+            return allocations.load();
+        }
+    };
+}
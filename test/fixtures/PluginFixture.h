@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "PluginCatalog.h"
+#include "Types.h"
+
+// A realistic slice of a plugin folder, shaped the way ResponseParser
+// hands it over: unique names, sorted case-insensitively, "Vendor:Name" uris.
+namespace fixture {
+    struct FixturePlugin {
+        const char* name;
+        const char* type;
+        const char* vendor;
+    };
+
+    // NOLINTBEGIN
+    inline const std::vector<FixturePlugin>& pluginTable() {
+        static const std::vector<FixturePlugin> table = {
+            {"ADPTR Streamliner", "VST3:", "Plugin Alliance"}
+            , {"API-2500 Stereo", "AUv2:", "Waves"}
+            , {"Auto Filter", "VST3:", "Ableton"}
+            , {"bx_XL V2", "VST3:", "Plugin Alliance"}
+            , {"C6 Stereo", "VST2:", "Waves"}
+            , {"C6-SideChain Stereo", "VST2:", "Waves"}
+            , {"Crystallizer", "VST3:", "Soundtoys"}
+            , {"Decapitator", "VST3:", "Soundtoys"}
+            , {"Diva", "VST3:", "u-he"}
+            , {"EchoBoy", "VST3:", "Soundtoys"}
+            , {"EchoBoy Jr", "VST3:", "Soundtoys"}
+            , {"\u00c9cho C\u00e9leste", "VST3:", "Sonic Fran\u00e7aise"}
+            , {"elysia alpha master", "VST3:", "Plugin Alliance"}
+            , {"Glue Compressor", "VST3:", "Ableton"}
+            , {"H-Delay Stereo", "AUv2:", "Waves"}
+            , {"Kickstart 2", "VST3:", "Nicky Romero"}
+            , {"Kontakt 7", "VST3:", "Native Instruments"}
+            , {"LittleAlterBoy", "VST3:", "Soundtoys"}
+            , {"Massive X", "VST3:", "Native Instruments"}
+            , {"Ozone 11 Equalizer", "VST3:", "iZotope"}
+            , {"Ozone 11 Maximizer", "VST3:", "iZotope"}
+            , {"Pro-C 2", "VST3:", "FabFilter"}
+            , {"Pro-DS", "VST3:", "FabFilter"}
+            , {"Pro-G", "VST3:", "FabFilter"}
+            , {"Pro-L 2", "VST3:", "FabFilter"}
+            , {"Pro-MB", "VST3:", "FabFilter"}
+            , {"Pro-Q 3", "VST3:", "FabFilter"}
+            , {"Pro-R", "VST3:", "FabFilter"}
+            , {"Phase Plant", "VST3:", "Kilohearts"}
+            , {"PrimalTap", "VST3:", "Soundtoys"}
+            , {"RC-20 Retro Color", "VST3:", "XLN Audio"}
+            , {"Saturn 2", "VST3:", "FabFilter"}
+            , {"Serum", "VST3:", "Xfer Records"}
+            , {"Sylenth1", "VST2:", "LennarDigital"}
+            , {"Timeless 3", "VST3:", "FabFilter"}
+            , {"Tonebr\u00fcnder \u00dcberdrive", "VST3:", "Tonebr\u00fcnder"}
+            , {"Trackspacer 2.5", "VST3:", "Wavesfactory"}
+            , {"Valhalla Room", "VST3:", "Valhalla DSP"}
+            , {"Valhalla Shimmer", "VST3:", "Valhalla DSP"}
+            , {"Valhalla VintageVerb", "VST3:", "Valhalla DSP"}
+            , {"Vari Comp", "VST3:", "Native Instruments"}
+            , {"Volcano 3", "VST3:", "FabFilter"}
+            , {"Vital", "VST3:", "Vital Audio"}
+            , {"Weiss DS1-MK3", "VST3:", "Softube"}
+        };
+        return table;
+    }
+    // NOLINTEND
+
+    inline auto lower(std::string s) -> std::string {
+        std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return s;
+    }
+
+    inline void sortLikeResponseParser(std::vector<Plugin>& plugins) {
+        std::sort(plugins.begin(), plugins.end(), [](const Plugin& a, const Plugin& b) {
+            return lower(a.name) < lower(b.name);
+        });
+    }
+
+    inline auto plugins() -> std::vector<Plugin> {
+        std::vector<Plugin> result;
+        int number = 0;
+        for (const auto& entry : pluginTable()) {
+            result.push_back({number++, entry.name, entry.type, std::string(entry.vendor) + ":" + entry.name});
+        }
+        sortLikeResponseParser(result);
+        return result;
+    }
+
+    inline auto catalog() -> PluginCatalogPtr {
+        return std::make_shared<const PluginCatalog>(plugins(), 1);
+    }
+
+    // fixture names with random numbered suffixes, for timing at scale
+    inline auto syntheticPlugins(size_t count, uint32_t seed = 42) -> std::vector<Plugin> { // NOLINT
+        const auto& table = pluginTable();
+        std::mt19937 rng(seed);
+        std::vector<Plugin> result;
+        result.reserve(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            const auto& entry = table[rng() % table.size()];
+            std::string name = std::string(entry.name) + " " + std::to_string(i);
+            result.push_back({static_cast<int>(i), name, entry.type, std::string(entry.vendor) + ":" + name});
+        }
+        sortLikeResponseParser(result);
+        return result;
+    }
+
+    inline auto syntheticCatalog(size_t count, uint32_t seed = 42) -> PluginCatalogPtr { // NOLINT
+        return std::make_shared<const PluginCatalog>(syntheticPlugins(count, seed), 1);
+    }
+}
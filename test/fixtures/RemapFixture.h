@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A large but well-formed remap section: every combination of modifiers
+// over the letters and digits, each remapped to a short macro of keys and
+// actions, the way a heavily customised config looks.
+namespace fixture {
+    // `count` distinct chords, "a", "cmd+a", ... up to 16 * 36
+    inline auto remapChords(size_t count) -> std::vector<std::string> {
+        static constexpr std::array<const char*, 4> MODIFIERS = {"cmd", "shift", "ctrl", "alt"};
+        static constexpr std::string_view KEYS = "abcdefghijklmnopqrstuvwxyz0123456789";
+
+        std::vector<std::string> chords;
+        for (unsigned mask = 0; mask < 16 && chords.size() < count; ++mask) { // NOLINT
+            std::string prefix;
+            for (size_t m = 0; m < MODIFIERS.size(); ++m) {
+                if ((mask >> m) & 1) {
+                    prefix += MODIFIERS[m];
+                    prefix += '+';
+                }
+            }
+            for (size_t k = 0; k < KEYS.size() && chords.size() < count; ++k) {
+                chords.push_back(prefix + KEYS[k]);
+            }
+        }
+        return chords;
+    }
+
+    // the macro chord i maps to
+    inline auto remapMacro(size_t i) -> std::string {
+        switch (i % 3) {
+            case 0: return "cmd+a, plugin.Synth " + std::to_string(i);
+            case 1: return "cmd+d, cmd+d, tilePluginWindows";
+            default: return "shift+leftarrow";
+        }
+    }
+
+    // a config file body with `count` remaps. Past 16 * 36 the chords
+    // repeat; every line is still parsed and compiled, later ones win
+    inline auto remapConfig(size_t count) -> std::string {
+        std::string yaml = "remap:\n";
+        const auto chords = remapChords(count);
+        for (size_t i = 0; i < count; ++i) {
+            yaml += "  " + chords[i % chords.size()] + ": " + remapMacro(i) + "\n";
+        }
+        return yaml;
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+// A fresh directory under the system temp dir, removed with everything
+// in it when the TempDir goes away.
+namespace fixture {
+    struct TempDir {
+        std::filesystem::path path;
+
+        explicit TempDir(const std::string& name)
+            : path(std::filesystem::temp_directory_path() / ("lim_" + name + "_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count())))
+        {
+            std::filesystem::create_directories(path);
+        }
+        ~TempDir() {
+            std::error_code ec;
+            std::filesystem::remove_all(path, ec);
+        }
+        TempDir(const TempDir&) = delete;
+        auto operator=(const TempDir&) -> TempDir& = delete;
+        TempDir(TempDir&&) = delete;
+        auto operator=(TempDir&&) -> TempDir& = delete;
+    };
+
+    // the file's bytes, or "" if it can't be read
+    inline auto readAll(const std::filesystem::path& path) -> std::string {
+        std::ifstream in(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+}
@@ -0,0 +1,156 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "CommandIndex.h"
+#include "MockLogHandler.h"
+#include "PluginCatalog.h"
+#include "SearchEngine.h"
+#include "fixtures/PluginFixture.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    // the shape ConfigMenu produces: categories with children, leaves with an action
+    auto menu() -> std::vector<MenuItem> {
+        return {
+            {"Dynamics", "category", {
+                {"Glue", "Pro-C 2 VST3", {}}
+                , {"--", "separator", {}}
+                , {"Pro-L 2", "Pro-L 2", {}}
+                , {"Multiband", "category", {
+                    {"Split", "Pro-MB AU", {}}
+                }}
+            }}
+            , {"Space", "category", {
+                {"Big Hall", "  Valhalla VintageVerb ", {}}
+            }}
+        };
+    }
+
+    auto actions() -> std::vector<std::string> {
+        return {"tilePluginWindows", "closeAllPlugins", "closeFocusedPlugin"};
+    }
+
+    auto search(const PluginCatalog& catalog, const std::string& query) -> std::vector<std::string> {
+        SearchEngine engine;
+        std::vector<SearchMatch> matches;
+        REQUIRE(engine.search(catalog, query, {}, matches));
+        std::vector<std::string> result;
+        for (const auto& match : matches) {
+            result.push_back(catalog.name(match.index));
+        }
+        return result;
+    }
+}
+
+TEST_CASE("CommandIndex flattens the context menu") {
+    auto commands = CommandIndex::menuCommands(menu());
+    REQUIRE(commands.size() == 3);
+
+    CHECK(commands[0].kind == EntryKind::MenuItem);
+    CHECK(commands[0].label == "Glue");
+    CHECK(commands[0].detail == "Dynamics");
+    CHECK(commands[0].action == "plugin.Pro-C 2 VST3");
+
+    // "Pro-L 2" only repeats the plugin row and the separator isn't a command
+    CHECK(commands[1].label == "Split");
+    CHECK(commands[1].detail == "Dynamics / Multiband");
+    CHECK(commands[1].action == "plugin.Pro-MB AU");
+
+    CHECK(commands[2].detail == "Space");
+    CHECK(commands[2].action == "plugin.Valhalla VintageVerb");
+}
+
+TEST_CASE("CommandIndex labels actions") {
+    CHECK(CommandIndex::actionLabel("closeAllPlugins") == "Close All Plugins");
+    CHECK(CommandIndex::actionLabel("tilePluginWindows") == "Tile Plugin Windows");
+    CHECK(CommandIndex::actionLabel("write-request") == "Write Request");
+    CHECK(CommandIndex::actionLabel("openVSTWindows") == "Open VSTWindows");
+    CHECK(CommandIndex::actionLabel("") == "");
+}
+
+TEST_CASE("CommandIndex merges plugins, menu items and actions") {
+    CommandIndex index;
+    CHECK(index.snapshot()->empty());
+
+    auto plugins = fixture::catalog();
+    index.setPlugins(plugins);
+    index.setMenu(menu());
+    index.setActions(actions());
+
+    auto snapshot = index.snapshot();
+    REQUIRE(snapshot->pluginCount() == plugins->size());
+    REQUIRE(snapshot->size() == plugins->size() + 6);
+
+    const uint32_t first = snapshot->pluginCount();
+    CHECK(snapshot->kind(0) == EntryKind::Plugin);
+    CHECK(snapshot->kind(first) == EntryKind::MenuItem);
+    CHECK(snapshot->name(first) == "Glue");
+    CHECK(snapshot->kind(first + 3) == EntryKind::Action);
+
+    // actions sorted by label
+    CHECK(snapshot->name(first + 3) == "Close All Plugins");
+    CHECK(snapshot->name(first + 4) == "Close Focused Plugin");
+    CHECK(snapshot->command(first + 5).action == "tilePluginWindows");
+
+    SUBCASE("plugin keys and columns carry over unchanged") {
+        for (uint32_t i = 0; i < plugins->size(); ++i) {
+            CHECK(snapshot->searchKey(i) == plugins->searchKey(i));
+            CHECK(snapshot->tokens(i).size() == plugins->tokens(i).size());
+            CHECK(snapshot->format(i) == plugins->format(i));
+            CHECK(snapshot->vendor(i) == plugins->vendor(i));
+        }
+        for (uint32_t i = first; i < snapshot->size(); ++i) {
+            CHECK(snapshot->format(i) == PluginFormat::Other);
+            CHECK(snapshot->vendor(i) == PluginCatalog::NO_VENDOR);
+            CHECK(snapshot->formatEntries(PluginFormat::Other).contains(i));
+        }
+        CHECK(snapshot->formatEntries(PluginFormat::Other).count()
+              == plugins->formatEntries(PluginFormat::Other).count() + 6);
+    }
+
+    SUBCASE("one search covers every kind") {
+        CHECK(search(*snapshot, "close all") == std::vector<std::string>{"Close All Plugins"});
+        CHECK(search(*snapshot, "glue") == std::vector<std::string>{"Glue", "Glue Compressor"});
+
+        auto hall = search(*snapshot, "hall");
+        CHECK(std::find(hall.begin(), hall.end(), "Big Hall") != hall.end());
+
+        // a format filter is about plugins
+        CHECK(search(*snapshot, "fmt:vst3 close").empty());
+    }
+
+    SUBCASE("highlights map onto labels") {
+        SearchEngine engine;
+        std::vector<SearchMatch> matches;
+        REQUIRE(engine.search(*snapshot, "tile plugin", {}, matches));
+        REQUIRE(matches.size() == 1);
+        std::vector<MatchSpan> spans;
+        engine.highlight(*snapshot, matches[0].index, spans);
+        REQUIRE(spans.size() == 1);
+        CHECK(snapshot->name(matches[0].index).substr(spans[0].offset, spans[0].length) == "Tile Plugin");
+    }
+
+    SUBCASE("each source is replaced on its own") {
+        index.setPlugins(std::make_shared<const PluginCatalog>(std::vector<Plugin>{{1, "Serum", "VST3:", "Xfer Records:Serum"}}, 2));
+        auto next = index.snapshot();
+        CHECK(next->version() > snapshot->version());
+        CHECK(next->pluginCount() == 1);
+        CHECK(next->size() == 7);
+        CHECK(next->name(1) == "Glue");
+
+        index.setMenu({});
+        CHECK(index.snapshot()->size() == 4);
+        CHECK(index.snapshot()->name(1) == "Close All Plugins");
+
+        // composing from a snapshot that has commands keeps only its plugins
+        PluginCatalog recomposed(*index.snapshot(), {{EntryKind::Action, "Tile", "Action", "tilePluginWindows"}}, 9); // NOLINT
+        CHECK(recomposed.size() == 2);
+        CHECK(recomposed.formatEntries(PluginFormat::Other).count() == 1);
+        CHECK(recomposed.name(1) == "Tile");
+    }
+}
@@ -0,0 +1,130 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <string>
+#include <vector>
+
+#include "EntrySet.h"
+#include "MockLogHandler.h"
+#include "QueryParser.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    auto parse(const std::string& query) -> ParsedQuery {
+        ParsedQuery parsed;
+        QueryParser::parse(query, parsed);
+        return parsed;
+    }
+
+    auto members(const EntrySet& set) -> std::vector<uint32_t> {
+        std::vector<uint32_t> result;
+        set.forEach([&](uint32_t i) { result.push_back(i); return true; });
+        return result;
+    }
+}
+
+TEST_CASE("QueryParser passes plain text through untouched") {
+    auto parsed = parse("  pro  q ");
+    CHECK(parsed.text == "  pro  q ");
+    CHECK(parsed.predicates.empty());
+}
+
+TEST_CASE("QueryParser splits fields from free text") {
+    auto parsed = parse("fmt:vst3 comp");
+    CHECK(parsed.text == "comp");
+    REQUIRE(parsed.predicates.size() == 1);
+    CHECK(parsed.predicates[0].field == QueryField::Format);
+    CHECK(parsed.predicates[0].value == "vst3");
+
+    parsed = parse("pro VENDOR:FabFilter q");
+    CHECK(parsed.text == "pro q");
+    REQUIRE(parsed.predicates.size() == 1);
+    CHECK(parsed.predicates[0].field == QueryField::Vendor);
+    CHECK(parsed.predicates[0].value == "fabfilter");
+
+    CHECK(parse("format:au").predicates[0].field == QueryField::Format);
+}
+
+TEST_CASE("QueryParser values") {
+    SUBCASE("commas give alternatives") {
+        auto parsed = parse("fmt:vst3,au,");
+        REQUIRE(parsed.predicates.size() == 2);
+        CHECK(parsed.predicates[0].value == "vst3");
+        CHECK(parsed.predicates[1].value == "au");
+    }
+
+    SUBCASE("quotes keep spaces") {
+        auto parsed = parse("vendor:\"Native Instruments\" kontakt");
+        REQUIRE(parsed.predicates.size() == 1);
+        CHECK(parsed.predicates[0].value == "native instruments");
+        CHECK(parsed.text == "kontakt");
+    }
+
+    SUBCASE("an unclosed quote runs to the end") {
+        auto parsed = parse("vendor:\"plugin all");
+        REQUIRE(parsed.predicates.size() == 1);
+        CHECK(parsed.predicates[0].value == "plugin all");
+        CHECK(parsed.text.empty());
+    }
+
+    SUBCASE("values are folded like search keys") {
+        CHECK(parse("vendor:Tonebründer").predicates[0].value == "tonebrunder");
+    }
+
+    SUBCASE("a field still being typed filters nothing") {
+        auto parsed = parse("comp vendor:");
+        CHECK(parsed.predicates.empty());
+        CHECK(parsed.text == "comp");
+    }
+}
+
+TEST_CASE("QueryParser leaves unknown fields as text") {
+    auto parsed = parse("tag:reverb 2:1 ratio");
+    CHECK(parsed.predicates.empty());
+    CHECK(parsed.text == "tag:reverb 2:1 ratio");
+}
+
+TEST_CASE("EntrySet bitmap operations") {
+    EntrySet all;
+    all.reset(130, true); // NOLINT
+    CHECK(all.count() == 130);
+    CHECK(all.contains(129));
+    CHECK(!all.contains(130));
+
+    EntrySet some;
+    some.reset(130, false); // NOLINT
+    for (uint32_t i : {0U, 63U, 64U, 100U, 129U}) {
+        some.insert(i);
+    }
+    CHECK(members(some) == std::vector<uint32_t>{0, 63, 64, 100, 129});
+
+    EntrySet other;
+    other.reset(130, false); // NOLINT
+    other.insert(64);
+    other.insert(65);
+
+    EntrySet both = some;
+    both.intersect(other);
+    CHECK(members(both) == std::vector<uint32_t>{64});
+
+    some.unite(other);
+    CHECK(some.count() == 6);
+
+    all.intersect(other);
+    CHECK(members(all) == std::vector<uint32_t>{64, 65});
+
+    // growing leaves the new entries out, shrinking forgets the cut ones
+    EntrySet grown = both;
+    grown.resize(200); // NOLINT
+    CHECK(members(grown) == std::vector<uint32_t>{64});
+    grown.insert(199);
+    grown.resize(65); // NOLINT
+    grown.resize(200); // NOLINT
+    CHECK(members(grown) == std::vector<uint32_t>{64});
+
+    // forEach stops when asked to
+    uint32_t visited = 0;
+    CHECK(!some.forEach([&](uint32_t) { return ++visited < 3; }));
+    CHECK(visited == 3);
+}
@@ -0,0 +1,114 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <string>
+#include <vector>
+
+#include "MockLogHandler.h"
+#include "PluginCatalog.h"
+#include "ResultList.h"
+#include "SearchEngine.h"
+#include "fixtures/AllocationCounter.h"
+#include "fixtures/PluginFixture.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    // what the worker does for one keystroke, minus the thread hop
+    struct Keystroke {
+        SearchEngine engine;
+        std::vector<SearchMatch> matches;
+        std::vector<MatchSpan> spans;
+        std::vector<uint32_t> spanOffsets;
+
+        void run(const PluginCatalogPtr& catalog, std::string_view query, ResultList& rows) {
+            engine.search(*catalog, query, {}, matches);
+            spans.clear();
+            spanOffsets.clear();
+            for (const auto& match : matches) {
+                spanOffsets.push_back(static_cast<uint32_t>(spans.size()));
+                engine.highlight(*catalog, match.index, spans);
+            }
+            spanOffsets.push_back(static_cast<uint32_t>(spans.size()));
+            rows.assign(catalog, matches, spans, spanOffsets);
+        }
+    };
+}
+
+TEST_CASE("ResultList resolves rows through the catalog") {
+    auto catalog = fixture::catalog();
+    ResultList rows;
+
+    rows.showAll(catalog);
+    REQUIRE(rows.size() == catalog->size());
+    CHECK(rows.plugin(0) == &catalog->plugin(0));
+    CHECK(rows.plugin(-1) == nullptr);
+    CHECK(rows.plugin(static_cast<int>(catalog->size())) == nullptr);
+    CHECK(rows.spans(0).empty());
+
+    Keystroke keystroke;
+    keystroke.run(catalog, "serum", rows);
+    REQUIRE(rows.size() == 1);
+    CHECK(rows.plugin(0)->name == "Serum");
+    REQUIRE(rows.spans(0).size() == 1);
+    CHECK(rows.spans(0)[0].offset == 0);
+    CHECK(rows.spans(0)[0].length == 5);
+}
+
+TEST_CASE("ResultList rows can be commands") {
+    auto plugins = fixture::catalog();
+    auto catalog = std::make_shared<const PluginCatalog>(*plugins, std::vector<Command>{{EntryKind::Action, "Close All Plugins", "Action", "closeAllPlugins"}}, 1);
+    ResultList rows;
+    Keystroke keystroke;
+    keystroke.run(catalog, "close all", rows);
+
+    REQUIRE(rows.size() == 1);
+    CHECK(*rows.name(0) == "Close All Plugins");
+    CHECK(rows.plugin(0) == nullptr);
+    CHECK(rows.catalog()->command(rows.catalogIndex(0)).action == "closeAllPlugins");
+    CHECK(rows.name(1) == nullptr);
+}
+
+TEST_CASE("ResultList keeps an older snapshot alive for its rows") {
+    auto catalog = fixture::catalog();
+    ResultList rows;
+    Keystroke keystroke;
+    keystroke.run(catalog, "diva", rows);
+
+    std::weak_ptr<const PluginCatalog> weak = catalog;
+    catalog.reset();
+    REQUIRE_FALSE(weak.expired());
+    CHECK(rows.plugin(0)->name == "Diva");
+
+    rows.showAll(fixture::catalog());
+    CHECK(weak.expired());
+}
+
+TEST_CASE("Typing does not allocate once buffers are warm") {
+    auto catalog = fixture::syntheticCatalog(5000); // NOLINT
+    ResultList rows;
+    rows.reserve(*catalog);
+    Keystroke keystroke;
+    keystroke.matches.reserve(catalog->size());
+
+    const std::vector<std::string> typed = {"s", "se", "ser", "seru", "serum", "ser", "v", "va", "val", "valhala", "valhala shim", ""};
+
+    // first pass grows every buffer to what these queries need
+    for (const auto& query : typed) {
+        keystroke.run(catalog, query, rows);
+    }
+    rows.showAll(catalog);
+
+    fixture::AllocationCounter counter;
+    for (const auto& query : typed) {
+        keystroke.run(catalog, query, rows);
+        // reading rows back is what painting does
+        for (uint32_t row = 0; row < std::min<uint32_t>(rows.size(), 20); ++row) { // NOLINT
+            (void)rows.plugin(static_cast<int>(row));
+            (void)rows.spans(row);
+        }
+    }
+    rows.showAll(catalog);
+
+    CHECK(counter.count() == 0);
+}
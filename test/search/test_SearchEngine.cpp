@@ -0,0 +1,380 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "EditDistance.h"
+#include "MockLogHandler.h"
+#include "PluginCatalog.h"
+#include "SearchEngine.h"
+#include "fixtures/PluginFixture.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    auto names(const PluginCatalog& catalog, const std::vector<SearchMatch>& matches) -> std::vector<std::string> {
+        std::vector<std::string> result;
+        for (const auto& match : matches) {
+            result.push_back(catalog.name(match.index));
+        }
+        return result;
+    }
+
+    auto run(SearchEngine& engine, const PluginCatalog& catalog, const std::string& query) -> std::vector<std::string> {
+        std::vector<SearchMatch> matches;
+        REQUIRE(engine.search(catalog, query, {}, matches));
+        return names(catalog, matches);
+    }
+
+    auto levenshtein(const std::string& a, const std::string& b) -> uint32_t {
+        std::vector<uint32_t> prev(b.size() + 1);
+        std::vector<uint32_t> cur(b.size() + 1);
+        for (size_t j = 0; j <= b.size(); ++j) prev[j] = static_cast<uint32_t>(j);
+        for (size_t i = 1; i <= a.size(); ++i) {
+            cur[0] = static_cast<uint32_t>(i);
+            for (size_t j = 1; j <= b.size(); ++j) {
+                uint32_t substitution = prev[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1);
+                cur[j] = std::min({prev[j] + 1, cur[j - 1] + 1, substitution});
+            }
+            std::swap(prev, cur);
+        }
+        return prev[b.size()];
+    }
+}
+
+TEST_CASE("BoundedEditMatcher agrees with the textbook DP") {
+    std::mt19937 rng(7); // NOLINT
+    auto randomWord = [&rng](size_t length) {
+        std::string s;
+        for (size_t i = 0; i < length; ++i) s.push_back(static_cast<char>('a' + rng() % 4));
+        return s;
+    };
+
+    for (int i = 0; i < 5000; ++i) { // NOLINT
+        auto pattern = randomWord(1 + rng() % 12);
+        auto text = randomWord(rng() % 16);
+        BoundedEditMatcher matcher(pattern);
+        CHECK(matcher.distance(text) == levenshtein(pattern, text));
+
+        uint32_t bestPrefix = static_cast<uint32_t>(pattern.size());
+        for (size_t j = 0; j <= text.size(); ++j) {
+            bestPrefix = std::min(bestPrefix, levenshtein(pattern, text.substr(0, j)));
+        }
+        const uint32_t bound = rng() % 4;
+        CHECK(matcher.prefixDistance(text, bound) == (bestPrefix <= bound ? bestPrefix : bound + 1));
+    }
+}
+
+TEST_CASE("BoundedEditMatcher bounds") {
+    CHECK(BoundedEditMatcher("sreum").prefixDistance("serum", 2) == 2);
+    CHECK(BoundedEditMatcher("valhala").prefixDistance("valhalla", 2) == 1);
+    CHECK(BoundedEditMatcher("valhala").prefixDistance("vintageverb", 2) == 3);
+    CHECK(BoundedEditMatcher("").prefixDistance("anything", 2) == 0);
+}
+
+TEST_CASE("SearchEngine exact and fuzzy tiers") {
+    auto catalog = fixture::catalog();
+    SearchEngine engine;
+
+    SUBCASE("empty query lists everything in catalog order") {
+        auto result = run(engine, *catalog, "  ");
+        REQUIRE(result.size() == catalog->size());
+        CHECK(result.front() == catalog->plugin(0).name);
+    }
+
+    SUBCASE("prefix matches outrank substring matches") {
+        auto result = run(engine, *catalog, "pro");
+        REQUIRE(result.size() >= 7);
+        for (size_t i = 0; i < 7; ++i) { // NOLINT
+            CHECK(result[i].rfind("Pro-", 0) == 0);
+        }
+    }
+
+    SUBCASE("word-start substring beats mid-word substring") {
+        auto result = run(engine, *catalog, "boy");
+        REQUIRE(result.size() >= 2);
+        CHECK(result[0] == "EchoBoy");
+    }
+
+    SUBCASE("subsequence still finds abbreviations") {
+        auto result = run(engine, *catalog, "vvv");
+        REQUIRE(!result.empty());
+        CHECK(result[0] == "Valhalla VintageVerb");
+    }
+}
+
+TEST_CASE("PluginCatalog format and vendor columns") {
+    auto catalog = fixture::catalog();
+
+    CHECK(PluginCatalog::formatOf("VST3:") == PluginFormat::VST3);
+    CHECK(PluginCatalog::formatOf("AUv2:") == PluginFormat::AU);
+    CHECK(PluginCatalog::formatOf("VST2") == PluginFormat::VST2);
+    CHECK(PluginCatalog::formatOf("") == PluginFormat::Other);
+
+    uint32_t total = 0;
+    for (auto format : {PluginFormat::VST3, PluginFormat::VST2, PluginFormat::AU, PluginFormat::Other}) {
+        catalog->formatEntries(format).forEach([&](uint32_t i) {
+            CHECK(catalog->format(i) == format);
+            ++total;
+            return true;
+        });
+    }
+    CHECK(total == catalog->size());
+    CHECK(catalog->formatEntries(PluginFormat::AU).count() == 2);
+
+    uint32_t posted = 0;
+    for (uint32_t v = 0; v < catalog->vendorCount(); ++v) {
+        auto entries = catalog->vendorEntries(v);
+        CHECK(std::is_sorted(entries.begin(), entries.end()));
+        for (uint32_t i : entries) {
+            CHECK(catalog->vendor(i) == v);
+            CHECK(catalog->plugin(i).uri.rfind(std::string(catalog->vendorName(v)) + ":", 0) == 0);
+        }
+        posted += static_cast<uint32_t>(entries.size());
+    }
+    CHECK(posted == catalog->size());
+}
+
+TEST_CASE("PluginCatalog resolves names") {
+    PluginAliases aliases = {
+        {"eq", "Pro-Q 3"}
+        , {"Verb", "valhalla vintageverb au"}
+        , {"Gone", "Serum 2"}
+        , {"Pro-C 2", "Pro-L 2"}
+    };
+    PluginCatalog catalog({
+        {1, "Pro-C 2", "VST3:", "FabFilter:Pro-C 2"}
+        , {2, "Pro-Q 3", "AUv2:", "FabFilter:Pro-Q 3"}
+        , {3, "Pro-Q 3", "VST3:", "FabFilter:Pro-Q 3"}
+        , {4, "Tonebründer", "VST3:", "Ösound:Tonebründer"}
+        , {5, "Valhalla VintageVerb", "AUv2:", "Valhalla DSP:Valhalla VintageVerb"}
+    }, 1, aliases);
+
+    auto number = [&](std::string_view name) {
+        auto lookup = catalog.findPlugin(name);
+        return lookup.found() ? catalog.plugin(lookup.index).number : 0;
+    };
+
+    SUBCASE("by name, ignoring case, accents and padding") {
+        CHECK(number("Pro-C 2") == 1);
+        CHECK(number("  pro-c 2 ") == 1);
+        CHECK(number("TONEBRUNDER") == 4);
+        CHECK(number("Tonebründer") == 4);
+    }
+
+    SUBCASE("the first format wins, a suffix picks one") {
+        CHECK(number("Pro-Q 3") == 2);
+        CHECK(number("Pro-Q 3 VST3") == 3);
+        CHECK(number("pro-q 3 au") == 2);
+        CHECK(number("Pro-C 2 VST3") == 1);
+    }
+
+    SUBCASE("through aliases") {
+        CHECK(number("EQ") == 2);
+        CHECK(number("verb") == 5);
+
+        // a plugin name shadows an alias of the same name
+        CHECK(number("Pro-C 2") == 1);
+    }
+
+    SUBCASE("misses say why") {
+        CHECK(catalog.findPlugin("").miss == NameMiss::Empty);
+        CHECK(catalog.findPlugin("Serum").miss == NameMiss::NotInstalled);
+        CHECK(catalog.findPlugin("Pro-C 2 AU").miss == NameMiss::NotInFormat);
+        CHECK(catalog.findPlugin("Valhalla VintageVerb VST3").miss == NameMiss::NotInFormat);
+
+        auto gone = catalog.findPlugin("gone");
+        CHECK(gone.miss == NameMiss::AliasTargetMissing);
+        CHECK(gone.target == "Serum 2");
+        CHECK(PluginCatalog::missReason("gone", gone) == "\"gone\" is an alias for \"Serum 2\", which isn't installed");
+        CHECK(PluginCatalog::missReason("Serum", catalog.findPlugin("Serum")) == "no plugin named \"Serum\" is installed");
+    }
+
+    SUBCASE("composed catalogs keep the index") {
+        PluginCatalog composed(catalog, {{EntryKind::Action, "Pro-Q 3 Launcher", "Action", "searchbox"}}, 2);
+        auto lookup = composed.findPlugin("eq");
+        REQUIRE(lookup.found());
+        CHECK(composed.plugin(lookup.index).number == 2);
+        CHECK(composed.findPlugin("Pro-Q 3 Launcher").miss == NameMiss::NotInstalled);
+        CHECK(composed.findNumber(4) == 3);
+    }
+
+    SUBCASE("by number") {
+        for (uint32_t i = 0; i < catalog.pluginCount(); ++i) {
+            CHECK(catalog.findNumber(catalog.plugin(i).number) == i);
+        }
+        CHECK(catalog.findNumber(0) == UINT32_MAX);
+        CHECK(catalog.findNumber(6) == UINT32_MAX);
+    }
+
+    SUBCASE("every name in a large catalog resolves to itself") {
+        auto large = fixture::syntheticCatalog(20000); // NOLINT
+        for (uint32_t i = 0; i < large->size(); ++i) {
+            auto lookup = large->findPlugin(large->plugin(i).name);
+            REQUIRE(lookup.found());
+            CHECK(lookup.index == i);
+        }
+    }
+}
+
+TEST_CASE("SearchEngine field predicates") {
+    auto catalog = fixture::catalog();
+    SearchEngine engine;
+
+    SUBCASE("a format alone lists that format in catalog order") {
+        auto result = run(engine, *catalog, "fmt:vst2");
+        CHECK(result == std::vector<std::string>{"C6 Stereo", "C6-SideChain Stereo", "Sylenth1"});
+    }
+
+    SUBCASE("a format prefix takes every format it starts") {
+        auto vst = run(engine, *catalog, "fmt:vst");
+        CHECK(vst.size() == catalog->size() - 2);
+    }
+
+    SUBCASE("alternatives widen, fields narrow") {
+        CHECK(run(engine, *catalog, "fmt:vst2,au").size() == 5);
+        CHECK(run(engine, *catalog, "fmt:au vendor:waves") == std::vector<std::string>{"API-2500 Stereo", "H-Delay Stereo"});
+        CHECK(run(engine, *catalog, "fmt:au vendor:fabfilter").empty());
+    }
+
+    SUBCASE("free text is scored within the filter") {
+        auto result = run(engine, *catalog, "vendor:fab pro");
+        REQUIRE(result.size() == 7);
+        for (const auto& name : result) {
+            CHECK(name.rfind("Pro-", 0) == 0);
+        }
+
+        // without the filter "stereo" finds Waves in every format
+        CHECK(run(engine, *catalog, "stereo fmt:vst2") == std::vector<std::string>{"C6 Stereo", "C6-SideChain Stereo"});
+    }
+
+    SUBCASE("vendor words match at word starts, accents folded") {
+        CHECK(run(engine, *catalog, "vendor:instruments").size() == 3);
+        CHECK(run(engine, *catalog, "vendor:struments").empty());
+        CHECK(run(engine, *catalog, "vendor:\"sonic francaise\"") == std::vector<std::string>{"\u00c9cho C\u00e9leste"});
+    }
+
+    SUBCASE("the typo tier stays inside the filter") {
+        auto result = run(engine, *catalog, "vendor:valhalla shimer");
+        REQUIRE(!result.empty());
+        CHECK(result[0] == "Valhalla Shimmer");
+        for (const auto& name : result) {
+            CHECK(name.rfind("Valhalla", 0) == 0);
+        }
+    }
+
+    SUBCASE("highlights cover the free text only") {
+        std::vector<SearchMatch> matches;
+        REQUIRE(engine.search(*catalog, "vendor:soundtoys boy", {}, matches));
+        REQUIRE(!matches.empty());
+        std::vector<MatchSpan> spans;
+        engine.highlight(*catalog, matches[0].index, spans);
+        REQUIRE(spans.size() == 1);
+        CHECK(catalog->plugin(matches[0].index).name.substr(spans[0].offset, spans[0].length) == "Boy");
+    }
+}
+
+TEST_CASE("SearchEngine approximate tier relevance") {
+    auto catalog = fixture::catalog();
+    SearchEngine engine;
+
+    SUBCASE("transposed letters") {
+        auto result = run(engine, *catalog, "sreum");
+        REQUIRE(!result.empty());
+        CHECK(result[0] == "Serum");
+    }
+
+    SUBCASE("dropped letter in a vendor prefix") {
+        auto result = run(engine, *catalog, "valhala");
+        REQUIRE(result.size() >= 3);
+        for (size_t i = 0; i < 3; ++i) {
+            CHECK(result[i].rfind("Valhalla", 0) == 0);
+        }
+    }
+
+    SUBCASE("multi-word query needs every word to land") {
+        auto result = run(engine, *catalog, "valhala shimer");
+        REQUIRE(!result.empty());
+        CHECK(result[0] == "Valhalla Shimmer");
+    }
+
+    SUBCASE("fewer errors rank first") {
+        auto result = run(engine, *catalog, "decapitatr");
+        REQUIRE(!result.empty());
+        CHECK(result[0] == "Decapitator");
+    }
+
+    SUBCASE("short words get no slack") {
+        CHECK(run(engine, *catalog, "qj").empty());
+    }
+
+    SUBCASE("does not run when the exact tiers already have enough") {
+        SearchOptions options;
+        options.approximateThreshold = 1;
+        SearchEngine strict(options);
+        // "pro" has plenty of real matches, so nothing approximate may sneak in
+        auto result = run(strict, *catalog, "pro");
+        for (const auto& name : result) {
+            CHECK(fixture::lower(name).find('p') != std::string::npos);
+        }
+    }
+}
+
+TEST_CASE("SearchEngine matches accented names from plain ASCII") {
+    auto catalog = fixture::catalog();
+    SearchEngine engine;
+
+    CHECK(run(engine, *catalog, "tonebrunder").at(0) == "Tonebr\u00fcnder \u00dcberdrive");
+    CHECK(run(engine, *catalog, "uberdrive").at(0) == "Tonebr\u00fcnder \u00dcberdrive");
+    CHECK(run(engine, *catalog, "celeste").at(0) == "\u00c9cho C\u00e9leste");
+
+    // and the other way round
+    CHECK(run(engine, *catalog, "\u00c9CHOBOY").at(0) == "EchoBoy");
+
+    // typo tier works over folded keys too
+    CHECK(run(engine, *catalog, "tonebrundr").at(0) == "Tonebr\u00fcnder \u00dcberdrive");
+}
+
+TEST_CASE("SearchEngine highlights what matched") {
+    auto catalog = fixture::catalog();
+    SearchEngine engine;
+    std::vector<SearchMatch> matches;
+
+    auto spansFor = [&](const std::string& query, const std::string& name) {
+        REQUIRE(engine.search(*catalog, query, {}, matches));
+        std::vector<std::string> parts;
+        for (const auto& match : matches) {
+            if (catalog->plugin(match.index).name != name) continue;
+            std::vector<MatchSpan> spans;
+            engine.highlight(*catalog, match.index, spans);
+            for (const auto& span : spans) {
+                parts.push_back(name.substr(span.offset, span.length));
+            }
+        }
+        return parts;
+    };
+
+    CHECK(spansFor("verb", "Valhalla VintageVerb") == std::vector<std::string>{"Verb"});
+    CHECK(spansFor("vvv", "Valhalla VintageVerb") == std::vector<std::string>{"V", "V", "V"});
+    CHECK(spansFor("glcomp", "Glue Compressor") == std::vector<std::string>{"Gl", "Comp"});
+
+    // spans land on the display name, not the folded key
+    CHECK(spansFor("brunder", "Tonebr\u00fcnder \u00dcberdrive") == std::vector<std::string>{"br\u00fcnder"});
+    CHECK(spansFor("uber", "Tonebr\u00fcnder \u00dcberdrive") == std::vector<std::string>{"\u00dcber"});
+
+    // typo matches mark the words they landed on
+    CHECK(spansFor("sreum", "Serum") == std::vector<std::string>{"Serum"});
+    CHECK(spansFor("vlahalla room", "Valhalla Room") == std::vector<std::string>{"Valhalla", "Room"});
+}
+
+TEST_CASE("SearchEngine honours cancellation") {
+    auto catalog = fixture::syntheticCatalog(10000); // NOLINT
+    SearchEngine engine;
+    std::atomic<uint64_t> latest{2};
+    CancellationToken stale(latest, 1);
+    std::vector<SearchMatch> matches;
+    CHECK_FALSE(engine.search(*catalog, "serum", stale, matches));
+}
@@ -0,0 +1,86 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <string>
+#include <vector>
+
+#include "MockLogHandler.h"
+#include "TextFold.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+TEST_CASE("TextFold leaves plain ASCII lowercased") {
+    CHECK(TextFold::fold("Pro-Q 3") == "pro-q 3");
+    CHECK(TextFold::fold("") == "");
+    CHECK(TextFold::fold("already lower 123") == "already lower 123");
+}
+
+TEST_CASE("TextFold strips Latin accents") {
+    CHECK(TextFold::fold("Tonebründer") == "tonebrunder");
+    CHECK(TextFold::fold("ÉCHOBOY") == "echoboy");
+    CHECK(TextFold::fold("Française") == "francaise");
+    CHECK(TextFold::fold("Øresund") == "oresund");
+    CHECK(TextFold::fold("Łódź") == "lodz");
+    CHECK(TextFold::fold("Škoda Ř") == "skoda r");
+}
+
+TEST_CASE("TextFold expands ligatures and sharp s") {
+    CHECK(TextFold::fold("Straße") == "strasse");
+    CHECK(TextFold::fold("Æther") == "aether");
+    CHECK(TextFold::fold("Œuvre") == "oeuvre");
+    CHECK(TextFold::fold("ÞPorn") == "thporn");
+}
+
+TEST_CASE("TextFold treats decomposed and precomposed alike") {
+    // macOS hands out NFD names: e + combining acute
+    CHECK(TextFold::fold("Café") == TextFold::fold("Café"));
+    CHECK(TextFold::fold("Überdrive") == "uberdrive");
+}
+
+TEST_CASE("TextFold case-folds Greek and Cyrillic without stripping") {
+    CHECK(TextFold::fold("ΣΙΓΜΑ") == "σιγμα");
+    CHECK(TextFold::fold("λογος") == "λογοσ");
+    CHECK(TextFold::fold("СИНТЕЗ") == "синтез");
+    CHECK(TextFold::fold("Ёж") == "ёж");
+}
+
+TEST_CASE("TextFold maps look-alikes to what people type") {
+    CHECK(TextFold::fold("Pro‑Q") == "pro-q");
+    CHECK(TextFold::fold("“Vintage”") == "\"vintage\"");
+    CHECK(TextFold::fold("Ozone 11") == "ozone 11");
+    CHECK(TextFold::fold("Ｓｅｒｕｍ") == "serum");
+}
+
+TEST_CASE("TextFold keeps what it has no rule for") {
+    CHECK(TextFold::fold("日本") == "日本");
+    CHECK(TextFold::fold("×÷") == "×÷");
+
+    std::string broken = "a\xff" "b\xc3";
+    CHECK(TextFold::fold(broken) == broken);
+}
+
+TEST_CASE("TextFold records where each folded byte came from") {
+    std::string out;
+    std::vector<uint16_t> offsets;
+    // T o n e b r ü(2 bytes) n d e r
+    TextFold::appendFolded("Tonebründer", out, &offsets);
+    REQUIRE(out == "tonebrunder");
+    REQUIRE(offsets.size() == out.size());
+    CHECK(offsets[6] == 6);
+    CHECK(offsets[7] == 8);
+
+    out.clear();
+    offsets.clear();
+    TextFold::appendFolded("ßx", out, &offsets);
+    REQUIRE(out == "ssx");
+    const std::vector<uint16_t> expected = {0, 0, 2};
+    CHECK(offsets == expected);
+}
+
+TEST_CASE("TextFold word bytes never split multi-byte characters") {
+    for (unsigned char c : std::string("ü日")) {
+        CHECK(TextFold::isWordByte(c));
+    }
+    CHECK_FALSE(TextFold::isWordByte(' '));
+    CHECK_FALSE(TextFold::isWordByte('-'));
+}
@@ -0,0 +1,207 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MockLogHandler.h"
+#include "PluginCatalog.h"
+#include "SearchEngine.h"
+#include "TextFold.h"
+#include "UsageStore.h"
+#include "fixtures/PluginFixture.h"
+
+std::shared_ptr<ILogger> logger = std::make_shared<MockLogHandler>();
+
+namespace {
+    using namespace std::chrono_literals;
+
+    // a clock the test moves by hand
+    struct FakeClock {
+        std::chrono::system_clock::time_point now = std::chrono::system_clock::time_point(std::chrono::hours(24 * 365 * 50)); // NOLINT
+
+        auto fn() -> UsageStore::Clock {
+            return [this]() { return now; };
+        }
+    };
+
+    struct TempFile {
+        std::filesystem::path path;
+
+        explicit TempFile(const std::string& name)
+            : path(std::filesystem::temp_directory_path() / ("lim_" + name + "_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".bin"))
+        {
+            std::filesystem::remove(path);
+        }
+        ~TempFile() {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+        TempFile(const TempFile&) = delete;
+        auto operator=(const TempFile&) -> TempFile& = delete;
+        TempFile(TempFile&&) = delete;
+        auto operator=(TempFile&&) -> TempFile& = delete;
+    };
+
+    auto options() -> UsageOptions {
+        UsageOptions o;
+        o.halfLife = std::chrono::hours(24 * 7); // NOLINT
+        o.flushDelay = 10ms; // NOLINT
+        return o;
+    }
+
+    auto topNames(const PluginCatalog& catalog, SearchEngine& engine, const std::string& query, const RankingBoostsPtr& boosts, size_t n) -> std::vector<std::string> {
+        std::vector<SearchMatch> matches;
+        std::span<const uint16_t> span;
+        if (boosts) span = *boosts;
+        REQUIRE(engine.search(catalog, query, {}, matches, span));
+
+        std::vector<std::string> result;
+        for (size_t i = 0; i < std::min(n, matches.size()); ++i) {
+            result.push_back(catalog.plugin(matches[i].index).name);
+        }
+        return result;
+    }
+}
+
+TEST_CASE("UsageStore decays weights by half-life") {
+    TempFile file("decay");
+    FakeClock clock;
+    UsageStore store(file.path, options(), clock.fn());
+
+    store.record("Serum");
+    CHECK(store.weight("Serum") == doctest::Approx(1.0));
+
+    clock.now += std::chrono::hours(24 * 7); // NOLINT
+    CHECK(store.weight("Serum") == doctest::Approx(0.5));
+
+    store.record("Serum");
+    CHECK(store.weight("Serum") == doctest::Approx(1.5));
+
+    CHECK(store.weight("Diva") == 0.0);
+    CHECK(store.size() == 1);
+}
+
+TEST_CASE("UsageStore recency beats stale frequency") {
+    TempFile file("recency");
+    FakeClock clock;
+    UsageStore store(file.path, options(), clock.fn());
+
+    for (int i = 0; i < 4; ++i) store.record("Diva");
+    clock.now += std::chrono::hours(24 * 28); // NOLINT four half-lives
+    store.record("Serum");
+
+    CHECK(store.weight("Serum") > store.weight("Diva"));
+}
+
+TEST_CASE("UsageStore survives many distinct entries") {
+    TempFile file("grow");
+    FakeClock clock;
+    UsageStore store(file.path, options(), clock.fn());
+
+    for (int i = 0; i < 5000; ++i) { // NOLINT
+        store.record("plugin " + std::to_string(i));
+    }
+    CHECK(store.size() == 5000);
+    CHECK(store.weight("plugin 4999") == doctest::Approx(1.0));
+}
+
+TEST_CASE("UsageStore persists across instances") {
+    TempFile file("persist");
+    FakeClock clock;
+    {
+        UsageStore store(file.path, options(), clock.fn());
+        store.record("Valhalla Room");
+        store.record("Valhalla Room");
+        store.record("Pro-Q 3");
+        // destructor flushes
+    }
+    REQUIRE(std::filesystem::exists(file.path));
+
+    clock.now += std::chrono::hours(24 * 7); // NOLINT
+    UsageStore reloaded(file.path, options(), clock.fn());
+    CHECK(reloaded.size() == 2);
+    CHECK(reloaded.weight("Valhalla Room") == doctest::Approx(1.0));
+    CHECK(reloaded.weight("Pro-Q 3") == doctest::Approx(0.5));
+}
+
+TEST_CASE("UsageStore flushes in the background") {
+    TempFile file("background");
+    FakeClock clock;
+    UsageStore store(file.path, options(), clock.fn());
+    store.record("EchoBoy");
+
+    for (int i = 0; i < 200 && !std::filesystem::exists(file.path); ++i) { // NOLINT
+        std::this_thread::sleep_for(5ms);
+    }
+    CHECK(std::filesystem::exists(file.path));
+}
+
+TEST_CASE("UsageStore ignores a corrupt file") {
+    TempFile file("corrupt");
+    {
+        std::ofstream out(file.path, std::ios::binary);
+        out << "definitely not a usage table";
+    }
+    FakeClock clock;
+    UsageStore store(file.path, options(), clock.fn());
+    CHECK(store.size() == 0);
+
+    store.record("Serum");
+    CHECK(store.weight("Serum") == doctest::Approx(1.0));
+}
+
+TEST_CASE("UsageStore boosts blend into ranking") {
+    TempFile file("ranking");
+    FakeClock clock;
+    UsageStore store(file.path, options(), clock.fn());
+    auto catalog = fixture::catalog();
+    SearchEngine engine;
+
+    SUBCASE("no history means no boosts and the old order") {
+        CHECK(store.rankingBoosts(*catalog) == nullptr);
+        CHECK(topNames(*catalog, engine, "", nullptr, 1)[0] == catalog->plugin(0).name);
+    }
+
+    SUBCASE("boosts are cached until usage changes") {
+        store.record("Serum");
+        auto first = store.rankingBoosts(*catalog);
+        REQUIRE(first != nullptr);
+        CHECK(store.rankingBoosts(*catalog) == first);
+
+        store.record("Diva");
+        CHECK(store.rankingBoosts(*catalog) != first);
+    }
+
+    SUBCASE("most used comes first on an empty query") {
+        for (int i = 0; i < 5; ++i) store.record("Serum");
+        store.record("Diva");
+        auto top = topNames(*catalog, engine, "", store.rankingBoosts(*catalog), 2);
+        CHECK(top[0] == "Serum");
+        CHECK(top[1] == "Diva");
+    }
+
+    SUBCASE("first keystroke surfaces the favourite within its tier") {
+        auto before = topNames(*catalog, engine, "s", nullptr, 1);
+        CHECK(before[0] != "Sylenth1");
+
+        for (int i = 0; i < 5; ++i) store.record("Sylenth1");
+        auto after = topNames(*catalog, engine, "s", store.rankingBoosts(*catalog), 1);
+        CHECK(after[0] == "Sylenth1");
+    }
+
+    SUBCASE("usage never lifts a weaker tier over a stronger one") {
+        // "ec" is a prefix of the Echo* names but only mid-word in Decapitator
+        for (int i = 0; i < 50; ++i) store.record("Decapitator"); // NOLINT
+        auto top = topNames(*catalog, engine, "ec", store.rankingBoosts(*catalog), 4);
+        REQUIRE(top.size() == 4);
+        for (size_t i = 0; i < 3; ++i) {
+            CHECK(TextFold::fold(top[i]).rfind("ec", 0) == 0);
+        }
+        CHECK(top[3] == "Decapitator");
+    }
+}
@@ -2,6 +2,7 @@
 #include <doctest/doctest.h>
 
 #include "ActionHandler.h"
+#include "KeyChord.h"
 #include "ConfigManager.h"
 #include "WindowManager.h"
 #include "PluginManager.h"
@@ -103,7 +104,7 @@ TEST_CASE("ActionHandler handleKeyEvent") {
     testKeyPress.alt = false;
     testKeyPress.shift = false;
 
-    CHECK(actionHandler.handleKeyEvent(testKeyPress));
+    CHECK(actionHandler.handleKeyEvent(KeyChord::fromKeyPress(testKeyPress)));
 }
 
 TEST_CASE("ActionHandler handleAction with arguments") {